@@ -0,0 +1,298 @@
+#include <span>
+#include <print>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <optional>
+#include <typeinfo>
+#include <exception>
+#include <algorithm>
+#include <filesystem>
+#include <string_view>
+#include <initializer_list>
+
+#include <cctype>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+
+#include "../support/error.hpp"
+#include "../support/parallel.hpp"
+#include "../support/process_memory.hpp"
+#include "../support/mapped_file.hpp"
+
+#include "../vmlib/mipmap.hpp"
+#include "../vmlib/block_compression.hpp"
+
+#include "../main/defaults.hpp"
+#include "../main/mesh_build.hpp"
+#include "../main/mesh_cache.hpp"
+#include "../main/asset_pack.hpp"
+#include "../main/image_decode.hpp"
+#include "../main/vertex_formats.hpp"
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "../third_party/fontstash/include/stb_truetype.h"
+
+/* assetc: builds the application's asset pack (see main/asset_pack.hpp)
+ *
+ * Usage: assetc [--textures=bc7|bc1|rgba8] [<asset directory> [<pack>]]
+ *
+ * The defaults, assets/cw2 and assets/cw2.pack, are where the application
+ * looks (run from the workspace directory, like the application). Every
+ * file under the asset directory that the application loads is converted:
+ *  - the OBJs in kMeshes_, with the vertex format and layout that the
+ *    application uses for them;
+ *  - images (.jpg, .jpeg, .png): decoded, flipped, mipmapped and, by
+ *    default, compressed to BC7 (--textures selects BC1, which is half the
+ *    size but drops alpha, or uncompressed RGBA8);
+ *  - fonts (.ttf): baked at kUiFontPixelHeight;
+ *  - shaders (.vert, .frag, ...): as they are.
+ * Other files (e.g., .mtl, whose colours are part of the meshes) are
+ * skipped.
+ *
+ * Meshes are built as the application builds them on a cold load (see
+ * build_mesh() in main/mesh_build.hpp), and assetc reports the process's
+ * peak RSS after each one. The peak belongs to a mesh only if that mesh set
+ * it; pack a directory with just the mesh to measure the memory that
+ * loading it takes.
+ */
+namespace
+{
+	struct MeshRecipe_
+	{
+		std::string_view name;
+		bool (*write)( std::ostream&, std::filesystem::path const&, MeshLayout const& );
+		MeshLayout layout;
+	};
+
+	template< class tVertex >
+	bool write_mesh_( std::ostream& aOut, std::filesystem::path const& aSource, MeshLayout const& aLayout )
+	{
+		auto const built = build_mesh<tVertex>( aSource, aLayout );
+		return write_mesh_data( aOut, VertexTraits<tVertex>::kCacheFormat, sizeof( tVertex ), built.vertex_bytes(), built.index_bytes(), built.chunks, built.chunkLods, built.meshlets, built.info );
+	}
+
+	// See load_parlahti_mesh() and load_landingpad_mesh() in main/main.cpp.
+	MeshRecipe_ const kMeshes_[] = {
+		{ "parlahti.obj", &write_mesh_<VertexPNT>, kTerrainMeshLayout },
+		{ "landingpad.obj", &write_mesh_<VertexPNC>, kLandingPadMeshLayout }
+	};
+
+	// Encodes aPixels in bands of block rows, one per thread.
+	std::vector<std::uint8_t> encode_level_( BlockFormat aFormat, std::vector<std::uint8_t> const& aPixels, std::uint32_t aWidth, std::uint32_t aHeight )
+	{
+		std::vector<std::uint8_t> ret( compressed_size( aFormat, aWidth, aHeight ) );
+		parallel_ranges( (aHeight + 3) / 4, default_thread_count(), [&] ( std::size_t aBegin, std::size_t aEnd, std::size_t ) {
+			auto const y0 = static_cast<std::uint32_t>( aBegin * 4 );
+			auto const y1 = std::min( aHeight, static_cast<std::uint32_t>( aEnd * 4 ) );
+			encode_blocks( aFormat,
+				std::span( aPixels ).subspan( std::size_t(y0) * aWidth * 4, std::size_t(y1 - y0) * aWidth * 4 ), aWidth, y1 - y0,
+				std::span( ret ).subspan( compressed_size( aFormat, aWidth, y0 ), compressed_size( aFormat, aWidth, y1 - y0 ) )
+			);
+		} );
+		return ret;
+	}
+
+	bool write_texture_( std::ostream& aOut, std::filesystem::path const& aSource, PackTextureFormat aFormat )
+	{
+		// As load_texture_2d() in main/main.cpp.
+		auto const image = decode_image_rgba8( aSource, true );
+		auto levels = build_srgba8_mips( image.pixels, image.width, image.height );
+
+		if( PackTextureFormat::Srgb8Alpha8 != aFormat )
+		{
+			auto const blockFormat = PackTextureFormat::Bc1Srgb == aFormat ? BlockFormat::Bc1 : BlockFormat::Bc7;
+			auto const encodeStart = Clock::now();
+
+			std::size_t texels = 0;
+			std::uint32_t levelWidth = image.width, levelHeight = image.height;
+			for( auto& level : levels )
+			{
+				level = encode_level_( blockFormat, level, levelWidth, levelHeight );
+				texels += std::size_t(levelWidth) * levelHeight;
+				levelWidth = std::max<std::uint32_t>( 1, levelWidth / 2 );
+				levelHeight = std::max<std::uint32_t>( 1, levelHeight / 2 );
+			}
+
+			double const seconds = std::chrono::duration<double>( Clock::now() - encodeStart ).count();
+			std::print( "  {} encoding: {} levels, {:.1f} ms, {:.1f} Mtexels/s on {} threads\n", BlockFormat::Bc1 == blockFormat ? "BC1" : "BC7",
+				levels.size(), seconds * 1000.0, double(texels) / seconds * 1e-6, default_thread_count()
+			);
+		}
+
+		return write_pack_texture( aOut, image.width, image.height, aFormat, levels );
+	}
+
+	bool write_font_( std::ostream& aOut, std::filesystem::path const& aSource )
+	{
+		static_assert( sizeof( PackGlyph ) == sizeof( stbtt_bakedchar ) );
+
+		// As create_bitmap_font() in main/main.cpp: ASCII 32..127.
+		constexpr int kFirstChar = 32, kCharCount = 96;
+
+		MappedFile const ttf( aSource );
+		std::vector<std::byte> atlas( kUiFontAtlasSize * kUiFontAtlasSize );
+		std::vector<stbtt_bakedchar> baked( kCharCount );
+
+		int const res = stbtt_BakeFontBitmap( reinterpret_cast<unsigned char const*>( ttf.bytes().data() ), 0, kUiFontPixelHeight,
+			reinterpret_cast<unsigned char*>( atlas.data() ), int(kUiFontAtlasSize), int(kUiFontAtlasSize), kFirstChar, kCharCount, baked.data()
+		);
+		if( res <= 0 )
+			throw Error( "stbtt_BakeFontBitmap failed for '{}'", aSource.string() );
+
+		return write_pack_font( aOut, PackFont{
+			kUiFontPixelHeight, kUiFontAtlasSize, kUiFontAtlasSize, kFirstChar,
+			std::span( reinterpret_cast<PackGlyph const*>( baked.data() ), baked.size() ),
+			atlas
+		} );
+	}
+
+	bool write_shader_( std::ostream& aOut, std::filesystem::path const& aSource )
+	{
+		MappedFile const text( aSource );
+		aOut.write( reinterpret_cast<char const*>( text.bytes().data() ), static_cast<std::streamsize>( text.bytes().size() ) );
+		return bool(aOut);
+	}
+
+	bool has_extension_( std::filesystem::path const& aPath, std::initializer_list<std::string_view> aExtensions )
+	{
+		auto ext = aPath.extension().string();
+		std::transform( ext.begin(), ext.end(), ext.begin(), [] ( unsigned char c ) { return char(std::tolower( c )); } );
+		return std::find( aExtensions.begin(), aExtensions.end(), ext ) != aExtensions.end();
+	}
+
+	std::optional<PackTextureFormat> parse_texture_format_( std::string_view aName ) noexcept
+	{
+		if( "bc7" == aName )
+			return PackTextureFormat::Bc7Srgb;
+		if( "bc1" == aName )
+			return PackTextureFormat::Bc1Srgb;
+		if( "rgba8" == aName )
+			return PackTextureFormat::Srgb8Alpha8;
+		return std::nullopt;
+	}
+
+	char const* kind_name_( AssetKind aKind ) noexcept
+	{
+		switch( aKind )
+		{
+			case AssetKind::Mesh: return "mesh";
+			case AssetKind::Texture: return "texture";
+			case AssetKind::Font: return "font";
+			case AssetKind::Shader: return "shader";
+		}
+		return "?";
+	}
+}
+
+int main( int aArgc, char* aArgv[] ) try
+{
+	constexpr std::string_view kTexturesOption = "--textures=";
+
+	std::vector<std::string_view> args( aArgv + std::min( aArgc, 1 ), aArgv + aArgc );
+
+	std::optional<PackTextureFormat> textureFormat = PackTextureFormat::Bc7Srgb;
+	if( !args.empty() && args.front().starts_with( kTexturesOption ) )
+	{
+		textureFormat = parse_texture_format_( args.front().substr( kTexturesOption.size() ) );
+		args.erase( args.begin() );
+	}
+
+	auto root = std::filesystem::path( args.size() > 0 ? args[0] : "assets/cw2" ).lexically_normal();
+	if( !root.has_filename() )
+		root = root.parent_path();
+
+	std::filesystem::path const packPath = args.size() > 1 ? std::filesystem::path( args[1] ) : std::filesystem::path( root ).concat( ".pack" );
+
+	if( !textureFormat || args.size() > 2 || !std::filesystem::is_directory( root ) )
+	{
+		std::print( stderr, "Usage: {} [--textures=bc7|bc1|rgba8] [<asset directory> [<pack>]]\n", aArgc > 0 ? aArgv[0] : "assetc" );
+		return 2;
+	}
+
+	// Sorted, so that the pack does not depend on the directory order.
+	std::vector<std::filesystem::path> sources;
+	for( auto const& entry : std::filesystem::recursive_directory_iterator( root ) )
+	{
+		if( entry.is_regular_file() )
+			sources.emplace_back( entry.path() );
+	}
+	std::sort( sources.begin(), sources.end() );
+
+	auto const start = Clock::now();
+	AssetPackWriter writer( packPath, root );
+
+	for( auto const& source : sources )
+	{
+		auto const entryStart = Clock::now();
+
+		bool written = false;
+		AssetKind kind{};
+		if( has_extension_( source, { ".obj" } ) )
+		{
+			auto const name = source.filename().string();
+			auto const recipe = std::find_if( std::begin( kMeshes_ ), std::end( kMeshes_ ), [&] ( MeshRecipe_ const& r ) { return r.name == name; } );
+			if( std::end( kMeshes_ ) == recipe )
+			{
+				std::print( "Skipping '{}': not a mesh that the application loads\n", source.string() );
+				continue;
+			}
+
+			kind = AssetKind::Mesh;
+			written = recipe->write( writer.begin_entry( source, kind ), source, recipe->layout );
+		}
+		else if( has_extension_( source, { ".jpg", ".jpeg", ".png" } ) )
+		{
+			kind = AssetKind::Texture;
+			written = write_texture_( writer.begin_entry( source, kind ), source, *textureFormat );
+		}
+		else if( has_extension_( source, { ".ttf" } ) )
+		{
+			kind = AssetKind::Font;
+			written = write_font_( writer.begin_entry( source, kind ), source );
+		}
+		else if( has_extension_( source, { ".vert", ".frag", ".geom", ".tesc", ".tese", ".comp" } ) )
+		{
+			kind = AssetKind::Shader;
+			written = write_shader_( writer.begin_entry( source, kind ), source );
+		}
+		else
+		{
+			continue;
+		}
+
+		if( !written )
+			throw Error( "Unable to write '{}' to '{}'", source.string(), packPath.string() );
+
+		std::print( "Packed {} '{}' in {:.1f} ms\n", kind_name_( kind ), source.string(),
+			std::chrono::duration<double, std::milli>( Clock::now() - entryStart ).count()
+		);
+
+		// As the application reports cold loads (see report_mesh_load_() in
+		// main/main.cpp).
+		if( AssetKind::Mesh == kind )
+		{
+			double const kMiB = 1024.0 * 1024.0;
+			double const peakMiB = double(peak_resident_bytes()) / kMiB;
+			double const objMiB = double(std::filesystem::file_size( source )) / kMiB;
+			std::print( "  Peak RSS so far {:.1f} MiB, {:.2f}x the OBJ ({:.1f} MiB)\n", peakMiB, peakMiB / objMiB, objMiB );
+		}
+	}
+
+	writer.finish();
+
+	std::print( "Wrote '{}': {} entries, {:.2f} MiB, in {:.2f} s\n", packPath.string(), writer.entry_count(),
+		double(std::filesystem::file_size( packPath )) / (1024.0 * 1024.0),
+		std::chrono::duration<double>( Clock::now() - start ).count()
+	);
+
+	return 0;
+}
+catch( std::exception const& eErr )
+{
+	std::print( stderr, "Top-level Exception ({}):\n", typeid(eErr).name() );
+	std::print( stderr, "{}\n", eErr.what() );
+	std::print( stderr, "Bye.\n" );
+	return 1;
+}
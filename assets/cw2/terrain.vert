@@ -8,17 +8,35 @@ uniform mat4 uModel;
 uniform mat4 uView;
 uniform mat4 uProj;
 
+// Vertex dequantization (see upload_dequantization() in main.cpp). For the
+// packed format, positions are unorm16 relative to the mesh bounds and
+// normals are octahedral-encoded in aNormal.xy.
+uniform vec3 uPositionScale;
+uniform vec3 uPositionOffset;
+uniform bool uOctNormals;
+
 out vec3 vNormal;
 out vec3 vWorldPos;
 out vec2 vTexCoord;
 
+vec3 decode_octahedral( vec2 p )
+{
+	vec3 n = vec3( p, 1.0 - abs( p.x ) - abs( p.y ) );
+	float t = max( -n.z, 0.0 );
+	n.xy += mix( vec2( t ), vec2( -t ), greaterThanEqual( n.xy, vec2( 0.0 ) ) );
+	return normalize( n );
+}
+
 void main()
 {
-	vec4 worldPos = uModel * vec4( aPosition, 1.0 );
+	vec3 position = aPosition * uPositionScale + uPositionOffset;
+	vec3 normal = uOctNormals ? decode_octahedral( aNormal.xy ) : aNormal;
+
+	vec4 worldPos = uModel * vec4( position, 1.0 );
 	vWorldPos = worldPos.xyz;
 
 	mat3 normalMatrix = mat3( transpose( inverse( uModel ) ) );
-	vNormal = normalize( normalMatrix * aNormal );
+	vNormal = normalize( normalMatrix * normal );
 	vTexCoord = aTexCoord;
 
 	gl_Position = uProj * uView * worldPos;
@@ -0,0 +1,334 @@
+#include "asset_pack.hpp"
+
+#include <algorithm>
+#include <system_error>
+
+#include <cassert>
+#include <cstring>
+
+#include "../support/error.hpp"
+#include "../support/file_hash.hpp"
+
+#include "../vmlib/block_compression.hpp"
+
+namespace
+{
+	constexpr char kMagic_[8] = { 'V', 'M', 'A', 'S', 'S', 'E', 'T', 'S' };
+	constexpr std::uint32_t kVersion_ = 1;
+	constexpr std::size_t kAlignment_ = 64;
+
+	struct Header_
+	{
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t entryCount;
+		std::uint64_t tableOffset;
+		std::byte reserved[8];
+	};
+
+	struct Entry_
+	{
+		char name[64]; // zero-terminated
+		std::uint32_t kind;
+		std::uint32_t reserved;
+		std::uint64_t offset;
+		std::uint64_t size;
+		std::uint64_t sourceSize;
+		std::int64_t sourceTime;
+		std::uint64_t sourceHash;
+	};
+
+	static_assert( sizeof(Header_) == 32 );
+	static_assert( sizeof(Entry_) == 112 );
+
+	struct TextureHeader_
+	{
+		std::uint32_t width;
+		std::uint32_t height;
+		std::uint32_t format;
+		std::uint32_t levelCount;
+	};
+
+	struct FontHeader_
+	{
+		float pixelHeight;
+		std::uint32_t atlasWidth;
+		std::uint32_t atlasHeight;
+		std::uint32_t firstChar;
+		std::uint32_t glyphCount;
+	};
+
+	static_assert( sizeof(PackGlyph) == 20 );
+
+	std::string entry_name_( std::filesystem::path const& aSource, std::filesystem::path const& aRoot )
+	{
+		auto const relative = aSource.lexically_normal().lexically_relative( aRoot );
+		if( relative.empty() || *relative.begin() == ".." )
+			return {};
+		return relative.generic_string();
+	}
+
+	template< class tValue >
+	void write_value_( std::ostream& aOut, tValue const& aValue )
+	{
+		aOut.write( reinterpret_cast<char const*>( &aValue ), sizeof(aValue) );
+	}
+}
+
+struct AssetPackWriter::Record_
+{
+	Entry_ entry;
+};
+
+AssetPack::AssetPack( std::filesystem::path const& aPackPath, std::filesystem::path const& aRoot )
+	: mFile( aPackPath )
+	, mRoot( aRoot.lexically_normal() )
+{
+	auto const bytes = mFile.bytes();
+	if( bytes.size() < sizeof(Header_) )
+		throw Error( "'{}' is not an asset pack", aPackPath.string() );
+
+	Header_ header;
+	std::memcpy( &header, bytes.data(), sizeof(Header_) );
+	if( 0 != std::memcmp( header.magic, kMagic_, sizeof(kMagic_) ) )
+		throw Error( "'{}' is not an asset pack", aPackPath.string() );
+	if( kVersion_ != header.version )
+		throw Error( "Asset pack '{}' has version {}, expected {}; rebuild it with assetc", aPackPath.string(), header.version, kVersion_ );
+
+	std::size_t const tableBytes = std::size_t(header.entryCount) * sizeof(Entry_);
+	if( header.tableOffset > bytes.size() || bytes.size() - header.tableOffset != tableBytes )
+		throw Error( "Asset pack '{}' is truncated", aPackPath.string() );
+
+	mTable = bytes.subspan( header.tableOffset, tableBytes );
+	mEntryCount = header.entryCount;
+}
+
+std::span<std::byte const> AssetPack::find( std::filesystem::path const& aSource, AssetKind aKind ) const
+{
+	if( 0 == mEntryCount )
+		return {};
+
+	auto const name = entry_name_( aSource, mRoot );
+	if( name.empty() )
+		return {};
+
+	for( std::size_t i = 0; i < mEntryCount; ++i )
+	{
+		Entry_ entry;
+		std::memcpy( &entry, mTable.data() + i * sizeof(Entry_), sizeof(Entry_) );
+		if( std::uint32_t(aKind) != entry.kind || name != entry.name )
+			continue;
+
+		auto const bytes = mFile.bytes();
+		if( entry.offset > bytes.size() || bytes.size() - entry.offset < entry.size )
+			return {};
+
+		// Without a source, the entry is all there is.
+		if( auto const stamp = file_stamp( aSource ) )
+		{
+			if( stamp->size != entry.sourceSize )
+				return {};
+			if( stamp->time != entry.sourceTime && hash_file( aSource ) != entry.sourceHash )
+				return {};
+		}
+
+		return bytes.subspan( entry.offset, entry.size );
+	}
+
+	return {};
+}
+
+bool AssetPack::empty() const noexcept
+{
+	return 0 == mEntryCount;
+}
+std::size_t AssetPack::entry_count() const noexcept
+{
+	return mEntryCount;
+}
+std::size_t AssetPack::size_bytes() const noexcept
+{
+	return mFile.bytes().size();
+}
+
+AssetPackWriter::AssetPackWriter( std::filesystem::path const& aPackPath, std::filesystem::path const& aRoot )
+	: mPackPath( aPackPath )
+	, mTempPath( aPackPath )
+	, mRoot( aRoot.lexically_normal() )
+{
+	mTempPath += ".tmp";
+
+	mOut.open( mTempPath, std::ios::binary | std::ios::trunc );
+	if( !mOut )
+		throw Error( "Unable to create '{}'", mTempPath.string() );
+
+	// Rewritten by finish().
+	Header_ const header{};
+	write_value_( mOut, header );
+}
+
+AssetPackWriter::~AssetPackWriter()
+{
+	if( !mFinished )
+	{
+		mOut.close();
+
+		std::error_code ec;
+		std::filesystem::remove( mTempPath, ec );
+	}
+}
+
+std::ostream& AssetPackWriter::begin_entry( std::filesystem::path const& aSource, AssetKind aKind )
+{
+	assert( !mFinished );
+	end_entry_();
+
+	auto const name = entry_name_( aSource, mRoot );
+	if( name.empty() || name.size() >= sizeof(Entry_::name) )
+		throw Error( "Cannot add '{}' to the pack: not under '{}', or its name is too long", aSource.string(), mRoot.string() );
+
+	auto const stamp = file_stamp( aSource );
+	if( !stamp )
+		throw Error( "Unable to read '{}'", aSource.string() );
+
+	// Align the entry's data.
+	auto const position = static_cast<std::uint64_t>( mOut.tellp() );
+	auto const padding = (kAlignment_ - position % kAlignment_) % kAlignment_;
+	char const zeros[kAlignment_] = {};
+	mOut.write( zeros, static_cast<std::streamsize>( padding ) );
+
+	Record_ record{};
+	std::memcpy( record.entry.name, name.data(), name.size() );
+	record.entry.kind = std::uint32_t(aKind);
+	record.entry.offset = position + padding;
+	record.entry.sourceSize = stamp->size;
+	record.entry.sourceTime = stamp->time;
+	record.entry.sourceHash = hash_file( aSource );
+	mRecords.emplace_back( record );
+
+	return mOut;
+}
+
+void AssetPackWriter::finish()
+{
+	assert( !mFinished );
+	end_entry_();
+
+	Header_ header{};
+	std::memcpy( header.magic, kMagic_, sizeof(kMagic_) );
+	header.version = kVersion_;
+	header.entryCount = static_cast<std::uint32_t>( mRecords.size() );
+	header.tableOffset = static_cast<std::uint64_t>( mOut.tellp() );
+
+	for( auto const& record : mRecords )
+		write_value_( mOut, record.entry );
+
+	mOut.seekp( 0 );
+	write_value_( mOut, header );
+	mOut.close();
+
+	if( !mOut )
+		throw Error( "Unable to write '{}'", mTempPath.string() );
+
+	std::filesystem::rename( mTempPath, mPackPath );
+	mFinished = true;
+}
+
+std::size_t AssetPackWriter::entry_count() const noexcept
+{
+	return mRecords.size();
+}
+
+void AssetPackWriter::end_entry_()
+{
+	if( !mOut )
+		throw Error( "Unable to write '{}'", mTempPath.string() );
+
+	if( !mRecords.empty() && 0 == mRecords.back().entry.size )
+		mRecords.back().entry.size = static_cast<std::uint64_t>( mOut.tellp() ) - mRecords.back().entry.offset;
+}
+
+std::size_t pack_texture_level_size( PackTextureFormat aFormat, std::uint32_t aWidth, std::uint32_t aHeight ) noexcept
+{
+	switch( aFormat )
+	{
+		case PackTextureFormat::Srgb8Alpha8: return std::size_t(aWidth) * aHeight * 4;
+		case PackTextureFormat::Bc1Srgb: return compressed_size( BlockFormat::Bc1, aWidth, aHeight );
+		case PackTextureFormat::Bc7Srgb: return compressed_size( BlockFormat::Bc7, aWidth, aHeight );
+	}
+	return 0;
+}
+
+bool write_pack_texture( std::ostream& aOut, std::uint32_t aWidth, std::uint32_t aHeight, PackTextureFormat aFormat, std::span<std::vector<std::uint8_t> const> aLevels )
+{
+	TextureHeader_ const header{ aWidth, aHeight, std::uint32_t(aFormat), static_cast<std::uint32_t>( aLevels.size() ) };
+	write_value_( aOut, header );
+	for( auto const& level : aLevels )
+		aOut.write( reinterpret_cast<char const*>( level.data() ), static_cast<std::streamsize>( level.size() ) );
+	return bool(aOut);
+}
+
+std::optional<PackTexture> parse_pack_texture( std::span<std::byte const> aBytes ) noexcept
+{
+	if( aBytes.size() < sizeof(TextureHeader_) )
+		return std::nullopt;
+
+	TextureHeader_ header;
+	std::memcpy( &header, aBytes.data(), sizeof(header) );
+	if( 0 == pack_texture_level_size( PackTextureFormat(header.format), 1, 1 ) || 0 == header.width || 0 == header.height )
+		return std::nullopt;
+
+	PackTexture ret{ header.width, header.height, PackTextureFormat(header.format), {} };
+
+	std::size_t offset = sizeof(TextureHeader_);
+	std::uint32_t width = header.width, height = header.height;
+	for( std::uint32_t level = 0; level < header.levelCount; ++level )
+	{
+		std::size_t const size = pack_texture_level_size( ret.format, width, height );
+		if( aBytes.size() - offset < size )
+			return std::nullopt;
+
+		ret.levels.emplace_back( aBytes.subspan( offset, size ) );
+		offset += size;
+		width = std::max<std::uint32_t>( 1, width / 2 );
+		height = std::max<std::uint32_t>( 1, height / 2 );
+	}
+
+	if( ret.levels.empty() || offset != aBytes.size() )
+		return std::nullopt;
+
+	return ret;
+}
+
+bool write_pack_font( std::ostream& aOut, PackFont const& aFont )
+{
+	assert( aFont.atlas.size() == std::size_t(aFont.atlasWidth) * aFont.atlasHeight );
+
+	FontHeader_ const header{ aFont.pixelHeight, aFont.atlasWidth, aFont.atlasHeight, aFont.firstChar, static_cast<std::uint32_t>( aFont.glyphs.size() ) };
+	write_value_( aOut, header );
+	aOut.write( reinterpret_cast<char const*>( aFont.glyphs.data() ), static_cast<std::streamsize>( aFont.glyphs.size_bytes() ) );
+	aOut.write( reinterpret_cast<char const*>( aFont.atlas.data() ), static_cast<std::streamsize>( aFont.atlas.size() ) );
+	return bool(aOut);
+}
+
+std::optional<PackFont> parse_pack_font( std::span<std::byte const> aBytes ) noexcept
+{
+	if( aBytes.size() < sizeof(FontHeader_) )
+		return std::nullopt;
+
+	FontHeader_ header;
+	std::memcpy( &header, aBytes.data(), sizeof(header) );
+
+	std::size_t const glyphBytes = std::size_t(header.glyphCount) * sizeof(PackGlyph);
+	std::size_t const atlasBytes = std::size_t(header.atlasWidth) * header.atlasHeight;
+	if( aBytes.size() - sizeof(FontHeader_) != glyphBytes + atlasBytes )
+		return std::nullopt;
+
+	// The glyphs follow the 20-byte header, so they are 4-byte aligned.
+	auto const data = aBytes.subspan( sizeof(FontHeader_) );
+	return PackFont{
+		header.pixelHeight, header.atlasWidth, header.atlasHeight, header.firstChar,
+		std::span( reinterpret_cast<PackGlyph const*>( data.data() ), header.glyphCount ),
+		data.subspan( glyphBytes, atlasBytes )
+	};
+}
@@ -0,0 +1,171 @@
+#ifndef ASSET_PACK_HPP_A5E07C3B_19D4_4B82_8F6E_2C94B7D1053F
+#define ASSET_PACK_HPP_A5E07C3B_19D4_4B82_8F6E_2C94B7D1053F
+
+#include <span>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <optional>
+#include <filesystem>
+
+#include "../support/mapped_file.hpp"
+
+/* Asset pack: the application's assets, preprocessed into one mapped file
+ *
+ * The asset compiler (assetc) converts the files under an asset directory
+ * into the form that the application uploads to OpenGL:
+ *  - meshes: the vertex and index buffers, chunks, LODs and meshlets, as
+ *    stored by write_mesh_data() (see mesh_cache.hpp and mesh_build.hpp);
+ *  - textures: all mip levels, optionally block-compressed (see
+ *    PackTexture);
+ *  - fonts: the baked glyph atlas (see PackFont);
+ *  - shaders: the GLSL source.
+ *
+ * At startup the application maps the pack and creates its GL objects
+ * directly from the mapped data. Parsing OBJs, decoding images, generating
+ * mipmaps and baking fonts then all happen offline.
+ *
+ * Layout: a fixed-size header, the entries' data (each 64-byte aligned),
+ * and the entry table at the end. Entries are named by their source's path
+ * relative to the asset directory, with '/' separators (e.g.
+ * "parlahti.obj"), and record the source's size, modification time and hash
+ * (see support/file_hash.hpp). AssetPack::find() compares these against the
+ * source, when it exists, and ignores stale entries, so that edited assets
+ * are picked up (from their source files) before the pack is rebuilt. If the
+ * source does not exist, the entry is used as it is, so the pack can also be
+ * shipped without the sources.
+ *
+ * Like the mesh cache, packs are not portable between machines with
+ * different endianness or struct layout.
+ */
+enum class AssetKind : std::uint32_t
+{
+	Mesh = 1,
+	Texture = 2,
+	Font = 3,
+	Shader = 4
+};
+
+// Font size that the application bakes its UI font at. assetc bakes the
+// font at this size; other sizes are baked at runtime.
+constexpr float kUiFontPixelHeight = 32.f;
+constexpr std::uint32_t kUiFontAtlasSize = 512;
+
+class AssetPack final
+{
+	public:
+		AssetPack() noexcept = default;
+
+		// Maps the pack at aPackPath, whose entries are named relative to
+		// aRoot. Throws Error if the pack cannot be read or is not a pack of
+		// this version.
+		AssetPack( std::filesystem::path const& aPackPath, std::filesystem::path const& aRoot );
+
+	public:
+		// The data of the entry for aSource, or an empty span if there is
+		// none, or if it is stale (see above). The data is at least 64-byte
+		// aligned and stays valid for the lifetime of the pack.
+		//
+		// If the source's modification time differs from the entry's, the
+		// source is hashed to tell whether it changed. The entry's time is
+		// not updated when the hash matches (the pack stays mapped, and its
+		// data is in use, possibly by other threads), so a touched but
+		// unchanged source is hashed on every start, until assetc rebuilds
+		// the pack. For parlahti.obj, that is a read of the whole file.
+		std::span<std::byte const> find( std::filesystem::path const& aSource, AssetKind ) const;
+
+		bool empty() const noexcept;
+		std::size_t entry_count() const noexcept;
+		std::size_t size_bytes() const noexcept;
+
+	private:
+		MappedFile mFile;
+		std::filesystem::path mRoot;
+		std::span<std::byte const> mTable;
+		std::size_t mEntryCount = 0;
+};
+
+// Writes a pack. Entries are added with begin_entry() and written to the
+// returned stream. finish() writes the entry table; the pack is written
+// under a temporary name and only renamed to its final name there, so an
+// interrupted run never leaves a truncated pack behind. Throws Error on
+// failure.
+class AssetPackWriter final
+{
+	public:
+		AssetPackWriter( std::filesystem::path const& aPackPath, std::filesystem::path const& aRoot );
+		~AssetPackWriter();
+
+		AssetPackWriter( AssetPackWriter const& ) = delete;
+		AssetPackWriter& operator= (AssetPackWriter const&) = delete;
+
+	public:
+		// Starts the entry for aSource (a file under the root), ending the
+		// previous one.
+		std::ostream& begin_entry( std::filesystem::path const& aSource, AssetKind );
+
+		void finish();
+
+		std::size_t entry_count() const noexcept;
+
+	private:
+		void end_entry_();
+
+	private:
+		struct Record_;
+
+		std::filesystem::path mPackPath;
+		std::filesystem::path mTempPath;
+		std::filesystem::path mRoot;
+		std::ofstream mOut;
+		std::vector<Record_> mRecords;
+		bool mFinished = false;
+};
+
+// Texture entries: a PackTexture header followed by the levels, largest
+// first, each tightly packed (see pack_texture_level_size()).
+enum class PackTextureFormat : std::uint32_t
+{
+	Srgb8Alpha8 = 1, // four bytes per texel, sRGB colour, linear alpha
+	Bc1Srgb = 2,     // BC1 blocks (vmlib/block_compression.hpp), opaque sRGB colour
+	Bc7Srgb = 3      // BC7 blocks, sRGB colour, linear alpha
+};
+
+// Size in bytes of a aWidth x aHeight level, or zero for unknown formats.
+std::size_t pack_texture_level_size( PackTextureFormat, std::uint32_t aWidth, std::uint32_t aHeight ) noexcept;
+
+struct PackTexture
+{
+	std::uint32_t width;
+	std::uint32_t height;
+	PackTextureFormat format;
+	std::vector<std::span<std::byte const>> levels;
+};
+
+bool write_pack_texture( std::ostream&, std::uint32_t aWidth, std::uint32_t aHeight, PackTextureFormat, std::span<std::vector<std::uint8_t> const> aLevels );
+std::optional<PackTexture> parse_pack_texture( std::span<std::byte const> ) noexcept;
+
+// Font entries: the baked characters (firstChar onwards) and the 8-bit
+// atlas. A PackGlyph has the layout of stbtt_bakedchar.
+struct PackGlyph
+{
+	std::uint16_t x0, y0, x1, y1;
+	float xoff, yoff, xadvance;
+};
+
+struct PackFont
+{
+	float pixelHeight;
+	std::uint32_t atlasWidth;
+	std::uint32_t atlasHeight;
+	std::uint32_t firstChar;
+	std::span<PackGlyph const> glyphs;
+	std::span<std::byte const> atlas;
+};
+
+bool write_pack_font( std::ostream&, PackFont const& );
+std::optional<PackFont> parse_pack_font( std::span<std::byte const> ) noexcept;
+
+#endif // ASSET_PACK_HPP_A5E07C3B_19D4_4B82_8F6E_2C94B7D1053F
@@ -0,0 +1,59 @@
+#include "gpu_cache.hpp"
+
+#include <utility>
+
+GpuTexture::GpuTexture( GLuint aId ) noexcept
+	: id( aId )
+{}
+GpuTexture::~GpuTexture()
+{
+	glDeleteTextures( 1, &id );
+}
+
+GpuBuffer::GpuBuffer( GLuint aId ) noexcept
+	: id( aId )
+{}
+GpuBuffer::~GpuBuffer()
+{
+	glDeleteBuffers( 1, &id );
+}
+
+GpuVertexArray::GpuVertexArray( GLuint aId, std::vector<std::shared_ptr<GpuBuffer const>> aBuffers ) noexcept
+	: id( aId )
+	, buffers( std::move(aBuffers) )
+{}
+GpuVertexArray::~GpuVertexArray()
+{
+	glDeleteVertexArrays( 1, &id );
+}
+
+
+std::shared_ptr<ShaderProgram> GpuCache::program( std::vector<ShaderProgram::ShaderSource> aSources )
+{
+	// E.g. "35633:assets/cw2/ui.vert;35632:assets/cw2/ui.frag".
+	std::string key;
+	for( auto const& source : aSources )
+	{
+		if( !key.empty() )
+			key += ';';
+		key += std::to_string( source.type ) + ':' + source.sourcePath;
+	}
+
+	return acquire_<ShaderProgram>( key, [&] { return std::make_shared<ShaderProgram>( std::move(aSources) ); } );
+}
+
+GpuCacheStats GpuCache::stats() const noexcept
+{
+	GpuCacheStats ret{ mHits, mMisses, 0, 0 };
+	std::apply( [&] ( auto const&... aObjects ) {
+		auto const count = [&] ( auto const& aMap ) {
+			for( auto const& [key, object] : aMap )
+			{
+				++ret.objects;
+				ret.inUse += object.use_count() > 1;
+			}
+		};
+		(count( aObjects ), ...);
+	}, mObjects );
+	return ret;
+}
@@ -0,0 +1,175 @@
+#ifndef GPU_CACHE_HPP_E1B84C2D_7A39_4F56_9D0E_3C58A2F71B96
+#define GPU_CACHE_HPP_E1B84C2D_7A39_4F56_9D0E_3C58A2F71B96
+
+#include <glad/glad.h>
+
+#include <tuple>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "../support/program.hpp"
+
+/* GL objects that delete themselves
+ *
+ * A GpuVertexArray keeps the buffers that its attributes read from, so that
+ * they live at least as long as it does.
+ */
+struct GpuTexture final
+{
+	explicit GpuTexture( GLuint ) noexcept;
+	~GpuTexture();
+
+	GpuTexture( GpuTexture const& ) = delete;
+	GpuTexture& operator= (GpuTexture const&) = delete;
+
+	GLuint id;
+};
+
+struct GpuBuffer final
+{
+	explicit GpuBuffer( GLuint ) noexcept;
+	~GpuBuffer();
+
+	GpuBuffer( GpuBuffer const& ) = delete;
+	GpuBuffer& operator= (GpuBuffer const&) = delete;
+
+	GLuint id;
+};
+
+struct GpuVertexArray final
+{
+	GpuVertexArray( GLuint, std::vector<std::shared_ptr<GpuBuffer const>> ) noexcept;
+	~GpuVertexArray();
+
+	GpuVertexArray( GpuVertexArray const& ) = delete;
+	GpuVertexArray& operator= (GpuVertexArray const&) = delete;
+
+	GLuint id;
+	std::vector<std::shared_ptr<GpuBuffer const>> buffers;
+};
+
+
+/* GpuCache: shared textures, buffers, vertex arrays and shader programs
+ *
+ * Resources are named by the path that they are loaded from (e.g.
+ * "assets/cw2/L4343A-4k.jpeg"), or for generated resources by a generator
+ * ID (e.g. "gen:particle-texture"). Asking for a name that the cache has
+ * (a hit) returns the existing object; otherwise (a miss) the given function
+ * creates it, and the cache keeps it.
+ *
+ * Handles are shared_ptrs, so objects are reference counted: their users
+ * hold them, and the cache holds one more reference. Objects without users
+ * stay cached as long as the cache lives, so that releasing a resource
+ * and asking for it again (as the particle system does when it is reset)
+ * costs a lookup instead of a reload. Handles may outlive the cache; their
+ * objects are deleted with the last of them.
+ *
+ * The GL context must be current whenever an object is created or deleted.
+ */
+struct GpuCacheStats
+{
+	std::uint64_t hits;
+	std::uint64_t misses;
+	std::size_t objects; // cached
+	std::size_t inUse;   // cached and held by a user
+};
+
+class GpuCache final
+{
+	public:
+		GpuCache() = default;
+
+		GpuCache( GpuCache const& ) = delete;
+		GpuCache& operator= (GpuCache const&) = delete;
+
+	public:
+		// aCreate() returns the new object's name.
+		template< class tCreate >
+		std::shared_ptr<GpuTexture const> texture( std::string const& aKey, tCreate&& aCreate );
+		template< class tCreate >
+		std::shared_ptr<GpuBuffer const> buffer( std::string const& aKey, tCreate&& aCreate );
+
+		// aCreate() returns the new vertex array's name. aBuffers are the
+		// buffers that its attributes read from.
+		template< class tCreate >
+		std::shared_ptr<GpuVertexArray const> vertex_array( std::string const& aKey, std::vector<std::shared_ptr<GpuBuffer const>> aBuffers, tCreate&& aCreate );
+
+		// Programs are named by their shaders' types and paths.
+		std::shared_ptr<ShaderProgram> program( std::vector<ShaderProgram::ShaderSource> );
+
+		GpuCacheStats stats() const noexcept;
+
+	private:
+		template< class tResource >
+		using Map_ = std::unordered_map<std::string, std::shared_ptr<tResource>>;
+
+		template< class tResource, class tMake >
+		std::shared_ptr<tResource> acquire_( std::string const& aKey, tMake&& aMake );
+
+	private:
+		std::tuple<
+			Map_<GpuTexture const>,
+			Map_<GpuBuffer const>,
+			Map_<GpuVertexArray const>,
+			Map_<ShaderProgram>
+		> mObjects;
+
+		std::uint64_t mHits = 0;
+		std::uint64_t mMisses = 0;
+};
+
+/* The owning handle is allocated (with the name 0, which GL ignores when
+ * deleting) before aCreate() makes the object, so that nothing can throw
+ * between the object's creation and its handle taking it over.
+ */
+template< class tCreate > inline
+std::shared_ptr<GpuTexture const> GpuCache::texture( std::string const& aKey, tCreate&& aCreate )
+{
+	return acquire_<GpuTexture const>( aKey, [&] {
+		auto ret = std::make_shared<GpuTexture>( 0 );
+		ret->id = aCreate();
+		return ret;
+	} );
+}
+
+template< class tCreate > inline
+std::shared_ptr<GpuBuffer const> GpuCache::buffer( std::string const& aKey, tCreate&& aCreate )
+{
+	return acquire_<GpuBuffer const>( aKey, [&] {
+		auto ret = std::make_shared<GpuBuffer>( 0 );
+		ret->id = aCreate();
+		return ret;
+	} );
+}
+
+template< class tCreate > inline
+std::shared_ptr<GpuVertexArray const> GpuCache::vertex_array( std::string const& aKey, std::vector<std::shared_ptr<GpuBuffer const>> aBuffers, tCreate&& aCreate )
+{
+	return acquire_<GpuVertexArray const>( aKey, [&] {
+		auto ret = std::make_shared<GpuVertexArray>( 0, std::move(aBuffers) );
+		ret->id = aCreate();
+		return ret;
+	} );
+}
+
+template< class tResource, class tMake > inline
+std::shared_ptr<tResource> GpuCache::acquire_( std::string const& aKey, tMake&& aMake )
+{
+	auto& objects = std::get<Map_<tResource>>( mObjects );
+	if( auto const it = objects.find( aKey ); objects.end() != it )
+	{
+		++mHits;
+		return it->second;
+	}
+
+	++mMisses;
+	std::shared_ptr<tResource> ret = aMake();
+	objects.emplace( aKey, ret ); // if this throws, ret deletes the object
+	return ret;
+}
+
+#endif // GPU_CACHE_HPP_E1B84C2D_7A39_4F56_9D0E_3C58A2F71B96
@@ -0,0 +1,100 @@
+#include "image_decode.hpp"
+
+#include <span>
+#include <memory>
+#include <algorithm>
+
+#include "../support/error.hpp"
+#include "../support/mapped_file.hpp"
+
+#include "../vmlib/jpeg_strips.hpp"
+
+#include "../third_party/stb/include/stb_image.h"
+
+namespace
+{
+	struct StbiDeleter_
+	{
+		void operator()( stbi_uc* aPixels ) const noexcept
+		{
+			stbi_image_free( aPixels );
+		}
+	};
+
+	using StbiPixels_ = std::unique_ptr<stbi_uc, StbiDeleter_>;
+
+	// Decodes aBytes to RGBA, unflipped, whatever the application set with
+	// stbi_set_flip_vertically_on_load().
+	StbiPixels_ decode_( std::span<std::uint8_t const> aBytes, int& aWidth, int& aHeight, std::filesystem::path const& aPath )
+	{
+		stbi_set_flip_vertically_on_load_thread( 0 );
+
+		int channels = 0;
+		StbiPixels_ ret( stbi_load_from_memory( aBytes.data(), static_cast<int>( aBytes.size() ), &aWidth, &aHeight, &channels, STBI_rgb_alpha ) );
+		if( !ret )
+		{
+			char const* reason = stbi_failure_reason();
+			throw Error( "Failed to load image '{}': {}", aPath.string(), reason ? reason : "unknown error" );
+		}
+		if( aWidth <= 0 || aHeight <= 0 )
+			throw Error( "Image '{}' reported invalid size {}x{}", aPath.string(), aWidth, aHeight );
+
+		return ret;
+	}
+
+	// Copies aCount rows from aSource to rows aFirstRow onwards of aImage.
+	void copy_rows_( DecodedImage& aImage, stbi_uc const* aSource, std::uint32_t aFirstRow, std::uint32_t aCount, bool aFlip ) noexcept
+	{
+		std::size_t const rowBytes = std::size_t(aImage.width) * 4;
+		for( std::uint32_t i = 0; i < aCount; ++i )
+		{
+			std::uint32_t const row = aFlip ? aImage.height - 1 - (aFirstRow + i) : aFirstRow + i;
+			std::copy_n( aSource + i * rowBytes, rowBytes, aImage.pixels.data() + row * rowBytes );
+		}
+	}
+}
+
+DecodedImage decode_image_rgba8( std::filesystem::path const& aPath, bool aFlipVertically, std::size_t aThreadCount )
+{
+	MappedFile const file( aPath );
+	std::span<std::uint8_t const> const bytes( reinterpret_cast<std::uint8_t const*>( file.bytes().data() ), file.bytes().size() );
+
+	auto const strips = aThreadCount > 1 ? split_jpeg( bytes, aThreadCount ) : std::vector<JpegStrip>{};
+
+	DecodedImage ret;
+	if( strips.empty() )
+	{
+		int width = 0, height = 0;
+		auto const pixels = decode_( bytes, width, height, aPath );
+
+		ret.width = std::uint32_t(width);
+		ret.height = std::uint32_t(height);
+		ret.pixels.resize( std::size_t(ret.width) * ret.height * 4 );
+		copy_rows_( ret, pixels.get(), 0, ret.height, aFlipVertically );
+		return ret;
+	}
+
+	int width = 0, height = 0, channels = 0;
+	if( !stbi_info_from_memory( bytes.data(), static_cast<int>( bytes.size() ), &width, &height, &channels ) || width <= 0 || height <= 0 )
+		throw Error( "Failed to load image '{}': invalid header", aPath.string() );
+
+	ret.width = std::uint32_t(width);
+	ret.height = std::uint32_t(height);
+	ret.pixels.resize( std::size_t(ret.width) * ret.height * 4 );
+
+	parallel_ranges( strips.size(), aThreadCount, [&] ( std::size_t aBegin, std::size_t aEnd, std::size_t ) {
+		for( std::size_t i = aBegin; i < aEnd; ++i )
+		{
+			auto const& strip = strips[i];
+
+			int stripWidth = 0, stripHeight = 0;
+			auto const pixels = decode_( strip.jpeg, stripWidth, stripHeight, aPath );
+			if( stripWidth != width || std::uint32_t(stripHeight) < strip.skipRows + strip.rowCount )
+				throw Error( "Failed to load image '{}': strip {} decoded to {}x{}", aPath.string(), i, stripWidth, stripHeight );
+
+			copy_rows_( ret, pixels.get() + std::size_t(strip.skipRows) * ret.width * 4, strip.firstRow, strip.rowCount, aFlipVertically );
+		}
+	} );
+
+	return ret;
+}
@@ -0,0 +1,34 @@
+#ifndef IMAGE_DECODE_HPP_47D2A9C1_8E3B_4B60_A15F_D6093E7C2B84
+#define IMAGE_DECODE_HPP_47D2A9C1_8E3B_4B60_A15F_D6093E7C2B84
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+#include "../support/parallel.hpp"
+
+/* Decoding images to 8-bit RGBA, on several threads where possible
+ *
+ * decode_image_rgba8() reads anything that stb_image does. JPEGs with
+ * suitable restart markers are split into strips (see
+ * vmlib/jpeg_strips.hpp) that are decoded on up to aThreadCount threads;
+ * other images are decoded on the calling thread.
+ *
+ * The image is flipped vertically if asked (as OpenGL wants its rows
+ * bottom-up) while its rows are copied out, so stb_image's own flipping is
+ * not used.
+ *
+ * Used by the application for textures that are not in the asset pack, and
+ * by the asset compiler (assetc).
+ */
+struct DecodedImage
+{
+	std::uint32_t width = 0;
+	std::uint32_t height = 0;
+	std::vector<std::uint8_t> pixels; // tightly packed rows of R, G, B, A
+};
+
+DecodedImage decode_image_rgba8( std::filesystem::path const&, bool aFlipVertically, std::size_t aThreadCount = default_thread_count() );
+
+#endif // IMAGE_DECODE_HPP_47D2A9C1_8E3B_4B60_A15F_D6093E7C2B84
@@ -6,16 +6,22 @@
 #include <typeinfo>
 #include <stdexcept>
 #include <filesystem>
+#include <fstream>
 #include <vector>
+#include <span>
 #include <array>
 #include <memory>
 #include <limits>
 #include <algorithm>
 #include <chrono>
+#include <optional>
 #include <cmath>
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <type_traits>
 #include <cstdio>
+#include <cstring>
 
 #include <cstdlib>
 
@@ -23,33 +29,77 @@
 #include "../support/program.hpp"
 #include "../support/checkpoint.hpp"
 #include "../support/debug_output.hpp"
+#include "../support/parallel.hpp"
+#include "../support/process_memory.hpp"
 
 #include "../vmlib/vec4.hpp"
 #include "../vmlib/vec2.hpp"
 #include "../vmlib/mat44.hpp"
+#include "../vmlib/mat34.hpp"
+#include "../vmlib/transform.hpp"
+#include "../vmlib/frustum.hpp"
+#include "../vmlib/fastmath.hpp"
+#include "../vmlib/quat.hpp"
+#include "../vmlib/weld.hpp"
+#include "../vmlib/vertex_cache.hpp"
+#include "../vmlib/quantize.hpp"
+#include "../vmlib/chunk_lod.hpp"
+#include "../vmlib/simplify.hpp"
+#include "../vmlib/mesh_chunks.hpp"
+#include "../vmlib/meshlets.hpp"
+#include "../vmlib/mip_streaming.hpp"
 #include "../vmlib/vec3.hpp"
 
 #include "defaults.hpp"
+#include "mesh_cache.hpp"
+#include "mesh_build.hpp"
+#include "asset_pack.hpp"
+#include "image_decode.hpp"
+#include "texture_stream.hpp"
+#include "gpu_cache.hpp"
+#include "startup_tasks.hpp"
+#include "vertex_layout.hpp"
+#include "vertex_formats.hpp"
 
-#include "../third_party/rapidobj/include/rapidobj/rapidobj.hpp"
-#include "../third_party/stb/include/stb_image.h"
 #include "../third_party/fontstash/include/fontstash.h"
 #define STB_TRUETYPE_IMPLEMENTATION
 #include "../third_party/fontstash/include/stb_truetype.h"
 
 // #define ENABLE_MEASURE_PERF
+
+// Particle emission and the camera use the vectorized sin/cos from
+// vmlib/fastmath.hpp (absolute error <= 2e-7). Comment out to use libm.
+#define ENABLE_FAST_TRIG
+
+// Cache the terrain and landing pad vertex buffers next to their OBJ files
+// (see mesh_cache.hpp). Comment out to always parse the OBJs.
+#define ENABLE_MESH_CACHE
+
+// Load meshes, textures, the UI font and shaders from the asset pack that
+// assetc builds (see asset_pack.hpp), where it has them. Comment out to
+// always load the source files.
+#define ENABLE_ASSET_PACK
+
+// Stream the terrain texture's finer mip levels from the asset pack as the
+// camera needs them (see texture_stream.hpp), within
+// kTerrainTextureBudgetBytes. Comment out to upload all levels at startup.
+#define ENABLE_TEXTURE_STREAMING
+
 namespace task5
 {
 	struct VehicleGeometry
 	{
 		GLuint vao = 0;
 		GLuint vbo = 0;
+		GLuint ebo = 0;
 		GLsizei vertexCount = 0;
+		Aabb3f bounds = kEmptyAabb3f;
+		std::vector<MeshLod> lods; // see build_lod_chain()
 	};
 
 	VehicleGeometry create_vehicle_geometry();
     void destroy_geometry(VehicleGeometry&);
-    void render_vehicle(const VehicleGeometry&, const Mat44f& modelMatrix, GLint uModelLocation);
+    void render_vehicle(const VehicleGeometry&, const Mat44fGl& modelMatrix, GLint uModelLocation, std::size_t lod);
 }
 
 namespace task6
@@ -83,6 +133,7 @@ namespace task7
 
         Vec3f startPos{};
         Vec3f lastPos{};
+        Quatf orientation = kIdentityQuatf;
 
         Mat44f baseModel = kIdentity44f;
         Mat44f currentModel = kIdentity44f;
@@ -203,18 +254,12 @@ namespace
 	};
 
 	// === Mesh vertex formats ===
-	struct VertexPNT
-	{
-		Vec3f position;
-		Vec3f normal;
-		Vec2f texCoord;
-	};
-
-	struct VertexPNC
+	// The vertex structs are in vertex_formats.hpp. Meshes are uploaded
+	// either as they are or in their packed variant.
+	enum class VertexFormat
 	{
-		Vec3f position;
-		Vec3f normal;
-		Vec3f color;
+		Full,
+		Packed
 	};
 
 	// === View / viewport containers ===
@@ -226,11 +271,35 @@ namespace
 		GLsizei height = 1;
 	};
 
+	// Matrices are kept in OpenGL layout, as they are only ever uploaded.
+	// The frustum is in world space.
 	struct RenderView
 	{
-		Mat44f view;
-		Mat44f proj;
+		Mat44fGl view;
+		Mat44fGl proj;
 		ViewportRect viewport;
+		Frustum frustum;
+		Vec3f eye;           // camera position, for LOD selection
+		float pixelsPerUnit; // see lod_pixels_per_unit()
+	};
+
+	// Terrain triangles submitted in the current frame (over all views), per
+	// level of detail, and what the same chunks would have cost at full
+	// detail.
+	struct TerrainLodStats
+	{
+		std::array<std::uint64_t, kMaxLodLevels> triangles{};
+		std::uint64_t fullDetailTriangles = 0;
+	};
+
+	// Meshlets (and their triangles) considered and kept by
+	// append_visible_meshlets_() in the current frame, for one view.
+	struct MeshletCullStats
+	{
+		std::uint64_t meshlets = 0;
+		std::uint64_t visibleMeshlets = 0;
+		std::uint64_t triangles = 0;
+		std::uint64_t visibleTriangles = 0;
 	};
 
 	// === Particle system data ===
@@ -246,7 +315,7 @@ namespace
 
 	struct ParticlePipeline
 	{
-		std::unique_ptr<ShaderProgram> program;
+		std::shared_ptr<ShaderProgram> program;
 		GLint uView = -1;
 		GLint uProj = -1;
 		GLint uViewportHeight = -1;
@@ -262,11 +331,13 @@ namespace
 		float alpha;
 	};
 
+	// The GL objects come from the GpuCache (see gpu_cache.hpp), so that
+	// resetting the system does not recreate them.
 	struct ParticleSystem
 	{
-		GLuint vao = 0;
-		GLuint vbo = 0;
-		GLuint textureId = 0;
+		std::shared_ptr<GpuBuffer const> vertices;
+		std::shared_ptr<GpuVertexArray const> vertexArray;
+		std::shared_ptr<GpuTexture const> texture;
 		std::vector<Particle> pool;
 		std::size_t head = 0;
 		std::size_t aliveCount = 0;
@@ -291,7 +362,7 @@ namespace
 
 	struct UIPipeline
 	{
-		std::unique_ptr<ShaderProgram> program;
+		std::shared_ptr<ShaderProgram> program;
 		GLint uProj = -1;
 		GLint uTexture = -1;
 		GLint uUseTexture = -1;
@@ -331,23 +402,53 @@ namespace
 	{
 		GLuint vao = 0;
 		GLuint vbo = 0;
+		GLuint ebo = 0;
 		GLsizei vertexCount = 0;
+		GLsizei indexCount = 0;
+		GLenum indexType = GL_UNSIGNED_INT;
+		VertexFormat format = VertexFormat::Full;
+		PositionQuantization positionQuant = kIdentityPositionQuantization;
 		Vec3f minBounds{ 0.f, 0.f, 0.f };
 		Vec3f maxBounds{ 0.f, 0.f, 0.f };
 		Vec3f center{ 0.f, 0.f, 0.f };
 		float radius = 1.f;
+
+		// Parts of the index buffer, for per-chunk culling, and their levels
+		// of detail (lodLevels per chunk, see vmlib/chunk_lod.hpp).
+		std::vector<MeshChunk> chunks;
+		std::vector<MeshLod> chunkLods;
+		std::size_t lodLevels = 0;
+
+		// Meshlets of all levels, see vmlib/meshlets.hpp.
+		std::vector<Meshlet> meshlets;
 	};
 
 	struct LandingPadGeometry
 	{
 		GLuint vao = 0;
 		GLuint vbo = 0;
+		GLuint ebo = 0;
 		GLsizei vertexCount = 0;
+		GLsizei indexCount = 0;
+		GLenum indexType = GL_UNSIGNED_INT;
+		VertexFormat format = VertexFormat::Full;
+		PositionQuantization positionQuant = kIdentityPositionQuantization;
+		Aabb3f bounds = kEmptyAabb3f;
+		std::vector<MeshLod> lods; // see build_lod_chain(); lods[0] is the full mesh
+		std::vector<Meshlet> meshlets; // of all levels
+	};
+
+	// Uniforms that undo the vertex quantization; see upload_dequantization().
+	struct DequantizationUniforms
+	{
+		GLint uPositionScale = -1;
+		GLint uPositionOffset = -1;
+		GLint uOctNormals = -1;
 	};
 
 	struct TerrainPipeline
 	{
-		std::unique_ptr<ShaderProgram> program;
+		std::shared_ptr<ShaderProgram> program;
 		GLint uModel = -1;
 		GLint uView = -1;
 		GLint uProj = -1;
@@ -355,18 +456,20 @@ namespace
 		GLint uAmbient = -1;
 		GLint uDiffuse = -1;
 		GLint uTexture = -1;
+		DequantizationUniforms dequant;
 		GLuint textureId = 0;
 	};
 
 	struct LandingPadPipeline
 	{
-		std::unique_ptr<ShaderProgram> program;
+		std::shared_ptr<ShaderProgram> program;
 		GLint uModel = -1;
 		GLint uView = -1;
 		GLint uProj = -1;
 		GLint uLightDir = -1;
 		GLint uAmbient = -1;
 		GLint uDiffuse = -1;
+		DequantizationUniforms dequant;
 	};
 
 	// === Feature toggles ===
@@ -404,6 +507,11 @@ namespace
 		task8::TrackingCamera trackingCam;
 		SplitScreenState splitScreen;
 		ParticleSystem particles;
+		VertexFormat meshFormat = VertexFormat::Full; // toggled with P
+		bool meshLod = true;                          // toggled with L
+		bool meshletCulling = true;                   // toggled with M
+		TerrainLodStats terrainLodStats;
+		std::array<MeshletCullStats, 2> meshletStats; // per view
 		// UI input (left button)
 		bool mouseLeftDown = false;
 		bool mouseLeftPressed = false;
@@ -427,27 +535,93 @@ namespace
 	void glfw_callback_framebuffer_( GLFWwindow*, int, int );
 
 	// --- Loading / resources ---
-	SceneGeometry load_parlahti_mesh( std::filesystem::path const& objPath );
+	// Largest error in pixels that terrain LOD selection accepts (see
+	// kTerrainLodLevels in mesh_build.hpp).
+	constexpr float kTerrainLodPixelError = 1.f;
+
+	// Simplified levels of the vehicle (vmlib/simplify.hpp), as fractions of
+	// its triangles, and the largest error in pixels that the LOD selection
+	// of the vehicle and the landing pads accepts.
+	constexpr std::array<float, 2> kVehicleLodRatios{ 0.5f, 0.25f };
+	constexpr float kMeshLodPixelError = 1.f;
+
+	// Packed vertices are encoded and uploaded in slices of
+	// kUploadSliceVertices.
+	constexpr std::size_t kUploadSliceVertices = 64 * 1024;
+
+	// GPU memory that the streamed terrain texture may take. The 4K texture
+	// takes 21.3 MiB with all its levels as BC7, but 85.3 MiB as RGBA8, in
+	// which case its top level is never loaded.
+	constexpr std::size_t kTerrainTextureBudgetBytes = 48 * 1024 * 1024;
+
+	// The particle texture is generated (see make_particle_texture_pixels()),
+	// and cached under this name.
+	constexpr char const* kParticleTextureKey = "gen:particle-texture";
+	constexpr std::size_t kParticleTextureSize = 64;
+
+	// A mesh loaded on the CPU, ready to upload: from the asset pack, the
+	// (mapped) mesh cache, or built from its OBJ; mesh refers to one of them.
+	// Preparing a mesh needs no GL context, so it can run on any thread.
+	template< class tVertex >
+	struct PreparedMesh
+	{
+		std::optional<MeshData> mesh;
+		std::optional<CachedMesh> cached;
+		BuiltMesh<tVertex> built;
+	};
+
+	PreparedMesh<VertexPNT> prepare_parlahti_mesh( std::filesystem::path const& objPath, AssetPack const& pack );
+	SceneGeometry upload_parlahti_mesh( PreparedMesh<VertexPNT> const& mesh, VertexFormat format );
+	SceneGeometry load_parlahti_mesh( std::filesystem::path const& objPath, AssetPack const& pack, VertexFormat format );
 	void destroy_geometry( SceneGeometry& geometry );
-	LandingPadGeometry load_landingpad_mesh( std::filesystem::path const& objPath );
+	PreparedMesh<VertexPNC> prepare_landingpad_mesh( std::filesystem::path const& objPath, AssetPack const& pack );
+	LandingPadGeometry upload_landingpad_mesh( PreparedMesh<VertexPNC> const& mesh, VertexFormat format );
+	LandingPadGeometry load_landingpad_mesh( std::filesystem::path const& objPath, AssetPack const& pack, VertexFormat format );
 
 	void destroy_geometry( LandingPadGeometry& geometry );
-	GLuint load_texture_2d( std::filesystem::path const& imagePath );
+
+	DequantizationUniforms get_dequantization_uniforms( GLuint programId );
+	void upload_dequantization( DequantizationUniforms const& uniforms, VertexFormat format, PositionQuantization const& positionQuant );
+
+	void append_visible_meshlets_( std::span<Meshlet const> meshlets, Frustum const& frustum, Mat34f const& model, float scale, Vec3f eye, std::size_t indexSize, MeshletCullStats& stats, std::vector<GLsizei>& counts, std::vector<void const*>& offsets );
+
+	// A texture read on the CPU, ready to upload: from the asset pack if it
+	// has it, and otherwise decoded from its file.
+	struct PreparedTexture
+	{
+		std::optional<PackTexture> packed;
+		DecodedImage image;
+	};
+	PreparedTexture prepare_texture_2d( std::filesystem::path const& imagePath, AssetPack const& pack );
+	GLuint upload_texture_2d( PreparedTexture const& texture, std::filesystem::path const& imagePath );
+	ShaderProgram::ShaderSource shader_source( GLenum type, std::filesystem::path const& path, AssetPack const& pack );
+	void print_gpu_cache_stats( GpuCache const& cache );
+	std::vector<std::uint8_t> make_particle_texture_pixels();
+	GLuint upload_particle_texture( std::span<std::uint8_t const> pixels );
 	GLuint create_particle_texture();
 
-	void init_particle_system( ParticleSystem& system );
+	void init_particle_system( ParticleSystem& system, GpuCache& cache );
 	void destroy_particle_system( ParticleSystem& system );
 	void emit_particles( ParticleSystem& system, Vec3f const& emitterPos, Vec3f const& emitterDir, float rate, float dt );
 	void update_particles( ParticleSystem& system, float dt );
 	void upload_particles( ParticleSystem& system );
-	void render_particles( ParticlePipeline const& pipeline, ParticleSystem const& system, Mat44f const& view, Mat44f const& proj, ViewportRect const& viewport, float fovRadians );
+	void render_particles( ParticlePipeline const& pipeline, ParticleSystem const& system, Mat44fGl const& view, Mat44fGl const& proj, ViewportRect const& viewport, float fovRadians );
 
 	// UI helpers
 	Mat44f make_ortho( float l, float r, float b, float t, float n = -1.f, float f = 1.f );
 	void init_ui_renderer( UIRenderer& ui );
 	void destroy_ui_renderer( UIRenderer& ui );
-	UIPipeline create_ui_pipeline( std::filesystem::path const& shaderRoot );
-	BitmapFont create_bitmap_font( std::filesystem::path const& fontPath, float pixelHeight = 32.f, int atlasSize = 512 );
+	UIPipeline create_ui_pipeline( std::filesystem::path const& shaderRoot, AssetPack const& pack, GpuCache& cache );
+	// A font baked on the CPU, ready to upload; atlas points to bitmap or into
+	// the asset pack.
+	struct BakedFont
+	{
+		BitmapFont font;
+		std::vector<unsigned char> bitmap;
+		unsigned char const* atlas = nullptr;
+	};
+	BakedFont bake_bitmap_font( std::filesystem::path const& fontPath, AssetPack const& pack, float pixelHeight = kUiFontPixelHeight, int atlasSize = int(kUiFontAtlasSize) );
+	BitmapFont upload_bitmap_font( BakedFont const& baked );
 	void destroy_bitmap_font( BitmapFont& font );
 	void ui_add_rect( UIRenderer& ui, Rect const& rc, Vec4f const& color );
 	void ui_add_text( UIRenderer& ui, BitmapFont const& font, std::string const& text, Vec2f pos, Vec4f color );
@@ -458,13 +632,12 @@ namespace
 		float minY = 0.f;
 	};
 	TextBounds ui_measure_text_bounds( BitmapFont const& font, std::string const& text );
-	void ui_flush( UIPipeline const& pipe, UIRenderer& ui, Mat44f const& proj, GLuint boundTexture, bool useTexture );
+	void ui_flush( UIPipeline const& pipe, UIRenderer& ui, Mat44fGl const& proj, GLuint boundTexture, bool useTexture );
 
 	Vec3f compute_forward_vector( Camera const& camera );
 	Mat44f make_view_matrix( Camera const& camera, Vec3f const& worldUp );
 	void update_projection( AppState& app );
 	void update_camera( AppState& app, float deltaSeconds );
-	std::array<float,16> to_gl_matrix( Mat44f const& mat );
 
 	// === Inline math helpers ===
 	inline Vec3f cross( Vec3f const& a, Vec3f const& b ) noexcept
@@ -519,12 +692,12 @@ namespace
 		ui.text.clear();
 	}
 
-	UIPipeline create_ui_pipeline( std::filesystem::path const& shaderRoot )
+	UIPipeline create_ui_pipeline( std::filesystem::path const& shaderRoot, AssetPack const& pack, GpuCache& cache )
 	{
 		UIPipeline pipe{};
-		pipe.program = std::make_unique<ShaderProgram>( std::vector<ShaderProgram::ShaderSource>{
-			{ GL_VERTEX_SHADER, (shaderRoot / "ui.vert").string() },
-			{ GL_FRAGMENT_SHADER, (shaderRoot / "ui.frag").string() }
+		pipe.program = cache.program( {
+			shader_source( GL_VERTEX_SHADER, shaderRoot / "ui.vert", pack ),
+			shader_source( GL_FRAGMENT_SHADER, shaderRoot / "ui.frag", pack )
 		} );
 		pipe.uProj = glGetUniformLocation( pipe.program->programId(), "uProj" );
 		pipe.uTexture = glGetUniformLocation( pipe.program->programId(), "uTexture" );
@@ -532,34 +705,61 @@ namespace
 		return pipe;
 	}
 
-	BitmapFont create_bitmap_font( std::filesystem::path const& fontPath, float pixelHeight, int atlasSize )
+	// Uses the font baked by assetc if the asset pack has it at this size,
+	// and otherwise bakes it.
+	BakedFont bake_bitmap_font( std::filesystem::path const& fontPath, AssetPack const& pack, float pixelHeight, int atlasSize )
 	{
-		BitmapFont font{};
+		static_assert( sizeof( PackGlyph ) == sizeof( stbtt_bakedchar ) );
+
+		BakedFont ret{};
+		auto& font = ret.font;
 		font.pixelHeight = pixelHeight;
 		font.atlasW = atlasSize;
 		font.atlasH = atlasSize;
 
-		std::vector<unsigned char> bitmap( atlasSize * atlasSize );
-		FILE* fp = std::fopen( fontPath.string().c_str(), "rb" );
-		if( !fp )
-			throw Error( "Failed to open font '{}'", fontPath.string() );
-		std::fseek( fp, 0, SEEK_END );
-		long size = std::ftell( fp );
-		std::fseek( fp, 0, SEEK_SET );
-		std::vector<unsigned char> ttf;
-		ttf.resize( static_cast<std::size_t>( size ) );
-		std::fread( ttf.data(), 1, static_cast<size_t>( size ), fp );
-		std::fclose( fp );
-
-		int bakeRes = stbtt_BakeFontBitmap( ttf.data(), 0, pixelHeight, bitmap.data(), atlasSize, atlasSize, 32, 96, font.baked.data() );
-		if( bakeRes <= 0 )
-			throw Error( "stbtt_BakeFontBitmap failed for '{}'", fontPath.string() );
+		auto& bitmap = ret.bitmap;
+		auto& atlas = ret.atlas;
+
+		auto const baked = parse_pack_font( pack.find( fontPath, AssetKind::Font ) );
+		if( baked && baked->pixelHeight == pixelHeight && baked->atlasWidth == std::uint32_t(atlasSize) && baked->atlasHeight == std::uint32_t(atlasSize)
+			&& 32 == baked->firstChar && font.baked.size() == baked->glyphs.size() )
+		{
+			std::memcpy( font.baked.data(), baked->glyphs.data(), baked->glyphs.size_bytes() );
+			atlas = reinterpret_cast<unsigned char const*>( baked->atlas.data() );
+		}
+		else
+		{
+			bitmap.resize( atlasSize * atlasSize );
+			FILE* fp = std::fopen( fontPath.string().c_str(), "rb" );
+			if( !fp )
+				throw Error( "Failed to open font '{}'", fontPath.string() );
+			std::fseek( fp, 0, SEEK_END );
+			long size = std::ftell( fp );
+			std::fseek( fp, 0, SEEK_SET );
+			std::vector<unsigned char> ttf;
+			ttf.resize( static_cast<std::size_t>( size ) );
+			std::fread( ttf.data(), 1, static_cast<size_t>( size ), fp );
+			std::fclose( fp );
+
+			int bakeRes = stbtt_BakeFontBitmap( ttf.data(), 0, pixelHeight, bitmap.data(), atlasSize, atlasSize, 32, 96, font.baked.data() );
+			if( bakeRes <= 0 )
+				throw Error( "stbtt_BakeFontBitmap failed for '{}'", fontPath.string() );
+
+			atlas = bitmap.data();
+		}
+
+		return ret;
+	}
+
+	BitmapFont upload_bitmap_font( BakedFont const& baked )
+	{
+		auto font = baked.font;
 
 		glGenTextures( 1, &font.textureId );
 		glBindTexture( GL_TEXTURE_2D, font.textureId );
 		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
 		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
-		glTexImage2D( GL_TEXTURE_2D, 0, GL_RED, atlasSize, atlasSize, 0, GL_RED, GL_UNSIGNED_BYTE, bitmap.data() );
+		glTexImage2D( GL_TEXTURE_2D, 0, GL_RED, font.atlasW, font.atlasH, 0, GL_RED, GL_UNSIGNED_BYTE, baked.atlas );
 		GLint swizzleMask[] = { GL_RED, GL_RED, GL_RED, GL_RED };
 		glTexParameteriv( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask );
 		glBindTexture( GL_TEXTURE_2D, 0 );
@@ -639,15 +839,14 @@ namespace
 		return b;
 	}
 
-	void ui_flush( UIPipeline const& pipe, UIRenderer& ui, Mat44f const& proj, GLuint boundTexture, bool useTexture )
+	void ui_flush( UIPipeline const& pipe, UIRenderer& ui, Mat44fGl const& proj, GLuint boundTexture, bool useTexture )
 	{
 		auto& verts = useTexture ? ui.text : ui.solid;
 		if( verts.empty() )
 			return;
 
 		glUseProgram( pipe.program->programId() );
-		auto projGl = to_gl_matrix( proj );
-		glUniformMatrix4fv( pipe.uProj, 1, GL_FALSE, projGl.data() );
+		glUniformMatrix4fv( pipe.uProj, 1, GL_FALSE, proj.data() );
 		glUniform1i( pipe.uUseTexture, useTexture ? 1 : 0 );
 		glUniform1i( pipe.uTexture, 0 );
 
@@ -678,6 +877,51 @@ namespace
 
 int main() try
 {
+	// === Start loading assets ===
+	// From the asset pack where possible (see asset_pack.hpp); it is
+	// optional, so a missing or outdated pack only costs startup time.
+	//
+	// The CPU side of loading (building or mapping meshes, decoding textures,
+	// baking the font) runs on worker threads (see startup_tasks.hpp) while
+	// this thread creates the window and compiles the shaders; each result is
+	// uploaded here as soon as it is ready. The timeline is printed at the
+	// end of startup.
+	StartupTrace trace;
+
+	std::filesystem::path const shaderRoot = std::filesystem::path( "assets/cw2" );
+	AssetPack pack;
+	#ifdef ENABLE_ASSET_PACK
+	{
+		StartupTrace::Stage const stage( trace, "asset pack" );
+
+		std::filesystem::path const packPath = std::filesystem::path( "assets/cw2.pack" );
+		try
+		{
+			if( std::filesystem::exists( packPath ) )
+				pack = AssetPack( packPath, shaderRoot );
+		}
+		catch( std::exception const& eErr )
+		{
+			std::print( stderr, "Ignoring asset pack: {}\n", eErr.what() );
+		}
+	}
+	#endif
+
+	std::filesystem::path const objPath = std::filesystem::path( "assets/cw2/parlahti.obj" );
+	std::filesystem::path const landingPadPath = shaderRoot / "landingpad.obj";
+	std::filesystem::path const texturePath = shaderRoot / "L4343A-4k.jpeg";
+	std::filesystem::path const fontPath = shaderRoot / "DroidSansMonoDotted.ttf";
+
+	// The workers refer to the pack and the paths above.
+	StartupTasks tasks( trace );
+	auto terrainMeshTask = tasks.run( "terrain mesh", [&] { return prepare_parlahti_mesh( objPath, pack ); } );
+	auto landingPadMeshTask = tasks.run( "landing pad mesh", [&] { return prepare_landingpad_mesh( landingPadPath, pack ); } );
+	auto terrainTextureTask = tasks.run( "terrain texture", [&] { return prepare_texture_2d( texturePath, pack ); } );
+	auto fontTask = tasks.run( "UI font", [&] { return bake_bitmap_font( fontPath, pack ); } );
+	auto particleTextureTask = tasks.run( "particle texture", &make_particle_texture_pixels );
+
+	std::optional<StartupTrace::Stage> contextStage( std::in_place, trace, "window and GL context" );
+
 	// Initialize GLFW
 	if( GLFW_TRUE != glfwInit() )
 	{
@@ -748,6 +992,8 @@ int main() try
 	glCullFace( GL_BACK );
 	glFrontFace( GL_CCW );
 
+	contextStage.reset();
+
 	AppState app{};
 	int fbWidth = 0;
 	int fbHeight = 0;
@@ -771,9 +1017,93 @@ int main() try
 	task12::init( app.gpuTimers );
 	#endif
 
-	// === Load terrain / setup camera ===
-	std::filesystem::path const objPath = std::filesystem::path( "assets/cw2/parlahti.obj" );
-	auto geometry = load_parlahti_mesh( objPath );
+	// Textures, buffers and programs, shared by name (see gpu_cache.hpp).
+	GpuCache gpuCache;
+
+	// === Shaders ===
+	TerrainPipeline terrain{};
+	LandingPadPipeline landingPad{};
+	ParticlePipeline particlePipeline{};
+	{
+		StartupTrace::Stage const stage( trace, "shaders" );
+
+		terrain.program = gpuCache.program( {
+			shader_source( GL_VERTEX_SHADER, shaderRoot / "terrain.vert", pack ),
+			shader_source( GL_FRAGMENT_SHADER, shaderRoot / "terrain.frag", pack )
+		} );
+		terrain.uModel = glGetUniformLocation( terrain.program->programId(), "uModel" );
+		terrain.uView = glGetUniformLocation( terrain.program->programId(), "uView" );
+		terrain.uProj = glGetUniformLocation( terrain.program->programId(), "uProj" );
+		terrain.uLightDir = glGetUniformLocation( terrain.program->programId(), "uLightDir" );
+		terrain.uAmbient = glGetUniformLocation( terrain.program->programId(), "uAmbientColor" );
+		terrain.uDiffuse = glGetUniformLocation( terrain.program->programId(), "uDiffuseColor" );
+		terrain.uTexture = glGetUniformLocation( terrain.program->programId(), "uTerrainTexture" );
+		terrain.dequant = get_dequantization_uniforms( terrain.program->programId() );
+
+		landingPad.program = gpuCache.program( {
+			shader_source( GL_VERTEX_SHADER, shaderRoot / "landingpad.vert", pack ),
+			shader_source( GL_FRAGMENT_SHADER, shaderRoot / "landingpad.frag", pack )
+		} );
+		landingPad.uModel = glGetUniformLocation( landingPad.program->programId(), "uModel" );
+		landingPad.uView = glGetUniformLocation( landingPad.program->programId(), "uView" );
+		landingPad.uProj = glGetUniformLocation( landingPad.program->programId(), "uProj" );
+		landingPad.uLightDir = glGetUniformLocation( landingPad.program->programId(), "uLightDir" );
+		landingPad.uAmbient = glGetUniformLocation( landingPad.program->programId(), "uAmbientColor" );
+		landingPad.uDiffuse = glGetUniformLocation( landingPad.program->programId(), "uDiffuseColor" );
+		landingPad.dequant = get_dequantization_uniforms( landingPad.program->programId() );
+
+		particlePipeline.program = gpuCache.program( {
+			shader_source( GL_VERTEX_SHADER, shaderRoot / "particles.vert", pack ),
+			shader_source( GL_FRAGMENT_SHADER, shaderRoot / "particles.frag", pack )
+		} );
+		particlePipeline.uView = glGetUniformLocation( particlePipeline.program->programId(), "uView" );
+		particlePipeline.uProj = glGetUniformLocation( particlePipeline.program->programId(), "uProj" );
+		particlePipeline.uViewportHeight = glGetUniformLocation( particlePipeline.program->programId(), "uViewportHeight" );
+		particlePipeline.uTanHalfFov = glGetUniformLocation( particlePipeline.program->programId(), "uTanHalfFov" );
+		particlePipeline.uTexture = glGetUniformLocation( particlePipeline.program->programId(), "uParticleTex" );
+		particlePipeline.uColor = glGetUniformLocation( particlePipeline.program->programId(), "uParticleColor" );
+
+		app.uiPipeline = create_ui_pipeline( shaderRoot, pack, gpuCache );
+	}
+
+	// === Upload assets ===
+	// In the order that the workers finish them.
+	SceneGeometry geometry{};
+	LandingPadGeometry landingPadGeometry{};
+	std::unique_ptr<StreamedTexture> terrainTexture;
+	std::shared_ptr<GpuTexture const> terrainTextureFile;
+
+	tasks.then( std::move(terrainMeshTask), [&] ( PreparedMesh<VertexPNT> const& aMesh ) {
+		geometry = upload_parlahti_mesh( aMesh, app.meshFormat );
+	} );
+	tasks.then( std::move(landingPadMeshTask), [&] ( PreparedMesh<VertexPNC> const& aMesh ) {
+		landingPadGeometry = upload_landingpad_mesh( aMesh, app.meshFormat );
+	} );
+	tasks.then( std::move(terrainTextureTask), [&] ( PreparedTexture aTexture ) {
+		#ifdef ENABLE_TEXTURE_STREAMING
+		if( aTexture.packed )
+		{
+			terrainTexture = std::make_unique<StreamedTexture>( std::move(*aTexture.packed), kTerrainTextureBudgetBytes, texturePath.string() );
+			terrain.textureId = terrainTexture->id();
+			return;
+		}
+		#endif
+
+		terrainTextureFile = gpuCache.texture( texturePath.lexically_normal().string(), [&] { return upload_texture_2d( aTexture, texturePath ); } );
+		terrain.textureId = terrainTextureFile->id;
+	} );
+	tasks.then( std::move(fontTask), [&] ( BakedFont const& aFont ) {
+		app.uiFont = upload_bitmap_font( aFont );
+	} );
+	tasks.then( std::move(particleTextureTask), [&] ( std::vector<std::uint8_t> const& aPixels ) {
+		// Cached for init_particle_system() below.
+		gpuCache.texture( kParticleTextureKey, [&] { return upload_particle_texture( aPixels ); } );
+	} );
+
+	tasks.finish();
+
+	// === Set up the scene ===
+	std::optional<StartupTrace::Stage> sceneStage( std::in_place, trace, "scene" );
 
 	app.camera.position = Vec3f{
 		geometry.center.x,
@@ -785,37 +1115,7 @@ int main() try
 	app.camera.yaw = std::atan2( lookDir.z, lookDir.x );
 	app.camera.pitch = std::asin( std::clamp( lookDir.y, -1.f, 1.f ) );
 
-	std::filesystem::path const shaderRoot = std::filesystem::path( "assets/cw2" );
-	TerrainPipeline terrain{};
-	terrain.program = std::make_unique<ShaderProgram>( std::vector<ShaderProgram::ShaderSource>{
-		{ GL_VERTEX_SHADER, (shaderRoot / "terrain.vert").string() },
-		{ GL_FRAGMENT_SHADER, (shaderRoot / "terrain.frag").string() }
-	} );
-	terrain.uModel = glGetUniformLocation( terrain.program->programId(), "uModel" );
-	terrain.uView = glGetUniformLocation( terrain.program->programId(), "uView" );
-	terrain.uProj = glGetUniformLocation( terrain.program->programId(), "uProj" );
-	terrain.uLightDir = glGetUniformLocation( terrain.program->programId(), "uLightDir" );
-	terrain.uAmbient = glGetUniformLocation( terrain.program->programId(), "uAmbientColor" );
-	terrain.uDiffuse = glGetUniformLocation( terrain.program->programId(), "uDiffuseColor" );
-	terrain.uTexture = glGetUniformLocation( terrain.program->programId(), "uTerrainTexture" );
-
-	std::filesystem::path const texturePath = shaderRoot / "L4343A-4k.jpeg";
-	terrain.textureId = load_texture_2d( texturePath );
-
-	auto landingPadGeometry = load_landingpad_mesh( shaderRoot / "landingpad.obj" );
-	LandingPadPipeline landingPad{};
-	landingPad.program = std::make_unique<ShaderProgram>( std::vector<ShaderProgram::ShaderSource>{
-		{ GL_VERTEX_SHADER, (shaderRoot / "landingpad.vert").string() },
-		{ GL_FRAGMENT_SHADER, (shaderRoot / "landingpad.frag").string() }
-	} );
-	landingPad.uModel = glGetUniformLocation( landingPad.program->programId(), "uModel" );
-	landingPad.uView = glGetUniformLocation( landingPad.program->programId(), "uView" );
-	landingPad.uProj = glGetUniformLocation( landingPad.program->programId(), "uProj" );
-	landingPad.uLightDir = glGetUniformLocation( landingPad.program->programId(), "uLightDir" );
-	landingPad.uAmbient = glGetUniformLocation( landingPad.program->programId(), "uAmbientColor" );
-	landingPad.uDiffuse = glGetUniformLocation( landingPad.program->programId(), "uDiffuseColor" );
-
-	Mat44f modelMatrix = kIdentity44f;
+	Mat44fGl const modelMatrixGl = kIdentity44fGl;
 	Vec3f lightDirection = safe_normalize( Vec3f{ 0.f, 1.f, -1.f } );
 	Vec3f ambientColor{ 0.25f, 0.25f, 0.25f };
 	Vec3f diffuseColor{ 0.75f, 0.75f, 0.75f };
@@ -826,21 +1126,47 @@ int main() try
 		Vec3f{ -10.f, 0.f, 23.f }
 	};
 	float const landingPadScale = 25.f;
-	Mat44f const landingPadScaleMatrix = make_scaling( landingPadScale, landingPadScale, landingPadScale );
 	std::array<Mat44f, 2> landingPadModels{};
 	for( std::size_t i = 0; i < landingPadAnchors.size(); ++i )
 	{
 		Vec3f position = landingPadAnchors[i];
 		position.y = waterLevel + 0.1f;
-		landingPadModels[i] = make_translation( position ) * landingPadScaleMatrix;
+		landingPadModels[i] = Transform{}.translate( position ).scale( landingPadScale ).matrix();
 	}
 
+	// The pads do not move; convert their model matrices to GL layout and
+	// compute their world-space bounds (for culling) once. Meshlet culling
+	// also needs the inverses, to bring the camera into the pads' space.
+	std::array<Mat44fGl, 2> landingPadModelsGl{};
+	std::array<Mat34f, 2> landingPadModels34{};
+	std::array<Mat34f, 2> landingPadInverses{};
+	std::array<Aabb3f, 2> landingPadBounds{};
+	for( std::size_t i = 0; i < landingPadModels.size(); ++i )
+	{
+		landingPadModelsGl[i] = to_gl( landingPadModels[i] );
+		landingPadModels34[i] = to_mat34( landingPadModels[i] );
+		landingPadInverses[i] = invert_affine( landingPadModels34[i] );
+		landingPadBounds[i] = transform_bounds( landingPadModels[i], landingPadGeometry.bounds );
+	}
+
+	// The terrain's model matrix is the identity.
+	Aabb3f const terrainBounds{ geometry.minBounds, geometry.maxBounds };
+
+	// Visible terrain chunks or meshlets, gathered per draw and submitted
+	// with a single glMultiDrawElements(). Kept across frames to avoid
+	// reallocating.
+	std::vector<GLsizei> drawCounts;
+	std::vector<void const*> drawOffsets;
+
 	glViewport( 0, 0, fbWidth, fbHeight );
 
 	//task5: create vehicle geometry
 	task5::VehicleGeometry vehicleGeometry = task5::create_vehicle_geometry();
-	Mat44f vehicleModelMatrix =
-		landingPadModels[0] * make_translation( Vec3f{ 0.f, 0.2f, 0.f } );
+	// The vehicle stands on the first pad: the offset is given in the pad's
+	// (scaled) space, but the vehicle itself must not inherit the pad's scale.
+	Mat44f vehicleModelMatrix = make_translation(
+		transform_point( to_mat34( landingPadModels[0] ), Vec3f{ 0.f, 0.2f, 0.f } )
+	);
 
 	//task6: setup point lights
 	// Vehicle position
@@ -867,25 +1193,22 @@ int main() try
 	task7::initialise(app.animation, vehicleModelMatrix, pointLights);
 
 	// task10: particle system (exhaust)
-	ParticlePipeline particlePipeline{};
-	particlePipeline.program = std::make_unique<ShaderProgram>( std::vector<ShaderProgram::ShaderSource>{
-		{ GL_VERTEX_SHADER, (shaderRoot / "particles.vert").string() },
-		{ GL_FRAGMENT_SHADER, (shaderRoot / "particles.frag").string() }
-	} );
-	particlePipeline.uView = glGetUniformLocation( particlePipeline.program->programId(), "uView" );
-	particlePipeline.uProj = glGetUniformLocation( particlePipeline.program->programId(), "uProj" );
-	particlePipeline.uViewportHeight = glGetUniformLocation( particlePipeline.program->programId(), "uViewportHeight" );
-	particlePipeline.uTanHalfFov = glGetUniformLocation( particlePipeline.program->programId(), "uTanHalfFov" );
-	particlePipeline.uTexture = glGetUniformLocation( particlePipeline.program->programId(), "uParticleTex" );
-	particlePipeline.uColor = glGetUniformLocation( particlePipeline.program->programId(), "uParticleColor" );
-	init_particle_system( app.particles );
-	app.particles.textureId = create_particle_texture();
-
-	// UI renderer / font / pipeline
+	init_particle_system( app.particles, gpuCache );
+
+	// UI renderer
 	init_ui_renderer( app.uiRenderer );
-	std::filesystem::path const fontPath = shaderRoot / "DroidSansMonoDotted.ttf";
-	app.uiFont = create_bitmap_font( fontPath, 32.f, 512 );
-	app.uiPipeline = create_ui_pipeline( shaderRoot );
+
+	glFinish();
+	sceneStage.reset();
+
+	// Compare with ENABLE_ASSET_PACK commented out (or without the pack) for
+	// the cost of loading the source files.
+	std::print( "Startup: ready in {:.1f} ms ({})\n",
+		trace.elapsed_ms(),
+		pack.empty() ? "from source files" : std::format( "asset pack, {} entries, {:.1f} MiB", pack.entry_count(), double(pack.size_bytes()) / (1024.0 * 1024.0) )
+	);
+	print_gpu_cache_stats( gpuCache );
+	trace.print();
 
 	while( !glfwWindowShouldClose( window ) )
 	{
@@ -899,6 +1222,19 @@ int main() try
 		glfwGetWindowSize( window, &app.windowWidth, &app.windowHeight );
 		update_camera( app, elapsed.count() );
 
+		// Switch between full and packed vertex formats. Reloading is cheap
+		// with the mesh cache, and only the active format is kept in memory.
+		if( app.meshFormat != geometry.format )
+		{
+			destroy_geometry( geometry );
+			geometry = load_parlahti_mesh( objPath, pack, app.meshFormat );
+			destroy_geometry( landingPadGeometry );
+			landingPadGeometry = load_landingpad_mesh( landingPadPath, pack, app.meshFormat );
+		}
+
+		app.terrainLodStats = TerrainLodStats{};
+		app.meshletStats = {};
+
 		//task12: reset GPU timers
 		#ifdef ENABLE_MEASURE_PERF
 		double const frameMs = static_cast<double>( elapsed.count() ) * 1000.0;
@@ -921,10 +1257,11 @@ int main() try
 		{
 			// 取得火箭世界位置与朝向，作为喷口基准
 			Vec3f rocketPos{ vehicleModelMatrix[0,3], vehicleModelMatrix[1,3], vehicleModelMatrix[2,3] };
+			// The nose is the model's +y axis, i.e., column 1.
 			Vec3f forward{
-				vehicleModelMatrix[1,0],
+				vehicleModelMatrix[0,1],
 				vehicleModelMatrix[1,1],
-				vehicleModelMatrix[1,2]
+				vehicleModelMatrix[2,1]
 			};
 			forward = safe_normalize( forward, Vec3f{ 0.f, 0.f, 1.f } );
 			Vec3f exhaustDir = -forward;
@@ -953,7 +1290,12 @@ int main() try
 		std::size_t viewCount = 0;
 		auto add_view = [&]( Mat44f const& view, Mat44f const& proj, ViewportRect viewport )
 		{
-			views[viewCount++] = RenderView{ view, proj, viewport };
+			Mat44f const world = invert( view );
+			views[viewCount++] = RenderView{
+				to_gl( view ), to_gl( proj ), viewport, make_frustum( proj * view ),
+				Vec3f{ world[0,3], world[1,3], world[2,3] },
+				lod_pixels_per_unit( float(viewport.height), app.fovRadians )
+			};
 		};
 
 		ViewportRect const fullViewport{
@@ -998,16 +1340,46 @@ int main() try
 			add_view( viewMatrix, app.projection, fullViewport );
 		}
 
-		auto const modelGl = to_gl_matrix( modelMatrix );
+		#ifdef ENABLE_TEXTURE_STREAMING
+		// The finest terrain texture level that any view needs, at the nearest
+		// visible chunk (the terrain's bounding box would contain any camera
+		// that flies lower than the highest peak).
+		if( terrainTexture )
+		{
+			float const extent = std::max( terrainBounds.max.x - terrainBounds.min.x, terrainBounds.max.z - terrainBounds.min.z );
+			float const texelsPerUnit = float(terrainTexture->width()) / std::max( extent, 1e-3f );
+
+			std::size_t neededLevel = terrainTexture->level_count();
+			for( std::size_t v = 0; v < viewCount; ++v )
+			{
+				auto const& renderView = views[v];
+				if( !is_visible( renderView.frustum, terrainBounds ) )
+					continue;
+
+				float nearest = std::numeric_limits<float>::max();
+				if( geometry.chunks.empty() )
+					nearest = distance( terrainBounds, renderView.eye );
+				for( auto const& chunk : geometry.chunks )
+				{
+					if( is_visible( renderView.frustum, chunk.bounds ) )
+						nearest = std::min( nearest, distance( chunk.bounds, renderView.eye ) );
+				}
+
+				neededLevel = std::min( neededLevel, needed_mip_level( texelsPerUnit, nearest, renderView.pixelsPerUnit, terrainTexture->level_count() ) );
+			}
+
+			terrainTexture->update( neededLevel, elapsed.count() );
+		}
+		#endif
+
+		Mat44fGl const vehicleModelGl = to_gl( vehicleModelMatrix );
+		Aabb3f const vehicleBounds = transform_bounds( vehicleModelMatrix, vehicleGeometry.bounds );
 
 		// === Render a single view (shared for split and non-split) ===
-		auto render_view = [&]( RenderView const& renderView, bool measure )
+		auto render_view = [&]( RenderView const& renderView, MeshletCullStats& meshletStats, bool measure )
 		{
 			glViewport( renderView.viewport.x, renderView.viewport.y, renderView.viewport.width, renderView.viewport.height );
 
-			auto const viewGl = to_gl_matrix( renderView.view );
-			auto const projGl = to_gl_matrix( renderView.proj );
-
 		#ifdef ENABLE_MEASURE_PERF
 			if( measure )
 				task12::begin_terrain( app.gpuTimers );
@@ -1020,20 +1392,65 @@ int main() try
 				pointLights,
 				lightDirection
 			);
-			glUniformMatrix4fv( terrain.uModel, 1, GL_FALSE, modelGl.data() );
-			glUniformMatrix4fv( terrain.uView, 1, GL_FALSE, viewGl.data() );
-			glUniformMatrix4fv( terrain.uProj, 1, GL_FALSE, projGl.data() );
+			glUniformMatrix4fv( terrain.uModel, 1, GL_FALSE, modelMatrixGl.data() );
+			glUniformMatrix4fv( terrain.uView, 1, GL_FALSE, renderView.view.data() );
+			glUniformMatrix4fv( terrain.uProj, 1, GL_FALSE, renderView.proj.data() );
 			glUniform3f( terrain.uLightDir, lightDirection.x, lightDirection.y, lightDirection.z );
 			glUniform3f( terrain.uAmbient, ambientColor.x, ambientColor.y, ambientColor.z );
 			glUniform3f( terrain.uDiffuse, diffuseColor.x, diffuseColor.y, diffuseColor.z );
 			glUniform1i( terrain.uTexture, 0 );
+			upload_dequantization( terrain.dequant, geometry.format, geometry.positionQuant );
 
 			glActiveTexture( GL_TEXTURE0 );
 			glBindTexture( GL_TEXTURE_2D, terrain.textureId );
 
-			glBindVertexArray( geometry.vao );
-			glDrawArrays( GL_TRIANGLES, 0, geometry.vertexCount );
-			glBindVertexArray( 0 );
+			if( is_visible( renderView.frustum, terrainBounds ) )
+			{
+				glBindVertexArray( geometry.vao );
+				if( geometry.chunks.empty() )
+				{
+					glDrawElements( GL_TRIANGLES, geometry.indexCount, geometry.indexType, nullptr );
+				}
+				else
+				{
+					std::size_t const indexSize = GL_UNSIGNED_SHORT == geometry.indexType ? 2 : 4;
+
+					auto& stats = app.terrainLodStats;
+
+					drawCounts.clear();
+					drawOffsets.clear();
+					for( std::size_t c = 0; c < geometry.chunks.size(); ++c )
+					{
+						auto const& chunk = geometry.chunks[c];
+						if( !is_visible( renderView.frustum, chunk.bounds ) )
+							continue;
+
+						auto const levels = std::span( geometry.chunkLods ).subspan( c * geometry.lodLevels, geometry.lodLevels );
+						std::size_t const level = app.meshLod
+							? select_lod( levels, distance( chunk.bounds, renderView.eye ), renderView.pixelsPerUnit, kTerrainLodPixelError )
+							: 0
+						;
+						auto const& lod = levels[level];
+
+						if( app.meshletCulling && !geometry.meshlets.empty() )
+						{
+							append_visible_meshlets_( find_meshlets( geometry.meshlets, lod ), renderView.frustum, kIdentity34f, 1.f, renderView.eye, indexSize, meshletStats, drawCounts, drawOffsets );
+						}
+						else
+						{
+							drawCounts.emplace_back( static_cast<GLsizei>( lod.indexCount ) );
+							drawOffsets.emplace_back( reinterpret_cast<void const*>( std::uintptr_t(lod.firstIndex) * indexSize ) );
+						}
+
+						stats.triangles[level] += lod.indexCount / 3;
+						stats.fullDetailTriangles += chunk.indexCount / 3;
+					}
+
+					if( !drawCounts.empty() )
+						glMultiDrawElements( GL_TRIANGLES, drawCounts.data(), geometry.indexType, drawOffsets.data(), static_cast<GLsizei>( drawCounts.size() ) );
+				}
+				glBindVertexArray( 0 );
+			}
 
 		#ifdef ENABLE_MEASURE_PERF
 			if( measure )
@@ -1052,23 +1469,54 @@ int main() try
 				pointLights,
 				lightDirection
 			);
-			glUniformMatrix4fv( landingPad.uView, 1, GL_FALSE, viewGl.data() );
-			glUniformMatrix4fv( landingPad.uProj, 1, GL_FALSE, projGl.data() );
+			glUniformMatrix4fv( landingPad.uView, 1, GL_FALSE, renderView.view.data() );
+			glUniformMatrix4fv( landingPad.uProj, 1, GL_FALSE, renderView.proj.data() );
 			glUniform3f( landingPad.uLightDir, lightDirection.x, lightDirection.y, lightDirection.z );
 			glUniform3f( landingPad.uAmbient, ambientColor.x, ambientColor.y, ambientColor.z );
 			glUniform3f( landingPad.uDiffuse, diffuseColor.x, diffuseColor.y, diffuseColor.z );
+			upload_dequantization( landingPad.dequant, landingPadGeometry.format, landingPadGeometry.positionQuant );
 
 			glBindVertexArray( landingPadGeometry.vao );
-			for( auto const& padModel : landingPadModels )
+			for( std::size_t i = 0; i < landingPadModelsGl.size(); ++i )
 			{
-				auto const padModelGl = to_gl_matrix( padModel );
-				glUniformMatrix4fv( landingPad.uModel, 1, GL_FALSE, padModelGl.data() );
-				glDrawArrays( GL_TRIANGLES, 0, landingPadGeometry.vertexCount );
+				if( !is_visible( renderView.frustum, landingPadBounds[i] ) )
+					continue;
+
+				// The errors are in model units, which the pads scale.
+				auto const& lod = landingPadGeometry.lods[app.meshLod
+					? select_lod( landingPadGeometry.lods, distance( landingPadBounds[i], renderView.eye ), renderView.pixelsPerUnit * landingPadScale, kMeshLodPixelError )
+					: 0
+				];
+				std::size_t const indexSize = GL_UNSIGNED_SHORT == landingPadGeometry.indexType ? 2 : 4;
+
+				glUniformMatrix4fv( landingPad.uModel, 1, GL_FALSE, landingPadModelsGl[i].data() );
+				if( app.meshletCulling && !landingPadGeometry.meshlets.empty() )
+				{
+					drawCounts.clear();
+					drawOffsets.clear();
+					append_visible_meshlets_( find_meshlets( landingPadGeometry.meshlets, lod ), renderView.frustum, landingPadModels34[i], landingPadScale, transform_point( landingPadInverses[i], renderView.eye ), indexSize, meshletStats, drawCounts, drawOffsets );
+
+					if( !drawCounts.empty() )
+						glMultiDrawElements( GL_TRIANGLES, drawCounts.data(), landingPadGeometry.indexType, drawOffsets.data(), static_cast<GLsizei>( drawCounts.size() ) );
+				}
+				else
+				{
+					glDrawElements( GL_TRIANGLES, static_cast<GLsizei>( lod.indexCount ), landingPadGeometry.indexType, reinterpret_cast<void const*>( std::uintptr_t(lod.firstIndex) * indexSize ) );
+				}
 			}
 			glBindVertexArray( 0 );
 
 			// vehicle 作为 1.5 的一部分，计入 pads 计时
-			task5::render_vehicle( vehicleGeometry, vehicleModelMatrix, landingPad.uModel );
+			// The vehicle shares the landing pad shader, but not its format.
+			upload_dequantization( landingPad.dequant, VertexFormat::Full, kIdentityPositionQuantization );
+			if( is_visible( renderView.frustum, vehicleBounds ) )
+			{
+				std::size_t const vehicleLod = app.meshLod
+					? select_lod( vehicleGeometry.lods, distance( vehicleBounds, renderView.eye ), renderView.pixelsPerUnit, kMeshLodPixelError )
+					: 0
+				;
+				task5::render_vehicle( vehicleGeometry, vehicleModelGl, landingPad.uModel, vehicleLod );
+			}
 
 		#ifdef ENABLE_MEASURE_PERF
 			if( measure )
@@ -1083,7 +1531,7 @@ int main() try
 		for( std::size_t viewIndex = 0; viewIndex < viewCount; ++viewIndex )
 		{
 			bool const measure = (viewIndex == 0); // 只对第一个视图做详细计时
-			render_view( views[viewIndex], measure );
+			render_view( views[viewIndex], app.meshletStats[viewIndex], measure );
 		}
 
 		#ifdef ENABLE_MEASURE_PERF
@@ -1162,7 +1610,7 @@ int main() try
 		draw_button( btnReset, "Reset", hoverReset, pressedReset );
 
 		// UI draw: first solid (no texture), then text (atlas)
-		Mat44f uiProj = make_ortho( 0.f, static_cast<float>( app.windowWidth ), static_cast<float>( app.windowHeight ), 0.f );
+		Mat44fGl const uiProj = to_gl( make_ortho( 0.f, static_cast<float>( app.windowWidth ), static_cast<float>( app.windowHeight ), 0.f ) );
 		ui_flush( app.uiPipeline, app.uiRenderer, uiProj, 0, false ); // solid rects
 		ui_flush( app.uiPipeline, app.uiRenderer, uiProj, app.uiFont.textureId, true ); // text
 
@@ -1181,8 +1629,7 @@ int main() try
 				task7::reset( app.animation );
 				// 也清理粒子
 				destroy_particle_system( app.particles );
-				init_particle_system( app.particles );
-				app.particles.textureId = create_particle_texture();
+				init_particle_system( app.particles, gpuCache );
 			}
 		}
 
@@ -1210,6 +1657,45 @@ int main() try
 						app.perfTimings.cpuFrameMs,
 						app.perfTimings.cpuSubmitMs
 					);
+
+					auto const& lodStats = app.terrainLodStats;
+					std::uint64_t submitted = 0;
+					std::print( "Terrain LOD{}: triangles per level =", app.meshLod ? "" : " (off)" );
+					for( std::size_t level = 0; level < geometry.lodLevels; ++level )
+					{
+						std::print( " {}", lodStats.triangles[level] );
+						submitted += lodStats.triangles[level];
+					}
+					std::print( " | {} of {} at full detail ({:.1f}%)\n",
+						submitted,
+						lodStats.fullDetailTriangles,
+						lodStats.fullDetailTriangles ? 100.0 * double(submitted) / double(lodStats.fullDetailTriangles) : 100.0
+					);
+
+					for( std::size_t v = 0; v < viewCount; ++v )
+					{
+						auto const& cull = app.meshletStats[v];
+						std::print( "Meshlets{} (view {}): {} of {} kept, {} of {} triangles\n",
+							app.meshletCulling ? "" : " (off)", v,
+							cull.visibleMeshlets, cull.meshlets,
+							cull.visibleTriangles, cull.triangles
+						);
+					}
+
+					print_gpu_cache_stats( gpuCache );
+
+					if( terrainTexture )
+					{
+						auto const texStats = terrainTexture->stats();
+						std::print( "Terrain texture: level {} of {} resident ({:.1f} MiB), level {} requested ({:.1f} MiB), budget {:.1f} MiB (level {})\n",
+							texStats.residentLevel, texStats.levelCount,
+							double(texStats.residentBytes) / (1024.0 * 1024.0),
+							texStats.requestedLevel,
+							double(texStats.requestedBytes) / (1024.0 * 1024.0),
+							double(texStats.budgetBytes) / (1024.0 * 1024.0),
+							texStats.budgetLevel
+						);
+					}
 				}
 			}
 		#endif
@@ -1225,11 +1711,9 @@ int main() try
 	#ifdef ENABLE_MEASURE_PERF
 		task12::shutdown( app.gpuTimers );
 	#endif
-	if( terrain.textureId )
-	{
-		glDeleteTextures( 1, &terrain.textureId );
-		terrain.textureId = 0;
-	}
+	terrainTexture.reset();
+	terrainTextureFile.reset();
+	terrain.textureId = 0;
 
 	return 0;
 }
@@ -1333,6 +1817,18 @@ namespace
 				if( aAction == GLFW_PRESS )
 					app->splitScreen.enabled = !app->splitScreen.enabled;
 				break;
+			case GLFW_KEY_P:
+				if( aAction == GLFW_PRESS )
+					app->meshFormat = VertexFormat::Full == app->meshFormat ? VertexFormat::Packed : VertexFormat::Full;
+				break;
+			case GLFW_KEY_L:
+				if( aAction == GLFW_PRESS )
+					app->meshLod = !app->meshLod;
+				break;
+			case GLFW_KEY_M:
+				if( aAction == GLFW_PRESS )
+					app->meshletCulling = !app->meshletCulling;
+				break;
 			default:
 				break;
 		}
@@ -1420,140 +1916,311 @@ namespace
 	}
 
 	// === Geometry loading / destruction (terrain & landing pad) ===
-	SceneGeometry load_parlahti_mesh( std::filesystem::path const& objPath )
+	enum class MeshOrigin_
 	{
-		auto const resultPath = objPath.lexically_normal();
-		auto result = rapidobj::ParseFile( resultPath );
-		if( result.error )
-			throw Error( "Failed to load '{}': {} at line {}", resultPath.string(), result.error.code.message(), result.error.line_num );
-		if( !rapidobj::Triangulate( result ) )
-			throw Error( "Triangulation failed for '{}'", resultPath.string() );
+		Obj,
+		MeshCache,
+		AssetPack
+	};
 
-		SceneGeometry geometry{};
-		Vec3f minBounds{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
-		Vec3f maxBounds{ std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+	void report_mesh_load_( std::filesystem::path const& path, MeshCacheInfo const& info, std::size_t vertexSize, MeshOrigin_ origin, Clock::time_point start )
+	{
+		bool const fromCache = MeshOrigin_::Obj != origin;
 
-		std::size_t totalIndices = 0;
-		for( auto const& shape : result.shapes )
-			totalIndices += shape.mesh.indices.size();
+		double const ms = std::chrono::duration<double, std::milli>( Clock::now() - start ).count();
 
-		std::vector<VertexPNT> vertices;
-		vertices.reserve( totalIndices );
+		// "Unindexed" is the triangle soup, with one vertex per corner.
+		double const kMiB = 1024.0 * 1024.0;
+		double const soupMiB = double(info.indexCount * vertexSize) / kMiB;
+		double const indexedMiB = double(info.vertexCount * vertexSize + info.indexCount * info.indexSize) / kMiB;
 
-		auto const fetch_position = [&]( int index ) -> Vec3f
-		{
-			std::size_t const base = static_cast<std::size_t>( index ) * 3;
-			return Vec3f{
-				result.attributes.positions[base + 0],
-				result.attributes.positions[base + 1],
-				result.attributes.positions[base + 2]
-			};
-		};
-		auto const fetch_normal = [&]( int index ) -> Vec3f
+		std::print( "Loaded '{}' in {:.1f} ms ({}): {} vertices, {} {}-bit indices, {:.2f} MiB (unindexed: {} vertices, {:.2f} MiB)\n",
+			path.string(), ms, MeshOrigin_::AssetPack == origin ? "warm, from asset pack" : fromCache ? "warm, from mesh cache" : "cold, parsed OBJ",
+			info.vertexCount, info.indexCount, info.indexSize * 8, indexedMiB,
+			info.indexCount, soupMiB
+		);
+
+		#ifdef ENABLE_MEASURE_PERF
+		// The peak covers the whole process, so it is attributable to this
+		// load only if the load set it (see support/process_memory.hpp).
+		std::error_code ec;
+		auto const fileBytes = std::filesystem::file_size( path, ec );
+		if( !fromCache && !ec && fileBytes )
 		{
-			std::size_t const base = static_cast<std::size_t>( index ) * 3;
-			return Vec3f{
-				result.attributes.normals[base + 0],
-				result.attributes.normals[base + 1],
-				result.attributes.normals[base + 2]
-			};
-		};
+			double const peakMiB = double(peak_resident_bytes()) / kMiB;
+			std::print( "  Peak RSS so far {:.1f} MiB, {:.2f}x the OBJ ({:.1f} MiB)\n", peakMiB, peakMiB / (double(fileBytes) / kMiB), double(fileBytes) / kMiB );
+		}
+		#endif
+	}
+
+	// Packs the attributes of a full vertex into its packed format (see
+	// vmlib/quantize.hpp). Attributes that the packed format does not have
+	// are dropped.
+	template< class tVertex >
+	auto pack_vertex_( tVertex const& vertex, PositionQuantization const& positionQuant ) noexcept
+	{
+		using Packed_ = typename VertexTraits<tVertex>::Packed;
+		using Full_ = typename VertexTraits<tVertex>::Layout;
+		using Layout_ = typename VertexTraits<Packed_>::Layout;
 
-		auto const fetch_texcoord = [&]( int index ) -> Vec2f
+		Packed_ ret{};
+		if constexpr( has_attribute_v<Layout_, VertexSemantic::Position> )
 		{
-			std::size_t const base = static_cast<std::size_t>( index ) * 2;
-			return Vec2f{
-				result.attributes.texcoords[base + 0],
-				result.attributes.texcoords[base + 1]
-			};
-		};
+			auto const position = quantize_position( positionQuant, vertex.*attribute_member_v<Full_, VertexSemantic::Position> );
+			auto& out = ret.*attribute_member_v<Layout_, VertexSemantic::Position>;
+			out[0] = position[0];
+			out[1] = position[1];
+			out[2] = position[2];
+		}
+		if constexpr( has_attribute_v<Layout_, VertexSemantic::Normal> )
+		{
+			auto const normal = quantize_normal( vertex.*attribute_member_v<Full_, VertexSemantic::Normal> );
+			auto& out = ret.*attribute_member_v<Layout_, VertexSemantic::Normal>;
+			out[0] = normal[0];
+			out[1] = normal[1];
+		}
+		if constexpr( has_attribute_v<Layout_, VertexSemantic::TexCoord> )
+		{
+			Vec2f const texCoord = vertex.*attribute_member_v<Full_, VertexSemantic::TexCoord>;
+			auto& out = ret.*attribute_member_v<Layout_, VertexSemantic::TexCoord>;
+			out[0] = float_to_half( texCoord.x );
+			out[1] = float_to_half( texCoord.y );
+		}
+		if constexpr( has_attribute_v<Layout_, VertexSemantic::Color> )
+		{
+			Vec3f const color = vertex.*attribute_member_v<Full_, VertexSemantic::Color>;
+			auto& out = ret.*attribute_member_v<Layout_, VertexSemantic::Color>;
+			out[0] = quantize_unorm8( color.x );
+			out[1] = quantize_unorm8( color.y );
+			out[2] = quantize_unorm8( color.z );
+			out[3] = 255;
+		}
+		return ret;
+	}
+
+	// Packs the vertices with pack_vertex_() and uploads them to the bound
+	// GL_ARRAY_BUFFER, kUploadSliceVertices at a time, so that the packed
+	// copy never exists as a whole. Reports the memory saved and the cost of
+	// packing.
+	template< class tVertex >
+	void upload_packed_vertices_( std::span<tVertex const> vertices, PositionQuantization const& positionQuant )
+	{
+		using Packed_ = typename VertexTraits<tVertex>::Packed;
+
+		glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( vertices.size() * sizeof( Packed_ ) ), nullptr, GL_STATIC_DRAW );
 
-		for( auto const& shape : result.shapes )
+		double ms = 0.0;
+		std::vector<Packed_> packed( std::min( vertices.size(), kUploadSliceVertices ) );
+		for( std::size_t first = 0; first < vertices.size(); first += kUploadSliceVertices )
 		{
-			auto const& mesh = shape.mesh;
-			std::size_t indexOffset = 0;
+			std::size_t const count = std::min( kUploadSliceVertices, vertices.size() - first );
 
-			for( auto const faceVertices : mesh.num_face_vertices )
-			{
-				if( faceVertices != 3 )
-				{
-					indexOffset += faceVertices;
-					continue;
-				}
+			auto const start = Clock::now();
+			for( std::size_t i = 0; i < count; ++i )
+				packed[i] = pack_vertex_( vertices[first + i], positionQuant );
+			ms += std::chrono::duration<double, std::milli>( Clock::now() - start ).count();
 
-				std::array<rapidobj::Index, 3> faceIndices{};
-				std::array<Vec3f, 3> positions{};
-				std::array<Vec3f, 3> normals{};
-				bool hasPerVertexNormals = !result.attributes.normals.empty();
-				bool hasTexCoordData = !result.attributes.texcoords.empty();
-				std::array<Vec2f, 3> texcoords{};
+			glBufferSubData( GL_ARRAY_BUFFER, static_cast<GLintptr>( first * sizeof( Packed_ ) ), static_cast<GLsizeiptr>( count * sizeof( Packed_ ) ), packed.data() );
+		}
 
-				for( std::size_t v = 0; v < 3; ++v )
-				{
-					faceIndices[v] = mesh.indices[indexOffset++];
-					positions[v] = fetch_position( faceIndices[v].position_index );
-					if( hasPerVertexNormals && faceIndices[v].normal_index >= 0 )
-						normals[v] = fetch_normal( faceIndices[v].normal_index );
-					else
-						hasPerVertexNormals = false;
+		double const kMiB = 1024.0 * 1024.0;
+		std::print( "  Packed vertices: {} -> {} bytes each, {:.2f} MiB saved, encoded in {:.2f} ms\n",
+			sizeof( tVertex ), sizeof( Packed_ ),
+			double(vertices.size() * (sizeof( tVertex ) - sizeof( Packed_ ))) / kMiB,
+			ms
+		);
+	}
 
-					if( hasTexCoordData && faceIndices[v].texcoord_index >= 0 )
-						texcoords[v] = fetch_texcoord( faceIndices[v].texcoord_index );
-				}
+	template< class tVertex >
+	void upload_full_vertices_( std::span<tVertex const> vertices )
+	{
+		glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( vertices.size_bytes() ), vertices.data(), GL_STATIC_DRAW );
+	}
+
+	// Fills the bound GL_ARRAY_BUFFER with vertices in the full or packed
+	// format, and declares that format's attributes for the bound VAO.
+	// positionQuant is set for the packed format.
+	template< class tVertex >
+	void upload_vertices_( std::span<tVertex const> vertices, MeshCacheInfo const& info, VertexFormat format, PositionQuantization& positionQuant )
+	{
+		using Packed_ = typename VertexTraits<tVertex>::Packed;
+
+		if( VertexFormat::Packed == format )
+		{
+			positionQuant = make_position_quantization( info.bounds );
+			upload_packed_vertices_( vertices, positionQuant );
+			declare_vertex_attributes<typename VertexTraits<Packed_>::Layout>();
+		}
+		else
+		{
+			upload_full_vertices_( vertices );
+			declare_vertex_attributes<typename VertexTraits<tVertex>::Layout>();
+		}
+	}
 
-				Vec3f const edgeA = positions[1] - positions[0];
-				Vec3f const edgeB = positions[2] - positions[0];
-				Vec3f faceNormal = safe_normalize( cross( edgeA, edgeB ) );
+	// Loads the mesh from resultPath as an indexed mesh of tVertex: from the
+	// asset pack or the mesh cache if possible, and otherwise by building it
+	// from the OBJ as the layout asks (see build_mesh() in mesh_build.hpp).
+	template< class tVertex >
+	PreparedMesh<tVertex> prepare_indexed_mesh_( std::filesystem::path const& resultPath, AssetPack const& pack, MeshLayout const& layout )
+	{
+		constexpr std::uint32_t kCacheFormat = VertexTraits<tVertex>::kCacheFormat;
 
-				for( std::size_t v = 0; v < 3; ++v )
-				{
-					VertexPNT vertex{};
-					vertex.position = positions[v];
-					vertex.normal = hasPerVertexNormals ? safe_normalize( normals[v], faceNormal ) : faceNormal;
-					vertex.texCoord = (hasTexCoordData && faceIndices[v].texcoord_index >= 0) ? texcoords[v] : Vec2f{ 0.f, 0.f };
-					vertices.emplace_back( vertex );
-
-					minBounds.x = std::min( minBounds.x, vertex.position.x );
-					minBounds.y = std::min( minBounds.y, vertex.position.y );
-					minBounds.z = std::min( minBounds.z, vertex.position.z );
-					maxBounds.x = std::max( maxBounds.x, vertex.position.x );
-					maxBounds.y = std::max( maxBounds.y, vertex.position.y );
-					maxBounds.z = std::max( maxBounds.z, vertex.position.z );
-				}
+		auto const loadStart = Clock::now();
+
+		PreparedMesh<tVertex> ret;
+		auto& mesh = ret.mesh;
+		MeshOrigin_ origin = MeshOrigin_::Obj;
+
+		if( auto const entry = pack.find( resultPath, AssetKind::Mesh ); !entry.empty() )
+		{
+			mesh = parse_mesh_data( entry, kCacheFormat, sizeof( tVertex ) );
+			origin = MeshOrigin_::AssetPack;
+		}
+
+		#ifdef ENABLE_MESH_CACHE
+		if( !mesh )
+		{
+			ret.cached = open_mesh_cache( resultPath, kCacheFormat, sizeof( tVertex ) );
+			if( ret.cached )
+			{
+				mesh = *ret.cached;
+				origin = MeshOrigin_::MeshCache;
 			}
 		}
+		#endif
 
-		if( vertices.empty() )
-			throw Error( "OBJ '{}' did not contain triangles", resultPath.string() );
+		if( !mesh )
+		{
+			auto& built = ret.built;
 
-		geometry.minBounds = minBounds;
-		geometry.maxBounds = maxBounds;
-		geometry.center = Vec3f{
-			(minBounds.x + maxBounds.x) * 0.5f,
-			(minBounds.y + maxBounds.y) * 0.5f,
-			(minBounds.z + maxBounds.z) * 0.5f
-		};
-		Vec3f const diagonal = maxBounds - minBounds;
-		geometry.radius = 0.5f * length( diagonal );
+			#ifdef ENABLE_MEASURE_PERF
+			built = build_mesh<tVertex>( resultPath, layout, true );
+			#else
+			built = build_mesh<tVertex>( resultPath, layout );
+			#endif
 
-		glGenVertexArrays( 1, &geometry.vao );
-		glGenBuffers( 1, &geometry.vbo );
+			mesh = MeshData{ built.info, built.chunks, built.chunkLods, built.lodLevels, built.meshlets, built.vertex_bytes(), built.index_bytes() };
+			origin = MeshOrigin_::Obj;
 
-		glBindVertexArray( geometry.vao );
-		glBindBuffer( GL_ARRAY_BUFFER, geometry.vbo );
-		glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( vertices.size() * sizeof( VertexPNT ) ), vertices.data(), GL_STATIC_DRAW );
+			#ifdef ENABLE_MESH_CACHE
+			write_mesh_cache( resultPath, kCacheFormat, sizeof( tVertex ), mesh->vertices, mesh->indices, mesh->chunks, mesh->chunkLods, mesh->meshlets, mesh->info );
+			#endif
+		}
 
-		glEnableVertexAttribArray( 0 );
-		glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, sizeof( VertexPNT ), reinterpret_cast<void*>( offsetof( VertexPNT, position ) ) );
-		glEnableVertexAttribArray( 1 );
-		glVertexAttribPointer( 1, 3, GL_FLOAT, GL_FALSE, sizeof( VertexPNT ), reinterpret_cast<void*>( offsetof( VertexPNT, normal ) ) );
-		glEnableVertexAttribArray( 2 );
-		glVertexAttribPointer( 2, 2, GL_FLOAT, GL_FALSE, sizeof( VertexPNT ), reinterpret_cast<void*>( offsetof( VertexPNT, texCoord ) ) );
+		report_mesh_load_( resultPath, mesh->info, sizeof( tVertex ), origin, loadStart );
+		if( !mesh->meshlets.empty() )
+			std::print( "  {} meshlets, {:.1f} triangles each on average\n", mesh->meshlets.size(), double(mesh->info.indexCount) / 3.0 / double(mesh->meshlets.size()) );
+
+		return ret;
+	}
+
+	// Creates the VAO, VBO and EBO of a prepared mesh, and uploads the
+	// vertices in the given format with upload_vertices_().
+	struct LoadedMesh_
+	{
+		MeshCacheInfo info;
+		std::vector<MeshChunk> chunks;
+		std::vector<MeshLod> chunkLods;
+		std::size_t lodLevels;
+		std::vector<Meshlet> meshlets;
+	};
+
+	template< class tVertex >
+	LoadedMesh_ upload_indexed_mesh_( PreparedMesh<tVertex> const& prepared, VertexFormat format, PositionQuantization& positionQuant, GLuint& vao, GLuint& vbo, GLuint& ebo )
+	{
+		auto const& mesh = prepared.mesh;
+		auto const& info = mesh->info;
+
+		glGenVertexArrays( 1, &vao );
+		glGenBuffers( 1, &vbo );
+		glGenBuffers( 1, &ebo );
+
+		glBindVertexArray( vao );
+		glBindBuffer( GL_ARRAY_BUFFER, vbo );
+
+		// Vertex data in the cache and the pack follows a fixed-size header
+		// in a page-aligned mapping, so it is suitably aligned for tVertex.
+		assert( mesh->vertices.size() == info.vertexCount * sizeof( tVertex ) );
+		upload_vertices_( std::span( reinterpret_cast<tVertex const*>( mesh->vertices.data() ), info.vertexCount ), info, format, positionQuant );
+
+		// The element buffer binding is part of the VAO's state; it must stay
+		// bound until the VAO is unbound.
+		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ebo );
+		glBufferData( GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>( mesh->indices.size() ), mesh->indices.data(), GL_STATIC_DRAW );
 
 		glBindVertexArray( 0 );
 		glBindBuffer( GL_ARRAY_BUFFER, 0 );
 
-		geometry.vertexCount = static_cast<GLsizei>( vertices.size() );
+		return LoadedMesh_{
+			info,
+			std::vector<MeshChunk>( mesh->chunks.begin(), mesh->chunks.end() ),
+			std::vector<MeshLod>( mesh->chunkLods.begin(), mesh->chunkLods.end() ),
+			mesh->lodLevels,
+			std::vector<Meshlet>( mesh->meshlets.begin(), mesh->meshlets.end() )
+		};
+	}
+
+	GLenum index_type( MeshCacheInfo const& info ) noexcept
+	{
+		return 2 == info.indexSize ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	}
+
+	PreparedMesh<VertexPNT> prepare_parlahti_mesh( std::filesystem::path const& objPath, AssetPack const& pack )
+	{
+		return prepare_indexed_mesh_<VertexPNT>( objPath.lexically_normal(), pack, kTerrainMeshLayout );
+	}
+
+	SceneGeometry load_parlahti_mesh( std::filesystem::path const& objPath, AssetPack const& pack, VertexFormat format )
+	{
+		return upload_parlahti_mesh( prepare_parlahti_mesh( objPath, pack ), format );
+	}
+
+	SceneGeometry upload_parlahti_mesh( PreparedMesh<VertexPNT> const& mesh, VertexFormat format )
+	{
+		SceneGeometry geometry{};
+		geometry.format = format;
+
+		auto loaded = upload_indexed_mesh_( mesh, format, geometry.positionQuant, geometry.vao, geometry.vbo, geometry.ebo );
+
+		auto const& info = loaded.info;
+		geometry.vertexCount = static_cast<GLsizei>( info.vertexCount );
+		geometry.indexCount = static_cast<GLsizei>( info.indexCount );
+		geometry.indexType = index_type( info );
+		geometry.minBounds = info.bounds.min;
+		geometry.maxBounds = info.bounds.max;
+		geometry.center = info.center;
+		geometry.radius = info.radius;
+		geometry.chunks = std::move(loaded.chunks);
+		geometry.chunkLods = std::move(loaded.chunkLods);
+		geometry.lodLevels = loaded.lodLevels;
+		geometry.meshlets = std::move(loaded.meshlets);
+
+		if( !geometry.chunks.empty() )
+		{
+			auto const [smallest, largest] = std::minmax_element( geometry.chunks.begin(), geometry.chunks.end(), [] ( MeshChunk const& a, MeshChunk const& b ) {
+				return a.indexCount < b.indexCount;
+			} );
+			std::print( "  {} chunks, {} to {} triangles each\n", geometry.chunks.size(), smallest->indexCount / 3, largest->indexCount / 3 );
+
+			// The index buffer also holds the coarser levels; the full mesh
+			// is what the chunks cover.
+			geometry.indexCount = static_cast<GLsizei>( geometry.chunks.back().firstIndex + geometry.chunks.back().indexCount );
+
+			for( std::size_t level = 0; level < geometry.lodLevels; ++level )
+			{
+				std::uint64_t triangles = 0;
+				float error = 0.f;
+				for( std::size_t c = 0; c < geometry.chunks.size(); ++c )
+				{
+					auto const& lod = geometry.chunkLods[c * geometry.lodLevels + level];
+					triangles += lod.indexCount / 3;
+					error = std::max( error, lod.error );
+				}
+				std::print( "  LOD {}: {} triangles, error up to {:.2f}\n", level, triangles, error );
+			}
+		}
+
 		return geometry;
 	}
 
@@ -1564,131 +2231,54 @@ namespace
 			glDeleteBuffers( 1, &geometry.vbo );
 			geometry.vbo = 0;
 		}
+		if( geometry.ebo )
+		{
+			glDeleteBuffers( 1, &geometry.ebo );
+			geometry.ebo = 0;
+		}
 		if( geometry.vao )
 		{
 			glDeleteVertexArrays( 1, &geometry.vao );
 			geometry.vao = 0;
 		}
 		geometry.vertexCount = 0;
+		geometry.indexCount = 0;
+		geometry.chunks.clear();
+		geometry.chunkLods.clear();
+		geometry.lodLevels = 0;
 	}
 
-	LandingPadGeometry load_landingpad_mesh( std::filesystem::path const& objPath )
+	PreparedMesh<VertexPNC> prepare_landingpad_mesh( std::filesystem::path const& objPath, AssetPack const& pack )
 	{
-		auto const resultPath = objPath.lexically_normal();
-		auto result = rapidobj::ParseFile( resultPath );
-		if( result.error )
-			throw Error( "Failed to load '{}': {} at line {}", resultPath.string(), result.error.code.message(), result.error.line_num );
-		if( !rapidobj::Triangulate( result ) )
-			throw Error( "Triangulation failed for '{}'", resultPath.string() );
-
-		LandingPadGeometry geometry{};
-
-		std::size_t totalIndices = 0;
-		for( auto const& shape : result.shapes )
-			totalIndices += shape.mesh.indices.size();
-
-		std::vector<VertexPNC> vertices;
-		vertices.reserve( totalIndices );
-
-		auto const fetch_position = [&]( int index ) -> Vec3f
-		{
-			std::size_t const base = static_cast<std::size_t>( index ) * 3;
-			return Vec3f{
-				result.attributes.positions[base + 0],
-				result.attributes.positions[base + 1],
-				result.attributes.positions[base + 2]
-			};
-		};
-		auto const fetch_normal = [&]( int index ) -> Vec3f
-		{
-			std::size_t const base = static_cast<std::size_t>( index ) * 3;
-			return Vec3f{
-				result.attributes.normals[base + 0],
-				result.attributes.normals[base + 1],
-				result.attributes.normals[base + 2]
-			};
-		};
-		auto const fetch_color = [&]( int materialIndex ) -> Vec3f
-		{
-			if( materialIndex >= 0 && static_cast<std::size_t>( materialIndex ) < result.materials.size() )
-			{
-				auto const& mat = result.materials[static_cast<std::size_t>( materialIndex )];
-				return Vec3f{ mat.diffuse[0], mat.diffuse[1], mat.diffuse[2] };
-			}
-			return Vec3f{ 0.7f, 0.7f, 0.7f };
-		};
-
-		for( auto const& shape : result.shapes )
-		{
-			auto const& mesh = shape.mesh;
-			std::size_t indexOffset = 0;
-			std::size_t faceIndex = 0;
-
-			for( auto const faceVertices : mesh.num_face_vertices )
-			{
-				if( faceVertices != 3 )
-				{
-					indexOffset += faceVertices;
-					++faceIndex;
-					continue;
-				}
-
-				std::array<rapidobj::Index, 3> faceIndices{};
-				std::array<Vec3f, 3> positions{};
-				std::array<Vec3f, 3> normals{};
-				bool hasPerVertexNormals = !result.attributes.normals.empty();
-
-				for( std::size_t v = 0; v < 3; ++v )
-				{
-					faceIndices[v] = mesh.indices[indexOffset++];
-					positions[v] = fetch_position( faceIndices[v].position_index );
-					if( hasPerVertexNormals && faceIndices[v].normal_index >= 0 )
-						normals[v] = fetch_normal( faceIndices[v].normal_index );
-					else
-						hasPerVertexNormals = false;
-				}
-
-				Vec3f const edgeA = positions[1] - positions[0];
-				Vec3f const edgeB = positions[2] - positions[0];
-				Vec3f faceNormal = safe_normalize( cross( edgeA, edgeB ) );
-				Vec3f const diffuseColor = (!mesh.material_ids.empty() && faceIndex < mesh.material_ids.size())
-					? fetch_color( mesh.material_ids[faceIndex] )
-					: fetch_color( -1 );
-
-				for( std::size_t v = 0; v < 3; ++v )
-				{
-					VertexPNC vertex{};
-					vertex.position = positions[v];
-					vertex.normal = hasPerVertexNormals ? safe_normalize( normals[v], faceNormal ) : faceNormal;
-					vertex.color = diffuseColor;
-					vertices.emplace_back( vertex );
-				}
-
-				++faceIndex;
-			}
-		}
+		return prepare_indexed_mesh_<VertexPNC>( objPath.lexically_normal(), pack, kLandingPadMeshLayout );
+	}
 
-		if( vertices.empty() )
-			throw Error( "OBJ '{}' did not contain triangles", resultPath.string() );
+	LandingPadGeometry load_landingpad_mesh( std::filesystem::path const& objPath, AssetPack const& pack, VertexFormat format )
+	{
+		return upload_landingpad_mesh( prepare_landingpad_mesh( objPath, pack ), format );
+	}
 
-		glGenVertexArrays( 1, &geometry.vao );
-		glGenBuffers( 1, &geometry.vbo );
+	LandingPadGeometry upload_landingpad_mesh( PreparedMesh<VertexPNC> const& mesh, VertexFormat format )
+	{
+		LandingPadGeometry geometry{};
+		geometry.format = format;
 
-		glBindVertexArray( geometry.vao );
-		glBindBuffer( GL_ARRAY_BUFFER, geometry.vbo );
-		glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( vertices.size() * sizeof( VertexPNC ) ), vertices.data(), GL_STATIC_DRAW );
+		auto loaded = upload_indexed_mesh_( mesh, format, geometry.positionQuant, geometry.vao, geometry.vbo, geometry.ebo );
 
-		glEnableVertexAttribArray( 0 );
-		glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, sizeof( VertexPNC ), reinterpret_cast<void*>( offsetof( VertexPNC, position ) ) );
-		glEnableVertexAttribArray( 1 );
-		glVertexAttribPointer( 1, 3, GL_FLOAT, GL_FALSE, sizeof( VertexPNC ), reinterpret_cast<void*>( offsetof( VertexPNC, normal ) ) );
-		glEnableVertexAttribArray( 2 );
-		glVertexAttribPointer( 2, 3, GL_FLOAT, GL_FALSE, sizeof( VertexPNC ), reinterpret_cast<void*>( offsetof( VertexPNC, color ) ) );
+		auto const& info = loaded.info;
+		geometry.vertexCount = static_cast<GLsizei>( info.vertexCount );
+		geometry.indexType = index_type( info );
+		geometry.bounds = info.bounds;
+		geometry.lods = std::move(loaded.chunkLods);
+		geometry.meshlets = std::move(loaded.meshlets);
+		if( geometry.lods.empty() )
+			geometry.lods.emplace_back( MeshLod{ 0, static_cast<std::uint32_t>( info.indexCount ), 0.f } );
 
-		glBindVertexArray( 0 );
-		glBindBuffer( GL_ARRAY_BUFFER, 0 );
+		// The index buffer also holds the simplified levels.
+		geometry.indexCount = static_cast<GLsizei>( geometry.lods[0].indexCount );
+		for( std::size_t level = 0; level < geometry.lods.size(); ++level )
+			std::print( "  LOD {}: {} triangles, error {:.4f}\n", level, geometry.lods[level].indexCount / 3, geometry.lods[level].error );
 
-		geometry.vertexCount = static_cast<GLsizei>( vertices.size() );
 		return geometry;
 	}
 
@@ -1699,42 +2289,129 @@ namespace
 			glDeleteBuffers( 1, &geometry.vbo );
 			geometry.vbo = 0;
 		}
+		if( geometry.ebo )
+		{
+			glDeleteBuffers( 1, &geometry.ebo );
+			geometry.ebo = 0;
+		}
 		if( geometry.vao )
 		{
 			glDeleteVertexArrays( 1, &geometry.vao );
 			geometry.vao = 0;
 		}
 		geometry.vertexCount = 0;
+		geometry.indexCount = 0;
 	}
 
-	GLuint load_texture_2d( std::filesystem::path const& imagePath )
+	DequantizationUniforms get_dequantization_uniforms( GLuint programId )
 	{
-		auto const normalizedPath = imagePath.lexically_normal();
-		int width = 0;
-		int height = 0;
-		int channels = 0;
+		DequantizationUniforms ret{};
+		ret.uPositionScale = glGetUniformLocation( programId, "uPositionScale" );
+		ret.uPositionOffset = glGetUniformLocation( programId, "uPositionOffset" );
+		ret.uOctNormals = glGetUniformLocation( programId, "uOctNormals" );
+		return ret;
+	}
+
+	// Positions are decoded as aPosition * uPositionScale + uPositionOffset
+	// in the vertex shader, which is the identity for the full format.
+	// Packed normals are octahedral-encoded in aNormal.xy.
+	void upload_dequantization( DequantizationUniforms const& uniforms, VertexFormat format, PositionQuantization const& positionQuant )
+	{
+		glUniform3f( uniforms.uPositionScale, positionQuant.scale.x, positionQuant.scale.y, positionQuant.scale.z );
+		glUniform3f( uniforms.uPositionOffset, positionQuant.offset.x, positionQuant.offset.y, positionQuant.offset.z );
+		glUniform1i( uniforms.uOctNormals, VertexFormat::Packed == format ? 1 : 0 );
+	}
 
-		stbi_set_flip_vertically_on_load( true );
-		stbi_uc* pixels = stbi_load( normalizedPath.string().c_str(), &width, &height, &channels, STBI_rgb_alpha );
-		if( !pixels )
+	// Appends the draw ranges of those meshlets that are in the frustum and
+	// not backfacing, for glMultiDrawElements(); neighbouring survivors share
+	// a range. The meshlets are in model space. model must be made of a
+	// rotation, a uniform scale by scale and a translation; eye is the camera
+	// position in model space.
+	void append_visible_meshlets_( std::span<Meshlet const> meshlets, Frustum const& frustum, Mat34f const& model, float scale, Vec3f eye, std::size_t indexSize, MeshletCullStats& stats, std::vector<GLsizei>& counts, std::vector<void const*>& offsets )
+	{
+		std::uintptr_t rangeEnd = ~std::uintptr_t(0);
+		for( auto const& meshlet : meshlets )
 		{
-			char const* reason = stbi_failure_reason();
-			throw Error( "Failed to load texture '{}': {}", normalizedPath.string(), reason ? reason : "unknown error" );
+			++stats.meshlets;
+			stats.triangles += meshlet.indexCount / 3;
+
+			if( !is_visible( frustum, transform_point( model, meshlet.center ), meshlet.radius * scale ) )
+				continue;
+			if( is_backfacing( meshlet, eye ) )
+				continue;
+
+			++stats.visibleMeshlets;
+			stats.visibleTriangles += meshlet.indexCount / 3;
+
+			std::uintptr_t const begin = std::uintptr_t(meshlet.firstIndex) * indexSize;
+			if( begin == rangeEnd )
+				counts.back() += static_cast<GLsizei>( meshlet.indexCount );
+			else
+			{
+				counts.emplace_back( static_cast<GLsizei>( meshlet.indexCount ) );
+				offsets.emplace_back( reinterpret_cast<void const*>( begin ) );
+			}
+			rangeEnd = begin + std::uintptr_t(meshlet.indexCount) * indexSize;
 		}
+	}
+
+	// Textures from the asset pack come with all their mip levels (see
+	// vmlib/mipmap.hpp), possibly block-compressed (see
+	// vmlib/block_compression.hpp); others are decoded here and get their
+	// mip levels from glGenerateMipmap().
+	PreparedTexture prepare_texture_2d( std::filesystem::path const& imagePath, AssetPack const& pack )
+	{
+		auto const normalizedPath = imagePath.lexically_normal();
+
+		PreparedTexture ret{};
+		ret.packed = parse_pack_texture( pack.find( normalizedPath, AssetKind::Texture ) );
+
+		// Decoded on several threads if it can be (see image_decode.hpp).
+		if( !ret.packed )
+			ret.image = decode_image_rgba8( normalizedPath, true );
+
+		return ret;
+	}
+
+	GLuint upload_texture_2d( PreparedTexture const& prepared, std::filesystem::path const& imagePath )
+	{
+		auto const normalizedPath = imagePath.lexically_normal();
 
-		if( width <= 0 || height <= 0 )
+		if( auto const& packed = prepared.packed )
 		{
-			stbi_image_free( pixels );
-			throw Error( "Texture '{}' reported invalid size {}x{}", normalizedPath.string(), width, height );
+			auto const format = texture_upload_format( packed->format );
+
+			GLuint texture = 0;
+			glGenTextures( 1, &texture );
+			if( texture == 0 )
+				throw Error( "glGenTextures() failed for '{}'", normalizedPath.string() );
+
+			glBindTexture( GL_TEXTURE_2D, texture );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>( packed->levels.size() - 1 ) );
+
+			std::uint32_t width = packed->width, height = packed->height;
+			for( std::size_t level = 0; level < packed->levels.size(); ++level )
+			{
+				upload_texture_level( format, static_cast<GLint>( level ), width, height, packed->levels[level] );
+
+				width = std::max( 1u, width / 2 );
+				height = std::max( 1u, height / 2 );
+			}
+
+			glBindTexture( GL_TEXTURE_2D, 0 );
+			return texture;
 		}
 
+		auto const& image = prepared.image;
+
 		GLuint texture = 0;
 		glGenTextures( 1, &texture );
 		if( texture == 0 )
-		{
-			stbi_image_free( pixels );
 			throw Error( "glGenTextures() failed for '{}'", normalizedPath.string() );
-		}
 
 		glBindTexture( GL_TEXTURE_2D, texture );
 		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
@@ -1746,26 +2423,39 @@ namespace
 			GL_TEXTURE_2D,
 			0,
 			GL_SRGB8_ALPHA8,
-			width,
-			height,
+			static_cast<GLsizei>( image.width ),
+			static_cast<GLsizei>( image.height ),
 			0,
 			GL_RGBA,
 			GL_UNSIGNED_BYTE,
-			pixels
+			image.pixels.data()
 		);
 		glGenerateMipmap( GL_TEXTURE_2D );
 
 		glBindTexture( GL_TEXTURE_2D, 0 );
-		stbi_image_free( pixels );
 		return texture;
 	}
 
+	// Takes the GLSL source from the asset pack if it has it; otherwise,
+	// ShaderProgram reads the file.
+	ShaderProgram::ShaderSource shader_source( GLenum type, std::filesystem::path const& path, AssetPack const& pack )
+	{
+		auto const text = pack.find( path, AssetKind::Shader );
+		return ShaderProgram::ShaderSource{ type, path.string(), std::string( reinterpret_cast<char const*>( text.data() ), text.size() ) };
+	}
+
+	void print_gpu_cache_stats( GpuCache const& cache )
+	{
+		auto const stats = cache.stats();
+		std::print( "GPU cache: {} hits, {} misses, {} objects ({} in use)\n", stats.hits, stats.misses, stats.objects, stats.inUse );
+	}
+
 	// === Particle helpers (texture/pool/render) ===
-	GLuint create_particle_texture()
+	std::vector<std::uint8_t> make_particle_texture_pixels()
 	{
 		// 程序生成一张带 alpha 的圆形软边纹理
-		int const size = 64;
-		std::vector<unsigned char> data( size * size * 4 );
+		int const size = int(kParticleTextureSize);
+		std::vector<std::uint8_t> data( size * size * 4 );
 		for( int y = 0; y < size; ++y )
 		{
 			for( int x = 0; x < size; ++x )
@@ -1783,6 +2473,13 @@ namespace
 			}
 		}
 
+		return data;
+	}
+
+	GLuint upload_particle_texture( std::span<std::uint8_t const> pixels )
+	{
+		GLsizei const size = GLsizei(kParticleTextureSize);
+
 		GLuint tex = 0;
 		glGenTextures( 1, &tex );
 		glBindTexture( GL_TEXTURE_2D, tex );
@@ -1790,13 +2487,18 @@ namespace
 		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
 		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
 		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
-		glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, data.data() );
+		glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data() );
 		glGenerateMipmap( GL_TEXTURE_2D );
 		glBindTexture( GL_TEXTURE_2D, 0 );
 		return tex;
 	}
 
-	void init_particle_system( ParticleSystem& system )
+	GLuint create_particle_texture()
+	{
+		return upload_particle_texture( make_particle_texture_pixels() );
+	}
+
+	void init_particle_system( ParticleSystem& system, GpuCache& cache )
 	{
 		constexpr std::size_t kMaxParticles = 4000;
 		system.pool.clear();
@@ -1805,41 +2507,42 @@ namespace
 		system.aliveCount = 0;
 		system.emitAccumulator = 0.f;
 
-		glGenVertexArrays( 1, &system.vao );
-		glGenBuffers( 1, &system.vbo );
+		system.vertices = cache.buffer( "gen:particle-vertices", [] {
+			GLuint vbo = 0;
+			glGenBuffers( 1, &vbo );
+			glBindBuffer( GL_ARRAY_BUFFER, vbo );
+			glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( kMaxParticles * sizeof( ParticleGpu ) ), nullptr, GL_DYNAMIC_DRAW );
+			glBindBuffer( GL_ARRAY_BUFFER, 0 );
+			return vbo;
+		} );
 
-		glBindVertexArray( system.vao );
-		glBindBuffer( GL_ARRAY_BUFFER, system.vbo );
-		glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( kMaxParticles * sizeof( ParticleGpu ) ), nullptr, GL_DYNAMIC_DRAW );
+		system.vertexArray = cache.vertex_array( "gen:particle-vertex-array", { system.vertices }, [&] {
+			GLuint vao = 0;
+			glGenVertexArrays( 1, &vao );
+			glBindVertexArray( vao );
+			glBindBuffer( GL_ARRAY_BUFFER, system.vertices->id );
 
-		// position
-		glEnableVertexAttribArray( 0 );
-		glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, sizeof( ParticleGpu ), reinterpret_cast<void*>( offsetof( ParticleGpu, position ) ) );
-		// size + alpha
-		glEnableVertexAttribArray( 1 );
-		glVertexAttribPointer( 1, 2, GL_FLOAT, GL_FALSE, sizeof( ParticleGpu ), reinterpret_cast<void*>( offsetof( ParticleGpu, size ) ) );
+			// position
+			glEnableVertexAttribArray( 0 );
+			glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, sizeof( ParticleGpu ), reinterpret_cast<void*>( offsetof( ParticleGpu, position ) ) );
+			// size + alpha
+			glEnableVertexAttribArray( 1 );
+			glVertexAttribPointer( 1, 2, GL_FLOAT, GL_FALSE, sizeof( ParticleGpu ), reinterpret_cast<void*>( offsetof( ParticleGpu, size ) ) );
 
-		glBindVertexArray( 0 );
-		glBindBuffer( GL_ARRAY_BUFFER, 0 );
+			glBindVertexArray( 0 );
+			glBindBuffer( GL_ARRAY_BUFFER, 0 );
+			return vao;
+		} );
+
+		system.texture = cache.texture( kParticleTextureKey, &create_particle_texture );
 	}
 
 	void destroy_particle_system( ParticleSystem& system )
 	{
-		if( system.vbo )
-		{
-			glDeleteBuffers( 1, &system.vbo );
-			system.vbo = 0;
-		}
-		if( system.vao )
-		{
-			glDeleteVertexArrays( 1, &system.vao );
-			system.vao = 0;
-		}
-		if( system.textureId )
-		{
-			glDeleteTextures( 1, &system.textureId );
-			system.textureId = 0;
-		}
+		// The objects stay in the cache.
+		system.vertexArray.reset();
+		system.vertices.reset();
+		system.texture.reset();
 		system.pool.clear();
 		system.head = 0;
 		system.aliveCount = 0;
@@ -1860,27 +2563,53 @@ namespace
 			return;
 
 		Vec3f dir = safe_normalize( emitterDir, Vec3f{ 0.f, 0.f, -1.f } );
-
-		for( int i = 0; i < toEmit; ++i )
+		Vec3f tangent = safe_normalize( cross( dir, Vec3f{ 0.f, 1.f, 0.f } ), Vec3f{ 1.f, 0.f, 0.f } );
+		Vec3f bitangent = cross( tangent, dir );
+		float const spread = 0.4f;
+
+		// Particles are emitted in batches: the random angles are drawn first,
+		// so that their sines and cosines can be computed together.
+		constexpr int kBatch = 64;
+		for( int first = 0; first < toEmit; first += kBatch )
 		{
-			std::size_t idx = system.head;
-			system.head = (system.head + 1) % system.pool.size();
-			Particle& p = system.pool[idx];
-			p.alive = true;
-			p.age = 0.f;
-			p.lifetime = 0.6f + rand01() * 0.6f;
-			p.size = 0.8f + rand01() * 0.6f;
-
-			Vec3f tangent = safe_normalize( cross( dir, Vec3f{ 0.f, 1.f, 0.f } ), Vec3f{ 1.f, 0.f, 0.f } );
-			Vec3f bitangent = cross( tangent, dir );
-			float spread = 0.4f;
-			float u = rand01() * 2.f * kPi;
-			float r = rand01() * spread;
-			Vec3f jitter = tangent * ( std::cos( u ) * r ) + bitangent * ( std::sin( u ) * r );
-
-			float speed = 25.f + rand01() * 10.f;
-			p.velocity = ( dir + jitter * 0.2f ) * speed;
-			p.position = emitterPos + dir * 0.2f;
+			int const count = std::min( kBatch, toEmit - first );
+
+			std::array<Particle*, kBatch> particles;
+			std::array<float, kBatch> angles, radii, speeds, sines, cosines;
+			for( int i = 0; i < count; ++i )
+			{
+				std::size_t idx = system.head;
+				system.head = (system.head + 1) % system.pool.size();
+				Particle& p = system.pool[idx];
+				p.alive = true;
+				p.age = 0.f;
+				p.lifetime = 0.6f + rand01() * 0.6f;
+				p.size = 0.8f + rand01() * 0.6f;
+
+				particles[i] = &p;
+				angles[i] = rand01() * 2.f * kPi;
+				radii[i] = rand01() * spread;
+				speeds[i] = 25.f + rand01() * 10.f;
+			}
+
+		#ifdef ENABLE_FAST_TRIG
+			batch_sincos( std::span( angles.data(), count ), sines, cosines );
+		#else
+			for( int i = 0; i < count; ++i )
+			{
+				sines[i] = std::sin( angles[i] );
+				cosines[i] = std::cos( angles[i] );
+			}
+		#endif
+
+			for( int i = 0; i < count; ++i )
+			{
+				Vec3f jitter = tangent * ( cosines[i] * radii[i] ) + bitangent * ( sines[i] * radii[i] );
+
+				Particle& p = *particles[i];
+				p.velocity = ( dir + jitter * 0.2f ) * speeds[i];
+				p.position = emitterPos + dir * 0.2f;
+			}
 		}
 	}
 
@@ -1908,7 +2637,7 @@ namespace
 
 	void upload_particles( ParticleSystem& system )
 	{
-		if( system.vbo == 0 )
+		if( !system.vertices )
 			return;
 		std::vector<ParticleGpu> gpuData;
 		gpuData.reserve( system.aliveCount );
@@ -1925,14 +2654,14 @@ namespace
 		}
 		system.aliveCount = gpuData.size();
 
-		glBindBuffer( GL_ARRAY_BUFFER, system.vbo );
+		glBindBuffer( GL_ARRAY_BUFFER, system.vertices->id );
 		glBufferSubData( GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>( gpuData.size() * sizeof( ParticleGpu ) ), gpuData.data() );
 		glBindBuffer( GL_ARRAY_BUFFER, 0 );
 	}
 
-	void render_particles( ParticlePipeline const& pipeline, ParticleSystem const& system, Mat44f const& view, Mat44f const& proj, ViewportRect const& viewport, float fovRadians )
+	void render_particles( ParticlePipeline const& pipeline, ParticleSystem const& system, Mat44fGl const& view, Mat44fGl const& proj, ViewportRect const& viewport, float fovRadians )
 	{
-		if( system.aliveCount == 0 || system.vao == 0 )
+		if( system.aliveCount == 0 || !system.vertexArray )
 			return;
 
 		glEnable( GL_BLEND );
@@ -1942,20 +2671,17 @@ namespace
 
 		glUseProgram( pipeline.program->programId() );
 
-		auto const viewGl = to_gl_matrix( view );
-		auto const projGl = to_gl_matrix( proj );
-
-		glUniformMatrix4fv( pipeline.uView, 1, GL_FALSE, viewGl.data() );
-		glUniformMatrix4fv( pipeline.uProj, 1, GL_FALSE, projGl.data() );
+		glUniformMatrix4fv( pipeline.uView, 1, GL_FALSE, view.data() );
+		glUniformMatrix4fv( pipeline.uProj, 1, GL_FALSE, proj.data() );
 		glUniform1f( pipeline.uViewportHeight, static_cast<float>( std::max<GLsizei>( 1, viewport.height ) ) );
 		glUniform1f( pipeline.uTanHalfFov, std::tan( fovRadians * 0.5f ) );
 		glUniform3f( pipeline.uColor, 1.0f, 0.8f, 0.5f );
 		glUniform1i( pipeline.uTexture, 0 );
 
 		glActiveTexture( GL_TEXTURE0 );
-		glBindTexture( GL_TEXTURE_2D, system.textureId );
+		glBindTexture( GL_TEXTURE_2D, system.texture ? system.texture->id : 0 );
 
-		glBindVertexArray( system.vao );
+		glBindVertexArray( system.vertexArray->id );
 		glDrawArrays( GL_POINTS, 0, static_cast<GLsizei>( system.aliveCount ) );
 		glBindVertexArray( 0 );
 
@@ -1966,12 +2692,29 @@ namespace
 
 	Vec3f compute_forward_vector( Camera const& camera )
 	{
+	#ifdef ENABLE_FAST_TRIG
+		float const angles[4] = { camera.yaw, camera.pitch, 0.f, 0.f };
+		simd::Float4 sinV, cosV;
+		simd::sincos( simd::load4( angles ), sinV, cosV );
+
+		float sines[4], cosines[4];
+		simd::store( sines, sinV );
+		simd::store( cosines, cosV );
+
+		float const cosPitch = cosines[1];
+		return safe_normalize( Vec3f{
+			cosines[0] * cosPitch,
+			sines[1],
+			sines[0] * cosPitch
+		} );
+	#else
 		float const cosPitch = std::cos( camera.pitch );
 		return safe_normalize( Vec3f{
 			std::cos( camera.yaw ) * cosPitch,
 			std::sin( camera.pitch ),
 			std::sin( camera.yaw ) * cosPitch
 		} );
+	#endif
 	}
 
 	Mat44f make_view_matrix( Camera const& camera, Vec3f const& worldUp )
@@ -2034,17 +2777,6 @@ namespace
 		app.camera.position += movement * ( speed * deltaSeconds );
 	}
 
-	std::array<float,16> to_gl_matrix( Mat44f const& mat )
-	{
-		std::array<float,16> glMat{};
-		for( std::size_t row = 0; row < 4; ++row )
-		{
-			for( std::size_t col = 0; col < 4; ++col )
-				glMat[col * 4 + row] = mat[row, col];
-		}
-		return glMat;
-	}
-
 	GLFWCleanupHelper::~GLFWCleanupHelper()
 	{
 		glfwTerminate();
@@ -2059,15 +2791,8 @@ namespace
 
 namespace task5
 {
-    struct Task5VertexPNC
-    {
-        Vec3f position;
-        Vec3f normal;
-        Vec3f color;
-    };
-
     void append_box(
-        std::vector<Task5VertexPNC>& vertices,
+        std::vector<VertexPNC>& vertices,
         Vec3f const& center,
         Vec3f const& halfSize,
         Vec3f const& color
@@ -2103,7 +2828,7 @@ namespace task5
     VehicleGeometry create_vehicle_geometry()
     {
         VehicleGeometry geom{};
-        std::vector<Task5VertexPNC> verts;
+        std::vector<VertexPNC> verts;
 
         verts.reserve(2000);
 
@@ -2159,48 +2884,53 @@ namespace task5
 			Vec3f{0.9f, 0.9f, 1.f}
 		);
 
-		// create VAO / VBO
+        // weld into an indexed mesh and add simplified levels (the colours
+        // act as materials, so the parts keep their colours)
+        auto mesh = weld_vertices(std::span<VertexPNC const>(verts));
+        {
+            auto const vertices = std::span<VertexPNC const>(mesh.vertices);
+            geom.lods = build_lod_chain(
+                mesh.indices,
+                extract_positions(vertices),
+                extract_normals(vertices),
+                vertex_materials(vertices),
+                kVehicleLodRatios
+            );
+        }
+
+		// create VAO / VBO / EBO
         glGenVertexArrays(1, &geom.vao);
         glGenBuffers(1, &geom.vbo);
+        glGenBuffers(1, &geom.ebo);
 
         glBindVertexArray(geom.vao);
         glBindBuffer(GL_ARRAY_BUFFER, geom.vbo);
 
         glBufferData(
             GL_ARRAY_BUFFER,
-            static_cast<GLsizeiptr>(verts.size() * sizeof(Task5VertexPNC)),
-            verts.data(),
+            static_cast<GLsizeiptr>(mesh.vertices.size() * sizeof(VertexPNC)),
+            mesh.vertices.data(),
             GL_STATIC_DRAW
         );
 
-        // layout(location = 0) position
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(
-            0, 3, GL_FLOAT, GL_FALSE,
-            sizeof(Task5VertexPNC),
-            reinterpret_cast<void*>(offsetof(Task5VertexPNC, position))
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geom.ebo);
+        glBufferData(
+            GL_ELEMENT_ARRAY_BUFFER,
+            static_cast<GLsizeiptr>(mesh.indices.size() * sizeof(std::uint32_t)),
+            mesh.indices.data(),
+            GL_STATIC_DRAW
         );
 
-        // layout(location = 1) normal
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(
-            1, 3, GL_FLOAT, GL_FALSE,
-            sizeof(Task5VertexPNC),
-            reinterpret_cast<void*>(offsetof(Task5VertexPNC, normal))
-        );
-
-        // layout(location = 2) color
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(
-            2, 3, GL_FLOAT, GL_FALSE,
-            sizeof(Task5VertexPNC),
-            reinterpret_cast<void*>(offsetof(Task5VertexPNC, color))
-        );
+        // same attribute locations as the landing pad (position, normal,
+        // color)
+        declare_vertex_attributes<VertexTraits<VertexPNC>::Layout>();
 
         glBindVertexArray(0);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-        geom.vertexCount = static_cast<GLsizei>(verts.size());
+        geom.vertexCount = static_cast<GLsizei>(mesh.vertices.size());
+        for (auto const& v : mesh.vertices)
+            expand(geom.bounds, v.position);
         return geom;
     }
 
@@ -2211,6 +2941,11 @@ namespace task5
             glDeleteBuffers(1, &g.vbo);
             g.vbo = 0;
         }
+        if (g.ebo)
+        {
+            glDeleteBuffers(1, &g.ebo);
+            g.ebo = 0;
+        }
         if (g.vao)
         {
             glDeleteVertexArrays(1, &g.vao);
@@ -2221,18 +2956,24 @@ namespace task5
 
     void render_vehicle(
         VehicleGeometry const& g,
-        Mat44f const& modelMatrix,
-        GLint uModel
+        Mat44fGl const& modelMatrix,
+        GLint uModel,
+        std::size_t lod
     )
     {
         if (g.vao == 0 || g.vertexCount == 0)
             return;
 
-        auto modelGl = to_gl_matrix(modelMatrix);
-        glUniformMatrix4fv(uModel, 1, GL_FALSE, modelGl.data());
+        glUniformMatrix4fv(uModel, 1, GL_FALSE, modelMatrix.data());
 
+        auto const& level = g.lods[lod];
         glBindVertexArray(g.vao);
-        glDrawArrays(GL_TRIANGLES, 0, g.vertexCount);
+        glDrawElements(
+            GL_TRIANGLES,
+            static_cast<GLsizei>(level.indexCount),
+            GL_UNSIGNED_INT,
+            reinterpret_cast<void const*>(std::uintptr_t(level.firstIndex) * sizeof(std::uint32_t))
+        );
         glBindVertexArray(0);
     }
 
@@ -2311,6 +3052,7 @@ namespace task7
             anim.paused = false;
             anim.time   = 0.f;
             anim.lastPos = anim.startPos;
+            anim.orientation = kIdentityQuatf;
         }
         else
         {
@@ -2325,6 +3067,7 @@ namespace task7
         anim.time   = 0.f;
         anim.currentModel = anim.baseModel;
         anim.lastPos      = anim.startPos;
+        anim.orientation  = kIdentityQuatf;
     }
 
     void update(AnimationState& anim,
@@ -2375,27 +3118,15 @@ namespace task7
 		Vec3f velocity = (currentPos - anim.lastPos) / deltaSeconds;
 		anim.lastPos = currentPos;
 
-		Vec3f forward = velocity;
-		if (length(forward) < 1e-4f)
-			forward = Vec3f{0.f, 1.f, 0.f};
-		else
-			forward = forward / length(forward);
-
-		Vec3f worldSide{0.f, 0.f, 1.f};
-		if (std::abs(dot(worldSide, forward)) > 0.9f)
-			worldSide = Vec3f{1.f, 0.f, 0.f};
-
-		Vec3f right = safe_normalize(cross(worldSide, forward), Vec3f{1.f,0.f,0.f});
-		Vec3f up    = cross(forward, right);
-
-		Mat44f R = kIdentity44f;
-		R[0,0] = right.x;   R[0,1] = right.y;   R[0,2] = right.z;
-		R[1,0] = forward.x; R[1,1] = forward.y; R[1,2] = forward.z;
-		R[2,0] = up.x;      R[2,1] = up.y;      R[2,2] = up.z;
-
-		Mat44f T = make_translation(currentPos);
+		// Point the vehicle's nose (+y in model space) along the velocity. The
+		// path lies in a vertical plane, so the shortest rotation from +y
+		// never rolls the vehicle. Keep the last orientation while (nearly)
+		// stationary.
+		float const speed = length(velocity);
+		if (speed >= 1e-4f)
+			anim.orientation = make_quat_from_to(Vec3f{0.f, 1.f, 0.f}, velocity / speed);
 
-		anim.currentModel = T * R;
+		anim.currentModel = to_mat44(make_rigid(anim.orientation, currentPos));
 		vehicleModelMatrix = anim.currentModel;
 
 		for (int i = 0; i < 3; ++i)
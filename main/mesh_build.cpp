@@ -0,0 +1,34 @@
+#include "mesh_build.hpp"
+
+namespace detail
+{
+	rapidobj::Result read_obj_( std::filesystem::path const& resultPath )
+	{
+		auto result = rapidobj::ParseFile( resultPath );
+		if( result.error )
+			throw Error( "Failed to load '{}': {} at line {}", resultPath.string(), result.error.code.message(), result.error.line_num );
+		if( !rapidobj::Triangulate( result ) )
+			throw Error( "Triangulation failed for '{}'", resultPath.string() );
+
+		return result;
+	}
+
+	std::size_t count_triangles_( rapidobj::Result const& result ) noexcept
+	{
+		std::size_t count = 0;
+		for( auto const& shape : result.shapes )
+			count += shape.mesh.num_face_vertices.size();
+		return count;
+	}
+
+	Aabb3f merge_bounds_( std::span<Aabb3f const> partial ) noexcept
+	{
+		Aabb3f ret = kEmptyAabb3f;
+		for( auto const& box : partial )
+		{
+			if( !is_empty( box ) )
+				ret = merge( ret, box );
+		}
+		return ret;
+	}
+}
@@ -0,0 +1,567 @@
+#ifndef MESH_BUILD_HPP_6F3A1D88_B52C_4E07_A9D4_0C71E5B2968A
+#define MESH_BUILD_HPP_6F3A1D88_B52C_4E07_A9D4_0C71E5B2968A
+
+#include <print>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <vector>
+#include <span>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "../support/error.hpp"
+#include "../support/parallel.hpp"
+
+#include "../vmlib/aabb.hpp"
+#include "../vmlib/weld.hpp"
+#include "../vmlib/obj_stream.hpp"
+#include "../vmlib/vertex_cache.hpp"
+#include "../vmlib/chunk_lod.hpp"
+#include "../vmlib/simplify.hpp"
+#include "../vmlib/mesh_chunks.hpp"
+#include "../vmlib/meshlets.hpp"
+
+#include "defaults.hpp"
+#include "mesh_cache.hpp"
+#include "vertex_formats.hpp"
+
+#include "../third_party/rapidobj/include/rapidobj/rapidobj.hpp"
+
+/* Building the indexed meshes of the scene from OBJ files
+ *
+ * build_mesh() parses an OBJ (only for the attributes that the vertex format
+ * has), welds it (vmlib/weld.hpp), reorders it for the vertex cache
+ * (vmlib/vertex_cache.hpp), and splits it into chunks, levels of detail and
+ * meshlets as its MeshLayout asks. The result is what the mesh cache (see
+ * mesh_cache.hpp) and the asset pack (see asset_pack.hpp) store.
+ *
+ * Used by the application when neither has the mesh, and by the asset
+ * compiler (assetc).
+ */
+
+// Parse large OBJs without materials (i.e., the terrain) in pieces, welding
+// their triangles as they are parsed, so that neither the whole parsed file
+// nor its triangle soup is held (see detail::stream_obj_()). Comment out to
+// always parse whole OBJs, on several threads.
+#define ENABLE_STREAMING_OBJ
+
+// The terrain is split into kTerrainChunkCells^2 chunks (see
+// vmlib/mesh_chunks.hpp), with kTerrainLodLevels levels of detail each
+// (vmlib/chunk_lod.hpp).
+constexpr std::size_t kTerrainChunkCells = 8;
+constexpr std::size_t kTerrainLodLevels = 5;
+
+// Simplified levels of the landing pad (vmlib/simplify.hpp), as fractions
+// of its triangles.
+constexpr std::array<float, 3> kLandingPadLodRatios{ 0.5f, 0.2f, 0.05f };
+
+// OBJs from kStreamObjMinBytes on are streamed (with ENABLE_STREAMING_OBJ),
+// in pieces of kObjStreamPieceBytes; smaller ones are parsed whole, which is
+// faster.
+constexpr std::uintmax_t kStreamObjMinBytes = 64 * 1024 * 1024;
+constexpr std::size_t kObjStreamPieceBytes = 4 * 1024 * 1024;
+
+// How a mesh is split up. If chunkCells is non-zero, the triangles are
+// grouped into chunkCells^2 chunks (see vmlib/mesh_chunks.hpp), with
+// lodLevels levels of detail each (see vmlib/chunk_lod.hpp). Otherwise, if
+// lodRatios is not empty, the whole mesh is a single chunk whose levels are
+// simplified to lodRatios of its triangles (see vmlib/simplify.hpp). If
+// meshlets is set, every level (or the whole mesh) is split into meshlets
+// (see vmlib/meshlets.hpp).
+struct MeshLayout
+{
+	std::size_t chunkCells = 0;
+	std::size_t lodLevels = 0;
+	std::span<float const> lodRatios;
+	bool meshlets = false;
+};
+
+constexpr MeshLayout kTerrainMeshLayout{ .chunkCells = kTerrainChunkCells, .lodLevels = kTerrainLodLevels, .lodRatios = {}, .meshlets = true };
+constexpr MeshLayout kLandingPadMeshLayout{ .chunkCells = 0, .lodLevels = 0, .lodRatios = kLandingPadLodRatios, .meshlets = true };
+
+template< class tVertex >
+struct BuiltMesh
+{
+	IndexedMesh<tVertex> mesh;
+	std::vector<std::uint16_t> indices16; // used instead of mesh.indices if info.indexSize is 2
+	MeshCacheInfo info;
+	std::vector<MeshChunk> chunks;
+	std::vector<MeshLod> chunkLods;
+	std::size_t lodLevels = 0;
+	std::vector<Meshlet> meshlets;
+
+	std::span<std::byte const> vertex_bytes() const noexcept;
+	std::span<std::byte const> index_bytes() const noexcept;
+};
+
+// Builds the mesh of an OBJ, see above. Throws Error if the OBJ cannot be
+// read or has no triangles. If reportScaling is set, the conversion of
+// OBJs that are parsed whole is also timed on 1 to 8 threads.
+template< class tVertex >
+BuiltMesh<tVertex> build_mesh( std::filesystem::path const& resultPath, MeshLayout const& layout, bool reportScaling = false );
+
+// Material ids for simplify_mesh(). Vertices with a colour are grouped by
+// it (the landing pad's colours are those of its materials); without
+// colours, all vertices share one material.
+template< class tVertex >
+std::vector<std::uint32_t> vertex_materials( std::span<tVertex const> vertices )
+{
+	std::vector<std::uint32_t> ret;
+	if constexpr( requires( tVertex const& v ) { v.color; } )
+	{
+		std::vector<Vec3f> colors;
+		ret.reserve( vertices.size() );
+		for( auto const& v : vertices )
+		{
+			auto const it = std::find_if( colors.begin(), colors.end(), [&] ( Vec3f const& c ) {
+				return c.x == v.color.x && c.y == v.color.y && c.z == v.color.z;
+			} );
+			ret.emplace_back( static_cast<std::uint32_t>( it - colors.begin() ) );
+			if( colors.end() == it )
+				colors.emplace_back( v.color );
+		}
+	}
+	return ret;
+}
+
+namespace detail
+{
+	inline Vec3f safe_normalize_( Vec3f vec, Vec3f fallback = Vec3f{ 0.f, 1.f, 0.f } ) noexcept
+	{
+		float const len = length( vec );
+		if( len <= 1e-6f )
+			return fallback;
+		return vec / len;
+	}
+
+	// Unit normal of a counter-clockwise triangle, or +Y if it is degenerate.
+	inline Vec3f face_normal_( std::array<Vec3f, 3> const& positions ) noexcept
+	{
+		Vec3f const a = positions[1] - positions[0];
+		Vec3f const b = positions[2] - positions[0];
+		return safe_normalize_( Vec3f{
+			a.y * b.z - a.z * b.y,
+			a.z * b.x - a.x * b.z,
+			a.x * b.y - a.y * b.x
+		} );
+	}
+
+	rapidobj::Result read_obj_( std::filesystem::path const& resultPath );
+
+	std::size_t count_triangles_( rapidobj::Result const& result ) noexcept;
+
+	// Calls face( mesh, faceIndex, triangle, range ) for all faces of all
+	// shapes, split into contiguous ranges over threadCount threads (see
+	// parallel_ranges()). triangle numbers the faces across all shapes, so
+	// the face's output vertices are 3*triangle ... 3*triangle+2; range
+	// identifies the calling range, for per-range partial results.
+	//
+	// Triangulate() leaves only triangles, so the face's vertices are at
+	// 3*faceIndex ... 3*faceIndex+2 in mesh.indices.
+	template< class tFace >
+	void for_each_triangle_parallel_( rapidobj::Result const& result, std::size_t threadCount, tFace&& face )
+	{
+		std::vector<std::size_t> shapeBegin( result.shapes.size() + 1, 0 );
+		for( std::size_t i = 0; i < result.shapes.size(); ++i )
+			shapeBegin[i+1] = shapeBegin[i] + result.shapes[i].mesh.num_face_vertices.size();
+
+		parallel_ranges( shapeBegin.back(), threadCount, [&] ( std::size_t begin, std::size_t end, std::size_t range ) {
+			std::size_t shape = static_cast<std::size_t>( std::upper_bound( shapeBegin.begin(), shapeBegin.end(), begin ) - shapeBegin.begin() ) - 1;
+			for( std::size_t triangle = begin; triangle < end; ++triangle )
+			{
+				while( triangle >= shapeBegin[shape+1] )
+					++shape;
+
+				auto const& mesh = result.shapes[shape].mesh;
+				std::size_t const faceIndex = triangle - shapeBegin[shape];
+				assert( 3 == mesh.num_face_vertices[faceIndex] );
+
+				face( mesh, faceIndex, triangle, range );
+			}
+		} );
+	}
+
+	Aabb3f merge_bounds_( std::span<Aabb3f const> partial ) noexcept;
+
+	// Times convert( threadCount ) for 1, 2, 4 and 8 threads (best of three
+	// runs each), to check how the OBJ to vertex conversion scales.
+	template< class tConvert >
+	void report_conversion_scaling_( std::filesystem::path const& path, tConvert&& convert )
+	{
+		std::print( "Conversion scaling for '{}':", path.string() );
+
+		double single = 0.0;
+		for( std::size_t threads : { 1, 2, 4, 8 } )
+		{
+			double best = std::numeric_limits<double>::max();
+			for( int run = 0; run < 3; ++run )
+			{
+				auto const start = Clock::now();
+				convert( threads );
+				best = std::min( best, std::chrono::duration<double, std::milli>( Clock::now() - start ).count() );
+			}
+
+			if( 1 == threads )
+				single = best;
+
+			std::print( " {}T {:.1f} ms ({:.2f}x)", threads, best, single / best );
+		}
+
+		std::print( "\n" );
+	}
+
+	// One triangle of an OBJ, with the attributes that the file has for it.
+	// Normals are used only if all three corners have one; missing texture
+	// coordinates are zero.
+	struct ObjTriangle_
+	{
+		std::array<Vec3f, 3> positions;
+		std::array<Vec3f, 3> normals;
+		std::array<Vec2f, 3> texCoords;
+		Vec3f color;
+		bool hasNormals;
+	};
+
+	// Writes the three tVertex corners of triangle to out. Only the
+	// attributes in tVertex's layout are written; normals fall back to the
+	// face normal.
+	template< class tVertex >
+	void make_corners_( ObjTriangle_ const& triangle, tVertex* out ) noexcept
+	{
+		using Layout = typename VertexTraits<tVertex>::Layout;
+		static_assert( has_attribute_v<Layout, VertexSemantic::Position> );
+
+		auto const& positions = triangle.positions;
+		for( std::size_t v = 0; v < 3; ++v )
+			out[v].*attribute_member_v<Layout, VertexSemantic::Position> = positions[v];
+
+		if constexpr( has_attribute_v<Layout, VertexSemantic::Normal> )
+		{
+			Vec3f const faceNormal = face_normal_( positions );
+			for( std::size_t v = 0; v < 3; ++v )
+				out[v].*attribute_member_v<Layout, VertexSemantic::Normal> = triangle.hasNormals ? safe_normalize_( triangle.normals[v], faceNormal ) : faceNormal;
+		}
+
+		if constexpr( has_attribute_v<Layout, VertexSemantic::TexCoord> )
+		{
+			for( std::size_t v = 0; v < 3; ++v )
+				out[v].*attribute_member_v<Layout, VertexSemantic::TexCoord> = triangle.texCoords[v];
+		}
+
+		if constexpr( has_attribute_v<Layout, VertexSemantic::Color> )
+		{
+			for( std::size_t v = 0; v < 3; ++v )
+				out[v].*attribute_member_v<Layout, VertexSemantic::Color> = triangle.color;
+		}
+	}
+
+	// Expands the triangles of an OBJ into tVertex corners, on threadCount
+	// threads (see make_corners_()). Only the attributes in tVertex's layout
+	// are fetched; colours are the diffuse colour of the face's material, or
+	// grey.
+	template< class tVertex >
+	std::vector<tVertex> convert_obj_( rapidobj::Result const& result, MeshCacheInfo& info, std::size_t threadCount )
+	{
+		using Layout = typename VertexTraits<tVertex>::Layout;
+
+		auto const fetch_position = [&]( int index ) -> Vec3f
+		{
+			std::size_t const base = static_cast<std::size_t>( index ) * 3;
+			return Vec3f{
+				result.attributes.positions[base + 0],
+				result.attributes.positions[base + 1],
+				result.attributes.positions[base + 2]
+			};
+		};
+		auto const fetch_normal = [&]( int index ) -> Vec3f
+		{
+			std::size_t const base = static_cast<std::size_t>( index ) * 3;
+			return Vec3f{
+				result.attributes.normals[base + 0],
+				result.attributes.normals[base + 1],
+				result.attributes.normals[base + 2]
+			};
+		};
+
+		auto const fetch_texcoord = [&]( int index ) -> Vec2f
+		{
+			std::size_t const base = static_cast<std::size_t>( index ) * 2;
+			return Vec2f{
+				result.attributes.texcoords[base + 0],
+				result.attributes.texcoords[base + 1]
+			};
+		};
+
+		auto const fetch_color = [&]( int materialIndex ) -> Vec3f
+		{
+			if( materialIndex >= 0 && static_cast<std::size_t>( materialIndex ) < result.materials.size() )
+			{
+				auto const& mat = result.materials[static_cast<std::size_t>( materialIndex )];
+				return Vec3f{ mat.diffuse[0], mat.diffuse[1], mat.diffuse[2] };
+			}
+			return Vec3f{ 0.7f, 0.7f, 0.7f };
+		};
+
+		// Each thread writes its own triangles' vertices, and reduces its own
+		// bounds; the partial bounds are merged afterwards.
+		std::vector<tVertex> vertices( 3 * count_triangles_( result ) );
+		std::vector<Aabb3f> partialBounds( std::max<std::size_t>( 1, threadCount ), kEmptyAabb3f );
+
+		for_each_triangle_parallel_( result, threadCount, [&] ( rapidobj::Mesh const& mesh, std::size_t faceIndex, std::size_t triangle, std::size_t range )
+		{
+			ObjTriangle_ face{};
+			face.hasNormals = has_attribute_v<Layout, VertexSemantic::Normal> && !result.attributes.normals.empty();
+			bool const hasTexCoordData = has_attribute_v<Layout, VertexSemantic::TexCoord> && !result.attributes.texcoords.empty();
+
+			Aabb3f& bounds = partialBounds[range];
+			for( std::size_t v = 0; v < 3; ++v )
+			{
+				auto const& index = mesh.indices[3*faceIndex + v];
+				face.positions[v] = fetch_position( index.position_index );
+				expand( bounds, face.positions[v] );
+
+				if( face.hasNormals && index.normal_index >= 0 )
+					face.normals[v] = fetch_normal( index.normal_index );
+				else
+					face.hasNormals = false;
+
+				if( hasTexCoordData && index.texcoord_index >= 0 )
+					face.texCoords[v] = fetch_texcoord( index.texcoord_index );
+			}
+
+			if constexpr( has_attribute_v<Layout, VertexSemantic::Color> )
+			{
+				face.color = faceIndex < mesh.material_ids.size()
+					? fetch_color( mesh.material_ids[faceIndex] )
+					: fetch_color( -1 );
+			}
+
+			make_corners_( face, vertices.data() + 3*triangle );
+		} );
+
+		Aabb3f const bounds = merge_bounds_( partialBounds );
+
+		info.bounds = bounds;
+		info.center = center( bounds );
+		info.radius = radius( bounds );
+		return vertices;
+	}
+
+	template< class tVertex >
+	std::vector<tVertex> parse_obj_( std::filesystem::path const& resultPath, MeshCacheInfo& info, bool reportScaling )
+	{
+		auto const result = read_obj_( resultPath );
+		if( 0 == count_triangles_( result ) )
+			throw Error( "OBJ '{}' did not contain triangles", resultPath.string() );
+
+		if( reportScaling )
+		{
+			report_conversion_scaling_( resultPath, [&] ( std::size_t threads ) {
+				MeshCacheInfo scratch{};
+				convert_obj_<tVertex>( result, scratch, threads );
+			} );
+		}
+
+		return convert_obj_<tVertex>( result, info, default_thread_count() );
+	}
+
+	// Reads the OBJ in pieces of kObjStreamPieceBytes (see
+	// vmlib/obj_stream.hpp), and converts and welds each piece's triangles
+	// as soon as it is parsed (VertexWelder, vmlib/weld.hpp). Besides the
+	// welded mesh, only the OBJ's vertex attributes and one piece are held;
+	// neither the whole file nor its triangle soup ever is. The result is
+	// the same as welding the output of parse_obj_().
+	//
+	// Materials are not read, so tVertex must not have colours.
+	template< class tVertex >
+	IndexedMesh<tVertex> stream_obj_( std::filesystem::path const& resultPath, MeshCacheInfo& info )
+	{
+		using Layout = typename VertexTraits<tVertex>::Layout;
+		static_assert( !has_attribute_v<Layout, VertexSemantic::Color> );
+
+		std::ifstream in( resultPath, std::ios::binary );
+		if( !in )
+			throw Error( "Unable to open '{}'", resultPath.string() );
+
+		ObjStreamParser parser;
+		VertexWelder<tVertex> welder;
+		Aabb3f bounds = kEmptyAabb3f;
+
+		auto const convert_triangles = [&] {
+			auto const corners = parser.triangles();
+			auto const positions = parser.positions();
+			auto const normals = parser.normals();
+			auto const texCoords = parser.texCoords();
+
+			for( std::size_t i = 0; i < corners.size(); i += 3 )
+			{
+				ObjTriangle_ face{};
+				face.hasNormals = has_attribute_v<Layout, VertexSemantic::Normal>;
+				for( std::size_t v = 0; v < 3; ++v )
+				{
+					auto const& corner = corners[i+v];
+					face.positions[v] = positions[corner.position];
+					expand( bounds, face.positions[v] );
+
+					if( face.hasNormals && kObjNoIndex != corner.normal )
+						face.normals[v] = normals[corner.normal];
+					else
+						face.hasNormals = false;
+
+					if( kObjNoIndex != corner.texCoord )
+						face.texCoords[v] = texCoords[corner.texCoord];
+				}
+
+				std::array<tVertex, 3> out{};
+				make_corners_( face, out.data() );
+				for( auto const& vertex : out )
+					welder.add( vertex );
+			}
+
+			parser.clear_triangles();
+		};
+
+		std::vector<char> piece( kObjStreamPieceBytes );
+		while( in )
+		{
+			in.read( piece.data(), static_cast<std::streamsize>( piece.size() ) );
+			auto const bytes = static_cast<std::size_t>( in.gcount() );
+			if( 0 == bytes )
+				break;
+
+			parser.feed( std::span( piece.data(), bytes ) );
+			if( parser.failed() )
+				break;
+
+			convert_triangles();
+		}
+
+		if( !parser.failed() )
+		{
+			parser.finish();
+			convert_triangles();
+		}
+
+		if( parser.failed() )
+			throw Error( "Failed to load '{}': {} at line {}", resultPath.string(), parser.error(), parser.line() );
+		if( in.bad() )
+			throw Error( "Unable to read '{}'", resultPath.string() );
+
+		parser.release();
+
+		auto mesh = welder.take();
+		if( mesh.indices.empty() )
+			throw Error( "OBJ '{}' did not contain triangles", resultPath.string() );
+
+		info.bounds = bounds;
+		info.center = center( bounds );
+		info.radius = radius( bounds );
+		return mesh;
+	}
+
+	// Parses the OBJ into a welded mesh of tVertex, streaming it if it is
+	// large (see stream_obj_()).
+	template< class tVertex >
+	IndexedMesh<tVertex> load_obj_( std::filesystem::path const& resultPath, MeshCacheInfo& info, bool reportScaling )
+	{
+		#ifdef ENABLE_STREAMING_OBJ
+		if constexpr( !has_attribute_v<typename VertexTraits<tVertex>::Layout, VertexSemantic::Color> )
+		{
+			std::error_code ec;
+			auto const size = std::filesystem::file_size( resultPath, ec );
+			if( !ec && size >= kStreamObjMinBytes )
+				return stream_obj_<tVertex>( resultPath, info );
+		}
+		#endif
+
+		auto const corners = parse_obj_<tVertex>( resultPath, info, reportScaling );
+		return weld_vertices( std::span<tVertex const>( corners ) );
+	}
+}
+
+template< class tVertex >
+std::span<std::byte const> BuiltMesh<tVertex>::vertex_bytes() const noexcept
+{
+	return std::as_bytes( std::span( mesh.vertices ) );
+}
+template< class tVertex >
+std::span<std::byte const> BuiltMesh<tVertex>::index_bytes() const noexcept
+{
+	if( sizeof( std::uint16_t ) == info.indexSize )
+		return std::as_bytes( std::span( indices16 ) );
+	return std::as_bytes( std::span( mesh.indices ) );
+}
+
+template< class tVertex >
+BuiltMesh<tVertex> build_mesh( std::filesystem::path const& resultPath, MeshLayout const& layout, bool reportScaling )
+{
+	BuiltMesh<tVertex> ret{};
+	auto& mesh = ret.mesh;
+	mesh = detail::load_obj_<tVertex>( resultPath, ret.info, reportScaling );
+
+	// Reorder for the post-transform vertex cache and for vertex fetches.
+	// Chunking and building LODs keep the relative order of triangles, so
+	// they can follow the cache optimization (and cost a few misses at chunk
+	// borders). The LODs only add indices, after those of the full mesh.
+	auto const cacheBefore = analyze_vertex_cache( mesh.indices, mesh.vertices.size() );
+	optimize_vertex_cache( std::span( mesh.indices ), mesh.vertices.size() );
+
+	std::size_t const fullIndexCount = mesh.indices.size();
+	if( layout.chunkCells )
+	{
+		auto const positions = extract_positions( std::span<tVertex const>( mesh.vertices ) );
+		ret.lodLevels = std::max<std::size_t>( 1, layout.lodLevels );
+		ret.chunks = partition_mesh_chunks( mesh.indices, positions, layout.chunkCells, layout.chunkCells );
+		ret.chunkLods = build_chunk_lods( mesh.indices, positions, ret.chunks, ret.lodLevels );
+	}
+	else if( !layout.lodRatios.empty() )
+	{
+		auto const vertices = std::span<tVertex const>( mesh.vertices );
+		auto const positions = extract_positions( vertices );
+		ret.chunks = partition_mesh_chunks( mesh.indices, positions, 1, 1 );
+		ret.chunkLods = build_lod_chain( mesh.indices, positions, extract_normals( vertices ), vertex_materials( vertices ), layout.lodRatios );
+		ret.lodLevels = ret.chunkLods.size();
+
+		// Unlike chunk LODs, the simplified levels are whole meshes of their
+		// own, so they get their own cache optimization.
+		for( std::size_t level = 1; level < ret.chunkLods.size(); ++level )
+			optimize_vertex_cache( std::span( mesh.indices ).subspan( ret.chunkLods[level].firstIndex, ret.chunkLods[level].indexCount ), mesh.vertices.size() );
+	}
+
+	optimize_vertex_fetch( std::span( mesh.indices ), mesh.vertices );
+
+	// Meshlets follow the final triangle order, and their bounds the final
+	// vertex order.
+	if( layout.meshlets )
+	{
+		MeshLod const whole{ 0, static_cast<std::uint32_t>( fullIndexCount ), 0.f };
+		auto const ranges = ret.chunkLods.empty() ? std::span( &whole, 1 ) : std::span<MeshLod const>( ret.chunkLods );
+		ret.meshlets = build_meshlets( mesh.indices, extract_positions( std::span<tVertex const>( mesh.vertices ) ), ranges );
+	}
+
+	auto const cacheAfter = analyze_vertex_cache( std::span( mesh.indices ).first( fullIndexCount ), mesh.vertices.size() );
+
+	std::print( "  Vertex cache ({} entries, FIFO): ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}\n",
+		kDefaultVertexCacheSize, cacheBefore.acmr, cacheAfter.acmr, cacheBefore.atvr, cacheAfter.atvr
+	);
+
+	ret.info.vertexCount = mesh.vertices.size();
+	ret.info.indexCount = mesh.indices.size();
+	ret.info.indexSize = sizeof( std::uint32_t );
+	if( fits_16bit_indices( mesh.vertices.size() ) )
+	{
+		ret.indices16 = narrow_indices( mesh.indices );
+		ret.info.indexSize = sizeof( std::uint16_t );
+	}
+
+	return ret;
+}
+
+#endif // MESH_BUILD_HPP_6F3A1D88_B52C_4E07_A9D4_0C71E5B2968A
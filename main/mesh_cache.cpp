@@ -0,0 +1,286 @@
+#include "mesh_cache.hpp"
+
+#include <print>
+#include <fstream>
+#include <algorithm>
+#include <exception>
+#include <type_traits>
+#include <system_error>
+
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+#include "../support/file_hash.hpp"
+
+namespace
+{
+	constexpr char kMagic_[8] = { 'V', 'M', 'E', 'S', 'H', 'C', 'A', 'C' };
+	constexpr std::uint32_t kVersion_ = 7;
+
+	// Fixed-size file header. It is followed by the chunk table, the chunk
+	// LOD table, the meshlet table, the vertex data and the index data, in
+	// this order. The
+	// header and table entries are multiples of four bytes in size, so that
+	// the vertex data stays aligned.
+	struct Header_
+	{
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t format;
+		std::uint64_t vertexSize;
+		std::uint64_t vertexCount;
+
+		std::uint64_t sourceSize;
+		std::int64_t sourceTime;
+		std::uint64_t sourceHash;
+
+		float boundsMin[3];
+		float boundsMax[3];
+		float center[3];
+		float radius;
+
+		std::uint64_t indexCount;
+		std::uint32_t indexSize;
+		std::uint32_t chunkCount;
+		std::uint32_t lodLevels; // per chunk; 0 without LODs
+		std::uint32_t meshletCount;
+
+		std::byte reserved[8];
+	};
+
+	static_assert( sizeof(Header_) == 128 );
+	static_assert( sizeof(MeshChunk) % 4 == 0 && std::is_trivially_copyable_v<MeshChunk> );
+	static_assert( sizeof(MeshLod) % 4 == 0 && std::is_trivially_copyable_v<MeshLod> );
+	static_assert( sizeof(Meshlet) % 4 == 0 && std::is_trivially_copyable_v<Meshlet> );
+
+	Header_ make_header_( std::uint32_t aFormat, std::size_t aVertexSize, std::size_t aChunkCount, std::size_t aChunkLodCount, std::size_t aMeshletCount, MeshCacheInfo const& aInfo ) noexcept
+	{
+		Header_ header{};
+		std::memcpy( header.magic, kMagic_, sizeof(kMagic_) );
+		header.version = kVersion_;
+		header.format = aFormat;
+		header.vertexSize = aVertexSize;
+		header.vertexCount = aInfo.vertexCount;
+		header.indexCount = aInfo.indexCount;
+		header.indexSize = aInfo.indexSize;
+		header.chunkCount = static_cast<std::uint32_t>( aChunkCount );
+		header.lodLevels = 0 == aChunkCount ? 0 : static_cast<std::uint32_t>( aChunkLodCount / aChunkCount );
+		header.meshletCount = static_cast<std::uint32_t>( aMeshletCount );
+
+		for( std::size_t i = 0; i < 3; ++i )
+		{
+			header.boundsMin[i] = aInfo.bounds.min[i];
+			header.boundsMax[i] = aInfo.bounds.max[i];
+			header.center[i] = aInfo.center[i];
+		}
+		header.radius = aInfo.radius;
+		return header;
+	}
+
+	bool write_( std::ostream& aOut, Header_ const& aHeader, std::span<std::byte const> aVertices, std::span<std::byte const> aIndices, std::span<MeshChunk const> aChunks, std::span<MeshLod const> aChunkLods, std::span<Meshlet const> aMeshlets )
+	{
+		aOut.write( reinterpret_cast<char const*>( &aHeader ), sizeof(aHeader) );
+		aOut.write( reinterpret_cast<char const*>( aChunks.data() ), static_cast<std::streamsize>( aChunks.size_bytes() ) );
+		aOut.write( reinterpret_cast<char const*>( aChunkLods.data() ), static_cast<std::streamsize>( aChunkLods.size_bytes() ) );
+		aOut.write( reinterpret_cast<char const*>( aMeshlets.data() ), static_cast<std::streamsize>( aMeshlets.size_bytes() ) );
+		aOut.write( reinterpret_cast<char const*>( aVertices.data() ), static_cast<std::streamsize>( aVertices.size() ) );
+		aOut.write( reinterpret_cast<char const*>( aIndices.data() ), static_cast<std::streamsize>( aIndices.size() ) );
+		return bool(aOut);
+	}
+
+	// Writes aWrite( out )'s output to aPath's temporary name (aPath.tmp),
+	// to be renamed into place once it is complete. Returns the temporary
+	// path, or std::nullopt if the file could not be written completely; the
+	// failure is reported on stderr, and the partial file removed.
+	template< class tWrite >
+	std::optional<std::filesystem::path> write_temporary_( std::filesystem::path const& aPath, tWrite&& aWrite )
+	{
+		auto tempPath = aPath;
+		tempPath += ".tmp";
+
+		{
+			std::ofstream out( tempPath, std::ios::binary | std::ios::trunc );
+			if( out && aWrite( out ) )
+			{
+				out.close();
+				if( out )
+					return tempPath;
+			}
+		}
+
+		std::print( stderr, "Unable to write mesh cache '{}'\n", tempPath.string() );
+
+		std::error_code ec;
+		std::filesystem::remove( tempPath, ec );
+		return std::nullopt;
+	}
+}
+
+std::filesystem::path mesh_cache_path( std::filesystem::path const& aSource )
+{
+	auto ret = aSource;
+	ret += ".meshcache";
+	return ret;
+}
+
+std::optional<CachedMesh> open_mesh_cache( std::filesystem::path const& aSource, std::uint32_t aFormat, std::size_t aVertexSize )
+{
+	auto const cachePath = mesh_cache_path( aSource );
+
+	std::error_code ec;
+	if( !std::filesystem::exists( cachePath, ec ) )
+		return std::nullopt;
+
+	auto const key = file_stamp( aSource );
+	if( !key )
+		return std::nullopt;
+
+	try
+	{
+		MappedFile file( cachePath );
+		auto data = parse_mesh_data( file.bytes(), aFormat, aVertexSize );
+		if( !data )
+			return std::nullopt;
+
+		Header_ header;
+		std::memcpy( &header, file.bytes().data(), sizeof(Header_) );
+
+		if( key->size != header.sourceSize )
+			return std::nullopt;
+
+		if( key->time != header.sourceTime )
+		{
+			if( hash_file( aSource ) != header.sourceHash )
+				return std::nullopt;
+
+			// Same contents; remember the new time so that the next start
+			// does not have to hash the source again. The file is mapped, so
+			// rather than patching it in place, a copy with the new time
+			// replaces it, as in write_mesh_cache(). If that fails, the
+			// caller rebuilds the cache.
+			header.sourceTime = key->time;
+			auto const contents = file.bytes().subspan( sizeof(Header_) );
+			auto const tempPath = write_temporary_( cachePath, [&] ( std::ostream& aOut ) {
+				aOut.write( reinterpret_cast<char const*>( &header ), sizeof(header) );
+				aOut.write( reinterpret_cast<char const*>( contents.data() ), static_cast<std::streamsize>( contents.size() ) );
+				return bool(aOut);
+			} );
+			if( !tempPath )
+				return std::nullopt;
+
+			// Unmap before replacing the file (which Windows requires), and
+			// map the new one.
+			data.reset();
+			file = MappedFile();
+			std::filesystem::rename( *tempPath, cachePath );
+
+			file = MappedFile( cachePath );
+			data = parse_mesh_data( file.bytes(), aFormat, aVertexSize );
+			if( !data )
+				return std::nullopt;
+		}
+
+		// Moving the mapping does not move the mapped memory, so the spans
+		// stay valid.
+		return CachedMesh{ *data, std::move(file) };
+	}
+	catch( std::exception const& eErr )
+	{
+		std::print( stderr, "Ignoring mesh cache '{}': {}\n", cachePath.string(), eErr.what() );
+		return std::nullopt;
+	}
+}
+
+void write_mesh_cache( std::filesystem::path const& aSource, std::uint32_t aFormat, std::size_t aVertexSize, std::span<std::byte const> aVertices, std::span<std::byte const> aIndices, std::span<MeshChunk const> aChunks, std::span<MeshLod const> aChunkLods, std::span<Meshlet const> aMeshlets, MeshCacheInfo const& aInfo ) noexcept
+{
+	assert( aVertices.size() == aInfo.vertexCount * aVertexSize );
+	assert( aIndices.size() == aInfo.indexCount * aInfo.indexSize );
+	assert( aChunks.empty() ? aChunkLods.empty() : aChunkLods.size() % aChunks.size() == 0 );
+
+	auto const cachePath = mesh_cache_path( aSource );
+
+	try
+	{
+		auto const key = file_stamp( aSource );
+		if( !key )
+			return;
+
+		auto header = make_header_( aFormat, aVertexSize, aChunks.size(), aChunkLods.size(), aMeshlets.size(), aInfo );
+		header.sourceSize = key->size;
+		header.sourceTime = key->time;
+		header.sourceHash = hash_file( aSource );
+
+		auto const tempPath = write_temporary_( cachePath, [&] ( std::ostream& aOut ) {
+			return write_( aOut, header, aVertices, aIndices, aChunks, aChunkLods, aMeshlets );
+		} );
+		if( !tempPath )
+			return;
+
+		std::filesystem::rename( *tempPath, cachePath );
+	}
+	catch( std::exception const& eErr )
+	{
+		std::print( stderr, "Unable to write mesh cache '{}': {}\n", cachePath.string(), eErr.what() );
+	}
+}
+
+bool write_mesh_data( std::ostream& aOut, std::uint32_t aFormat, std::size_t aVertexSize, std::span<std::byte const> aVertices, std::span<std::byte const> aIndices, std::span<MeshChunk const> aChunks, std::span<MeshLod const> aChunkLods, std::span<Meshlet const> aMeshlets, MeshCacheInfo const& aInfo )
+{
+	assert( aVertices.size() == aInfo.vertexCount * aVertexSize );
+	assert( aIndices.size() == aInfo.indexCount * aInfo.indexSize );
+	assert( aChunks.empty() ? aChunkLods.empty() : aChunkLods.size() % aChunks.size() == 0 );
+
+	auto const header = make_header_( aFormat, aVertexSize, aChunks.size(), aChunkLods.size(), aMeshlets.size(), aInfo );
+	return write_( aOut, header, aVertices, aIndices, aChunks, aChunkLods, aMeshlets );
+}
+
+std::optional<MeshData> parse_mesh_data( std::span<std::byte const> aBytes, std::uint32_t aFormat, std::size_t aVertexSize ) noexcept
+{
+	assert( 0 == reinterpret_cast<std::uintptr_t>( aBytes.data() ) % 4 );
+
+	if( aBytes.size() < sizeof(Header_) )
+		return std::nullopt;
+
+	Header_ header;
+	std::memcpy( &header, aBytes.data(), sizeof(Header_) );
+
+	if( 0 != std::memcmp( header.magic, kMagic_, sizeof(kMagic_) ) || kVersion_ != header.version )
+		return std::nullopt;
+	if( aFormat != header.format || aVertexSize != header.vertexSize )
+		return std::nullopt;
+	if( 2 != header.indexSize && 4 != header.indexSize )
+		return std::nullopt;
+
+	std::size_t const chunkBytes = header.chunkCount * sizeof(MeshChunk);
+	std::size_t const lodCount = std::size_t(header.chunkCount) * header.lodLevels;
+	std::size_t const lodBytes = lodCount * sizeof(MeshLod);
+	std::size_t const meshletBytes = header.meshletCount * sizeof(Meshlet);
+	std::size_t const tableBytes = chunkBytes + lodBytes + meshletBytes;
+	std::size_t const vertexBytes = header.vertexCount * header.vertexSize;
+	std::size_t const indexBytes = header.indexCount * header.indexSize;
+	if( aBytes.size() - sizeof(Header_) != tableBytes + vertexBytes + indexBytes )
+		return std::nullopt;
+
+	MeshData ret{};
+	ret.info.vertexCount = header.vertexCount;
+	ret.info.indexCount = header.indexCount;
+	ret.info.indexSize = header.indexSize;
+	ret.info.bounds = Aabb3f{
+		{ header.boundsMin[0], header.boundsMin[1], header.boundsMin[2] },
+		{ header.boundsMax[0], header.boundsMax[1], header.boundsMax[2] }
+	};
+	ret.info.center = Vec3f{ header.center[0], header.center[1], header.center[2] };
+	ret.info.radius = header.radius;
+
+	auto const data = aBytes.subspan( sizeof(Header_) );
+	ret.chunks = std::span( reinterpret_cast<MeshChunk const*>( data.data() ), header.chunkCount );
+	ret.chunkLods = std::span( reinterpret_cast<MeshLod const*>( data.data() + chunkBytes ), lodCount );
+	ret.lodLevels = header.lodLevels;
+	ret.meshlets = std::span( reinterpret_cast<Meshlet const*>( data.data() + chunkBytes + lodBytes ), header.meshletCount );
+	ret.vertices = data.subspan( tableBytes, vertexBytes );
+	ret.indices = data.subspan( tableBytes + vertexBytes, indexBytes );
+	return ret;
+}
@@ -0,0 +1,95 @@
+#ifndef MESH_CACHE_HPP_4B8E2F61_C3A7_4D95_9A10_E7F25B6C83D4
+#define MESH_CACHE_HPP_4B8E2F61_C3A7_4D95_9A10_E7F25B6C83D4
+
+#include <span>
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+#include <optional>
+#include <filesystem>
+
+#include "../vmlib/vec3.hpp"
+#include "../vmlib/aabb.hpp"
+#include "../vmlib/chunk_lod.hpp"
+#include "../vmlib/mesh_chunks.hpp"
+#include "../vmlib/meshlets.hpp"
+
+#include "../support/mapped_file.hpp"
+
+/* Binary cache of a mesh's final vertex and index buffers (and its chunks,
+ * their levels of detail, and their meshlets)
+ *
+ * Parsing and triangulating an OBJ, expanding it into an interleaved vertex
+ * array, welding that into an indexed mesh and optimizing its triangle order
+ * is by far the slowest part of startup. The result only depends on the OBJ
+ * file, so it is written to "<source>.meshcache" after the first load.
+ * Subsequent loads map the cache file into memory and pass the vertex and
+ * index data directly to glBufferData().
+ *
+ * A cache file is tied to its source by the source's size, modification time
+ * and a 64-bit hash of its contents:
+ *  - size differs: stale, rebuild.
+ *  - size and modification time match: valid (the source is not read).
+ *  - only the time differs (e.g. after a fresh checkout): the source is
+ *    hashed; if the hash matches, the cache is valid and its time updated.
+ *
+ * The cache also records the vertex format (a caller-chosen tag and the
+ * vertex size) and the index size (2 or 4 bytes), so that changing the
+ * vertex layout invalidates old caches.
+ * Caches are not portable between machines with different endianness or
+ * struct layout; they are only ever meant to be reused locally.
+ *
+ * The same layout, without the source fields, also stores meshes in other
+ * containers, e.g. the asset pack (see asset_pack.hpp, write_mesh_data()
+ * and parse_mesh_data()).
+ */
+struct MeshCacheInfo
+{
+	std::uint64_t vertexCount = 0;
+	std::uint64_t indexCount = 0;
+	std::uint32_t indexSize = 4; // bytes per index: 2 or 4
+	Aabb3f bounds = kEmptyAabb3f;
+	Vec3f center{ 0.f, 0.f, 0.f };
+	float radius = 0.f;
+};
+
+// A stored mesh. The spans point into the memory that it was parsed from.
+struct MeshData
+{
+	MeshCacheInfo info;
+	std::span<MeshChunk const> chunks;
+	std::span<MeshLod const> chunkLods; // lodLevels per chunk, see build_chunk_lods() and build_lod_chain()
+	std::size_t lodLevels;
+	std::span<Meshlet const> meshlets; // see build_meshlets()
+	std::span<std::byte const> vertices;
+	std::span<std::byte const> indices;
+};
+
+struct CachedMesh : MeshData
+{
+	MappedFile file; // the spans point into file
+};
+
+// Path of the cache file for aSource.
+std::filesystem::path mesh_cache_path( std::filesystem::path const& aSource );
+
+// Returns the cached mesh for aSource, or std::nullopt if there is no cache
+// file or it is stale (see above) or unreadable.
+std::optional<CachedMesh> open_mesh_cache( std::filesystem::path const& aSource, std::uint32_t aFormat, std::size_t aVertexSize );
+
+// Writes the cache file for aSource. The file is first written under a
+// temporary name and then renamed, so that an interrupted write never leaves
+// a truncated cache behind. Failures are reported on stderr, but are
+// otherwise ignored: the cache is an optimization only.
+void write_mesh_cache( std::filesystem::path const& aSource, std::uint32_t aFormat, std::size_t aVertexSize, std::span<std::byte const> aVertices, std::span<std::byte const> aIndices, std::span<MeshChunk const> aChunks, std::span<MeshLod const> aChunkLods, std::span<Meshlet const> aMeshlets, MeshCacheInfo const& aInfo ) noexcept;
+
+// Writes a mesh in the cache file layout, but without a source, to aOut.
+// Returns false if writing failed.
+bool write_mesh_data( std::ostream& aOut, std::uint32_t aFormat, std::size_t aVertexSize, std::span<std::byte const> aVertices, std::span<std::byte const> aIndices, std::span<MeshChunk const> aChunks, std::span<MeshLod const> aChunkLods, std::span<Meshlet const> aMeshlets, MeshCacheInfo const& aInfo );
+
+// Parses a mesh written by write_mesh_data() (or a whole cache file, whose
+// source is then not checked). aBytes must be at least 4-byte aligned.
+// Returns std::nullopt if the data is not a mesh of the given format.
+std::optional<MeshData> parse_mesh_data( std::span<std::byte const> aBytes, std::uint32_t aFormat, std::size_t aVertexSize ) noexcept;
+
+#endif // MESH_CACHE_HPP_4B8E2F61_C3A7_4D95_9A10_E7F25B6C83D4
@@ -0,0 +1,151 @@
+#include "startup_tasks.hpp"
+
+#include <print>
+#include <algorithm>
+
+namespace
+{
+	// Width of the timeline's bars, in characters.
+	constexpr std::size_t kTimelineColumns_ = 48;
+}
+
+StartupTrace::Stage::Stage( StartupTrace& aTrace, std::string aName, StageKind aKind )
+	: mTrace( aTrace )
+	, mName( std::move(aName) )
+	, mKind( aKind )
+	, mBegin( Clock::now() )
+{}
+
+StartupTrace::Stage::~Stage()
+{
+	auto const end = Clock::now();
+
+	std::scoped_lock const lock( mTrace.mMutex );
+	mTrace.mEntries.emplace_back( Entry_{ std::move(mName), mKind, std::this_thread::get_id(), mBegin, end } );
+}
+
+StartupTrace::StartupTrace()
+	: mOrigin( Clock::now() )
+	, mMainThread( std::this_thread::get_id() )
+{}
+
+double StartupTrace::elapsed_ms() const noexcept
+{
+	return std::chrono::duration<double, std::milli>( Clock::now() - mOrigin ).count();
+}
+
+void StartupTrace::print() const
+{
+	std::vector<Entry_> entries;
+	{
+		std::scoped_lock const lock( mMutex );
+		entries = mEntries;
+	}
+	if( entries.empty() )
+		return;
+
+	std::ranges::sort( entries, {}, &Entry_::begin );
+
+	auto const ms = [&] ( Clock::time_point aTime ) {
+		return std::chrono::duration<double, std::milli>( aTime - mOrigin ).count();
+	};
+
+	double total = 0.0;
+	for( auto const& entry : entries )
+		total = std::max( total, ms( entry.end ) );
+
+	// Workers are numbered in the order that they start their first stage.
+	std::vector<std::thread::id> workers;
+	auto const thread_name = [&] ( std::thread::id aThread ) {
+		if( mMainThread == aThread )
+			return std::string( "main" );
+
+		auto it = std::ranges::find( workers, aThread );
+		if( workers.end() == it )
+			it = workers.insert( workers.end(), aThread );
+		return "worker " + std::to_string( it - workers.begin() + 1 );
+	};
+
+	std::print( "Startup timeline ({:.1f} ms; '#' working, '.' main thread waiting for workers):\n", total );
+
+	double waiting = 0.0;
+	Entry_ const* lastWorker = nullptr;
+	for( auto const& entry : entries )
+	{
+		double const begin = ms( entry.begin ), end = ms( entry.end );
+
+		std::string bar( kTimelineColumns_, ' ' );
+		auto const column = [&] ( double aMs ) {
+			return std::min( kTimelineColumns_, static_cast<std::size_t>( aMs / std::max( total, 1e-3 ) * double(kTimelineColumns_) ) );
+		};
+		std::size_t const first = std::min( column( begin ), kTimelineColumns_ - 1 );
+		std::size_t const last = std::max( first + 1, column( end ) );
+		std::fill( bar.begin() + std::ptrdiff_t(first), bar.begin() + std::ptrdiff_t(last), StageKind::Wait == entry.kind ? '.' : '#' );
+
+		std::print( "  {:<9} {:8.1f} {:8.1f} |{}| {}\n", thread_name( entry.thread ), begin, end, bar, entry.name );
+
+		if( StageKind::Wait == entry.kind )
+			waiting += end - begin;
+		if( mMainThread != entry.thread && (!lastWorker || entry.end > lastWorker->end) )
+			lastWorker = &entry;
+	}
+
+	std::print( "  main thread waited {:.1f} ms for workers", waiting );
+	if( lastWorker )
+		std::print( "; the last to finish was '{}', at {:.1f} ms", lastWorker->name, ms( lastWorker->end ) );
+	std::print( "\n" );
+}
+
+
+StartupTasks::StartupTasks( StartupTrace& aTrace ) noexcept
+	: mTrace( aTrace )
+{}
+
+void StartupTasks::finish()
+{
+	std::vector<std::exception_ptr> errors( mThreads.size() );
+	for( std::size_t finished = 0; finished < mThreads.size(); )
+	{
+		std::vector<Done_> done;
+		{
+			std::unique_lock lock( mMutex );
+			if( mDone.empty() )
+			{
+				StartupTrace::Stage const stage( mTrace, "(waiting)", StartupTrace::StageKind::Wait );
+				mDoneChanged.wait( lock, [this] { return !mDone.empty(); } );
+			}
+			done.swap( mDone );
+		}
+
+		for( auto const& [id, error] : done )
+		{
+			++finished;
+			errors[id] = error;
+
+			for( auto& upload : mUploads )
+			{
+				if( id != upload.id || errors[id] )
+					continue;
+
+				StartupTrace::Stage const stage( mTrace, mNames[id] + " (upload)" );
+				try
+				{
+					upload.upload();
+				}
+				catch( ... )
+				{
+					errors[id] = std::current_exception();
+				}
+			}
+		}
+	}
+
+	mUploads.clear();
+	mThreads.clear();
+
+	for( auto const& error : errors )
+	{
+		if( error )
+			std::rethrow_exception( error );
+	}
+}
@@ -0,0 +1,194 @@
+#ifndef STARTUP_TASKS_HPP_5F0C8B31_A27E_4D96_B4E8_19D6C3F20A7B
+#define STARTUP_TASKS_HPP_5F0C8B31_A27E_4D96_B4E8_19D6C3F20A7B
+
+#include <mutex>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <exception>
+#include <functional>
+#include <type_traits>
+#include <condition_variable>
+
+/* StartupTrace: a timeline of the stages of startup
+ *
+ * Stages are timed on whichever thread runs them (see Stage), and print()
+ * draws them as one bar each, in order of their start, with the thread that
+ * ran them. Time that the main thread spends waiting for workers is shown
+ * as such, so the critical path (the worker that the main thread waits for
+ * last) is easy to see.
+ */
+class StartupTrace final
+{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		enum class StageKind
+		{
+			Work,
+			Wait
+		};
+
+		// Times a stage from its construction to its destruction.
+		class Stage final
+		{
+			public:
+				Stage( StartupTrace&, std::string aName, StageKind = StageKind::Work );
+				~Stage();
+
+				Stage( Stage const& ) = delete;
+				Stage& operator= (Stage const&) = delete;
+
+			private:
+				StartupTrace& mTrace;
+				std::string mName;
+				StageKind mKind;
+				Clock::time_point mBegin;
+		};
+
+	public:
+		StartupTrace();
+
+	public:
+		double elapsed_ms() const noexcept;
+
+		void print() const;
+
+	private:
+		struct Entry_
+		{
+			std::string name;
+			StageKind kind;
+			std::thread::id thread;
+			Clock::time_point begin, end;
+		};
+
+		Clock::time_point mOrigin;
+		std::thread::id mMainThread;
+
+		mutable std::mutex mMutex;
+		std::vector<Entry_> mEntries;
+};
+
+
+/* StartupTasks: CPU work on worker threads, with GL uploads on the main
+ * thread as each piece completes
+ *
+ * run() starts aWork on a thread of its own (traced as aName) and returns a
+ * handle to its result. then() gives the upload for that result, which
+ * finish() calls on the calling (GL) thread as soon as the work is done:
+ * uploads run in the order that the work completes in, not the order that
+ * it was started in.
+ *
+ * If a piece of work (or its upload) throws, its upload is skipped, and the
+ * exception is rethrown by finish() once all of the work is done, whether
+ * or not the work has an upload. As with parallel_ranges(), the exception
+ * from the earliest started failing task wins.
+ *
+ * Everything that the work refers to must outlive the StartupTasks, whose
+ * destructor waits for all of it.
+ */
+template< class tResult >
+struct StartupTask
+{
+	std::size_t id;
+	std::future<tResult> result;
+};
+
+class StartupTasks final
+{
+	public:
+		explicit StartupTasks( StartupTrace& ) noexcept;
+
+		StartupTasks( StartupTasks const& ) = delete;
+		StartupTasks& operator= (StartupTasks const&) = delete;
+
+	public:
+		template< class tWork >
+		auto run( std::string aName, tWork&& aWork ) -> StartupTask<std::invoke_result_t<tWork&>>;
+
+		// aUpload( result ) runs in finish().
+		template< class tResult, class tUpload >
+		void then( StartupTask<tResult>, tUpload&& aUpload );
+
+		void finish();
+
+	private:
+		struct Upload_
+		{
+			std::size_t id;
+			std::move_only_function<void()> upload;
+		};
+
+		struct Done_
+		{
+			std::size_t id;
+			std::exception_ptr error;
+		};
+
+		StartupTrace& mTrace;
+		std::vector<std::string> mNames;
+		std::vector<Upload_> mUploads;
+
+		std::mutex mMutex;
+		std::condition_variable mDoneChanged;
+		std::vector<Done_> mDone;
+
+		std::vector<std::jthread> mThreads; // last: joined first
+};
+
+template< class tWork > inline
+auto StartupTasks::run( std::string aName, tWork&& aWork ) -> StartupTask<std::invoke_result_t<tWork&>>
+{
+	using Result_ = std::invoke_result_t<tWork&>;
+
+	std::promise<Result_> promise;
+	StartupTask<Result_> ret{ mNames.size(), promise.get_future() };
+	mNames.emplace_back( aName );
+
+	mThreads.emplace_back( [this, id = ret.id, name = std::move(aName), work = std::forward<tWork>(aWork), promise = std::move(promise)] () mutable {
+		std::exception_ptr error;
+		{
+			StartupTrace::Stage const stage( mTrace, std::move(name) );
+			try
+			{
+				if constexpr( std::is_void_v<Result_> )
+				{
+					work();
+					promise.set_value();
+				}
+				else
+				{
+					promise.set_value( work() );
+				}
+			}
+			catch( ... )
+			{
+				error = std::current_exception();
+				promise.set_exception( error );
+			}
+		}
+
+		{
+			std::scoped_lock const lock( mMutex );
+			mDone.emplace_back( Done_{ id, std::move(error) } );
+		}
+		mDoneChanged.notify_one();
+	} );
+
+	return ret;
+}
+
+template< class tResult, class tUpload > inline
+void StartupTasks::then( StartupTask<tResult> aTask, tUpload&& aUpload )
+{
+	mUploads.emplace_back( Upload_{ aTask.id, [result = std::move(aTask.result), upload = std::forward<tUpload>(aUpload)] () mutable {
+		upload( result.get() );
+	} } );
+}
+
+#endif // STARTUP_TASKS_HPP_5F0C8B31_A27E_4D96_B4E8_19D6C3F20A7B
@@ -0,0 +1,360 @@
+#include "texture_stream.hpp"
+
+#include <utility>
+#include <algorithm>
+
+#include "../support/error.hpp"
+
+#include "../vmlib/mip_streaming.hpp"
+
+namespace
+{
+	// GL_COMPRESSED_SRGB_S3TC_DXT1_EXT, from EXT_texture_sRGB, which the
+	// generated GL loader does not include.
+	constexpr GLenum kCompressedSrgbBc1_ = 0x8C4C;
+
+	// Levels up to 256x256 are uploaded when the texture is created: 64 KiB
+	// for BC7, 341 KiB with everything below it in RGBA8.
+	constexpr std::uint32_t kStreamTailSize_ = 256;
+
+	// Upload rate of update(): at 60 frames per second, about 240 MiB/s, so
+	// that the 16 MiB top level of a 4K BC7 texture lands in four frames.
+	constexpr std::size_t kStreamUploadBytes_ = 4 * 1024 * 1024;
+
+	// GL_TEXTURE_MIN_LOD slides down by this many levels per second after a
+	// level lands.
+	constexpr float kStreamFadeLevelsPerSecond_ = 4.f;
+
+	std::span<std::uint8_t const> as_bytes_( std::span<std::byte const> aData ) noexcept
+	{
+		return { reinterpret_cast<std::uint8_t const*>( aData.data() ), aData.size() };
+	}
+}
+
+TextureUploadFormat texture_upload_format( PackTextureFormat aFormat )
+{
+	TextureUploadFormat ret{ GL_SRGB8_ALPHA8, std::nullopt, false };
+	if( PackTextureFormat::Bc1Srgb == aFormat )
+	{
+		ret.blocks = BlockFormat::Bc1;
+		ret.internalFormat = kCompressedSrgbBc1_;
+	}
+	else if( PackTextureFormat::Bc7Srgb == aFormat )
+	{
+		ret.blocks = BlockFormat::Bc7;
+		ret.internalFormat = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+	}
+
+	if( ret.blocks )
+	{
+		GLint supported = GL_TRUE;
+		glGetInternalformativ( GL_TEXTURE_2D, ret.internalFormat, GL_INTERNALFORMAT_SUPPORTED, 1, &supported );
+		if( GL_TRUE != supported )
+		{
+			ret.internalFormat = GL_SRGB8_ALPHA8;
+			ret.decode = true;
+		}
+	}
+
+	return ret;
+}
+
+std::size_t texture_upload_size( TextureUploadFormat const& aFormat, std::uint32_t aWidth, std::uint32_t aHeight ) noexcept
+{
+	if( !aFormat.blocks || aFormat.decode )
+		return std::size_t(aWidth) * aHeight * 4;
+	return compressed_size( *aFormat.blocks, aWidth, aHeight );
+}
+
+void upload_texture_level( TextureUploadFormat const& aFormat, GLint aLevel, std::uint32_t aWidth, std::uint32_t aHeight, std::span<std::byte const> aData )
+{
+	GLsizei const width = static_cast<GLsizei>( aWidth ), height = static_cast<GLsizei>( aHeight );
+	if( !aFormat.blocks )
+	{
+		glTexImage2D( GL_TEXTURE_2D, aLevel, GL_SRGB8_ALPHA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, aData.data() );
+	}
+	else if( !aFormat.decode )
+	{
+		glCompressedTexImage2D( GL_TEXTURE_2D, aLevel, aFormat.internalFormat, width, height, 0, static_cast<GLsizei>( aData.size() ), aData.data() );
+	}
+	else
+	{
+		auto const decoded = decode_blocks( *aFormat.blocks, as_bytes_( aData ), aWidth, aHeight );
+		glTexImage2D( GL_TEXTURE_2D, aLevel, GL_SRGB8_ALPHA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, decoded.data() );
+	}
+}
+
+
+StreamedTexture::StreamedTexture( PackTexture aSource, std::size_t aBudgetBytes, std::string aName )
+	: mSource( std::move(aSource) )
+	, mFormat( texture_upload_format( mSource.format ) )
+	, mName( std::move(aName) )
+	, mBudgetBytes( aBudgetBytes )
+{
+	std::size_t const levelCount = mSource.levels.size();
+	if( 0 == levelCount )
+		throw Error( "Streamed texture '{}' has no levels", mName );
+
+	for( std::size_t level = 0; level < levelCount; ++level )
+		mLevelBytes.emplace_back( texture_upload_size( mFormat, level_width_( level ), level_height_( level ) ) );
+
+	mTailLevel = mip_tail_level( mSource.width, mSource.height, kStreamTailSize_, levelCount );
+	mBudgetLevel = budget_mip_level( mLevelBytes, mBudgetBytes, mTailLevel );
+
+	mBaseLevel = mTailLevel;
+	mNeededLevel = mTailLevel;
+	mTargetLevel = mTailLevel;
+	mQueuedLevel = mTailLevel;
+
+	glGenTextures( 1, &mTexture );
+	if( 0 == mTexture )
+		throw Error( "glGenTextures() failed for '{}'", mName );
+
+	glBindTexture( GL_TEXTURE_2D, mTexture );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>( mBaseLevel ) );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>( levelCount - 1 ) );
+
+	for( std::size_t level = mTailLevel; level < levelCount; ++level )
+		upload_texture_level( mFormat, static_cast<GLint>( level ), level_width_( level ), level_height_( level ), mSource.levels[level] );
+
+	glBindTexture( GL_TEXTURE_2D, 0 );
+
+	mWorker = std::jthread( [this] ( std::stop_token aStop ) { load_levels_( aStop ); } );
+}
+
+StreamedTexture::~StreamedTexture()
+{
+	mWorker.request_stop();
+	if( mWorker.joinable() )
+		mWorker.join();
+
+	glDeleteTextures( 1, &mTexture );
+}
+
+GLuint StreamedTexture::id() const noexcept
+{
+	return mTexture;
+}
+
+std::uint32_t StreamedTexture::width() const noexcept
+{
+	return mSource.width;
+}
+
+std::size_t StreamedTexture::level_count() const noexcept
+{
+	return mSource.levels.size();
+}
+
+void StreamedTexture::update( std::size_t aNeededLevel, float aDeltaSeconds )
+{
+	mNeededLevel = std::min( aNeededLevel, mTailLevel );
+
+	std::size_t const target = std::max( mNeededLevel, mBudgetLevel );
+	mTargetLevel = target;
+
+	std::size_t const keep = std::max( mBudgetLevel, mNeededLevel > 0 ? mNeededLevel - 1 : 0 );
+
+	glBindTexture( GL_TEXTURE_2D, mTexture );
+
+	if( mBaseLevel < keep )
+		evict_( keep );
+
+	if( mQueuedLevel < target )
+	{
+		cancel_( target );
+	}
+	else if( mQueuedLevel > target )
+	{
+		{
+			std::scoped_lock const lock( mMutex );
+			for( std::size_t level = mQueuedLevel; level > target; --level )
+				mQueue.emplace_back( level - 1 );
+		}
+		mQueuedLevel = target;
+		mWake.notify_one();
+	}
+
+	std::size_t bytesLeft = kStreamUploadBytes_;
+	while( bytesLeft > 0 && upload_( bytesLeft ) )
+		;
+
+	if( mMinLod > 0.f )
+	{
+		mMinLod = std::max( 0.f, mMinLod - aDeltaSeconds * kStreamFadeLevelsPerSecond_ );
+		glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MIN_LOD, mMinLod );
+	}
+
+	glBindTexture( GL_TEXTURE_2D, 0 );
+}
+
+TextureStreamStats StreamedTexture::stats() const noexcept
+{
+	return TextureStreamStats{
+		level_count(),
+		mBaseLevel,
+		mNeededLevel,
+		mBudgetLevel,
+		chain_bytes_( mBaseLevel ),
+		chain_bytes_( mNeededLevel ),
+		mBudgetBytes
+	};
+}
+
+void StreamedTexture::load_levels_( std::stop_token aStop )
+{
+	for( ;; )
+	{
+		std::size_t level = 0;
+		{
+			std::unique_lock lock( mMutex );
+			if( !mWake.wait( lock, aStop, [this] { return !mQueue.empty(); } ) )
+				return;
+
+			level = mQueue.front();
+			mQueue.pop_front();
+		}
+
+		// Reading the mapped pages is what takes the time (unless they are
+		// cached already).
+		auto const source = as_bytes_( mSource.levels[level] );
+
+		Level_ loaded{ level, {} };
+		if( mFormat.decode )
+			loaded.data = decode_blocks( *mFormat.blocks, source, level_width_( level ), level_height_( level ) );
+		else
+			loaded.data.assign( source.begin(), source.end() );
+
+		std::scoped_lock const lock( mMutex );
+		mLoaded.emplace_back( std::move(loaded) );
+	}
+}
+
+void StreamedTexture::evict_( std::size_t aKeepLevel )
+{
+	// Stop sampling the levels first.
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>( aKeepLevel ) );
+	glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MIN_LOD, 0.f );
+	mMinLod = 0.f;
+
+	for( std::size_t level = mBaseLevel; level < aKeepLevel; ++level )
+		release_level_( level );
+
+	mBaseLevel = aKeepLevel;
+}
+
+void StreamedTexture::cancel_( std::size_t aTargetLevel )
+{
+	{
+		std::scoped_lock const lock( mMutex );
+		std::erase_if( mQueue, [&] ( std::size_t aLevel ) { return aLevel < aTargetLevel; } );
+		std::erase_if( mLoaded, [&] ( Level_ const& aLevel ) { return aLevel.level < aTargetLevel; } );
+	}
+
+	if( mUploading && mUploading->level < aTargetLevel )
+	{
+		release_level_( mUploading->level );
+		mUploading.reset();
+	}
+
+	mQueuedLevel = std::min( aTargetLevel, mBaseLevel );
+}
+
+bool StreamedTexture::upload_( std::size_t& aBytesLeft )
+{
+	if( !mUploading )
+	{
+		if( 0 == mBaseLevel )
+			return false;
+
+		{
+			std::scoped_lock const lock( mMutex );
+
+			// Drop levels that the worker finished after a cancel_(): those
+			// that are resident already, and those that are no longer
+			// wanted (see wanted_mip_level()).
+			std::erase_if( mLoaded, [&] ( Level_ const& aLevel ) { return !wanted_mip_level( aLevel.level, mBaseLevel, mTargetLevel ); } );
+
+			auto const next = std::ranges::find( mLoaded, mBaseLevel - 1, &Level_::level );
+			if( mLoaded.end() == next )
+				return false;
+
+			mUploading = std::move(*next);
+			mLoaded.erase( next );
+		}
+
+		// Allocate the level; its contents are uploaded in bands below.
+		std::size_t const level = mUploading->level;
+		GLsizei const width = static_cast<GLsizei>( level_width_( level ) ), height = static_cast<GLsizei>( level_height_( level ) );
+		if( mFormat.blocks && !mFormat.decode )
+			glCompressedTexImage2D( GL_TEXTURE_2D, static_cast<GLint>( level ), mFormat.internalFormat, width, height, 0, static_cast<GLsizei>( mLevelBytes[level] ), nullptr );
+		else
+			glTexImage2D( GL_TEXTURE_2D, static_cast<GLint>( level ), GL_SRGB8_ALPHA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr );
+
+		mUploadedRows = 0;
+	}
+
+	// Bands of whole rows of blocks (four rows of texels) or of texels.
+	std::size_t const level = mUploading->level;
+	std::uint32_t const width = level_width_( level ), height = level_height_( level );
+	bool const compressed = mFormat.blocks && !mFormat.decode;
+	std::uint32_t const rowUnit = compressed ? 4 : 1;
+	std::size_t const unitBytes = texture_upload_size( mFormat, width, rowUnit );
+
+	std::size_t const units = std::max<std::size_t>( 1, aBytesLeft / unitBytes );
+	std::uint32_t const rows = static_cast<std::uint32_t>( std::min<std::size_t>( height - mUploadedRows, units * rowUnit ) );
+	std::size_t const offset = mUploadedRows / rowUnit * unitBytes;
+	std::size_t const bytes = std::min( mUploading->data.size() - offset, (rows + rowUnit - 1) / rowUnit * unitBytes );
+
+	std::uint8_t const* const data = mUploading->data.data() + offset;
+	if( compressed )
+		glCompressedTexSubImage2D( GL_TEXTURE_2D, static_cast<GLint>( level ), 0, static_cast<GLint>( mUploadedRows ), static_cast<GLsizei>( width ), static_cast<GLsizei>( rows ), mFormat.internalFormat, static_cast<GLsizei>( bytes ), data );
+	else
+		glTexSubImage2D( GL_TEXTURE_2D, static_cast<GLint>( level ), 0, static_cast<GLint>( mUploadedRows ), static_cast<GLsizei>( width ), static_cast<GLsizei>( rows ), GL_RGBA, GL_UNSIGNED_BYTE, data );
+
+	mUploadedRows += rows;
+	aBytesLeft -= std::min( aBytesLeft, bytes );
+
+	if( mUploadedRows < height )
+		return true;
+
+	// The level is complete. Sample it, but at the level of detail that was
+	// sampled so far, and fade from there (see update()).
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>( level ) );
+	mMinLod += float(mBaseLevel - level);
+	glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MIN_LOD, mMinLod );
+
+	mBaseLevel = level;
+	mUploading.reset();
+	return true;
+}
+
+void StreamedTexture::release_level_( std::size_t aLevel )
+{
+	// A zero-sized image releases the level's storage.
+	if( mFormat.blocks && !mFormat.decode )
+		glCompressedTexImage2D( GL_TEXTURE_2D, static_cast<GLint>( aLevel ), mFormat.internalFormat, 0, 0, 0, 0, nullptr );
+	else
+		glTexImage2D( GL_TEXTURE_2D, static_cast<GLint>( aLevel ), GL_SRGB8_ALPHA8, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr );
+}
+
+std::uint32_t StreamedTexture::level_width_( std::size_t aLevel ) const noexcept
+{
+	return std::max( 1u, mSource.width >> aLevel );
+}
+std::uint32_t StreamedTexture::level_height_( std::size_t aLevel ) const noexcept
+{
+	return std::max( 1u, mSource.height >> aLevel );
+}
+
+std::size_t StreamedTexture::chain_bytes_( std::size_t aFirstLevel ) const noexcept
+{
+	std::size_t ret = 0;
+	for( std::size_t level = aFirstLevel; level < mLevelBytes.size(); ++level )
+		ret += mLevelBytes[level];
+	return ret;
+}
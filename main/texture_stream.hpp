@@ -0,0 +1,152 @@
+#ifndef TEXTURE_STREAM_HPP_C27B4E90_5D1F_4A83_9E6C_08F3A1D7B542
+#define TEXTURE_STREAM_HPP_C27B4E90_5D1F_4A83_9E6C_08F3A1D7B542
+
+#include <glad/glad.h>
+
+#include <span>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stop_token>
+#include <condition_variable>
+
+#include "../vmlib/block_compression.hpp"
+
+#include "asset_pack.hpp"
+
+/* GL formats of the levels of a PackTexture
+ *
+ * BC7 is core since OpenGL 4.2, but BC1 (S3TC) is an extension. Blocks that
+ * the GL cannot take are decoded to 8-bit RGBA on the CPU (decode is set),
+ * and the texture is GL_SRGB8_ALPHA8.
+ */
+struct TextureUploadFormat
+{
+	GLenum internalFormat;
+	std::optional<BlockFormat> blocks; // the pack's blocks, if any
+	bool decode;
+};
+
+TextureUploadFormat texture_upload_format( PackTextureFormat );
+
+// Size in bytes of an aWidth x aHeight level on the GPU.
+std::size_t texture_upload_size( TextureUploadFormat const&, std::uint32_t aWidth, std::uint32_t aHeight ) noexcept;
+
+// Uploads aData, a whole aWidth x aHeight level as stored in the pack, to
+// level aLevel of the texture bound to GL_TEXTURE_2D.
+void upload_texture_level( TextureUploadFormat const&, GLint aLevel, std::uint32_t aWidth, std::uint32_t aHeight, std::span<std::byte const> aData );
+
+
+/* StreamedTexture: a texture from the asset pack whose finer mip levels are
+ * loaded as the camera needs them
+ *
+ * The texture is created with its mip tail only (the levels of at most 256
+ * texels on a side; see mip_tail_level() in vmlib/mip_streaming.hpp), which
+ * is small enough to upload at once.
+ *
+ * update() is called every frame with the finest level that the camera needs
+ * (see needed_mip_level()). Missing levels, up to that one, are copied out
+ * of the mapped pack by a worker thread, so that the render thread does not
+ * wait for the pages to be read from disk (and, for blocks that the GL
+ * cannot take, decoded there too). update() then uploads them, coarsest
+ * first, a few MiB per frame in bands of rows. GL_TEXTURE_BASE_LEVEL is the
+ * finest complete level, so the GL never samples a level that is still being
+ * uploaded; when a level lands, GL_TEXTURE_MIN_LOD first holds the sampled
+ * level where it was and then slides down to it over a few frames, so the
+ * new detail fades in instead of popping.
+ *
+ * The resident levels never take more than the budget (except for the mip
+ * tail, which is always resident); see budget_mip_level(). Levels more than
+ * one finer than the camera needs are dropped again, so a camera that moves
+ * back and forth over a level boundary does not reload the level.
+ *
+ * The PackTexture refers to the pack's mapping, so the AssetPack must
+ * outlive the StreamedTexture. The StreamedTexture owns its GL texture, and
+ * must be destroyed while the GL context is current.
+ */
+struct TextureStreamStats
+{
+	std::size_t levelCount;
+	std::size_t residentLevel;   // finest level on the GPU
+	std::size_t requestedLevel;  // finest level that the camera needs
+	std::size_t budgetLevel;     // finest level that the budget allows
+
+	std::size_t residentBytes;   // levels residentLevel onwards
+	std::size_t requestedBytes;  // levels requestedLevel onwards
+	std::size_t budgetBytes;
+};
+
+class StreamedTexture final
+{
+	public:
+		StreamedTexture( PackTexture, std::size_t aBudgetBytes, std::string aName );
+		~StreamedTexture();
+
+		StreamedTexture( StreamedTexture const& ) = delete;
+		StreamedTexture& operator= (StreamedTexture const&) = delete;
+
+	public:
+		GLuint id() const noexcept;
+
+		std::uint32_t width() const noexcept;
+		std::size_t level_count() const noexcept;
+
+		void update( std::size_t aNeededLevel, float aDeltaSeconds );
+
+		TextureStreamStats stats() const noexcept;
+
+	private:
+		struct Level_
+		{
+			std::size_t level;
+			std::vector<std::uint8_t> data; // as uploaded
+		};
+
+		void load_levels_( std::stop_token );
+
+		void evict_( std::size_t aKeepLevel );
+		void cancel_( std::size_t aTargetLevel );
+		bool upload_( std::size_t& aBytesLeft );
+		void release_level_( std::size_t );
+
+		std::uint32_t level_width_( std::size_t ) const noexcept;
+		std::uint32_t level_height_( std::size_t ) const noexcept;
+		std::size_t chain_bytes_( std::size_t aFirstLevel ) const noexcept;
+
+	private:
+		PackTexture mSource;
+		TextureUploadFormat mFormat;
+		std::string mName;
+
+		std::vector<std::size_t> mLevelBytes; // on the GPU
+		std::size_t mBudgetBytes;
+		std::size_t mTailLevel;
+		std::size_t mBudgetLevel;
+
+		GLuint mTexture = 0;
+
+		// Render thread only.
+		std::size_t mBaseLevel;      // finest resident level
+		std::size_t mNeededLevel;    // as of the last update()
+		std::size_t mTargetLevel;    // finest level to load, likewise
+		std::size_t mQueuedLevel;    // finest level asked of the worker
+		float mMinLod = 0.f;
+
+		std::optional<Level_> mUploading; // level mBaseLevel-1
+		std::uint32_t mUploadedRows = 0;
+
+		// Shared with the worker.
+		std::mutex mMutex;
+		std::condition_variable_any mWake;
+		std::deque<std::size_t> mQueue;
+		std::vector<Level_> mLoaded;
+
+		std::jthread mWorker; // last: stopped and joined first
+};
+
+#endif // TEXTURE_STREAM_HPP_C27B4E90_5D1F_4A83_9E6C_08F3A1D7B542
@@ -0,0 +1,105 @@
+#ifndef VERTEX_FORMATS_HPP_E19B4C7D_2A58_4F36_B0C9_5D7E83A16F24
+#define VERTEX_FORMATS_HPP_E19B4C7D_2A58_4F36_B0C9_5D7E83A16F24
+
+#include <cstdint>
+
+#include "../vmlib/vec2.hpp"
+#include "../vmlib/vec3.hpp"
+
+#include "vertex_layout.hpp"
+
+/* Vertex formats of the meshes
+ *
+ * Shared by the application and the asset compiler (assetc), so that both
+ * agree on the layout of stored vertex buffers.
+ */
+struct VertexPNT
+{
+	Vec3f position;
+	Vec3f normal;
+	Vec2f texCoord;
+};
+
+struct VertexPNC
+{
+	Vec3f position;
+	Vec3f normal;
+	Vec3f color;
+};
+
+// Packed variants (see vmlib/quantize.hpp): positions are unorm16
+// relative to the mesh bounds and normals octahedral snorm16; both are
+// decoded in the vertex shader. The fourth position component is padding
+// that keeps the following attributes 4-byte aligned.
+struct PackedVertexPNT
+{
+	std::uint16_t position[4];
+	std::int16_t normal[2];
+	std::uint16_t texCoord[2]; // half floats
+};
+
+struct PackedVertexPNC
+{
+	std::uint16_t position[4];
+	std::int16_t normal[2];
+	std::uint8_t color[4]; // RGBA8, alpha is always 255
+};
+
+static_assert( sizeof( PackedVertexPNT ) == 16 );
+static_assert( sizeof( PackedVertexPNC ) == 16 );
+
+// Vertex format tags for the mesh cache. Change the tag when the meaning
+// of a format changes without its size changing.
+constexpr std::uint32_t kMeshCacheFormatPNT = 1;
+constexpr std::uint32_t kMeshCacheFormatPNC = 2;
+
+// Per vertex format: its attributes (see vertex_layout.hpp), and for the
+// full formats, the packed variant and the mesh cache tag.
+template< class tVertex >
+struct VertexTraits;
+
+template<>
+struct VertexTraits<VertexPNT>
+{
+	using Layout = VertexLayout< VertexPNT,
+		VertexAttribute< VertexSemantic::Position, &VertexPNT::position, 3, GL_FLOAT >,
+		VertexAttribute< VertexSemantic::Normal, &VertexPNT::normal, 3, GL_FLOAT >,
+		VertexAttribute< VertexSemantic::TexCoord, &VertexPNT::texCoord, 2, GL_FLOAT >
+	>;
+	using Packed = PackedVertexPNT;
+	static constexpr std::uint32_t kCacheFormat = kMeshCacheFormatPNT;
+};
+
+template<>
+struct VertexTraits<VertexPNC>
+{
+	using Layout = VertexLayout< VertexPNC,
+		VertexAttribute< VertexSemantic::Position, &VertexPNC::position, 3, GL_FLOAT >,
+		VertexAttribute< VertexSemantic::Normal, &VertexPNC::normal, 3, GL_FLOAT >,
+		VertexAttribute< VertexSemantic::Color, &VertexPNC::color, 3, GL_FLOAT >
+	>;
+	using Packed = PackedVertexPNC;
+	static constexpr std::uint32_t kCacheFormat = kMeshCacheFormatPNC;
+};
+
+template<>
+struct VertexTraits<PackedVertexPNT>
+{
+	using Layout = VertexLayout< PackedVertexPNT,
+		VertexAttribute< VertexSemantic::Position, &PackedVertexPNT::position, 3, GL_UNSIGNED_SHORT, GL_TRUE >,
+		VertexAttribute< VertexSemantic::Normal, &PackedVertexPNT::normal, 2, GL_SHORT, GL_TRUE >,
+		VertexAttribute< VertexSemantic::TexCoord, &PackedVertexPNT::texCoord, 2, GL_HALF_FLOAT >
+	>;
+};
+
+template<>
+struct VertexTraits<PackedVertexPNC>
+{
+	using Layout = VertexLayout< PackedVertexPNC,
+		VertexAttribute< VertexSemantic::Position, &PackedVertexPNC::position, 3, GL_UNSIGNED_SHORT, GL_TRUE >,
+		VertexAttribute< VertexSemantic::Normal, &PackedVertexPNC::normal, 2, GL_SHORT, GL_TRUE >,
+		VertexAttribute< VertexSemantic::Color, &PackedVertexPNC::color, 3, GL_UNSIGNED_BYTE, GL_TRUE >
+	>;
+};
+
+#endif // VERTEX_FORMATS_HPP_E19B4C7D_2A58_4F36_B0C9_5D7E83A16F24
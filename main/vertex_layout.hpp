@@ -0,0 +1,116 @@
+#ifndef VERTEX_LAYOUT_HPP_7A3D95E2_0C4B_4F18_8E6A_B2D14F97C35E
+#define VERTEX_LAYOUT_HPP_7A3D95E2_0C4B_4F18_8E6A_B2D14F97C35E
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <type_traits>
+
+/* Compile-time description of an interleaved vertex format
+ *
+ * A VertexLayout lists the attributes of a vertex struct, in the order of
+ * their shader locations (the first attribute is location 0, and so on).
+ * Each attribute names its meaning, the struct member it is stored in, and
+ * how OpenGL reads it:
+ *
+ *   using Layout = VertexLayout< VertexPNT,
+ *       VertexAttribute< VertexSemantic::Position, &VertexPNT::position, 3, GL_FLOAT >,
+ *       VertexAttribute< VertexSemantic::Normal, &VertexPNT::normal, 3, GL_FLOAT >,
+ *       ...
+ *   >;
+ *
+ * declare_vertex_attributes() emits the glVertexAttribPointer() calls for a
+ * layout. Code that fills vertices can ask has_attribute_v and
+ * attribute_member_v which attributes a format has, and skip (with
+ * `if constexpr`) the work for those it does not; see
+ * detail::make_corners_() in mesh_build.hpp and pack_vertex_() in main.cpp.
+ */
+enum class VertexSemantic
+{
+	Position,
+	Normal,
+	TexCoord,
+	Color
+};
+
+template< VertexSemantic tSemantic, auto tMember, GLint tComponents, GLenum tType, GLboolean tNormalized = GL_FALSE >
+struct VertexAttribute
+{
+	static_assert( std::is_member_object_pointer_v<decltype(tMember)> );
+
+	static constexpr VertexSemantic semantic = tSemantic;
+	static constexpr auto member = tMember;
+	static constexpr GLint components = tComponents;
+	static constexpr GLenum type = tType;
+	static constexpr GLboolean normalized = tNormalized;
+};
+
+template< class tVertex, class... tAttributes >
+struct VertexLayout
+{
+	using Vertex = tVertex;
+};
+
+namespace detail
+{
+	template< class... tAttributes >
+	struct Attributes_ {};
+
+	template< VertexSemantic tSemantic >
+	consteval auto find_member_( Attributes_<> ) noexcept
+	{
+		return nullptr;
+	}
+	template< VertexSemantic tSemantic, class tFirst, class... tRest >
+	consteval auto find_member_( Attributes_<tFirst, tRest...> ) noexcept
+	{
+		if constexpr( tSemantic == tFirst::semantic )
+			return tFirst::member;
+		else
+			return find_member_<tSemantic>( Attributes_<tRest...>{} );
+	}
+
+	template< VertexSemantic tSemantic, class tVertex, class... tAttributes >
+	consteval auto layout_member_( VertexLayout<tVertex, tAttributes...> ) noexcept
+	{
+		return find_member_<tSemantic>( Attributes_<tAttributes...>{} );
+	}
+
+	template< class tVertex, class tMember >
+	std::size_t member_offset_( tMember tVertex::* aMember ) noexcept
+	{
+		tVertex const vertex{};
+		return static_cast<std::size_t>( reinterpret_cast<std::byte const*>( &(vertex.*aMember) ) - reinterpret_cast<std::byte const*>( &vertex ) );
+	}
+}
+
+// The member that holds tSemantic in tLayout's vertex (the first one, if
+// several do), or nullptr if there is none.
+template< class tLayout, VertexSemantic tSemantic >
+constexpr auto attribute_member_v = detail::layout_member_<tSemantic>( tLayout{} );
+
+template< class tLayout, VertexSemantic tSemantic >
+constexpr bool has_attribute_v = !std::is_null_pointer_v<std::remove_const_t<decltype(attribute_member_v<tLayout, tSemantic>)>>;
+
+// Enables and declares the attributes of tLayout for the bound VAO and
+// GL_ARRAY_BUFFER, at locations 0, 1, ...
+template< class tVertex, class... tAttributes >
+void declare_vertex_attributes( VertexLayout<tVertex, tAttributes...> )
+{
+	GLuint location = 0;
+	( [&] {
+		glEnableVertexAttribArray( location );
+		glVertexAttribPointer( location, tAttributes::components, tAttributes::type, tAttributes::normalized, sizeof( tVertex ),
+			reinterpret_cast<void*>( detail::member_offset_( tAttributes::member ) )
+		);
+		++location;
+	}(), ... );
+}
+
+template< class tLayout >
+void declare_vertex_attributes()
+{
+	declare_vertex_attributes( tLayout{} );
+}
+
+#endif // VERTEX_LAYOUT_HPP_7A3D95E2_0C4B_4F18_8E6A_B2D14F97C35E
@@ -103,6 +103,30 @@ project "main"
 	links "x-glfw"
 	links "x-fontstash"
 
+project "assetc"
+	local sources = { 
+		"assetc/**.cpp",
+		"assetc/**.hpp",
+
+		-- Shared with main; see main/asset_pack.hpp
+		"main/mesh_build.cpp",
+		"main/mesh_cache.cpp",
+		"main/asset_pack.cpp",
+		"main/image_decode.cpp"
+	}
+
+	kind "ConsoleApp"
+	location "assetc"
+
+	files( sources )
+
+	dependson "x-rapidobj"
+
+	links "vmlib"
+	links "support"
+
+	links "x-stb"
+
 project "main-shaders"
 	local shaders = { 
 		"assets/cw2/*.vert",
@@ -133,6 +157,7 @@ project "vmlib-test"
 
 	links "vmlib"
 
+	links "x-stb"
 	links "x-catch2"
 
 project "support"
@@ -0,0 +1,75 @@
+#include "file_hash.hpp"
+
+#include <algorithm>
+#include <system_error>
+
+#include <cstring>
+
+#include "mapped_file.hpp"
+
+namespace
+{
+	std::uint64_t mix_( std::uint64_t aX ) noexcept
+	{
+		// splitmix64 finalizer
+		aX = (aX ^ (aX >> 30)) * 0xBF58476D1CE4E5B9ull;
+		aX = (aX ^ (aX >> 27)) * 0x94D049BB133111EBull;
+		return aX ^ (aX >> 31);
+	}
+}
+
+// The four independent lanes let consecutive words be processed in
+// parallel.
+std::uint64_t hash_bytes( std::span<std::byte const> aBytes ) noexcept
+{
+	constexpr std::uint64_t kPrime = 0x9E3779B97F4A7C15ull;
+
+	std::uint64_t lanes[4] = { 1, 2, 3, 4 };
+
+	std::byte const* data = aBytes.data();
+	std::size_t const count = aBytes.size();
+
+	std::size_t i = 0;
+	for( ; i + 32 <= count; i += 32 )
+	{
+		for( std::size_t k = 0; k < 4; ++k )
+		{
+			std::uint64_t word;
+			std::memcpy( &word, data + i + 8*k, 8 );
+			lanes[k] = (lanes[k] ^ word) * kPrime;
+			lanes[k] ^= lanes[k] >> 29;
+		}
+	}
+
+	for( std::size_t k = 0; i < count; i += 8, ++k )
+	{
+		std::uint64_t word = 0;
+		std::memcpy( &word, data + i, std::min<std::size_t>( 8, count - i ) );
+		lanes[k] = (lanes[k] ^ word) * kPrime;
+	}
+
+	std::uint64_t hash = count;
+	for( auto const lane : lanes )
+		hash = (hash ^ mix_( lane )) * kPrime;
+	return mix_( hash );
+}
+
+std::uint64_t hash_file( std::filesystem::path const& aPath )
+{
+	MappedFile const file( aPath );
+	return hash_bytes( file.bytes() );
+}
+
+std::optional<FileStamp> file_stamp( std::filesystem::path const& aPath ) noexcept
+{
+	std::error_code ec;
+	auto const size = std::filesystem::file_size( aPath, ec );
+	if( ec )
+		return std::nullopt;
+
+	auto const time = std::filesystem::last_write_time( aPath, ec );
+	if( ec )
+		return std::nullopt;
+
+	return FileStamp{ size, static_cast<std::int64_t>( time.time_since_epoch().count() ) };
+}
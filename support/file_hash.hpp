@@ -0,0 +1,31 @@
+#ifndef FILE_HASH_HPP_C84A1E39_5F27_4B6D_9E03_A7D2B6F1845C
+#define FILE_HASH_HPP_C84A1E39_5F27_4B6D_9E03_A7D2B6F1845C
+
+#include <span>
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+#include <filesystem>
+
+// 64-bit hash of a byte range. Not cryptographic; it only needs to tell
+// edited files apart. It runs at several GB/s, so that checking a derived
+// file (e.g., a mesh cache) against its source adds little to a warm start.
+std::uint64_t hash_bytes( std::span<std::byte const> ) noexcept;
+
+// Hash of the contents of a file (see hash_bytes()). Throws Error if the
+// file cannot be read.
+std::uint64_t hash_file( std::filesystem::path const& );
+
+// Size and modification time of a file. Files derived from it record these,
+// and only need to hash it when the time changes (e.g. after a fresh
+// checkout) but the size does not.
+struct FileStamp
+{
+	std::uint64_t size;
+	std::int64_t time;
+};
+
+// Returns std::nullopt if the file does not exist or cannot be queried.
+std::optional<FileStamp> file_stamp( std::filesystem::path const& ) noexcept;
+
+#endif // FILE_HASH_HPP_C84A1E39_5F27_4B6D_9E03_A7D2B6F1845C
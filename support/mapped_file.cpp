@@ -0,0 +1,121 @@
+#include "mapped_file.hpp"
+
+#include <utility>
+
+#include "error.hpp"
+
+#if defined(_WIN32)
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <windows.h>
+#else // POSIX
+#	include <fcntl.h>
+#	include <unistd.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <cerrno>
+#	include <cstring>
+#endif
+
+#if defined(_WIN32)
+MappedFile::MappedFile( std::filesystem::path const& aPath )
+{
+	HANDLE const file = CreateFileW( aPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+	if( INVALID_HANDLE_VALUE == file )
+		throw Error( "Unable to open '{}': error {}", aPath.string(), GetLastError() );
+
+	LARGE_INTEGER size{};
+	if( !GetFileSizeEx( file, &size ) )
+	{
+		auto const err = GetLastError();
+		CloseHandle( file );
+		throw Error( "Unable to query size of '{}': error {}", aPath.string(), err );
+	}
+
+	if( 0 == size.QuadPart )
+	{
+		CloseHandle( file );
+		return;
+	}
+
+	// As with mmap(), the view keeps the file open; neither handle is needed
+	// once the view exists.
+	HANDLE const mapping = CreateFileMappingW( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+	auto err = GetLastError();
+	CloseHandle( file );
+
+	if( !mapping )
+		throw Error( "Unable to map '{}': error {}", aPath.string(), err );
+
+	void const* const data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+	err = GetLastError();
+	CloseHandle( mapping );
+
+	if( !data )
+		throw Error( "Unable to map '{}': error {}", aPath.string(), err );
+
+	mData = static_cast<std::byte const*>( data );
+	mSize = static_cast<std::size_t>( size.QuadPart );
+}
+
+MappedFile::~MappedFile()
+{
+	if( mData )
+		UnmapViewOfFile( mData );
+}
+#else // POSIX
+MappedFile::MappedFile( std::filesystem::path const& aPath )
+{
+	int const fd = ::open( aPath.c_str(), O_RDONLY );
+	if( -1 == fd )
+		throw Error( "Unable to open '{}': {}", aPath.string(), std::strerror( errno ) );
+
+	struct stat info{};
+	if( -1 == ::fstat( fd, &info ) )
+	{
+		auto const err = errno;
+		::close( fd );
+		throw Error( "Unable to query size of '{}': {}", aPath.string(), std::strerror( err ) );
+	}
+
+	mSize = static_cast<std::size_t>( info.st_size );
+	if( 0 == mSize )
+	{
+		::close( fd );
+		return;
+	}
+
+	// The mapping keeps its own reference to the file; the descriptor is not
+	// needed after this.
+	void* const data = ::mmap( nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0 );
+	auto const err = errno;
+	::close( fd );
+
+	if( MAP_FAILED == data )
+		throw Error( "Unable to map '{}': {}", aPath.string(), std::strerror( err ) );
+
+	mData = static_cast<std::byte const*>( data );
+}
+
+MappedFile::~MappedFile()
+{
+	if( mData )
+		::munmap( const_cast<std::byte*>( mData ), mSize );
+}
+#endif // ~ _WIN32
+
+MappedFile::MappedFile( MappedFile&& aOther ) noexcept
+	: mData( std::exchange( aOther.mData, nullptr ) )
+	, mSize( std::exchange( aOther.mSize, 0 ) )
+{}
+MappedFile& MappedFile::operator= (MappedFile&& aOther) noexcept
+{
+	std::swap( mData, aOther.mData );
+	std::swap( mSize, aOther.mSize );
+	return *this;
+}
+
+std::span<std::byte const> MappedFile::bytes() const noexcept
+{
+	return { mData, mSize };
+}
@@ -0,0 +1,44 @@
+#ifndef MAPPED_FILE_HPP_7C1D5B3E_94A2_4F60_8E3B_2D6A90F4C1B7
+#define MAPPED_FILE_HPP_7C1D5B3E_94A2_4F60_8E3B_2D6A90F4C1B7
+
+#include <span>
+#include <cstddef>
+#include <filesystem>
+
+// Read-only memory mapping of a whole file.
+//
+// The contents are paged in on first access, so that a large file can be
+// handed to e.g. glBufferData() without first copying it into a separately
+// allocated buffer. The mapping stays valid for the lifetime of the object.
+//
+// Throws Error if the file cannot be opened or mapped. Empty files are mapped
+// as an empty span.
+//
+// Example:
+//
+//	MappedFile const file( "assets/cw2/parlahti.obj" );
+//	std::span<std::byte const> bytes = file.bytes();
+//
+class MappedFile final
+{
+	public:
+		MappedFile() noexcept = default;
+		explicit MappedFile( std::filesystem::path const& );
+
+		~MappedFile();
+
+		MappedFile( MappedFile const& ) = delete;
+		MappedFile& operator= (MappedFile const&) = delete;
+
+		MappedFile( MappedFile&& ) noexcept;
+		MappedFile& operator= (MappedFile&&) noexcept;
+
+	public:
+		std::span<std::byte const> bytes() const noexcept;
+
+	private:
+		std::byte const* mData = nullptr;
+		std::size_t mSize = 0;
+};
+
+#endif // MAPPED_FILE_HPP_7C1D5B3E_94A2_4F60_8E3B_2D6A90F4C1B7
@@ -0,0 +1,91 @@
+#ifndef PARALLEL_HPP_3F8A6C20_D51B_4E7A_9C43_86B1E2F07D59
+#define PARALLEL_HPP_3F8A6C20_D51B_4E7A_9C43_86B1E2F07D59
+
+#include <vector>
+#include <thread>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <exception>
+
+// Number of worker threads to use by default: one per hardware thread.
+inline
+std::size_t default_thread_count() noexcept
+{
+	return std::max<std::size_t>( 1, std::thread::hardware_concurrency() );
+}
+
+// Splits [0, aCount) into at most aThreadCount contiguous ranges of (nearly)
+// equal size, and calls
+//
+//	aBody( begin, end, rangeIndex )
+//
+// for each range. The first range runs on the calling thread, the others on
+// threads started for this call; parallel_ranges() returns once all of them
+// are done. Ranges are never empty, so rangeIndex < min( aCount, aThreadCount ).
+//
+// If aBody throws, the exception from the lowest-numbered failing range is
+// rethrown after all threads have finished.
+//
+// Example (per-thread partial sums, reduced afterwards):
+//
+//	std::vector<float> partial( threads );
+//	parallel_ranges( data.size(), threads, [&] ( std::size_t aBegin, std::size_t aEnd, std::size_t aRange ) {
+//		for( auto i = aBegin; i < aEnd; ++i )
+//			partial[aRange] += data[i];
+//	} );
+//
+template< class tBody >
+void parallel_ranges( std::size_t aCount, std::size_t aThreadCount, tBody&& aBody )
+{
+	std::size_t const ranges = std::min( aCount, std::max<std::size_t>( 1, aThreadCount ) );
+	if( ranges <= 1 )
+	{
+		if( aCount )
+			aBody( std::size_t(0), aCount, std::size_t(0) );
+		return;
+	}
+
+	auto const range_begin = [&] ( std::size_t aRange ) {
+		return aCount / ranges * aRange + std::min( aRange, aCount % ranges );
+	};
+
+	std::vector<std::exception_ptr> errors( ranges );
+	auto const run = [&] ( std::size_t aRange ) {
+		try
+		{
+			aBody( range_begin( aRange ), range_begin( aRange+1 ), aRange );
+		}
+		catch( ... )
+		{
+			errors[aRange] = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve( ranges - 1 );
+	try
+	{
+		for( std::size_t i = 1; i < ranges; ++i )
+			workers.emplace_back( run, i );
+	}
+	catch( ... )
+	{
+		for( auto& worker : workers )
+			worker.join();
+		throw;
+	}
+
+	run( 0 );
+
+	for( auto& worker : workers )
+		worker.join();
+
+	for( auto const& error : errors )
+	{
+		if( error )
+			std::rethrow_exception( error );
+	}
+}
+
+#endif // PARALLEL_HPP_3F8A6C20_D51B_4E7A_9C43_86B1E2F07D59
@@ -0,0 +1,35 @@
+#include "process_memory.hpp"
+
+#if defined(_WIN32)
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <windows.h>
+#	include <psapi.h>
+#else // POSIX
+#	include <sys/resource.h>
+#endif
+
+#if defined(_WIN32)
+std::size_t peak_resident_bytes() noexcept
+{
+	PROCESS_MEMORY_COUNTERS counters{};
+	if( !GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) )
+		return 0;
+
+	return counters.PeakWorkingSetSize;
+}
+#else // POSIX
+std::size_t peak_resident_bytes() noexcept
+{
+	struct rusage usage{};
+	if( -1 == ::getrusage( RUSAGE_SELF, &usage ) )
+		return 0;
+
+	// Linux reports kilobytes, macOS bytes.
+#	if defined(__APPLE__)
+	return static_cast<std::size_t>( usage.ru_maxrss );
+#	else
+	return static_cast<std::size_t>( usage.ru_maxrss ) * 1024;
+#	endif
+}
+#endif // ~ _WIN32
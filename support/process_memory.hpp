@@ -0,0 +1,14 @@
+#ifndef PROCESS_MEMORY_HPP_2B8E4F17_6A3D_4C95_A0D1_E7C53924B68F
+#define PROCESS_MEMORY_HPP_2B8E4F17_6A3D_4C95_A0D1_E7C53924B68F
+
+#include <cstddef>
+
+// Peak resident set size (Windows: peak working set) of the process so far,
+// in bytes, or zero if the platform does not report it.
+//
+// The peak never decreases, so measuring a single step, e.g. loading one
+// mesh, is only meaningful if that step sets a new peak; compare against the
+// value before the step.
+std::size_t peak_resident_bytes() noexcept;
+
+#endif // PROCESS_MEMORY_HPP_2B8E4F17_6A3D_4C95_A0D1_E7C53924B68F
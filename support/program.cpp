@@ -15,7 +15,8 @@ namespace
 {
 	GLuint load_shader_( 
 		GLenum aShaderType, 
-		char const* aSourcePath
+		char const* aSourcePath,
+		std::string const& aSource
 	);
 
 	// lightweight std::experimental::scope_exit alternative
@@ -81,7 +82,7 @@ void ShaderProgram::reload()
 
 	// Load shaders
 	for( auto const& source : mSources )
-		shaders.emplace_back( load_shader_( source.type, source.sourcePath.c_str() ) );
+		shaders.emplace_back( load_shader_( source.type, source.sourcePath.c_str(), source.source ) );
 
 	// Create program object
 	OGL_CHECKPOINT_ALWAYS();
@@ -140,40 +141,43 @@ void ShaderProgram::reload()
 
 namespace
 {
-	GLuint load_shader_( GLenum aShaderType, char const* aSourcePath )
+	GLuint load_shader_( GLenum aShaderType, char const* aSourcePath, std::string const& aSource )
 	{
-		// Load the shader source code from file
-		std::vector<GLchar> source;
+		// Load the shader source code from file, unless it was given
+		std::vector<GLchar> source( aSource.begin(), aSource.end() );
 
-		if( std::FILE* fin = std::fopen( aSourcePath, "rb" ) )
+		if( source.empty() )
 		{
-			auto const scopeFile_ = scope_exit_( [&fin] {
-				std::fclose( fin );
-			} );
-
-			std::fseek( fin, 0, SEEK_END );
-			auto const length = std::size_t(std::ftell( fin ));
-			std::fseek( fin, 0, SEEK_SET );
-
-			source.resize( length );
-			for( std::size_t read = 0; read != length; )
+			if( std::FILE* fin = std::fopen( aSourcePath, "rb" ) )
 			{
-				auto const ret = std::fread( source.data()+read, 1, length-read, fin );
+				auto const scopeFile_ = scope_exit_( [&fin] {
+					std::fclose( fin );
+				} );
+
+				std::fseek( fin, 0, SEEK_END );
+				auto const length = std::size_t(std::ftell( fin ));
+				std::fseek( fin, 0, SEEK_SET );
 
-				if( 0 == ret )
+				source.resize( length );
+				for( std::size_t read = 0; read != length; )
 				{
-					if( auto const err = std::ferror( fin ) )
-						throw Error( "load_shader_(): error while reading from '{}': {} ({} bytes read, {} total)", aSourcePath, err, read, length );
-					if( std::feof( fin ) )
-						throw Error( "load_shader_(): unexpected EOF in '{}' ({} bytes read, {} total)", aSourcePath, read, length );
-				}
+					auto const ret = std::fread( source.data()+read, 1, length-read, fin );
+
+					if( 0 == ret )
+					{
+						if( auto const err = std::ferror( fin ) )
+							throw Error( "load_shader_(): error while reading from '{}': {} ({} bytes read, {} total)", aSourcePath, err, read, length );
+						if( std::feof( fin ) )
+							throw Error( "load_shader_(): unexpected EOF in '{}' ({} bytes read, {} total)", aSourcePath, read, length );
+					}
 			
-				read += ret;
+					read += ret;
+				}
+			}
+			else
+			{
+				throw Error( "load_shader_(): unable to open input file '{}'", aSourcePath );
 			}
-		}
-		else
-		{
-			throw Error( "load_shader_(): unable to open input file '{}'", aSourcePath );
 		}
 
 		// Create shader object
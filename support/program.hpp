@@ -16,6 +16,11 @@ class ShaderProgram final
 		{
 			GLenum type;
 			std::string sourcePath;
+
+			// If not empty, the GLSL source, which is then not read from
+			// sourcePath (e.g., because it comes from an asset pack).
+			// sourcePath still names the shader in error messages.
+			std::string source = {};
 		};
 
 	public:
@@ -0,0 +1,283 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include "../vmlib/block_compression.hpp"
+
+namespace
+{
+	// Smooth colour and alpha gradients with some noise, like a photo. The
+	// noise alone limits the PSNR of a good encoding to about 37 dB.
+	std::vector<std::uint8_t> make_image_( std::uint32_t aWidth, std::uint32_t aHeight, unsigned aSeed )
+	{
+		std::mt19937 rng( aSeed );
+		std::uniform_int_distribution<int> noise( -6, 6 );
+
+		std::vector<std::uint8_t> ret( std::size_t(aWidth) * aHeight * 4 );
+		for( std::uint32_t y = 0; y < aHeight; ++y )
+		{
+			for( std::uint32_t x = 0; x < aWidth; ++x )
+			{
+				auto* texel = ret.data() + (std::size_t(y) * aWidth + x) * 4;
+				int const values[4] = {
+					int(255 * x / aWidth), int(255 * y / aHeight), 128 + int(100 * std::sin( 0.1f * float(x + y) )), 255 - int(127 * y / aHeight)
+				};
+				for( std::size_t c = 0; c < 4; ++c )
+					texel[c] = std::uint8_t( std::clamp( values[c] + (c < 3 ? noise( rng ) : 0), 0, 255 ) );
+			}
+		}
+		return ret;
+	}
+
+	// Peak signal-to-noise ratio of the first aChannels channels, in dB.
+	double psnr_( std::vector<std::uint8_t> const& aA, std::vector<std::uint8_t> const& aB, std::size_t aChannels )
+	{
+		REQUIRE( aA.size() == aB.size() );
+
+		double sum = 0.0;
+		for( std::size_t i = 0; i < aA.size(); i += 4 )
+		{
+			for( std::size_t c = 0; c < aChannels; ++c )
+			{
+				double const d = double(aA[i+c]) - double(aB[i+c]);
+				sum += d * d;
+			}
+		}
+
+		double const mse = sum / double(aA.size() / 4 * aChannels);
+		return mse > 0.0 ? 10.0 * std::log10( 255.0 * 255.0 / mse ) : 100.0;
+	}
+}
+
+TEST_CASE( "Compressed sizes", "[block_compression]" )
+{
+	REQUIRE( block_bytes( BlockFormat::Bc1 ) == 8 );
+	REQUIRE( block_bytes( BlockFormat::Bc7 ) == 16 );
+
+	REQUIRE( compressed_size( BlockFormat::Bc1, 4096, 4096 ) == 4096 * 4096 / 2 );
+	REQUIRE( compressed_size( BlockFormat::Bc7, 4096, 4096 ) == 4096 * 4096 );
+
+	// Partial blocks count as whole ones.
+	REQUIRE( compressed_size( BlockFormat::Bc1, 5, 3 ) == 2 * 8 );
+	REQUIRE( compressed_size( BlockFormat::Bc7, 1, 1 ) == 16 );
+}
+
+TEST_CASE( "Uniform blocks", "[block_compression]" )
+{
+	std::vector<std::uint8_t> pixels( 8 * 8 * 4 );
+	for( std::size_t i = 0; i < pixels.size(); i += 4 )
+	{
+		pixels[i+0] = 200;
+		pixels[i+1] = 100;
+		pixels[i+2] = 51;
+		pixels[i+3] = 255;
+	}
+
+	// BC1 endpoints are RGB565; BC7 ones are exact up to their shared low
+	// bit (which opaque blocks need set, for alpha).
+	for( auto const& [format, tolerance] : { std::pair{ BlockFormat::Bc1, 4 }, std::pair{ BlockFormat::Bc7, 1 } } )
+	{
+		auto const decoded = decode_blocks( format, encode_blocks( format, pixels, 8, 8 ), 8, 8 );
+		REQUIRE( decoded.size() == pixels.size() );
+		for( std::size_t i = 0; i < pixels.size(); ++i )
+			REQUIRE( std::abs( int(decoded[i]) - int(pixels[i]) ) <= tolerance );
+	}
+}
+
+// Known answers: blocks laid out by hand from the format specifications
+// (D3D11 functional specification, BC1 and BC7 mode 6), and the texels
+// that the specifications' interpolation gives for them. Unlike the
+// round trips above, these catch a bit layout mistake that the encoder and
+// the decoder share.
+TEST_CASE( "Known BC1 blocks", "[block_compression]" )
+{
+	using Texel = std::array<std::uint8_t, 4>;
+	auto const texels = [] ( std::vector<std::uint8_t> const& aPixels ) {
+		std::vector<Texel> ret;
+		for( std::size_t i = 0; i < aPixels.size(); i += 4 )
+			ret.push_back( { aPixels[i], aPixels[i+1], aPixels[i+2], aPixels[i+3] } );
+		return ret;
+	};
+
+	SECTION( "Four colours" )
+	{
+		// c0 = red (0xf800) > c1 = blue (0x001f), little endian. Two bits per
+		// texel from the lowest, a byte per row: 0xe4 is indices 0,1,2,3.
+		std::vector<std::uint8_t> const block{ 0x00, 0xf8, 0x1f, 0x00, 0xe4, 0x1b, 0x00, 0xff };
+
+		Texel const c0{ 255, 0, 0, 255 }, c1{ 0, 0, 255, 255 };
+		Texel const c2{ 170, 0, 85, 255 }, c3{ 85, 0, 170, 255 }; // 2/3 c0 + 1/3 c1, and 1/3 c0 + 2/3 c1
+		std::vector<Texel> const expected{
+			c0, c1, c2, c3,
+			c3, c2, c1, c0,
+			c0, c0, c0, c0,
+			c3, c3, c3, c3
+		};
+		REQUIRE( texels( decode_blocks( BlockFormat::Bc1, block, 4, 4 ) ) == expected );
+	}
+
+	SECTION( "Three colours and transparent black" )
+	{
+		// c0 = black (0x0000) <= c1 = 0x8000, red 16/31 (132 in eight bits).
+		std::vector<std::uint8_t> const block{ 0x00, 0x00, 0x00, 0x80, 0xe4, 0xe4, 0xe4, 0xe4 };
+
+		Texel const c0{ 0, 0, 0, 255 }, c1{ 132, 0, 0, 255 }, c2{ 66, 0, 0, 255 }, c3{ 0, 0, 0, 0 };
+		auto const decoded = texels( decode_blocks( BlockFormat::Bc1, block, 4, 4 ) );
+		for( std::size_t row = 0; row < 4; ++row )
+			REQUIRE( std::vector<Texel>( decoded.begin() + 4*row, decoded.begin() + 4*row + 4 ) == std::vector<Texel>{ c0, c1, c2, c3 } );
+	}
+
+	SECTION( "Encoding" )
+	{
+		// White on the left, black on the right: c0 = 0xffff, c1 = 0x0000,
+		// and indices 0,0,1,1 in every row (0x50).
+		std::vector<std::uint8_t> pixels( 4 * 4 * 4, 255 );
+		for( std::size_t i = 0; i < 16; ++i )
+		{
+			if( i % 4 >= 2 )
+				std::fill_n( pixels.begin() + std::ptrdiff_t(4*i), 3, std::uint8_t(0) );
+		}
+
+		std::vector<std::uint8_t> const expected{ 0xff, 0xff, 0x00, 0x00, 0x50, 0x50, 0x50, 0x50 };
+		REQUIRE( encode_blocks( BlockFormat::Bc1, pixels, 4, 4 ) == expected );
+	}
+}
+
+TEST_CASE( "Known BC7 mode 6 blocks", "[block_compression]" )
+{
+	using Texel = std::array<std::uint8_t, 4>;
+	auto const texels = [] ( std::vector<std::uint8_t> const& aPixels ) {
+		std::vector<Texel> ret;
+		for( std::size_t i = 0; i < aPixels.size(); i += 4 )
+			ret.push_back( { aPixels[i], aPixels[i+1], aPixels[i+2], aPixels[i+3] } );
+		return ret;
+	};
+
+	SECTION( "Decoding" )
+	{
+		// From the lowest bit: mode 6 (0b1000000), then seven bits each of
+		// R0 R1 G0 G1 B0 B1 A0 A1, P0, P1, a three-bit first index and
+		// fifteen four-bit indices.
+		//
+		// Endpoints (10,20,30,40) with P0 = 1 and (100,90,80,127) with
+		// P1 = 0, i.e. (21,41,61,81) and (200,180,160,254). Indices 5, 0,
+		// 15, 1, 2, 3, 4, 6, 7, ..., 14.
+		std::vector<std::uint8_t> const block{
+			0x40, 0x05, 0x99, 0xa2, 0xf5, 0x40, 0x51, 0xff,
+			0x0a, 0x1f, 0x32, 0x64, 0x87, 0xa9, 0xcb, 0xed
+		};
+
+		// ((64 - w) * e0 + w * e1 + 32) >> 6, with the weights of the
+		// indices (0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60,
+		// 64).
+		std::vector<Texel> const expected{
+			{ 80, 87, 93, 138 }, { 21, 41, 61, 81 }, { 200, 180, 160, 254 }, { 32, 50, 67, 92 },
+			{ 46, 61, 75, 105 }, { 57, 69, 81, 116 }, { 69, 78, 87, 127 }, { 94, 97, 101, 151 },
+			{ 105, 106, 107, 162 }, { 116, 115, 114, 173 }, { 127, 124, 120, 184 }, { 141, 134, 128, 197 },
+			{ 152, 143, 134, 208 }, { 164, 152, 140, 219 }, { 175, 160, 146, 230 }, { 189, 171, 154, 243 }
+		};
+		REQUIRE( texels( decode_blocks( BlockFormat::Bc7, block, 4, 4 ) ) == expected );
+	}
+
+	SECTION( "Encoding" )
+	{
+		// (1,1,1,255) on the left and white on the right: endpoints
+		// (0,0,0,127) and (127,127,127,127), both with P = 1, and indices
+		// 0,0,15,15 in every row. The first index is the one whose high bit
+		// is implied zero, so texel 0 picks the order of the endpoints.
+		std::vector<std::uint8_t> pixels( 4 * 4 * 4, 255 );
+		for( std::size_t i = 0; i < 16; ++i )
+		{
+			if( i % 4 < 2 )
+				std::fill_n( pixels.begin() + std::ptrdiff_t(4*i), 3, std::uint8_t(1) );
+		}
+
+		std::vector<std::uint8_t> const expected{
+			0x40, 0xc0, 0x1f, 0xf0, 0x07, 0xfc, 0xff, 0xff,
+			0x01, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff
+		};
+		auto const blocks = encode_blocks( BlockFormat::Bc7, pixels, 4, 4 );
+		REQUIRE( blocks == expected );
+		REQUIRE( decode_blocks( BlockFormat::Bc7, blocks, 4, 4 ) == pixels );
+	}
+}
+
+TEST_CASE( "Block compression quality", "[block_compression]" )
+{
+	// Not a multiple of four: the last blocks are padded.
+	constexpr std::uint32_t kWidth = 130, kHeight = 66;
+	auto const pixels = make_image_( kWidth, kHeight, 2211 );
+
+	SECTION( "BC1" )
+	{
+		auto const blocks = encode_blocks( BlockFormat::Bc1, pixels, kWidth, kHeight );
+		REQUIRE( blocks.size() == compressed_size( BlockFormat::Bc1, kWidth, kHeight ) );
+
+		auto const decoded = decode_blocks( BlockFormat::Bc1, blocks, kWidth, kHeight );
+		REQUIRE( psnr_( pixels, decoded, 3 ) > 33.0 );
+
+		// Always opaque.
+		for( std::size_t i = 3; i < decoded.size(); i += 4 )
+			REQUIRE( decoded[i] == 255 );
+	}
+
+	SECTION( "BC7" )
+	{
+		auto const blocks = encode_blocks( BlockFormat::Bc7, pixels, kWidth, kHeight );
+		REQUIRE( blocks.size() == compressed_size( BlockFormat::Bc7, kWidth, kHeight ) );
+
+		auto const decoded = decode_blocks( BlockFormat::Bc7, blocks, kWidth, kHeight );
+		REQUIRE( psnr_( pixels, decoded, 3 ) > 36.0 );
+		REQUIRE( psnr_( pixels, decoded, 4 ) > 36.0 );
+	}
+
+	SECTION( "Bands of rows" )
+	{
+		// Encoding the image in two bands gives the same blocks.
+		for( auto const format : { BlockFormat::Bc1, BlockFormat::Bc7 } )
+		{
+			auto const whole = encode_blocks( format, pixels, kWidth, kHeight );
+
+			constexpr std::uint32_t kSplit = 32;
+			std::vector<std::uint8_t> banded( whole.size() );
+			std::size_t const split = compressed_size( format, kWidth, kSplit );
+			encode_blocks( format, std::span( pixels ).first( std::size_t(kWidth) * kSplit * 4 ), kWidth, kSplit, std::span( banded ).first( split ) );
+			encode_blocks( format, std::span( pixels ).subspan( std::size_t(kWidth) * kSplit * 4 ), kWidth, kHeight - kSplit, std::span( banded ).subspan( split ) );
+
+			REQUIRE( banded == whole );
+		}
+	}
+}
+
+// Benchmarks (hidden by default; run with "[benchmark]").
+//
+// Texels per second = 1024 * 1024 / reported mean time.
+TEST_CASE( "Block compression of a 1024x1024 image", "[.][benchmark][block_compression]" )
+{
+	constexpr std::uint32_t kSize = 1024;
+	auto const pixels = make_image_( kSize, kSize, 7 );
+	auto const bc1 = encode_blocks( BlockFormat::Bc1, pixels, kSize, kSize );
+	auto const bc7 = encode_blocks( BlockFormat::Bc7, pixels, kSize, kSize );
+
+	BENCHMARK( "encode BC1" )
+	{
+		return encode_blocks( BlockFormat::Bc1, pixels, kSize, kSize );
+	};
+	BENCHMARK( "encode BC7" )
+	{
+		return encode_blocks( BlockFormat::Bc7, pixels, kSize, kSize );
+	};
+
+	BENCHMARK( "decode BC1" )
+	{
+		return decode_blocks( BlockFormat::Bc1, bc1, kSize, kSize );
+	};
+	BENCHMARK( "decode BC7" )
+	{
+		return decode_blocks( BlockFormat::Bc7, bc7, kSize, kSize );
+	};
+}
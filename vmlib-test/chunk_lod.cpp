@@ -0,0 +1,172 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <set>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "../vmlib/aabb.hpp"
+#include "../vmlib/chunk_lod.hpp"
+
+#include "test_grid.hpp"
+
+namespace
+{
+	// Grid with gentle hills (see test_grid.hpp).
+	TestGrid make_grid_( std::uint32_t aN )
+	{
+		return make_test_grid( aN, [] ( float aX, float aZ ) {
+			return 2.f * std::sin( 0.1f * aX ) * std::cos( 0.07f * aZ );
+		} );
+	}
+
+	using Edge_ = std::pair<std::uint32_t,std::uint32_t>;
+
+	// Undirected edges of the triangles in aLod whose endpoints both satisfy
+	// aKeep.
+	template< class tKeep >
+	std::multiset<Edge_> edges_( std::span<std::uint32_t const> aIndices, MeshLod const& aLod, tKeep&& aKeep )
+	{
+		std::multiset<Edge_> ret;
+		for( std::uint32_t i = aLod.firstIndex; i < aLod.firstIndex + aLod.indexCount; i += 3 )
+		{
+			for( std::uint32_t k = 0; k < 3; ++k )
+			{
+				auto const a = aIndices[i + k], b = aIndices[i + (k+1) % 3];
+				if( aKeep( a ) && aKeep( b ) )
+					ret.emplace( std::min( a, b ), std::max( a, b ) );
+			}
+		}
+		return ret;
+	}
+}
+
+TEST_CASE( "Chunk LODs of a grid", "[lod]" )
+{
+	constexpr std::size_t kLevels = 5;
+
+	auto grid = make_grid_( 128 );
+	auto const chunks = partition_mesh_chunks( grid.indices, grid.positions, 4, 4 );
+	std::size_t const baseIndexCount = grid.indices.size();
+	auto const base = grid.indices;
+
+	auto const lods = build_chunk_lods( grid.indices, grid.positions, chunks, kLevels );
+	REQUIRE( lods.size() == chunks.size() * kLevels );
+
+	// Level 0 is untouched; the other levels follow it.
+	REQUIRE( std::equal( base.begin(), base.end(), grid.indices.begin() ) );
+	for( auto const index : grid.indices )
+		REQUIRE( index < grid.positions.size() );
+
+	std::size_t top = 0;
+	for( std::size_t c = 0; c < chunks.size(); ++c )
+	{
+		INFO( "chunk " << c );
+		REQUIRE( lods[c * kLevels].firstIndex == chunks[c].firstIndex );
+		REQUIRE( lods[c * kLevels].indexCount == chunks[c].indexCount );
+		REQUIRE( lods[c * kLevels].error == 0.f );
+
+		for( std::size_t level = 1; level < kLevels; ++level )
+		{
+			auto const& lod = lods[c * kLevels + level];
+			auto const& finer = lods[c * kLevels + level - 1];
+			INFO( "level " << level );
+
+			REQUIRE( lod.firstIndex >= baseIndexCount );
+			REQUIRE( lod.indexCount % 3 == 0 );
+			REQUIRE( lod.indexCount > 0 );
+			REQUIRE( lod.indexCount <= finer.indexCount );
+			REQUIRE( lod.error >= finer.error );
+
+			// Replacements stay within a few grid cells. The edges are about
+			// 1.1 units long, so level k uses cells of about 2^k * 1.1.
+			REQUIRE( lod.error > 0.f );
+			REQUIRE( lod.error < 1.2f * float(1u << level) * std::sqrt( 3.f ) );
+		}
+
+		top += lods[c * kLevels + kLevels - 1].indexCount;
+	}
+
+	// The coarsest level is much smaller than the full mesh, even though the
+	// chunk borders stay at full resolution.
+	REQUIRE( top * 4 < baseIndexCount );
+}
+
+TEST_CASE( "Chunk LODs keep the chunk borders", "[lod]" )
+{
+	constexpr std::size_t kLevels = 4;
+
+	auto grid = make_grid_( 48 );
+	auto const chunks = partition_mesh_chunks( grid.indices, grid.positions, 3, 3 );
+	auto const lods = build_chunk_lods( grid.indices, grid.positions, chunks, kLevels );
+
+	// Vertices used by more than one chunk.
+	std::vector<std::uint32_t> owner( grid.positions.size(), ~0u );
+	std::vector<bool> shared( grid.positions.size(), false );
+	for( std::size_t c = 0; c < chunks.size(); ++c )
+	{
+		for( std::uint32_t i = chunks[c].firstIndex; i < chunks[c].firstIndex + chunks[c].indexCount; ++i )
+		{
+			auto const v = grid.indices[i];
+			if( ~0u != owner[v] && c != owner[v] )
+				shared[v] = true;
+			owner[v] = std::uint32_t(c);
+		}
+	}
+
+	auto const is_shared = [&] ( std::uint32_t aV ) { return bool(shared[aV]); };
+
+	// The edges between shared vertices, i.e., those along the chunk
+	// borders, are the same at every level. Neighbouring chunks thus meet
+	// without cracks, whatever their levels.
+	for( std::size_t c = 0; c < chunks.size(); ++c )
+	{
+		auto const border = edges_( grid.indices, lods[c * kLevels], is_shared );
+		REQUIRE( !border.empty() );
+
+		for( std::size_t level = 1; level < kLevels; ++level )
+		{
+			INFO( "chunk " << c << ", level " << level );
+			REQUIRE( edges_( grid.indices, lods[c * kLevels + level], is_shared ) == border );
+		}
+	}
+}
+
+TEST_CASE( "Chunk LOD selection", "[lod]" )
+{
+	std::array<MeshLod,4> const levels{ {
+		{ 0, 300, 0.f },
+		{ 300, 90, 1.f },
+		{ 390, 30, 2.f },
+		{ 420, 9, 4.f }
+	} };
+
+	// 1 unit of error covers 100 pixels at distance one; allow one pixel.
+	REQUIRE( select_lod( levels, 0.f, 100.f, 1.f ) == 0 );
+	REQUIRE( select_lod( levels, 50.f, 100.f, 1.f ) == 0 );
+	REQUIRE( select_lod( levels, 100.f, 100.f, 1.f ) == 1 );
+	REQUIRE( select_lod( levels, 250.f, 100.f, 1.f ) == 2 );
+	REQUIRE( select_lod( levels, 1e6f, 100.f, 1.f ) == 3 );
+
+	// A larger tolerance selects coarser levels sooner.
+	REQUIRE( select_lod( levels, 100.f, 100.f, 4.f ) == 3 );
+
+	REQUIRE( select_lod( std::span( levels ).first( 1 ), 1e6f, 100.f, 1.f ) == 0 );
+
+	// 90 degrees: the viewport's half height at distance one.
+	REQUIRE( lod_pixels_per_unit( 720.f, std::numbers::pi_v<float> / 2.f ) == Catch::Approx( 360.f ) );
+}
+
+TEST_CASE( "Distance to a box", "[lod]" )
+{
+	Aabb3f const box{ { -1.f, 0.f, 2.f }, { 1.f, 4.f, 3.f } };
+
+	REQUIRE( distance( box, Vec3f{ 0.f, 1.f, 2.5f } ) == 0.f );
+	REQUIRE( distance( box, Vec3f{ 1.f, 4.f, 3.f } ) == 0.f );
+	REQUIRE( distance( box, Vec3f{ 4.f, 1.f, 2.5f } ) == Catch::Approx( 3.f ) );
+	REQUIRE( distance( box, Vec3f{ 0.f, -2.f, 2.5f } ) == Catch::Approx( 2.f ) );
+	REQUIRE( distance( box, Vec3f{ 4.f, 8.f, 3.f } ) == Catch::Approx( 5.f ) );
+}
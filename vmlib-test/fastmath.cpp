@@ -0,0 +1,224 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include <numbers>
+
+#include "../vmlib/fastmath.hpp"
+
+// The error bounds checked here are the ones documented in fastmath.hpp.
+
+namespace
+{
+	constexpr std::size_t kCount_ = 200'000;
+
+	template< class tFloatN, class tFunc >
+	std::vector<float> apply_( std::vector<float> const& aIn, tFunc&& aFunc )
+	{
+		constexpr std::size_t kWidth = tFloatN::kWidth;
+		REQUIRE( aIn.size() % kWidth == 0 );
+
+		std::vector<float> ret( aIn.size() );
+		for( std::size_t i = 0; i < aIn.size(); i += kWidth )
+		{
+			tFloatN x;
+			if constexpr( kWidth == 4 )
+				x = simd::load4( aIn.data() + i );
+			else
+				x = simd::load8( aIn.data() + i );
+
+			simd::store( ret.data() + i, aFunc( x ) );
+		}
+		return ret;
+	}
+
+	std::vector<float> uniform_( float aMin, float aMax, std::uint32_t aSeed )
+	{
+		std::mt19937 rng( aSeed );
+		std::uniform_real_distribution<float> dist( aMin, aMax );
+
+		std::vector<float> ret( kCount_ );
+		for( auto& x : ret )
+			x = dist( rng );
+		return ret;
+	}
+
+	double max_abs_error_( std::vector<float> const& aIn, std::vector<float> const& aOut, double (*aRef)( double ) )
+	{
+		double err = 0.0;
+		for( std::size_t i = 0; i < aIn.size(); ++i )
+			err = std::max( err, std::abs( double(aOut[i]) - aRef( aIn[i] ) ) );
+		return err;
+	}
+}
+
+TEMPLATE_TEST_CASE( "Fast sin/cos stay within the documented bounds", "[fastmath]", simd::Float4, simd::Float8 )
+{
+	SECTION( "Principal range" )
+	{
+		auto const in = uniform_( -float(std::numbers::pi), float(std::numbers::pi), 1 );
+		auto const s = apply_<TestType>( in, []( TestType x ) { return simd::sin( x ); } );
+		auto const c = apply_<TestType>( in, []( TestType x ) { return simd::cos( x ); } );
+
+		REQUIRE( max_abs_error_( in, s, []( double x ) { return std::sin( x ); } ) <= 2e-7 );
+		REQUIRE( max_abs_error_( in, c, []( double x ) { return std::cos( x ); } ) <= 2e-7 );
+	}
+
+	SECTION( "Up to |x| = 1000" )
+	{
+		auto const in = uniform_( -1000.f, 1000.f, 2 );
+		auto const s = apply_<TestType>( in, []( TestType x ) { return simd::sin( x ); } );
+		auto const c = apply_<TestType>( in, []( TestType x ) { return simd::cos( x ); } );
+
+		REQUIRE( max_abs_error_( in, s, []( double x ) { return std::sin( x ); } ) <= 2e-7 );
+		REQUIRE( max_abs_error_( in, c, []( double x ) { return std::cos( x ); } ) <= 2e-7 );
+	}
+
+	SECTION( "sincos agrees with sin and cos" )
+	{
+		auto const in = uniform_( -20.f, 20.f, 3 );
+		auto const s = apply_<TestType>( in, []( TestType x ) { return simd::sin( x ); } );
+		auto const c = apply_<TestType>( in, []( TestType x ) { return simd::cos( x ); } );
+		auto const s2 = apply_<TestType>( in, []( TestType x ) { TestType s, c; simd::sincos( x, s, c ); return s; } );
+		auto const c2 = apply_<TestType>( in, []( TestType x ) { TestType s, c; simd::sincos( x, s, c ); return c; } );
+
+		REQUIRE( s == s2 );
+		REQUIRE( c == c2 );
+	}
+
+	SECTION( "Exact values" )
+	{
+		std::vector<float> in( TestType::kWidth, 0.f );
+		REQUIRE( apply_<TestType>( in, []( TestType x ) { return simd::sin( x ); } )[0] == 0.f );
+		REQUIRE( apply_<TestType>( in, []( TestType x ) { return simd::cos( x ); } )[0] == 1.f );
+	}
+}
+
+TEMPLATE_TEST_CASE( "Fast atan2 stays within the documented bound", "[fastmath]", simd::Float4, simd::Float8 )
+{
+	auto const ys = uniform_( -100.f, 100.f, 4 );
+	auto xs = uniform_( -100.f, 100.f, 5 );
+
+	// Some special cases: axes, diagonals, and the origin.
+	float const special[][2] = {
+		{ 0.f, 1.f }, { 1.f, 0.f }, { 0.f, -1.f }, { -1.f, 0.f },
+		{ 1.f, 1.f }, { -1.f, 1.f }, { 1.f, -1.f }, { -1.f, -1.f }
+	};
+
+	std::vector<float> y2 = ys;
+	for( std::size_t i = 0; i < std::size( special ); ++i )
+	{
+		y2[i] = special[i][0];
+		xs[i] = special[i][1];
+	}
+
+	constexpr std::size_t kWidth = TestType::kWidth;
+	std::vector<float> out( kCount_ );
+	for( std::size_t i = 0; i < kCount_; i += kWidth )
+	{
+		if constexpr( kWidth == 4 )
+			simd::store( out.data() + i, simd::atan2( simd::load4( y2.data() + i ), simd::load4( xs.data() + i ) ) );
+		else
+			simd::store( out.data() + i, simd::atan2( simd::load8( y2.data() + i ), simd::load8( xs.data() + i ) ) );
+	}
+
+	double err = 0.0;
+	for( std::size_t i = 0; i < kCount_; ++i )
+		err = std::max( err, std::abs( double(out[i]) - std::atan2( double(y2[i]), double(xs[i]) ) ) );
+	REQUIRE( err <= 4e-7 );
+
+	// atan2( 0, 0 ) is defined as 0.
+	TestType const zero = 0.f;
+	float origin[kWidth];
+	simd::store( origin, simd::atan2( zero, zero ) );
+	REQUIRE( origin[0] == 0.f );
+}
+
+TEMPLATE_TEST_CASE( "Fast rsqrt stays within the documented bound", "[fastmath]", simd::Float4, simd::Float8 )
+{
+	auto in = uniform_( 1e-3f, 1e4f, 6 );
+	in[0] = 1.f;
+	in[1] = 4.f;
+
+	auto const out = apply_<TestType>( in, []( TestType x ) { return simd::rsqrt( x ); } );
+
+	double err = 0.0;
+	for( std::size_t i = 0; i < kCount_; ++i )
+	{
+		double const ref = 1.0 / std::sqrt( double(in[i]) );
+		err = std::max( err, std::abs( double(out[i]) - ref ) / ref );
+	}
+	REQUIRE( err <= 4e-7 );
+}
+
+TEST_CASE( "batch_sincos matches the vector version", "[fastmath]" )
+{
+	// Not a multiple of eight, so that the padded tail is exercised too.
+	auto in = uniform_( -10.f, 10.f, 9 );
+	in.resize( 1003 );
+
+	std::vector<float> s( in.size() ), c( in.size() );
+	batch_sincos( in, s, c );
+
+	for( std::size_t i = 0; i < in.size(); ++i )
+	{
+		REQUIRE_THAT( s[i], Catch::Matchers::WithinAbs( std::sin( double(in[i]) ), 2e-7 ) );
+		REQUIRE_THAT( c[i], Catch::Matchers::WithinAbs( std::cos( double(in[i]) ), 2e-7 ) );
+	}
+}
+
+// Benchmarks (hidden by default; run with "[benchmark]").
+TEST_CASE( "Fast math throughput on 200k values: libm vs " VMLIB_SIMD_NAME, "[.][benchmark][fastmath]" )
+{
+	auto const in = uniform_( -10.f, 10.f, 7 );
+	auto const in2 = uniform_( -10.f, 10.f, 8 );
+	std::vector<float> out( kCount_ ), out2( kCount_ );
+
+	BENCHMARK( "sincos (std::sin + std::cos)" )
+	{
+		for( std::size_t i = 0; i < kCount_; ++i )
+		{
+			out[i] = std::sin( in[i] );
+			out2[i] = std::cos( in[i] );
+		}
+		return out[kCount_/2] + out2[kCount_/2];
+	};
+	BENCHMARK( "sincos (Float8)" )
+	{
+		for( std::size_t i = 0; i < kCount_; i += 8 )
+		{
+			simd::Float8 s, c;
+			simd::sincos( simd::load8( in.data() + i ), s, c );
+			simd::store( out.data() + i, s );
+			simd::store( out2.data() + i, c );
+		}
+		return out[kCount_/2] + out2[kCount_/2];
+	};
+
+	BENCHMARK( "atan2 (std::atan2)" )
+	{
+		for( std::size_t i = 0; i < kCount_; ++i )
+			out[i] = std::atan2( in[i], in2[i] );
+		return out[kCount_/2];
+	};
+	BENCHMARK( "atan2 (Float8)" )
+	{
+		for( std::size_t i = 0; i < kCount_; i += 8 )
+			simd::store( out.data() + i, simd::atan2( simd::load8( in.data() + i ), simd::load8( in2.data() + i ) ) );
+		return out[kCount_/2];
+	};
+
+	BENCHMARK( "rsqrt (1/std::sqrt)" )
+	{
+		for( std::size_t i = 0; i < kCount_; ++i )
+			out[i] = 1.f / std::sqrt( std::abs( in[i] ) + 1.f );
+		return out[kCount_/2];
+	};
+	BENCHMARK( "rsqrt (Float8)" )
+	{
+		for( std::size_t i = 0; i < kCount_; i += 8 )
+			simd::store( out.data() + i, simd::rsqrt( simd::abs( simd::load8( in.data() + i ) ) + 1.f ) );
+		return out[kCount_/2];
+	};
+}
@@ -0,0 +1,213 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <random>
+#include <vector>
+
+#include "../vmlib/frustum.hpp"
+
+namespace
+{
+	// Not a multiple of eight, so that the scalar tail is exercised too.
+	constexpr std::size_t kCount_ = 1003;
+
+	Mat44f test_proj_view_()
+	{
+		auto const proj = make_perspective_projection( 1.2f, 16.f/9.f, 0.1f, 200.f );
+		auto const view = make_rotation_x( 0.2f ) * make_rotation_y( -0.5f ) * make_translation( { -10.f, -5.f, 3.f } );
+		return proj * view;
+	}
+
+	bool inside_clip_( Mat44f const& aProjView, Vec3f aPoint )
+	{
+		auto const c = aProjView * Vec4f{ aPoint.x, aPoint.y, aPoint.z, 1.f };
+		return -c.w <= c.x && c.x <= c.w
+			&& -c.w <= c.y && c.y <= c.w
+			&& -c.w <= c.z && c.z <= c.w;
+	}
+}
+
+TEST_CASE( "Frustum planes match the projection", "[frustum]" )
+{
+	auto const proj = make_perspective_projection( 1.2f, 1.f, 1.f, 100.f );
+	auto const frustum = make_frustum( proj );
+
+	SECTION( "Planes are normalized" )
+	{
+		for( auto const& plane : frustum.planes )
+			REQUIRE_THAT( length( plane.normal ), Catch::Matchers::WithinAbs( 1.f, 1e-5f ) );
+	}
+
+	SECTION( "Points" )
+	{
+		REQUIRE( is_visible( frustum, Vec3f{ 0.f, 0.f, -5.f }, 0.f ) );
+		REQUIRE( !is_visible( frustum, Vec3f{ 0.f, 0.f, 5.f }, 0.f ) );     // behind
+		REQUIRE( !is_visible( frustum, Vec3f{ 0.f, 0.f, -0.5f }, 0.f ) );   // before near
+		REQUIRE( !is_visible( frustum, Vec3f{ 0.f, 0.f, -150.f }, 0.f ) );  // beyond far
+		REQUIRE( !is_visible( frustum, Vec3f{ -50.f, 0.f, -10.f }, 0.f ) ); // left
+		REQUIRE( !is_visible( frustum, Vec3f{ 0.f, 50.f, -10.f }, 0.f ) );  // above
+	}
+
+	SECTION( "Spheres and boxes straddling a plane" )
+	{
+		REQUIRE( is_visible( frustum, Vec3f{ 0.f, 0.f, 2.f }, 3.5f ) );
+		REQUIRE( !is_visible( frustum, Vec3f{ 0.f, 0.f, 2.f }, 2.5f ) );
+
+		REQUIRE( is_visible( frustum, Aabb3f{ { -1.f, -1.f, -2.f }, { 1.f, 1.f, 5.f } } ) );
+		REQUIRE( !is_visible( frustum, Aabb3f{ { -1.f, -1.f, 1.f }, { 1.f, 1.f, 5.f } } ) );
+		REQUIRE( !is_visible( frustum, kEmptyAabb3f ) );
+	}
+
+	SECTION( "Agrees with clip space for random points" )
+	{
+		auto const projView = test_proj_view_();
+		auto const general = make_frustum( projView );
+
+		std::mt19937 rng( 606 );
+		std::uniform_real_distribution<float> dist( -100.f, 100.f );
+		for( std::size_t i = 0; i < kCount_; ++i )
+		{
+			Vec3f const p{ dist( rng ), dist( rng ), dist( rng ) };
+			REQUIRE( is_visible( general, p, 0.f ) == inside_clip_( projView, p ) );
+		}
+	}
+}
+
+TEST_CASE( "Batch frustum tests match single-object tests", "[frustum][soa]" )
+{
+	auto const frustum = make_frustum( test_proj_view_() );
+
+	std::mt19937 rng( 607 );
+	std::uniform_real_distribution<float> pos( -150.f, 150.f );
+	std::uniform_real_distribution<float> size( 0.1f, 20.f );
+
+	Vec3fSoA centers, extents;
+	std::vector<float> radii;
+	for( std::size_t i = 0; i < kCount_; ++i )
+	{
+		centers.push_back( Vec3f{ pos( rng ), pos( rng ), pos( rng ) } );
+		extents.push_back( Vec3f{ size( rng ), size( rng ), size( rng ) } );
+		radii.push_back( size( rng ) );
+	}
+
+	std::vector<std::uint8_t> visible( kCount_ );
+
+	SECTION( "Spheres" )
+	{
+		auto const count = batch_test_spheres( frustum, centers, radii, visible );
+
+		std::size_t expected = 0;
+		for( std::size_t i = 0; i < kCount_; ++i )
+		{
+			bool const ref = is_visible( frustum, centers.get( i ), radii[i] );
+			REQUIRE( bool(visible[i]) == ref );
+			expected += ref;
+		}
+		REQUIRE( count == expected );
+		REQUIRE( count > 0 );
+		REQUIRE( count < kCount_ );
+	}
+
+	SECTION( "Boxes" )
+	{
+		auto const count = batch_test_boxes( frustum, centers, extents, visible );
+
+		std::size_t expected = 0;
+		for( std::size_t i = 0; i < kCount_; ++i )
+		{
+			Vec3f const c = centers.get( i ), e = extents.get( i );
+			bool const ref = is_visible( frustum, Aabb3f{ c - e, c + e } );
+			REQUIRE( bool(visible[i]) == ref );
+			expected += ref;
+		}
+		REQUIRE( count == expected );
+		REQUIRE( count > 0 );
+		REQUIRE( count < kCount_ );
+	}
+}
+
+TEST_CASE( "Transformed bounds contain the transformed corners", "[frustum][aabb]" )
+{
+	Aabb3f const box{ { -0.5f, 0.f, -0.5f }, { 0.5f, 0.25f, 0.5f } };
+	auto const m = make_translation( { 3.f, 1.f, -2.f } ) * make_rotation_y( 0.6f ) * make_scaling( 25.f, 25.f, 25.f );
+	auto const bounds = transform_bounds( m, box );
+
+	for( std::size_t corner = 0; corner < 8; ++corner )
+	{
+		Vec4f const p{
+			(corner & 1) ? box.max.x : box.min.x,
+			(corner & 2) ? box.max.y : box.min.y,
+			(corner & 4) ? box.max.z : box.min.z,
+			1.f
+		};
+		auto const q = m * p;
+		REQUIRE( q.x >= bounds.min.x - 1e-4f );
+		REQUIRE( q.y >= bounds.min.y - 1e-4f );
+		REQUIRE( q.z >= bounds.min.z - 1e-4f );
+		REQUIRE( q.x <= bounds.max.x + 1e-4f );
+		REQUIRE( q.y <= bounds.max.y + 1e-4f );
+		REQUIRE( q.z <= bounds.max.z + 1e-4f );
+	}
+
+	REQUIRE( is_empty( transform_bounds( m, kEmptyAabb3f ) ) );
+}
+
+// Benchmarks (hidden by default; run with "[benchmark]").
+//
+// Tests per second = 100'000 / reported mean time.
+TEST_CASE( "Frustum culling 100k objects: single vs batch " VMLIB_SIMD_NAME, "[.][benchmark][frustum]" )
+{
+	constexpr std::size_t kBenchCount = 100'000;
+
+	auto const frustum = make_frustum( test_proj_view_() );
+
+	std::mt19937 rng( 608 );
+	std::uniform_real_distribution<float> pos( -300.f, 300.f );
+	std::uniform_real_distribution<float> size( 0.1f, 10.f );
+
+	std::vector<Aabb3f> boxes( kBenchCount );
+	std::vector<float> radii( kBenchCount );
+	Vec3fSoA centers, extents;
+	for( std::size_t i = 0; i < kBenchCount; ++i )
+	{
+		Vec3f const c{ pos( rng ), pos( rng ), pos( rng ) };
+		Vec3f const e{ size( rng ), size( rng ), size( rng ) };
+		boxes[i] = Aabb3f{ c - e, c + e };
+		radii[i] = length( e );
+		centers.push_back( c );
+		extents.push_back( e );
+	}
+
+	std::vector<std::uint8_t> visible( kBenchCount );
+
+	BENCHMARK( "boxes (is_visible per Aabb3f)" )
+	{
+		std::size_t count = 0;
+		for( std::size_t i = 0; i < kBenchCount; ++i )
+		{
+			bool const vis = is_visible( frustum, boxes[i] );
+			visible[i] = vis;
+			count += vis;
+		}
+		return count;
+	};
+	BENCHMARK( "boxes (batch)" )
+	{
+		return batch_test_boxes( frustum, centers, extents, visible );
+	};
+
+	BENCHMARK( "spheres (is_visible per sphere)" )
+	{
+		std::size_t count = 0;
+		for( std::size_t i = 0; i < kBenchCount; ++i )
+		{
+			bool const vis = is_visible( frustum, centers.get( i ), radii[i] );
+			visible[i] = vis;
+			count += vis;
+		}
+		return count;
+	};
+	BENCHMARK( "spheres (batch)" )
+	{
+		return batch_test_spheres( frustum, centers, radii, visible );
+	};
+}
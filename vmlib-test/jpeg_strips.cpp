@@ -0,0 +1,220 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+#include "../vmlib/jpeg_strips.hpp"
+#include "../support/parallel.hpp"
+
+#include "../third_party/stb/include/stb_image.h"
+#include "../third_party/stb/include/stb_image_write.h"
+
+namespace
+{
+	// Rows aFirstRow onwards of a smooth RGB pattern with some detail.
+	std::vector<std::uint8_t> make_rows_( std::uint32_t aWidth, std::uint32_t aFirstRow, std::uint32_t aCount )
+	{
+		std::vector<std::uint8_t> ret( std::size_t(aWidth) * aCount * 3 );
+		for( std::uint32_t j = 0; j < aCount; ++j )
+		{
+			std::uint32_t const y = aFirstRow + j;
+			for( std::uint32_t x = 0; x < aWidth; ++x )
+			{
+				auto* texel = ret.data() + (std::size_t(j) * aWidth + x) * 3;
+				texel[0] = std::uint8_t( x * 7 + y );
+				texel[1] = std::uint8_t( 128 + 120 * std::sin( 0.05f * float(x) ) * std::cos( 0.03f * float(y) ) );
+				texel[2] = std::uint8_t( (x ^ y) & 0xFF );
+			}
+		}
+		return ret;
+	}
+
+	std::vector<std::uint8_t> write_jpeg_( std::vector<std::uint8_t> const& aPixels, std::uint32_t aWidth, std::uint32_t aHeight )
+	{
+		std::vector<std::uint8_t> ret;
+		stbi_write_jpg_to_func( [] ( void* aContext, void* aData, int aSize ) {
+			auto* out = static_cast<std::vector<std::uint8_t>*>( aContext );
+			auto const* bytes = static_cast<std::uint8_t const*>( aData );
+			out->insert( out->end(), bytes, bytes + aSize );
+		}, &ret, int(aWidth), int(aHeight), 3, aPixels.data(), 90 );
+		return ret;
+	}
+
+	// Offset of the segment with aMarker in aJpeg (which must have one).
+	std::size_t find_segment_( std::vector<std::uint8_t> const& aJpeg, std::uint8_t aMarker )
+	{
+		std::size_t pos = 2;
+		while( aMarker != aJpeg[pos+1] )
+			pos += 2 + ((std::size_t(aJpeg[pos+2]) << 8) | aJpeg[pos+3]);
+		return pos;
+	}
+
+	// A JPEG with a restart marker every aMcuRowsPerInterval rows of MCUs.
+	// stb_image_write does not write restart markers, so bands of that many
+	// MCU rows are encoded as JPEGs of their own (at quality 90, with 16x16
+	// MCUs) and their entropy-coded data is joined with RSTn markers.
+	std::vector<std::uint8_t> make_restart_jpeg_( std::uint32_t aWidth, std::uint32_t aHeight, std::uint32_t aMcuRowsPerInterval )
+	{
+		std::uint32_t const bandHeight = 16 * aMcuRowsPerInterval;
+
+		std::vector<std::uint8_t> ret;
+		std::size_t band = 0;
+		for( std::uint32_t y = 0; y < aHeight; y += bandHeight, ++band )
+		{
+			std::uint32_t const rows = std::min( bandHeight, aHeight - y );
+			auto const jpeg = write_jpeg_( make_rows_( aWidth, y, rows ), aWidth, rows );
+
+			std::size_t const sos = find_segment_( jpeg, 0xDA );
+			std::size_t const data = sos + 2 + ((std::size_t(jpeg[sos+2]) << 8) | jpeg[sos+3]);
+
+			if( 0 == band )
+			{
+				// The headers, with the full height and a DRI segment.
+				ret.assign( jpeg.begin(), jpeg.begin() + std::ptrdiff_t(sos) );
+
+				std::size_t const sof = find_segment_( ret, 0xC0 );
+				ret[sof+5] = std::uint8_t( aHeight >> 8 );
+				ret[sof+6] = std::uint8_t( aHeight );
+
+				std::uint32_t const interval = (aWidth + 15) / 16 * aMcuRowsPerInterval;
+				ret.insert( ret.end(), { 0xFF, 0xDD, 0x00, 0x04, std::uint8_t( interval >> 8 ), std::uint8_t( interval ) } );
+				ret.insert( ret.end(), jpeg.begin() + std::ptrdiff_t(sos), jpeg.begin() + std::ptrdiff_t(data) );
+			}
+			else
+			{
+				ret.insert( ret.end(), { 0xFF, std::uint8_t( 0xD0 + (band - 1) % 8 ) } );
+			}
+
+			// Without the EOI.
+			ret.insert( ret.end(), jpeg.begin() + std::ptrdiff_t(data), jpeg.end() - 2 );
+		}
+
+		ret.insert( ret.end(), { 0xFF, 0xD9 } );
+		return ret;
+	}
+
+	struct Image_
+	{
+		int width = 0, height = 0;
+		std::vector<std::uint8_t> pixels;
+	};
+
+	Image_ decode_( std::vector<std::uint8_t> const& aJpeg )
+	{
+		Image_ ret;
+		int channels = 0;
+		stbi_uc* pixels = stbi_load_from_memory( aJpeg.data(), int(aJpeg.size()), &ret.width, &ret.height, &channels, STBI_rgb_alpha );
+		REQUIRE( pixels );
+		ret.pixels.assign( pixels, pixels + std::size_t(ret.width) * ret.height * 4 );
+		stbi_image_free( pixels );
+		return ret;
+	}
+
+	// Decodes aStrips on up to aThreads threads, into an aWidth x aHeight image.
+	std::vector<std::uint8_t> decode_strips_( std::vector<JpegStrip> const& aStrips, int aWidth, int aHeight, std::size_t aThreads )
+	{
+		std::size_t const rowBytes = std::size_t(aWidth) * 4;
+		std::vector<std::uint8_t> ret( rowBytes * aHeight );
+		parallel_ranges( aStrips.size(), aThreads, [&] ( std::size_t aBegin, std::size_t aEnd, std::size_t ) {
+			for( std::size_t i = aBegin; i < aEnd; ++i )
+			{
+				int width = 0, height = 0, channels = 0;
+				stbi_uc* pixels = stbi_load_from_memory( aStrips[i].jpeg.data(), int(aStrips[i].jpeg.size()), &width, &height, &channels, STBI_rgb_alpha );
+				if( pixels && width == aWidth && std::uint32_t(height) >= aStrips[i].skipRows + aStrips[i].rowCount )
+					std::memcpy( ret.data() + aStrips[i].firstRow * rowBytes, pixels + aStrips[i].skipRows * rowBytes, aStrips[i].rowCount * rowBytes );
+				stbi_image_free( pixels );
+			}
+		} );
+		return ret;
+	}
+}
+
+TEST_CASE( "Splitting a JPEG at restart markers", "[jpeg_strips]" )
+{
+	// Not a multiple of the 16x16 MCUs.
+	constexpr std::uint32_t kWidth = 200, kHeight = 150;
+
+	auto const mcuRowsPerInterval = GENERATE( 1u, 3u );
+	auto const jpeg = make_restart_jpeg_( kWidth, kHeight, mcuRowsPerInterval );
+	auto const whole = decode_( jpeg );
+	REQUIRE( whole.width == int(kWidth) );
+	REQUIRE( whole.height == int(kHeight) );
+
+	// 10 rows of MCUs, so at most 10 or 4 strips.
+	auto const maxStrips = GENERATE( 2u, 4u, 16u );
+	auto const strips = split_jpeg( jpeg, maxStrips );
+	REQUIRE( strips.size() == std::min<std::size_t>( maxStrips, 1 == mcuRowsPerInterval ? 10 : 4 ) );
+
+	std::uint32_t next = 0;
+	for( auto const& strip : strips )
+	{
+		REQUIRE( strip.firstRow == next );
+		REQUIRE( strip.rowCount > 0 );
+		REQUIRE( strip.firstRow % (16 * mcuRowsPerInterval) == 0 );
+		next += strip.rowCount;
+
+		auto const decoded = decode_( strip.jpeg );
+		REQUIRE( decoded.width == int(kWidth) );
+		REQUIRE( std::uint32_t(decoded.height) >= strip.skipRows + strip.rowCount );
+	}
+	REQUIRE( next == kHeight );
+
+	// Exactly the pixels of the whole image, chroma upsampling included.
+	REQUIRE( decode_strips_( strips, whole.width, whole.height, 1 ) == whole.pixels );
+}
+
+TEST_CASE( "JPEGs that cannot be split", "[jpeg_strips]" )
+{
+	// No restart markers.
+	auto const plain = write_jpeg_( make_rows_( 64, 0, 64 ), 64, 64 );
+	REQUIRE( split_jpeg( plain, 4 ).empty() );
+
+	// Only one strip asked for, or possible.
+	auto const jpeg = make_restart_jpeg_( 64, 64, 1 );
+	REQUIRE( split_jpeg( jpeg, 1 ).empty() );
+	REQUIRE( split_jpeg( make_restart_jpeg_( 64, 64, 4 ), 4 ).empty() );
+	REQUIRE( split_jpeg( jpeg, 4 ).size() == 4 );
+
+	// Truncated, or not a JPEG.
+	REQUIRE( split_jpeg( std::span( jpeg ).first( jpeg.size() / 2 ), 4 ).empty() );
+	REQUIRE( split_jpeg( std::span( jpeg ).first( 3 ), 4 ).empty() );
+	std::vector<std::uint8_t> const notJpeg( 256, 0x42 );
+	REQUIRE( split_jpeg( notJpeg, 4 ).empty() );
+}
+
+// Benchmarks (hidden by default; run with "[benchmark]").
+//
+// The synthetic images have a restart marker at every MCU row. Generating
+// the 16K one takes a while (and 2 GiB for the decoded pixels).
+TEST_CASE( "Decoding 8K and 16K JPEGs in strips", "[.][benchmark][jpeg_strips]" )
+{
+	auto const size = GENERATE( 8192u, 16384u );
+	auto const jpeg = make_restart_jpeg_( size, size, 1 );
+
+	BENCHMARK( std::to_string( size ) + "^2 whole (stb_image)" )
+	{
+		int width = 0, height = 0, channels = 0;
+		stbi_uc* pixels = stbi_load_from_memory( jpeg.data(), int(jpeg.size()), &width, &height, &channels, STBI_rgb_alpha );
+		stbi_image_free( pixels );
+		return width;
+	};
+
+	std::size_t const maxThreads = default_thread_count();
+	for( std::size_t threads = 1; ; threads = std::min( 2 * threads, maxThreads ) )
+	{
+		// As decode_image_rgba8() in main/image_decode.cpp, which only splits
+		// images for two threads or more. With one, this is the overhead of
+		// the strips.
+		auto const strips = split_jpeg( jpeg, std::max<std::size_t>( 2, threads ) );
+		BENCHMARK( std::to_string( size ) + "^2 strips, " + std::to_string( threads ) + " threads" )
+		{
+			return decode_strips_( strips, int(size), int(size), threads );
+		};
+
+		if( threads == maxThreads )
+			break;
+	}
+}
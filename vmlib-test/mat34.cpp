@@ -0,0 +1,194 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <array>
+#include <random>
+
+#include "../vmlib/mat34.hpp"
+
+namespace
+{
+	constexpr std::size_t kRandomCount_ = 64;
+
+	Mat44f random_rigid_( std::mt19937& aRng )
+	{
+		std::uniform_real_distribution<float> angle( -3.f, 3.f );
+		std::uniform_real_distribution<float> offset( -100.f, 100.f );
+
+		return make_translation( { offset( aRng ), offset( aRng ), offset( aRng ) } )
+			* make_rotation_z( angle( aRng ) )
+			* make_rotation_y( angle( aRng ) )
+			* make_rotation_x( angle( aRng ) );
+	}
+
+	// Rigid transformation followed by a non-uniform scaling and a shear.
+	Mat44f random_affine_( std::mt19937& aRng )
+	{
+		std::uniform_real_distribution<float> scale( 0.5f, 4.f );
+		std::uniform_real_distribution<float> shear( -0.5f, 0.5f );
+
+		Mat44f linear = kIdentity44f;
+		linear[0,0] = scale( aRng );
+		linear[1,1] = scale( aRng );
+		linear[2,2] = scale( aRng );
+		linear[0,1] = shear( aRng );
+		linear[2,0] = shear( aRng );
+
+		return random_rigid_( aRng ) * linear;
+	}
+
+	void require_near_( Mat44f const& aA, Mat44f const& aB, float aTolerance )
+	{
+		using Catch::Matchers::WithinAbs;
+		using Catch::Matchers::WithinRel;
+		for( std::size_t i = 0; i < 16; ++i )
+			REQUIRE_THAT( aA.v[i], WithinRel( aB.v[i], aTolerance ) || WithinAbs( aB.v[i], aTolerance ) );
+	}
+}
+
+TEST_CASE( "Mat34f matches the equivalent Mat44f operations", "[mat34]" )
+{
+	using Catch::Matchers::WithinAbs;
+	using Catch::Matchers::WithinRel;
+
+	std::mt19937 rng( 3434 );
+
+	SECTION( "Conversions round trip" )
+	{
+		auto const m = random_affine_( rng );
+		auto const back = to_mat44( to_mat34( m ) );
+		for( std::size_t i = 0; i < 16; ++i )
+			REQUIRE( back.v[i] == m.v[i] );
+	}
+
+	SECTION( "Composition" )
+	{
+		for( std::size_t i = 0; i < kRandomCount_; ++i )
+		{
+			auto const a = random_affine_( rng );
+			auto const b = random_affine_( rng );
+			require_near_( to_mat44( to_mat34( a ) * to_mat34( b ) ), a * b, 1e-5f );
+		}
+	}
+
+	SECTION( "Points and directions" )
+	{
+		auto const m = random_affine_( rng );
+		auto const m34 = to_mat34( m );
+		Vec3f const v{ 1.5f, -2.f, 7.f };
+
+		auto const p = transform_point( m34, v );
+		auto const pRef = m * Vec4f{ v.x, v.y, v.z, 1.f };
+		REQUIRE_THAT( p.x, WithinRel( pRef.x, 1e-5f ) );
+		REQUIRE_THAT( p.y, WithinRel( pRef.y, 1e-5f ) );
+		REQUIRE_THAT( p.z, WithinRel( pRef.z, 1e-5f ) );
+
+		auto const d = transform_direction( m34, v );
+		auto const dRef = m * Vec4f{ v.x, v.y, v.z, 0.f };
+		REQUIRE_THAT( d.x, WithinRel( dRef.x, 1e-5f ) );
+		REQUIRE_THAT( d.y, WithinRel( dRef.y, 1e-5f ) );
+		REQUIRE_THAT( d.z, WithinRel( dRef.z, 1e-5f ) );
+	}
+
+	SECTION( "Rigid inverse" )
+	{
+		for( std::size_t i = 0; i < kRandomCount_; ++i )
+		{
+			auto const m = random_rigid_( rng );
+			auto const inv = invert_rigid( to_mat34( m ) );
+			require_near_( to_mat44( inv ), invert( m ), 1e-4f );
+			require_near_( to_mat44( to_mat34( m ) * inv ), kIdentity44f, 1e-4f );
+		}
+	}
+
+	SECTION( "Affine inverse" )
+	{
+		for( std::size_t i = 0; i < kRandomCount_; ++i )
+		{
+			auto const m = random_affine_( rng );
+			auto const inv = invert_affine( to_mat34( m ) );
+			require_near_( to_mat44( inv ), invert( m ), 1e-4f );
+			require_near_( to_mat44( to_mat34( m ) * inv ), kIdentity44f, 1e-4f );
+		}
+	}
+
+	SECTION( "Normal matrix" )
+	{
+		for( std::size_t i = 0; i < kRandomCount_; ++i )
+		{
+			auto const m = random_affine_( rng );
+			auto const normal = make_normal_matrix( to_mat34( m ) );
+			auto const ref = mat44_to_mat33( transpose( invert( m ) ) );
+			for( std::size_t j = 0; j < 9; ++j )
+				REQUIRE_THAT( normal.v[j], WithinRel( ref.v[j], 1e-4f ) || WithinAbs( ref.v[j], 1e-5f ) );
+		}
+
+		// For rigid transformations, the normal matrix is the rotation itself.
+		auto const rigid = to_mat34( random_rigid_( rng ) );
+		auto const normal = make_normal_matrix( rigid );
+		auto const rotation = linear_part( rigid );
+		for( std::size_t j = 0; j < 9; ++j )
+			REQUIRE_THAT( normal.v[j], WithinAbs( rotation.v[j], 1e-5f ) );
+	}
+
+	SECTION( "Constant evaluation" )
+	{
+		constexpr Mat34f shifted = [] {
+			Mat34f m = kIdentity34f;
+			m[0,3] = 2.f;
+			m[1,1] = 4.f;
+			return invert_affine( m * m );
+		}();
+		static_assert( shifted[0,3] == -4.f && shifted[1,1] == 1.f/16.f );
+	}
+}
+
+// Benchmarks (hidden by default; run with "[benchmark]").
+TEST_CASE( "Affine kernels: Mat34f vs Mat44f", "[.][benchmark][mat34]" )
+{
+	std::mt19937 rng( 43 );
+
+	std::array<Mat44f,64> mats;
+	std::array<Mat34f,64> mats34;
+	for( std::size_t i = 0; i < mats.size(); ++i )
+	{
+		mats[i] = random_rigid_( rng );
+		mats34[i] = to_mat34( mats[i] );
+	}
+
+	BENCHMARK( "compose (Mat44f)" )
+	{
+		Mat44f acc = kIdentity44f;
+		for( auto const& m : mats )
+			acc = acc * m;
+		return acc;
+	};
+	BENCHMARK( "compose (Mat34f)" )
+	{
+		Mat34f acc = kIdentity34f;
+		for( auto const& m : mats34 )
+			acc = acc * m;
+		return acc;
+	};
+
+	BENCHMARK( "invert (Mat44f, general)" )
+	{
+		float acc = 0.f;
+		for( auto const& m : mats )
+			acc += invert( m ).v[3];
+		return acc;
+	};
+	BENCHMARK( "invert (Mat34f, affine)" )
+	{
+		float acc = 0.f;
+		for( auto const& m : mats34 )
+			acc += invert_affine( m ).v[3];
+		return acc;
+	};
+	BENCHMARK( "invert (Mat34f, rigid)" )
+	{
+		float acc = 0.f;
+		for( auto const& m : mats34 )
+			acc += invert_rigid( m ).v[3];
+		return acc;
+	};
+}
@@ -0,0 +1,169 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <array>
+#include <random>
+#include <vector>
+#include <cstring>
+
+#include "../vmlib/mat44.hpp"
+
+namespace
+{
+	Mat44f random_matrix_( std::mt19937& aRng )
+	{
+		std::uniform_real_distribution<float> dist( -10.f, 10.f );
+
+		Mat44f ret;
+		for( auto& v : ret.v )
+			v = dist( aRng );
+		return ret;
+	}
+
+	// What main.cpp used to do before every glUniformMatrix4fv() call.
+	std::array<float,16> to_gl_matrix_( Mat44f const& aMat )
+	{
+		std::array<float,16> glMat{};
+		for( std::size_t row = 0; row < 4; ++row )
+		{
+			for( std::size_t col = 0; col < 4; ++col )
+				glMat[col * 4 + row] = aMat[row, col];
+		}
+		return glMat;
+	}
+
+	// Stand-in for glUniformMatrix4fv(): copies the 16 floats somewhere, so
+	// that the benchmarks include the (unavoidable) cost of the upload itself.
+	struct UniformSink_
+	{
+		float slot[16];
+		float checksum = 0.f;
+
+		void upload( float const* aData ) noexcept
+		{
+			std::memcpy( slot, aData, sizeof(slot) );
+			checksum += slot[3];
+		}
+	};
+}
+
+TEST_CASE( "Mat44fGl stores matrices in column-major order", "[mat44][gl]" )
+{
+	std::mt19937 rng( 77 );
+
+	for( std::size_t n = 0; n < 16; ++n )
+	{
+		auto const m = random_matrix_( rng );
+		auto const gl = to_gl( m );
+		auto const ref = to_gl_matrix_( m );
+
+		for( std::size_t i = 0; i < 4; ++i )
+		{
+			for( std::size_t j = 0; j < 4; ++j )
+				REQUIRE( gl[i,j] == m[i,j] );
+		}
+		for( std::size_t i = 0; i < 16; ++i )
+			REQUIRE( gl.data()[i] == ref[i] );
+
+		auto const back = from_gl( gl );
+		for( std::size_t i = 0; i < 16; ++i )
+			REQUIRE( back.v[i] == m.v[i] );
+	}
+
+	constexpr Mat44fGl translation = [] {
+		Mat44f m = kIdentity44f;
+		m[0,3] = 1.f;
+		return to_gl( m );
+	}();
+	static_assert( translation.v[12] == 1.f && translation[0,3] == 1.f );
+	static_assert( to_gl( kIdentity44f ).v[5] == kIdentity44fGl.v[5] );
+}
+
+// Benchmarks (hidden by default; run with "[benchmark]").
+//
+// Mirrors the uniform uploads that the render loop makes per frame: for each
+// of two views, view + projection + terrain model, then one model matrix per
+// landing pad and one for the vehicle. The "per draw" variant converts every
+// matrix right before it is uploaded; the "cached" variant converts view and
+// projection once per view and the vehicle once per frame, and keeps the
+// static pad matrices in GL layout.
+TEST_CASE( "Per-frame matrix uploads: 2 views x N pads", "[.][benchmark][mat44][gl]" )
+{
+	constexpr std::size_t kViews = 2;
+
+	std::mt19937 rng( 78 );
+
+	auto padCount = GENERATE( std::size_t(2), std::size_t(32), std::size_t(512) );
+
+	std::array<Mat44f, kViews> views, projs;
+	for( std::size_t i = 0; i < kViews; ++i )
+	{
+		views[i] = random_matrix_( rng );
+		projs[i] = random_matrix_( rng );
+	}
+
+	Mat44f const terrainModel = kIdentity44f;
+	Mat44f const vehicleModel = random_matrix_( rng );
+
+	std::vector<Mat44f> pads( padCount );
+	for( auto& p : pads )
+		p = random_matrix_( rng );
+
+	std::vector<Mat44fGl> padsGl( padCount );
+	for( std::size_t i = 0; i < padCount; ++i )
+		padsGl[i] = to_gl( pads[i] );
+	Mat44fGl const terrainModelGl = to_gl( terrainModel );
+
+	UniformSink_ sink;
+
+	BENCHMARK( "to_gl_matrix per draw, " + std::to_string( padCount ) + " pads" )
+	{
+		for( std::size_t v = 0; v < kViews; ++v )
+		{
+			auto const modelGl = to_gl_matrix_( terrainModel );
+			auto const viewGl = to_gl_matrix_( views[v] );
+			auto const projGl = to_gl_matrix_( projs[v] );
+			sink.upload( modelGl.data() );
+			sink.upload( viewGl.data() );
+			sink.upload( projGl.data() );
+
+			// landing pad program
+			sink.upload( viewGl.data() );
+			sink.upload( projGl.data() );
+			for( auto const& pad : pads )
+			{
+				auto const padGl = to_gl_matrix_( pad );
+				sink.upload( padGl.data() );
+			}
+
+			auto const vehicleGl = to_gl_matrix_( vehicleModel );
+			sink.upload( vehicleGl.data() );
+		}
+		return sink.checksum;
+	};
+
+	BENCHMARK( "Mat44fGl cached, " + std::to_string( padCount ) + " pads" )
+	{
+		std::array<Mat44fGl, kViews> viewsGl, projsGl;
+		for( std::size_t v = 0; v < kViews; ++v )
+		{
+			viewsGl[v] = to_gl( views[v] );
+			projsGl[v] = to_gl( projs[v] );
+		}
+		Mat44fGl const vehicleGl = to_gl( vehicleModel );
+
+		for( std::size_t v = 0; v < kViews; ++v )
+		{
+			sink.upload( terrainModelGl.data() );
+			sink.upload( viewsGl[v].data() );
+			sink.upload( projsGl[v].data() );
+
+			sink.upload( viewsGl[v].data() );
+			sink.upload( projsGl[v].data() );
+			for( auto const& padGl : padsGl )
+				sink.upload( padGl.data() );
+
+			sink.upload( vehicleGl.data() );
+		}
+		return sink.checksum;
+	};
+}
@@ -0,0 +1,215 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <array>
+#include <random>
+
+#include "../vmlib/mat44.hpp"
+
+// The SIMD code paths must produce the same results as the scalar reference
+// implementations. Some additions happen in a different order, so results are
+// compared with a small tolerance rather than bit-exactly.
+
+namespace
+{
+	constexpr std::size_t kRandomCount_ = 64;
+
+	Mat44f random_matrix_( std::mt19937& aRng )
+	{
+		std::uniform_real_distribution<float> dist( -10.f, 10.f );
+
+		Mat44f ret;
+		for( auto& v : ret.v )
+			v = dist( aRng );
+		return ret;
+	}
+
+	// A well-conditioned matrix (rotation, scale and translation, and a
+	// perspective-like bottom row every now and then).
+	Mat44f random_invertible_( std::mt19937& aRng )
+	{
+		std::uniform_real_distribution<float> angle( -3.f, 3.f );
+		std::uniform_real_distribution<float> scale( 0.5f, 4.f );
+		std::uniform_real_distribution<float> offset( -100.f, 100.f );
+
+		Mat44f const scaling = make_scaling( scale( aRng ), scale( aRng ), scale( aRng ) );
+
+		Mat44f ret = make_translation( { offset( aRng ), offset( aRng ), offset( aRng ) } )
+			* make_rotation_z( angle( aRng ) )
+			* make_rotation_y( angle( aRng ) )
+			* make_rotation_x( angle( aRng ) )
+			* scaling;
+
+		if( aRng() % 2 )
+			ret = make_perspective_projection( 1.f, 1.5f, 0.5f, 400.f ) * ret;
+
+		return ret;
+	}
+
+	void require_near_( Mat44f const& aA, Mat44f const& aB, float aTolerance )
+	{
+		using Catch::Matchers::WithinAbs;
+		using Catch::Matchers::WithinRel;
+		for( std::size_t i = 0; i < 16; ++i )
+			REQUIRE_THAT( aA.v[i], WithinRel( aB.v[i], aTolerance ) || WithinAbs( aB.v[i], aTolerance ) );
+	}
+}
+
+TEST_CASE( "Mat44 operators match the scalar reference", "[mat44][simd]" )
+{
+	using Catch::Matchers::WithinAbs;
+	using Catch::Matchers::WithinRel;
+
+	std::mt19937 rng( 1234 );
+
+	SECTION( "Matrix times matrix" )
+	{
+		for( std::size_t i = 0; i < kRandomCount_; ++i )
+		{
+			auto const a = random_matrix_( rng );
+			auto const b = random_matrix_( rng );
+			require_near_( a * b, detail::mul_scalar( a, b ), 1e-5f );
+		}
+	}
+
+	SECTION( "Matrix times vector" )
+	{
+		std::uniform_real_distribution<float> dist( -10.f, 10.f );
+		for( std::size_t i = 0; i < kRandomCount_; ++i )
+		{
+			auto const m = random_matrix_( rng );
+			Vec4f const v{ dist( rng ), dist( rng ), dist( rng ), dist( rng ) };
+
+			auto const res = m * v;
+			auto const ref = detail::mul_scalar( m, v );
+			for( std::size_t j = 0; j < 4; ++j )
+				REQUIRE_THAT( res[j], WithinRel( ref[j], 1e-5f ) || WithinAbs( ref[j], 1e-4f ) );
+		}
+	}
+
+	SECTION( "Transpose" )
+	{
+		for( std::size_t i = 0; i < kRandomCount_; ++i )
+		{
+			auto const m = random_matrix_( rng );
+			auto const t = transpose( m );
+			auto const ref = detail::transpose_scalar( m );
+			for( std::size_t j = 0; j < 16; ++j )
+				REQUIRE( t.v[j] == ref.v[j] );
+		}
+	}
+
+	SECTION( "Inverse" )
+	{
+		for( std::size_t i = 0; i < kRandomCount_; ++i )
+		{
+			auto const m = random_invertible_( rng );
+			auto const inv = invert( m );
+			require_near_( inv, detail::invert_scalar( m ), 1e-4f );
+			require_near_( m * inv, kIdentity44f, 1e-4f );
+		}
+	}
+
+	SECTION( "Constant evaluation uses the scalar path" )
+	{
+		constexpr Mat44f twice = [] {
+			Mat44f m = kIdentity44f;
+			m[0,0] = 2.f;
+			m[0,3] = 1.f;
+			return transpose( m * m );
+		}();
+		static_assert( twice[0,0] == 4.f && twice[3,0] == 3.f );
+	}
+}
+
+#if defined(VMLIB_SIMD_SSE)
+TEST_CASE( "Mat44 SIMD kernels match the scalar reference", "[mat44][simd]" )
+{
+	std::mt19937 rng( 4321 );
+
+	for( std::size_t i = 0; i < kRandomCount_; ++i )
+	{
+		auto const a = random_invertible_( rng );
+		auto const b = random_matrix_( rng );
+
+		require_near_( detail::mul_simd( a, b ), detail::mul_scalar( a, b ), 1e-5f );
+		require_near_( detail::transpose_simd( b ), detail::transpose_scalar( b ), 0.f );
+		require_near_( detail::invert_simd( a ), detail::invert_scalar( a ), 1e-4f );
+	}
+}
+#endif // ~ VMLIB_SIMD_SSE
+
+// Benchmarks. These are hidden by default; run them with
+//   vmlib-test "[benchmark]"
+// Build in the release configuration to get meaningful numbers.
+TEST_CASE( "Mat44 kernels: scalar vs " VMLIB_SIMD_NAME, "[.][benchmark][mat44]" )
+{
+	std::mt19937 rng( 42 );
+
+	std::array<Mat44f,64> mats;
+	for( auto& m : mats )
+		m = random_invertible_( rng );
+
+	Vec4f const vec{ 1.f, 2.f, 3.f, 1.f };
+
+	// Each benchmark chains results through the array so that the work cannot
+	// be hoisted out of the measurement loop.
+	BENCHMARK( "multiply (scalar)" )
+	{
+		Mat44f acc = kIdentity44f;
+		for( auto const& m : mats )
+			acc = detail::mul_scalar( acc, m );
+		return acc;
+	};
+	BENCHMARK( "multiply (" VMLIB_SIMD_NAME ")" )
+	{
+		Mat44f acc = kIdentity44f;
+		for( auto const& m : mats )
+			acc = acc * m;
+		return acc;
+	};
+
+	BENCHMARK( "transform (scalar)" )
+	{
+		Vec4f acc{};
+		for( auto const& m : mats )
+			acc += detail::mul_scalar( m, vec );
+		return acc;
+	};
+	BENCHMARK( "transform (" VMLIB_SIMD_NAME ")" )
+	{
+		Vec4f acc{};
+		for( auto const& m : mats )
+			acc += m * vec;
+		return acc;
+	};
+
+	BENCHMARK( "transpose (scalar)" )
+	{
+		float acc = 0.f;
+		for( auto const& m : mats )
+			acc += detail::transpose_scalar( m ).v[1];
+		return acc;
+	};
+	BENCHMARK( "transpose (" VMLIB_SIMD_NAME ")" )
+	{
+		float acc = 0.f;
+		for( auto const& m : mats )
+			acc += transpose( m ).v[1];
+		return acc;
+	};
+
+	BENCHMARK( "invert (scalar)" )
+	{
+		float acc = 0.f;
+		for( auto const& m : mats )
+			acc += detail::invert_scalar( m ).v[5];
+		return acc;
+	};
+	BENCHMARK( "invert (" VMLIB_SIMD_NAME ")" )
+	{
+		float acc = 0.f;
+		for( auto const& m : mats )
+			acc += invert( m ).v[5];
+		return acc;
+	};
+}
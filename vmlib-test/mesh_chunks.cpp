@@ -0,0 +1,136 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <array>
+#include <vector>
+#include <algorithm>
+
+#include "../vmlib/mesh_chunks.hpp"
+
+#include "test_grid.hpp"
+
+namespace
+{
+	// Grid with some height variation (see test_grid.hpp).
+	TestGrid make_grid_( std::uint32_t aN )
+	{
+		return make_test_grid( aN, [] ( float aX, float aZ ) {
+			return 0.25f * float((std::uint32_t(aX) * 7 + std::uint32_t(aZ) * 3) % 5);
+		} );
+	}
+
+	std::vector<std::array<std::uint32_t,3>> sorted_triangles_( std::span<std::uint32_t const> aIndices )
+	{
+		std::vector<std::array<std::uint32_t,3>> ret;
+		for( std::size_t i = 0; i < aIndices.size(); i += 3 )
+			ret.push_back( { aIndices[i], aIndices[i+1], aIndices[i+2] } );
+		std::sort( ret.begin(), ret.end() );
+		return ret;
+	}
+}
+
+TEST_CASE( "Chunking a regular grid", "[chunks]" )
+{
+	auto grid = make_grid_( 64 );
+	auto const original = grid.indices;
+
+	auto const chunks = partition_mesh_chunks( grid.indices, grid.positions, 4, 4 );
+
+	// Same triangles (with the same vertex order), regrouped.
+	REQUIRE( sorted_triangles_( grid.indices ) == sorted_triangles_( original ) );
+
+	// 16 x 16 quads per cell, two triangles each.
+	REQUIRE( chunks.size() == 16 );
+
+	std::uint32_t nextIndex = 0;
+	for( std::size_t c = 0; c < chunks.size(); ++c )
+	{
+		auto const& chunk = chunks[c];
+		INFO( "chunk " << c );
+
+		REQUIRE( chunk.indexCount == 16 * 16 * 2 * 3 );
+		REQUIRE( chunk.firstIndex == nextIndex );
+		nextIndex += chunk.indexCount;
+
+		REQUIRE( chunk.cellX == c % 4 );
+		REQUIRE( chunk.cellZ == c / 4 );
+
+		// Each cell covers exactly 16 x 16 units.
+		REQUIRE( chunk.bounds.min.x == 16.f * chunk.cellX );
+		REQUIRE( chunk.bounds.max.x == 16.f * (chunk.cellX + 1) );
+		REQUIRE( chunk.bounds.min.z == 16.f * chunk.cellZ );
+		REQUIRE( chunk.bounds.max.z == 16.f * (chunk.cellZ + 1) );
+		REQUIRE( chunk.bounds.min.y >= 0.f );
+		REQUIRE( chunk.bounds.max.y <= 1.f );
+
+		// The sphere contains all vertices, and is no larger than the box'.
+		REQUIRE( chunk.radius <= radius( chunk.bounds ) * (1.f + 1e-6f) );
+		for( std::uint32_t i = chunk.firstIndex; i < chunk.firstIndex + chunk.indexCount; ++i )
+		{
+			Vec3f const d = grid.positions[grid.indices[i]] - chunk.center;
+			REQUIRE( length( d ) <= chunk.radius * (1.f + 1e-6f) );
+		}
+	}
+
+	REQUIRE( nextIndex == grid.indices.size() );
+}
+
+TEST_CASE( "Chunking with uneven cells", "[chunks]" )
+{
+	// Cells of 10/3 units do not line up with the quads; each triangle goes
+	// to the cell containing its centroid.
+	auto grid = make_grid_( 10 );
+	auto const chunks = partition_mesh_chunks( grid.indices, grid.positions, 3, 1 );
+
+	REQUIRE( chunks.size() == 3 );
+
+	std::size_t total = 0;
+	for( auto const& chunk : chunks )
+	{
+		REQUIRE( chunk.cellZ == 0 );
+		total += chunk.indexCount;
+
+		float const cellMin = 10.f / 3.f * chunk.cellX;
+		float const cellMax = 10.f / 3.f * (chunk.cellX + 1);
+		for( std::uint32_t i = chunk.firstIndex; i < chunk.firstIndex + chunk.indexCount; i += 3 )
+		{
+			float const cx = (grid.positions[grid.indices[i]].x + grid.positions[grid.indices[i+1]].x + grid.positions[grid.indices[i+2]].x) / 3.f;
+			REQUIRE( cx >= cellMin - 1e-4f );
+			REQUIRE( cx <= cellMax + 1e-4f );
+		}
+	}
+	REQUIRE( total == grid.indices.size() );
+}
+
+TEST_CASE( "Chunking skips empty cells", "[chunks]" )
+{
+	// Two separate triangles in opposite corners of a 4x4 grid.
+	std::vector<Vec3f> const positions{
+		{ 0.f, 0.f, 0.f }, { 0.f, 0.f, 1.f }, { 1.f, 0.f, 0.f },
+		{ 9.f, 0.f, 9.f }, { 9.f, 0.f, 10.f }, { 10.f, 0.f, 10.f }
+	};
+	std::vector<std::uint32_t> indices{ 3, 4, 5, 0, 1, 2 };
+
+	auto const chunks = partition_mesh_chunks( indices, positions, 4, 4 );
+
+	REQUIRE( chunks.size() == 2 );
+	REQUIRE( chunks[0].cellX == 0 );
+	REQUIRE( chunks[0].cellZ == 0 );
+	REQUIRE( chunks[1].cellX == 3 );
+	REQUIRE( chunks[1].cellZ == 3 );
+	REQUIRE( indices == std::vector<std::uint32_t>{ 0, 1, 2, 3, 4, 5 } );
+}
+
+TEST_CASE( "Chunking a flat strip", "[chunks]" )
+{
+	// No extent along Z: everything goes to the first row of cells.
+	std::vector<Vec3f> const positions{ { 0.f, 0.f, 0.f }, { 1.f, 1.f, 0.f }, { 2.f, 0.f, 0.f } };
+	std::vector<std::uint32_t> indices{ 0, 1, 2 };
+
+	auto const chunks = partition_mesh_chunks( indices, positions, 2, 2 );
+	REQUIRE( chunks.size() == 1 );
+	REQUIRE( chunks[0].cellX == 1 );
+	REQUIRE( chunks[0].cellZ == 0 );
+
+	std::vector<std::uint32_t> none;
+	REQUIRE( partition_mesh_chunks( none, positions, 2, 2 ).empty() );
+}
@@ -0,0 +1,121 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <set>
+#include <array>
+#include <vector>
+
+#include "../vmlib/meshlets.hpp"
+
+#include "test_grid.hpp"
+
+namespace
+{
+	// Flat grid, facing up (see test_grid.hpp).
+	TestGrid make_grid_( std::uint32_t aN )
+	{
+		return make_test_grid( aN );
+	}
+}
+
+TEST_CASE( "Meshlets of a grid", "[meshlets]" )
+{
+	auto const grid = make_grid_( 64 );
+	MeshLod const all{ 0, std::uint32_t(grid.indices.size()), 0.f };
+
+	auto const meshlets = build_meshlets( grid.indices, grid.positions, std::span( &all, 1 ) );
+	REQUIRE( meshlets.size() >= grid.indices.size() / 3 / kMeshletMaxTriangles );
+
+	// The meshlets cover the indices in order, within the limits.
+	std::uint32_t next = 0;
+	for( auto const& meshlet : meshlets )
+	{
+		REQUIRE( meshlet.firstIndex == next );
+		REQUIRE( meshlet.indexCount > 0 );
+		REQUIRE( meshlet.indexCount % 3 == 0 );
+		REQUIRE( meshlet.indexCount <= 3 * kMeshletMaxTriangles );
+		next += meshlet.indexCount;
+
+		std::set<std::uint32_t> vertices;
+		for( std::uint32_t i = meshlet.firstIndex; i < meshlet.firstIndex + meshlet.indexCount; ++i )
+		{
+			vertices.emplace( grid.indices[i] );
+			REQUIRE( length( grid.positions[grid.indices[i]] - meshlet.center ) <= meshlet.radius * 1.0001f );
+		}
+		REQUIRE( vertices.size() <= kMeshletMaxVertices );
+
+		// Flat and facing up: the cone is a single direction.
+		REQUIRE( meshlet.coneAxis.y == Catch::Approx( 1.f ) );
+		REQUIRE( meshlet.coneCutoff == Catch::Approx( 0.f ).margin( 1e-3 ) );
+	}
+	REQUIRE( next == grid.indices.size() );
+
+	REQUIRE( find_meshlets( meshlets, all ).size() == meshlets.size() );
+}
+
+TEST_CASE( "Meshlets of several ranges", "[meshlets]" )
+{
+	auto const grid = make_grid_( 32 );
+	auto const half = std::uint32_t(grid.indices.size() / 2);
+
+	// Given out of order; the meshlets come back sorted, and never straddle
+	// two ranges.
+	std::array<MeshLod,2> const ranges{ {
+		{ half, std::uint32_t(grid.indices.size()) - half, 0.f },
+		{ 0, half, 0.f }
+	} };
+	auto const meshlets = build_meshlets( grid.indices, grid.positions, ranges, 16, 20 );
+
+	for( std::size_t i = 1; i < meshlets.size(); ++i )
+		REQUIRE( meshlets[i-1].firstIndex < meshlets[i].firstIndex );
+
+	std::size_t found = 0;
+	for( auto const& range : ranges )
+	{
+		auto const own = find_meshlets( meshlets, range );
+		REQUIRE( !own.empty() );
+		REQUIRE( own.front().firstIndex == range.firstIndex );
+		REQUIRE( own.back().firstIndex + own.back().indexCount == range.firstIndex + range.indexCount );
+		for( auto const& meshlet : own )
+			REQUIRE( meshlet.indexCount <= 3 * 20 );
+		found += own.size();
+	}
+	REQUIRE( found == meshlets.size() );
+}
+
+TEST_CASE( "Meshlet backface culling", "[meshlets]" )
+{
+	auto const grid = make_grid_( 4 );
+	MeshLod const all{ 0, std::uint32_t(grid.indices.size()), 0.f };
+
+	auto const meshlets = build_meshlets( grid.indices, grid.positions, std::span( &all, 1 ) );
+	REQUIRE( meshlets.size() == 1 );
+	auto const& flat = meshlets[0];
+
+	// Seen from below, the grid faces away; from above, or from the side
+	// above its plane, it does not.
+	REQUIRE( is_backfacing( flat, Vec3f{ 2.f, -10.f, 2.f } ) );
+	REQUIRE( is_backfacing( flat, Vec3f{ 50.f, -60.f, 2.f } ) );
+	REQUIRE( !is_backfacing( flat, Vec3f{ 2.f, 10.f, 2.f } ) );
+	REQUIRE( !is_backfacing( flat, Vec3f{ 50.f, 0.5f, 2.f } ) );
+
+	// Just below the plane, but next to the grid: conservatively kept.
+	REQUIRE( !is_backfacing( flat, Vec3f{ 5.f, -0.1f, 2.f } ) );
+
+	// A closed box always shows some faces.
+	std::vector<Vec3f> const box{
+		{ 0.f, 0.f, 0.f }, { 1.f, 0.f, 0.f }, { 1.f, 1.f, 0.f }, { 0.f, 1.f, 0.f },
+		{ 0.f, 0.f, 1.f }, { 1.f, 0.f, 1.f }, { 1.f, 1.f, 1.f }, { 0.f, 1.f, 1.f }
+	};
+	std::vector<std::uint32_t> const boxIndices{
+		0, 2, 1,  0, 3, 2,  4, 5, 6,  4, 6, 7,
+		0, 1, 5,  0, 5, 4,  3, 6, 2,  3, 7, 6,
+		0, 4, 7,  0, 7, 3,  1, 2, 6,  1, 6, 5
+	};
+	MeshLod const boxRange{ 0, std::uint32_t(boxIndices.size()), 0.f };
+
+	auto const closed = build_meshlets( boxIndices, box, std::span( &boxRange, 1 ) );
+	REQUIRE( closed.size() == 1 );
+	REQUIRE( closed[0].coneCutoff == 1.f );
+	for( auto const eye : { Vec3f{ 0.5f, 0.5f, -10.f }, Vec3f{ 0.5f, -10.f, 0.5f }, Vec3f{ 10.f, 10.f, 10.f } } )
+		REQUIRE( !is_backfacing( closed[0], eye ) );
+}
@@ -0,0 +1,97 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "../vmlib/mip_streaming.hpp"
+
+TEST_CASE( "Mip tail level", "[mip_streaming]" )
+{
+	// 4096^2 has 13 levels; 256^2 is level 4.
+	REQUIRE( mip_tail_level( 4096, 4096, 256, 13 ) == 4 );
+	REQUIRE( mip_tail_level( 4096, 4096, 255, 13 ) == 5 );
+	REQUIRE( mip_tail_level( 4096, 1024, 256, 13 ) == 4 );
+	REQUIRE( mip_tail_level( 200, 100, 256, 8 ) == 0 );
+
+	// Never past the last level.
+	REQUIRE( mip_tail_level( 4096, 4096, 0, 13 ) == 12 );
+	REQUIRE( mip_tail_level( 4096, 4096, 256, 3 ) == 2 );
+}
+
+TEST_CASE( "Needed mip level", "[mip_streaming]" )
+{
+	// 1000 pixels per unit at distance 1, 100 texels per unit.
+	constexpr float kPixelsPerUnit = 1000.f, kTexelsPerUnit = 100.f;
+
+	// Up to 10 units away, a texel covers at least a pixel.
+	REQUIRE( needed_mip_level( kTexelsPerUnit, 0.f, kPixelsPerUnit, 13 ) == 0 );
+	REQUIRE( needed_mip_level( kTexelsPerUnit, 5.f, kPixelsPerUnit, 13 ) == 0 );
+	REQUIRE( needed_mip_level( kTexelsPerUnit, 19.f, kPixelsPerUnit, 13 ) == 0 );
+
+	// Each doubling of the distance skips a level.
+	REQUIRE( needed_mip_level( kTexelsPerUnit, 20.f, kPixelsPerUnit, 13 ) == 1 );
+	REQUIRE( needed_mip_level( kTexelsPerUnit, 39.f, kPixelsPerUnit, 13 ) == 1 );
+	REQUIRE( needed_mip_level( kTexelsPerUnit, 40.f, kPixelsPerUnit, 13 ) == 2 );
+	REQUIRE( needed_mip_level( kTexelsPerUnit, 80.f, kPixelsPerUnit, 13 ) == 3 );
+
+	// Clamped to the last level.
+	REQUIRE( needed_mip_level( kTexelsPerUnit, 1e6f, kPixelsPerUnit, 13 ) == 12 );
+	REQUIRE( needed_mip_level( kTexelsPerUnit, std::numeric_limits<float>::infinity(), kPixelsPerUnit, 13 ) == 12 );
+	REQUIRE( needed_mip_level( kTexelsPerUnit, 1e6f, kPixelsPerUnit, 1 ) == 0 );
+
+	// Degenerate inputs want the finest level.
+	REQUIRE( needed_mip_level( kTexelsPerUnit, -5.f, kPixelsPerUnit, 13 ) == 0 );
+	REQUIRE( needed_mip_level( kTexelsPerUnit, 0.f, 0.f, 13 ) == 0 );
+	REQUIRE( needed_mip_level( kTexelsPerUnit, std::nanf( "" ), kPixelsPerUnit, 13 ) == 0 );
+}
+
+TEST_CASE( "Budget mip level", "[mip_streaming]" )
+{
+	// RGBA8 levels of a 64x64 texture: 16 KiB, 4 KiB, 1 KiB, 256, 64, 16, 4.
+	std::vector<std::size_t> const bytes{ 16384, 4096, 1024, 256, 64, 16, 4 };
+	std::size_t const tail = 3; // 8x8 and smaller, 340 bytes
+
+	REQUIRE( budget_mip_level( bytes, 1 << 20, tail ) == 0 );
+	REQUIRE( budget_mip_level( bytes, 21844, tail ) == 0 );
+	REQUIRE( budget_mip_level( bytes, 21843, tail ) == 1 );
+	REQUIRE( budget_mip_level( bytes, 5460, tail ) == 1 );
+	REQUIRE( budget_mip_level( bytes, 1364, tail ) == 2 );
+
+	// The tail stays, even if it does not fit.
+	REQUIRE( budget_mip_level( bytes, 1000, tail ) == 3 );
+	REQUIRE( budget_mip_level( bytes, 0, tail ) == 3 );
+	REQUIRE( budget_mip_level( bytes, 0, 0 ) == 0 );
+
+	// A tail level past the last level is clamped to the last level.
+	REQUIRE( budget_mip_level( bytes, 0, 99 ) == bytes.size() - 1 );
+	REQUIRE( budget_mip_level( bytes, 4, 99 ) == bytes.size() - 1 );
+	REQUIRE( budget_mip_level( bytes, 20, 99 ) == bytes.size() - 2 );
+	REQUIRE( budget_mip_level( bytes, 1 << 20, 99 ) == 0 );
+	REQUIRE( budget_mip_level( {}, 1 << 20, 99 ) == 0 );
+}
+
+TEST_CASE( "Wanted mip level", "[mip_streaming]" )
+{
+	// Levels 4 onwards are resident, and levels 1 to 3 were asked for.
+	REQUIRE( wanted_mip_level( 3, 4, 1 ) );
+	REQUIRE( wanted_mip_level( 1, 4, 1 ) );
+	REQUIRE( !wanted_mip_level( 0, 4, 1 ) );
+
+	// Resident levels are stale.
+	REQUIRE( !wanted_mip_level( 4, 4, 1 ) );
+	REQUIRE( !wanted_mip_level( 5, 4, 1 ) );
+
+	// The camera moved away and the target became level 3 while level 2 was
+	// being loaded: level 2 is dropped when it arrives, not uploaded.
+	REQUIRE( wanted_mip_level( 3, 4, 3 ) );
+	REQUIRE( !wanted_mip_level( 2, 4, 3 ) );
+	REQUIRE( !wanted_mip_level( 1, 4, 3 ) );
+
+	// Once the camera comes back, a level loaded again is wanted.
+	REQUIRE( wanted_mip_level( 2, 4, 1 ) );
+
+	// Nothing is wanted when everything up to the target is resident.
+	REQUIRE( !wanted_mip_level( 3, 3, 3 ) );
+	REQUIRE( !wanted_mip_level( 0, 0, 0 ) );
+}
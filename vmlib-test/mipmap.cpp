@@ -0,0 +1,50 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <vector>
+
+#include "../vmlib/mipmap.hpp"
+
+TEST_CASE( "Mip level count and sizes", "[mipmap]" )
+{
+	REQUIRE( mip_level_count( 1, 1 ) == 1 );
+	REQUIRE( mip_level_count( 4096, 4096 ) == 13 );
+	REQUIRE( mip_level_count( 5, 3 ) == 3 );
+	REQUIRE( mip_level_count( 1, 8 ) == 4 );
+
+	std::vector<std::uint8_t> const pixels( 5 * 3 * 4, 200 );
+	auto const levels = build_srgba8_mips( pixels, 5, 3 );
+	REQUIRE( levels.size() == 3 );
+	REQUIRE( levels[0] == pixels );
+	REQUIRE( levels[1].size() == 2 * 1 * 4 );
+	REQUIRE( levels[2].size() == 1 * 1 * 4 );
+
+	// A uniform image stays uniform.
+	for( auto const& level : levels )
+	{
+		for( auto const value : level )
+			REQUIRE( value == 200 );
+	}
+}
+
+TEST_CASE( "sRGB-correct downsampling", "[mipmap]" )
+{
+	// Black and white, half transparent: colour is averaged in linear space
+	// (0.5 linear is 188 in sRGB, not 128), alpha as it is.
+	std::vector<std::uint8_t> const pixels{
+		  0,   0,   0,   0,    255, 255, 255, 255,
+		255, 255, 255, 255,      0,   0,   0,   0
+	};
+
+	auto const half = downsample_srgba8( pixels, 2, 2 );
+	REQUIRE( half.size() == 4 );
+	for( std::size_t c = 0; c < 3; ++c )
+		REQUIRE( half[c] == 188 );
+	REQUIRE( half[3] == 128 );
+
+	// A single row: only the columns are halved.
+	std::vector<std::uint8_t> const row{
+		255, 0, 0, 255,    255, 0, 0, 255,    0, 0, 255, 255,    0, 0, 255, 255
+	};
+	auto const narrow = downsample_srgba8( row, 4, 1 );
+	REQUIRE( narrow == std::vector<std::uint8_t>{ 255, 0, 0, 255, 0, 0, 255, 255 } );
+}
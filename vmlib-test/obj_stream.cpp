@@ -0,0 +1,102 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <string>
+#include <vector>
+#include <string_view>
+
+#include "../vmlib/obj_stream.hpp"
+
+namespace
+{
+	// A quad and a triangle, with a bit of everything the parser has to skip
+	// or resolve.
+	constexpr std::string_view kObj_ =
+		"# test\n"
+		"mtllib test.mtl\n"
+		"o quad\n"
+		"v 0 0 0\n"
+		"v 1 0 0\r\n"
+		"v 1 0 1 0.5 0.5 0.5\n"
+		"v 0 0 +1\n"
+		"vt 0 0\n"
+		"vt 1\n"
+		"vt 1 1 0\n"
+		"vn 0 1 0\n"
+		"usemtl grey\n"
+		"s off\n"
+		"f 1/1/1 2/2/1 3/3/1 4//1\n"
+		"f -3 -2 -1\n"
+		"f 1/3 2/2 3/1"
+	;
+
+	bool same_( ObjCorner const& aA, ObjCorner const& aB )
+	{
+		return aA.position == aB.position && aA.texCoord == aB.texCoord && aA.normal == aB.normal;
+	}
+}
+
+TEST_CASE( "Streaming OBJ parsing", "[obj]" )
+{
+	// The result must not depend on how the file is split.
+	std::size_t const pieceSize = GENERATE( 1, 2, 7, 64, 4096 );
+
+	ObjStreamParser parser;
+	std::vector<ObjCorner> triangles;
+	for( std::size_t i = 0; i < kObj_.size(); i += pieceSize )
+	{
+		auto const piece = kObj_.substr( i, pieceSize );
+		parser.feed( std::span( piece.data(), piece.size() ) );
+		triangles.insert( triangles.end(), parser.triangles().begin(), parser.triangles().end() );
+		parser.clear_triangles();
+	}
+	parser.finish();
+	triangles.insert( triangles.end(), parser.triangles().begin(), parser.triangles().end() );
+
+	REQUIRE( !parser.failed() );
+	REQUIRE( parser.line() == 16 );
+
+	REQUIRE( parser.positions().size() == 4 );
+	REQUIRE( parser.positions()[2].x == 1.f );
+	REQUIRE( parser.positions()[2].z == 1.f );
+	REQUIRE( parser.positions()[3].z == 1.f );
+	REQUIRE( parser.normals().size() == 1 );
+	REQUIRE( parser.texCoords().size() == 3 );
+	REQUIRE( parser.texCoords()[1].x == 1.f );
+	REQUIRE( parser.texCoords()[1].y == 0.f );
+
+	// The quad is fanned into two triangles.
+	std::vector<ObjCorner> const expected{
+		{ 0, 0, 0 }, { 1, 1, 0 }, { 2, 2, 0 },
+		{ 0, 0, 0 }, { 2, 2, 0 }, { 3, kObjNoIndex, 0 },
+		{ 1, kObjNoIndex, kObjNoIndex }, { 2, kObjNoIndex, kObjNoIndex }, { 3, kObjNoIndex, kObjNoIndex },
+		{ 0, 2, kObjNoIndex }, { 1, 1, kObjNoIndex }, { 2, 0, kObjNoIndex }
+	};
+	REQUIRE( triangles.size() == expected.size() );
+	for( std::size_t i = 0; i < expected.size(); ++i )
+		REQUIRE( same_( triangles[i], expected[i] ) );
+}
+
+TEST_CASE( "Streaming OBJ errors", "[obj]" )
+{
+	auto const parse = [] ( std::string_view aText ) {
+		ObjStreamParser parser;
+		parser.feed( std::span( aText.data(), aText.size() ) );
+		parser.finish();
+		return parser;
+	};
+
+	REQUIRE( !parse( "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n" ).failed() );
+
+	// Faces may only refer to earlier vertices.
+	auto const forward = parse( "v 0 0 0\nv 1 0 0\nf 1 2 3\nv 0 1 0\n" );
+	REQUIRE( forward.failed() );
+	REQUIRE( forward.line() == 3 );
+
+	REQUIRE( parse( "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 0 1 2\n" ).failed() );
+	REQUIRE( parse( "v 0 0 0\nv 1 0 0\nv 0 1 0\nf -4 1 2\n" ).failed() );
+	REQUIRE( parse( "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2\n" ).failed() );
+	REQUIRE( parse( "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1/1 2/1 3/1\n" ).failed() );
+	REQUIRE( parse( "v 0 0\n" ).failed() );
+	REQUIRE( parse( "v 0 0 x\n" ).failed() );
+	REQUIRE( parse( "vt 0 y\n" ).failed() );
+}
@@ -0,0 +1,165 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+
+#include "../support/parallel.hpp"
+
+namespace
+{
+	struct Range_
+	{
+		std::size_t begin, end, index;
+
+		bool operator== (Range_ const&) const = default;
+	};
+
+	// The ranges that parallel_ranges() calls its body with, sorted by index.
+	std::vector<Range_> ranges_( std::size_t aCount, std::size_t aThreadCount )
+	{
+		std::mutex mutex;
+		std::vector<Range_> ret;
+		parallel_ranges( aCount, aThreadCount, [&] ( std::size_t aBegin, std::size_t aEnd, std::size_t aRange ) {
+			std::scoped_lock const lock( mutex );
+			ret.emplace_back( Range_{ aBegin, aEnd, aRange } );
+		} );
+
+		std::sort( ret.begin(), ret.end(), [] ( Range_ const& aA, Range_ const& aB ) { return aA.index < aB.index; } );
+		return ret;
+	}
+}
+
+TEST_CASE( "Parallel ranges", "[parallel]" )
+{
+	SECTION( "Empty" )
+	{
+		REQUIRE( ranges_( 0, 1 ).empty() );
+		REQUIRE( ranges_( 0, 8 ).empty() );
+	}
+
+	SECTION( "One thread" )
+	{
+		REQUIRE( ranges_( 10, 1 ) == std::vector<Range_>{ { 0, 10, 0 } } );
+
+		// No threads means one.
+		REQUIRE( ranges_( 10, 0 ) == std::vector<Range_>{ { 0, 10, 0 } } );
+	}
+
+	SECTION( "Fewer items than threads" )
+	{
+		// One item per range; no empty ranges.
+		REQUIRE( ranges_( 3, 8 ) == std::vector<Range_>{ { 0, 1, 0 }, { 1, 2, 1 }, { 2, 3, 2 } } );
+		REQUIRE( ranges_( 1, 8 ) == std::vector<Range_>{ { 0, 1, 0 } } );
+	}
+
+	SECTION( "Remainders" )
+	{
+		// The first count % threads ranges take one more item.
+		REQUIRE( ranges_( 10, 4 ) == std::vector<Range_>{ { 0, 3, 0 }, { 3, 6, 1 }, { 6, 8, 2 }, { 8, 10, 3 } } );
+		REQUIRE( ranges_( 8, 4 ) == std::vector<Range_>{ { 0, 2, 0 }, { 2, 4, 1 }, { 4, 6, 2 }, { 6, 8, 3 } } );
+	}
+
+	SECTION( "Coverage" )
+	{
+		// Contiguous, in order, and covering everything exactly once.
+		for( std::size_t count : { 1, 2, 7, 64, 1000, 1001 } )
+		{
+			for( std::size_t threads : { 1, 2, 3, 7, 16 } )
+			{
+				auto const ranges = ranges_( count, threads );
+				REQUIRE( ranges.size() == std::min( count, threads ) );
+
+				std::size_t next = 0;
+				for( std::size_t i = 0; i < ranges.size(); ++i )
+				{
+					REQUIRE( ranges[i].index == i );
+					REQUIRE( ranges[i].begin == next );
+					REQUIRE( ranges[i].end > ranges[i].begin );
+					next = ranges[i].end;
+				}
+				REQUIRE( next == count );
+
+				auto const [smallest, largest] = std::minmax_element( ranges.begin(), ranges.end(), [] ( Range_ const& aA, Range_ const& aB ) {
+					return aA.end - aA.begin < aB.end - aB.begin;
+				} );
+				REQUIRE( (largest->end - largest->begin) - (smallest->end - smallest->begin) <= 1 );
+			}
+		}
+	}
+
+	SECTION( "The first range runs on the calling thread" )
+	{
+		auto const caller = std::this_thread::get_id();
+		std::vector<std::thread::id> threads( 4 );
+		parallel_ranges( 4, 4, [&] ( std::size_t, std::size_t, std::size_t aRange ) {
+			threads[aRange] = std::this_thread::get_id();
+		} );
+
+		REQUIRE( threads[0] == caller );
+		for( std::size_t i = 1; i < threads.size(); ++i )
+			REQUIRE( threads[i] != caller );
+	}
+}
+
+TEST_CASE( "Parallel ranges with exceptions", "[parallel]" )
+{
+	SECTION( "From a worker" )
+	{
+		std::atomic<std::size_t> finished{ 0 };
+		auto const run = [&] {
+			parallel_ranges( 40, 4, [&] ( std::size_t, std::size_t, std::size_t aRange ) {
+				if( 2 == aRange )
+					throw std::runtime_error( "range 2" );
+				++finished;
+			} );
+		};
+
+		REQUIRE_THROWS_WITH( run(), "range 2" );
+
+		// The other ranges ran to completion before the rethrow.
+		REQUIRE( finished == 3 );
+	}
+
+	SECTION( "The lowest-numbered failing range wins" )
+	{
+		auto const run = [] {
+			parallel_ranges( 40, 4, [] ( std::size_t, std::size_t, std::size_t aRange ) {
+				if( aRange >= 1 )
+					throw std::runtime_error( "range " + std::to_string( aRange ) );
+			} );
+		};
+
+		REQUIRE_THROWS_WITH( run(), "range 1" );
+	}
+
+	SECTION( "From the calling thread" )
+	{
+		std::atomic<std::size_t> finished{ 0 };
+		auto const run = [&] {
+			parallel_ranges( 40, 4, [&] ( std::size_t, std::size_t, std::size_t aRange ) {
+				if( 0 == aRange )
+					throw std::logic_error( "range 0" );
+				++finished;
+			} );
+		};
+
+		REQUIRE_THROWS_AS( run(), std::logic_error );
+		REQUIRE( finished == 3 );
+	}
+
+	SECTION( "On a single thread" )
+	{
+		auto const run = [] {
+			parallel_ranges( 5, 1, [] ( std::size_t, std::size_t, std::size_t ) {
+				throw std::runtime_error( "only range" );
+			} );
+		};
+
+		REQUIRE_THROWS_WITH( run(), "only range" );
+	}
+}
@@ -0,0 +1,180 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../vmlib/quantize.hpp"
+
+namespace
+{
+	constexpr std::size_t kCount_ = 1003;
+
+	Vec3f random_unit_( std::mt19937& aRng )
+	{
+		std::normal_distribution<float> dist( 0.f, 1.f );
+		return normalize( Vec3f{ dist( aRng ), dist( aRng ), dist( aRng ) } );
+	}
+}
+
+TEST_CASE( "Normalized integers", "[quantize]" )
+{
+	REQUIRE( quantize_unorm16( 0.f ) == 0 );
+	REQUIRE( quantize_unorm16( 1.f ) == 65535 );
+	REQUIRE( quantize_unorm16( -3.f ) == 0 );
+	REQUIRE( quantize_unorm16( 2.f ) == 65535 );
+	REQUIRE( dequantize_unorm16( quantize_unorm16( 0.5f ) ) == Catch::Approx( 0.5f ).margin( 1e-5f ) );
+
+	REQUIRE( quantize_unorm8( 1.f ) == 255 );
+	REQUIRE( quantize_unorm8( 0.5f ) == 128 );
+	REQUIRE( dequantize_unorm8( 255 ) == 1.f );
+
+	REQUIRE( quantize_snorm16( -1.f ) == -32767 );
+	REQUIRE( quantize_snorm16( 1.f ) == 32767 );
+	REQUIRE( quantize_snorm16( 0.f ) == 0 );
+	REQUIRE( dequantize_snorm16( -32768 ) == -1.f );
+	REQUIRE( dequantize_snorm16( -32767 ) == -1.f );
+	REQUIRE( dequantize_snorm16( 32767 ) == 1.f );
+}
+
+TEST_CASE( "Position quantization", "[quantize]" )
+{
+	Aabb3f const bounds{ { -100.f, 2.f, 0.f }, { 300.f, 2.f, 50.f } };
+	auto const q = make_position_quantization( bounds );
+
+	// The flat axis keeps its value exactly.
+	REQUIRE( q.scale.y == 1.f );
+
+	auto const corner = dequantize_position( q, quantize_position( q, bounds.max ) );
+	REQUIRE( corner.x == Catch::Approx( 300.f ) );
+	REQUIRE( corner.y == 2.f );
+	REQUIRE( corner.z == Catch::Approx( 50.f ) );
+
+	std::mt19937 rng( 42 );
+	std::uniform_real_distribution<float> ux( -100.f, 300.f ), uz( 0.f, 50.f );
+	for( std::size_t i = 0; i < kCount_; ++i )
+	{
+		Vec3f const p{ ux( rng ), 2.f, uz( rng ) };
+		auto const r = dequantize_position( q, quantize_position( q, p ) );
+
+		// Error is at most half a step of extent / 65535.
+		REQUIRE( std::abs( r.x - p.x ) <= 0.5f * 400.f / 65535.f + 1e-4f );
+		REQUIRE( std::abs( r.z - p.z ) <= 0.5f * 50.f / 65535.f + 1e-5f );
+	}
+}
+
+TEST_CASE( "Octahedral normals", "[quantize]" )
+{
+	SECTION( "Axes" )
+	{
+		for( auto const n : { Vec3f{ 1.f, 0.f, 0.f }, Vec3f{ -1.f, 0.f, 0.f }, Vec3f{ 0.f, 1.f, 0.f }, Vec3f{ 0.f, -1.f, 0.f }, Vec3f{ 0.f, 0.f, 1.f }, Vec3f{ 0.f, 0.f, -1.f } } )
+		{
+			auto const r = dequantize_normal( quantize_normal( n ) );
+			REQUIRE( r.x == Catch::Approx( n.x ).margin( 1e-6f ) );
+			REQUIRE( r.y == Catch::Approx( n.y ).margin( 1e-6f ) );
+			REQUIRE( r.z == Catch::Approx( n.z ).margin( 1e-6f ) );
+		}
+	}
+
+	SECTION( "Random" )
+	{
+		std::mt19937 rng( 7 );
+		float maxAngle = 0.f;
+		for( std::size_t i = 0; i < kCount_; ++i )
+		{
+			auto const n = random_unit_( rng );
+
+			// Exact encoding round-trips to within float precision.
+			auto const e = decode_octahedral( encode_octahedral( n ) );
+			REQUIRE( dot( e, n ) == Catch::Approx( 1.f ).margin( 1e-6f ) );
+
+			auto const r = dequantize_normal( quantize_normal( n ) );
+			REQUIRE( length( r ) == Catch::Approx( 1.f ) );
+
+			// acos() of the dot product is too imprecise for small angles.
+			Vec3f const c{ r.y*n.z - r.z*n.y, r.z*n.x - r.x*n.z, r.x*n.y - r.y*n.x };
+			maxAngle = std::max( maxAngle, std::atan2( length( c ), dot( r, n ) ) );
+		}
+
+		// 2x16 bits: well below a hundredth of a degree.
+		REQUIRE( maxAngle < 1e-4f );
+	}
+}
+
+TEST_CASE( "Half floats", "[quantize]" )
+{
+	REQUIRE( float_to_half( 0.f ) == 0x0000 );
+	REQUIRE( float_to_half( -0.f ) == 0x8000 );
+	REQUIRE( float_to_half( 1.f ) == 0x3c00 );
+	REQUIRE( float_to_half( -2.f ) == 0xc000 );
+	REQUIRE( float_to_half( 65504.f ) == 0x7bff );
+	REQUIRE( float_to_half( 1e6f ) == 0x7c00 );
+	REQUIRE( float_to_half( std::numeric_limits<float>::infinity() ) == 0x7c00 );
+	REQUIRE( float_to_half( 1e-8f ) == 0 );
+	REQUIRE( std::isnan( half_to_float( float_to_half( std::numeric_limits<float>::quiet_NaN() ) ) ) );
+
+	REQUIRE( half_to_float( 0x3c00 ) == 1.f );
+	REQUIRE( half_to_float( 0x3555 ) == Catch::Approx( 1.f / 3.f ).epsilon( 1e-3f ) );
+	REQUIRE( half_to_float( 0x0001 ) == std::ldexp( 1.f, -24 ) );
+	REQUIRE( half_to_float( 0x7c00 ) == std::numeric_limits<float>::infinity() );
+	REQUIRE( half_to_float( 0xfc00 ) == -std::numeric_limits<float>::infinity() );
+
+	// Every normal half survives a round trip.
+	for( std::uint32_t h = 0x0400; h < 0x7c00; ++h )
+	{
+		REQUIRE( float_to_half( half_to_float( std::uint16_t(h) ) ) == h );
+		REQUIRE( float_to_half( -half_to_float( std::uint16_t(h) ) ) == (h | 0x8000) );
+	}
+
+	// Relative error of at most 2^-11 in the normal range.
+	std::mt19937 rng( 3 );
+	std::uniform_real_distribution<float> dist( 0.f, 1.f );
+	for( std::size_t i = 0; i < kCount_; ++i )
+	{
+		float const x = dist( rng );
+		if( x < std::ldexp( 1.f, -14 ) )
+			continue;
+
+		REQUIRE( std::abs( half_to_float( float_to_half( x ) ) - x ) <= x * std::ldexp( 1.f, -11 ) );
+	}
+}
+
+// Benchmarks (hidden by default; run with "[benchmark]").
+TEST_CASE( "Vertex attribute encoding", "[.][benchmark][quantize]" )
+{
+	constexpr std::size_t kN = 1 << 20;
+
+	std::mt19937 rng( 1 );
+	std::vector<Vec3f> normals( kN );
+	for( auto& n : normals )
+		n = random_unit_( rng );
+
+	std::vector<std::array<std::int16_t,2>> packed( kN );
+	BENCHMARK( "quantize_normal (1M)" )
+	{
+		for( std::size_t i = 0; i < kN; ++i )
+			packed[i] = quantize_normal( normals[i] );
+		return packed.back()[0];
+	};
+
+	auto const q = make_position_quantization( Aabb3f{ { -1.f, -1.f, -1.f }, { 1.f, 1.f, 1.f } } );
+	std::vector<std::array<std::uint16_t,3>> positions( kN );
+	BENCHMARK( "quantize_position (1M)" )
+	{
+		for( std::size_t i = 0; i < kN; ++i )
+			positions[i] = quantize_position( q, normals[i] );
+		return positions.back()[0];
+	};
+
+	std::vector<std::uint16_t> halves( 2*kN );
+	BENCHMARK( "float_to_half (2M)" )
+	{
+		for( std::size_t i = 0; i < kN; ++i )
+		{
+			halves[2*i+0] = float_to_half( normals[i].x );
+			halves[2*i+1] = float_to_half( normals[i].y );
+		}
+		return halves.back();
+	};
+}
@@ -0,0 +1,270 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "../vmlib/quat.hpp"
+
+namespace
+{
+	// Not a multiple of eight, so that the scalar tail is exercised too.
+	constexpr std::size_t kCount_ = 1003;
+
+	Quatf random_quat_( std::mt19937& aRng )
+	{
+		std::normal_distribution<float> dist( 0.f, 1.f );
+		return normalize( Quatf{ dist( aRng ), dist( aRng ), dist( aRng ), dist( aRng ) } );
+	}
+	Vec3f random_unit_( std::mt19937& aRng )
+	{
+		std::normal_distribution<float> dist( 0.f, 1.f );
+		return normalize( Vec3f{ dist( aRng ), dist( aRng ), dist( aRng ) } );
+	}
+
+	void require_near_( Vec3f aA, Vec3f aB, float aTolerance )
+	{
+		using Catch::Matchers::WithinAbs;
+		REQUIRE_THAT( aA.x, WithinAbs( aB.x, aTolerance ) );
+		REQUIRE_THAT( aA.y, WithinAbs( aB.y, aTolerance ) );
+		REQUIRE_THAT( aA.z, WithinAbs( aB.z, aTolerance ) );
+	}
+	// q and -q are the same rotation.
+	void require_same_rotation_( Quatf const& aA, Quatf const& aB, float aTolerance )
+	{
+		REQUIRE_THAT( std::abs( dot( aA, aB ) ), Catch::Matchers::WithinAbs( 1.f, aTolerance ) );
+	}
+	void require_near_( Quatf const& aA, Quatf const& aB, float aTolerance )
+	{
+		using Catch::Matchers::WithinAbs;
+		REQUIRE_THAT( aA.x, WithinAbs( aB.x, aTolerance ) );
+		REQUIRE_THAT( aA.y, WithinAbs( aB.y, aTolerance ) );
+		REQUIRE_THAT( aA.z, WithinAbs( aB.z, aTolerance ) );
+		REQUIRE_THAT( aA.w, WithinAbs( aB.w, aTolerance ) );
+	}
+}
+
+TEST_CASE( "Quatf matches the matrix rotations", "[quat]" )
+{
+	using Catch::Matchers::WithinAbs;
+
+	SECTION( "Axis rotations" )
+	{
+		float const angle = 0.7f;
+		auto const rx = to_mat33( make_quat_axis_angle( { 1.f, 0.f, 0.f }, angle ) );
+		auto const ry = to_mat33( make_quat_axis_angle( { 0.f, 1.f, 0.f }, angle ) );
+		auto const rz = to_mat33( make_quat_axis_angle( { 0.f, 0.f, 1.f }, angle ) );
+
+		auto const mx = make_rotation_x( angle );
+		auto const my = make_rotation_y( angle );
+		auto const mz = make_rotation_z( angle );
+		for( std::size_t i = 0; i < 3; ++i )
+		{
+			for( std::size_t j = 0; j < 3; ++j )
+			{
+				REQUIRE_THAT( (rx[i,j]), WithinAbs( (mx[i,j]), 1e-6f ) );
+				REQUIRE_THAT( (ry[i,j]), WithinAbs( (my[i,j]), 1e-6f ) );
+				REQUIRE_THAT( (rz[i,j]), WithinAbs( (mz[i,j]), 1e-6f ) );
+			}
+		}
+	}
+
+	SECTION( "Products compose like matrices" )
+	{
+		std::mt19937 rng( 801 );
+		for( std::size_t i = 0; i < 64; ++i )
+		{
+			auto const a = random_quat_( rng );
+			auto const b = random_quat_( rng );
+			auto const v = random_unit_( rng );
+
+			require_near_( rotate( a * b, v ), rotate( a, rotate( b, v ) ), 1e-5f );
+			require_near_( to_mat33( a * b ) * v, to_mat33( a ) * (to_mat33( b ) * v), 1e-5f );
+			require_near_( rotate( a, v ), to_mat33( a ) * v, 1e-5f );
+			require_near_( rotate( conjugate( a ), rotate( a, v ) ), v, 1e-5f );
+		}
+	}
+
+	SECTION( "make_rigid() rotates, then translates" )
+	{
+		auto const q = make_quat_axis_angle( normalize( Vec3f{ 1.f, 2.f, -1.f } ), 1.3f );
+		Vec3f const t{ 4.f, -2.f, 7.f };
+		Vec3f const p{ 0.5f, 1.f, -3.f };
+
+		require_near_( transform_point( make_rigid( q, t ), p ), rotate( q, p ) + t, 1e-5f );
+	}
+}
+
+TEST_CASE( "make_quat_from_to() takes one vector onto the other", "[quat]" )
+{
+	std::mt19937 rng( 802 );
+
+	SECTION( "Random" )
+	{
+		for( std::size_t i = 0; i < 64; ++i )
+		{
+			auto const from = random_unit_( rng );
+			auto const to = random_unit_( rng );
+			auto const q = make_quat_from_to( from, to );
+
+			REQUIRE_THAT( length( q ), Catch::Matchers::WithinAbs( 1.f, 1e-6f ) );
+			require_near_( rotate( q, from ), to, 1e-5f );
+
+			// Shortest rotation: the axis is perpendicular to both vectors.
+			REQUIRE_THAT( dot( Vec3f{ q.x, q.y, q.z }, from ), Catch::Matchers::WithinAbs( 0.f, 1e-5f ) );
+		}
+	}
+
+	SECTION( "Same and opposite vectors" )
+	{
+		Vec3f const up{ 0.f, 1.f, 0.f };
+		require_same_rotation_( make_quat_from_to( up, up ), kIdentityQuatf, 1e-6f );
+		require_near_( rotate( make_quat_from_to( up, -up ), up ), -up, 1e-6f );
+
+		Vec3f const x{ 1.f, 0.f, 0.f };
+		require_near_( rotate( make_quat_from_to( x, -x ), x ), -x, 1e-6f );
+	}
+}
+
+TEST_CASE( "slerp() and nlerp() interpolate rotations", "[quat]" )
+{
+	using Catch::Matchers::WithinAbs;
+
+	Vec3f const axis = normalize( Vec3f{ 0.f, 1.f, 1.f } );
+	auto const a = make_quat_axis_angle( axis, 0.2f );
+	auto const b = make_quat_axis_angle( axis, 2.6f );
+
+	SECTION( "End points" )
+	{
+		require_same_rotation_( slerp( a, b, 0.f ), a, 1e-6f );
+		require_same_rotation_( slerp( a, b, 1.f ), b, 1e-6f );
+		require_same_rotation_( nlerp( a, b, 0.f ), a, 1e-6f );
+		require_same_rotation_( nlerp( a, b, 1.f ), b, 1e-6f );
+	}
+
+	SECTION( "slerp() has constant angular speed" )
+	{
+		for( float t = 0.f; t <= 1.f; t += 0.125f )
+			require_same_rotation_( slerp( a, b, t ), make_quat_axis_angle( axis, 0.2f + t * 2.4f ), 1e-6f );
+	}
+
+	SECTION( "nlerp() follows the same path" )
+	{
+		auto const q = nlerp( a, b, 0.25f );
+		REQUIRE_THAT( length( q ), WithinAbs( 1.f, 1e-6f ) );
+		REQUIRE_THAT( dot( Vec3f{ q.x, q.y, q.z }, axis ), WithinAbs( length( Vec3f{ q.x, q.y, q.z } ), 1e-6f ) );
+		require_same_rotation_( nlerp( a, b, 0.5f ), slerp( a, b, 0.5f ), 1e-6f );
+	}
+
+	SECTION( "Shorter path" )
+	{
+		require_same_rotation_( slerp( a, -b, 0.5f ), slerp( a, b, 0.5f ), 1e-6f );
+		require_same_rotation_( nlerp( a, -b, 0.5f ), nlerp( a, b, 0.5f ), 1e-6f );
+	}
+
+	SECTION( "Nearly identical inputs" )
+	{
+		auto const c = make_quat_axis_angle( axis, 0.2f + 1e-4f );
+		require_same_rotation_( slerp( a, c, 0.5f ), make_quat_axis_angle( axis, 0.2f + 0.5e-4f ), 1e-6f );
+	}
+}
+
+TEST_CASE( "Batch interpolation matches slerp() and nlerp()", "[quat][soa]" )
+{
+	std::mt19937 rng( 803 );
+	std::uniform_real_distribution<float> param( 0.f, 1.f );
+
+	std::vector<Quatf> from( kCount_ ), to( kCount_ ), out( kCount_ );
+	std::vector<float> t( kCount_ );
+	for( std::size_t i = 0; i < kCount_; ++i )
+	{
+		from[i] = random_quat_( rng );
+		t[i] = param( rng );
+
+		// Every fourth pair is nearly identical, for the nlerp fallback.
+		to[i] = (i % 4 == 3) ? normalize( from[i] + Quatf{ 1e-3f, 0.f, -1e-3f, 0.f } ) : random_quat_( rng );
+	}
+
+	SECTION( "nlerp" )
+	{
+		batch_nlerp( from, to, t, out );
+		for( std::size_t i = 0; i < kCount_; ++i )
+			require_near_( out[i], nlerp( from[i], to[i], t[i] ), 2e-6f );
+	}
+
+	SECTION( "slerp" )
+	{
+		batch_slerp( from, to, t, out );
+		for( std::size_t i = 0; i < kCount_; ++i )
+			require_near_( out[i], slerp( from[i], to[i], t[i] ), 2e-6f );
+	}
+
+	SECTION( "In place" )
+	{
+		auto expected = from;
+		for( std::size_t i = 0; i < kCount_; ++i )
+			expected[i] = slerp( from[i], to[i], t[i] );
+
+		batch_slerp( from, to, t, from );
+		for( std::size_t i = 0; i < kCount_; ++i )
+			require_near_( from[i], expected[i], 2e-6f );
+	}
+
+	SECTION( "make_rigid" )
+	{
+		std::vector<Vec3f> offsets( kCount_ );
+		for( auto& o : offsets )
+			o = 10.f * random_unit_( rng );
+
+		std::vector<Mat34f> models( kCount_ );
+		batch_make_rigid( from, offsets, models );
+		for( std::size_t i = 0; i < kCount_; ++i )
+		{
+			auto const expected = make_rigid( from[i], offsets[i] );
+			for( std::size_t j = 0; j < 12; ++j )
+				REQUIRE( models[i].v[j] == expected.v[j] );
+		}
+	}
+}
+
+// Benchmarks (hidden by default; run with "[benchmark]").
+TEST_CASE( "Interpolating 100k orientations: single vs batch " VMLIB_SIMD_NAME, "[.][benchmark][quat]" )
+{
+	constexpr std::size_t kBenchCount = 100'000;
+
+	std::mt19937 rng( 804 );
+	std::uniform_real_distribution<float> param( 0.f, 1.f );
+
+	std::vector<Quatf> from( kBenchCount ), to( kBenchCount ), out( kBenchCount );
+	std::vector<float> t( kBenchCount );
+	for( std::size_t i = 0; i < kBenchCount; ++i )
+	{
+		from[i] = random_quat_( rng );
+		to[i] = random_quat_( rng );
+		t[i] = param( rng );
+	}
+
+	BENCHMARK( "slerp (per quaternion)" )
+	{
+		for( std::size_t i = 0; i < kBenchCount; ++i )
+			out[i] = slerp( from[i], to[i], t[i] );
+		return out[0].w;
+	};
+	BENCHMARK( "slerp (batch)" )
+	{
+		batch_slerp( from, to, t, out );
+		return out[0].w;
+	};
+
+	BENCHMARK( "nlerp (per quaternion)" )
+	{
+		for( std::size_t i = 0; i < kBenchCount; ++i )
+			out[i] = nlerp( from[i], to[i], t[i] );
+		return out[0].w;
+	};
+	BENCHMARK( "nlerp (batch)" )
+	{
+		batch_nlerp( from, to, t, out );
+		return out[0].w;
+	};
+}
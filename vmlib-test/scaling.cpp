@@ -0,0 +1,40 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include "../vmlib/mat44.hpp"
+
+TEST_CASE( "Scaling matrix scales along each axis", "[mat44][scaling]" )
+{
+	using Catch::Matchers::WithinAbs;
+	static constexpr float kEps = 1e-6f;
+
+	auto const scaling = make_scaling( 2.f, -0.5f, 3.f );
+
+	SECTION( "Points are scaled about the origin" )
+	{
+		Vec4f point{ 1.f, 2.f, 3.f, 1.f };
+		auto const result = scaling * point;
+
+		REQUIRE_THAT( result.x, WithinAbs( 2.f, kEps ) );
+		REQUIRE_THAT( result.y, WithinAbs( -1.f, kEps ) );
+		REQUIRE_THAT( result.z, WithinAbs( 9.f, kEps ) );
+		REQUIRE_THAT( result.w, WithinAbs( 1.f, kEps ) );
+	}
+
+	SECTION( "Direction vectors are scaled too" )
+	{
+		Vec4f direction{ -3.f, 0.5f, 2.f, 0.f };
+		auto const result = scaling * direction;
+
+		REQUIRE_THAT( result.x, WithinAbs( -6.f, kEps ) );
+		REQUIRE_THAT( result.y, WithinAbs( -0.25f, kEps ) );
+		REQUIRE_THAT( result.z, WithinAbs( 6.f, kEps ) );
+		REQUIRE_THAT( result.w, WithinAbs( 0.f, kEps ) );
+	}
+
+	SECTION( "Unit scaling is the identity" )
+	{
+		auto const identity = make_scaling( 1.f, 1.f, 1.f );
+		for( std::size_t i = 0; i < 16; ++i )
+			REQUIRE( identity.v[i] == kIdentity44f.v[i] );
+	}
+}
@@ -0,0 +1,207 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <set>
+#include <array>
+#include <cmath>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "../vmlib/simplify.hpp"
+
+#include "test_grid.hpp"
+
+namespace
+{
+	struct Mesh_
+	{
+		std::vector<Vec3f> positions;
+		std::vector<std::uint32_t> materials;
+		std::vector<std::uint32_t> indices;
+	};
+
+	// Grid of aN x aN quads with heights from aHeight( x, z ) (see
+	// test_grid.hpp). Quads with x >= aSplit get material 1; the vertices
+	// on the line x = aSplit are duplicated for it.
+	template< class tHeight >
+	Mesh_ make_grid_( std::uint32_t aN, std::uint32_t aSplit, tHeight&& aHeight )
+	{
+		auto const grid = make_test_grid( aN, std::forward<tHeight>(aHeight) );
+		auto const count = static_cast<std::uint32_t>( grid.positions.size() );
+
+		// The vertices of material 1 follow those of material 0.
+		Mesh_ ret;
+		ret.positions.insert( ret.positions.end(), grid.positions.begin(), grid.positions.end() );
+		ret.positions.insert( ret.positions.end(), grid.positions.begin(), grid.positions.end() );
+		ret.materials.resize( count, 0 );
+		ret.materials.resize( 2 * count, 1 );
+
+		ret.indices = grid.indices;
+		for( std::size_t i = 0; i < ret.indices.size(); ++i )
+		{
+			std::size_t const quad = i / 6;
+			if( quad % aN >= aSplit )
+				ret.indices[i] += count;
+		}
+		return ret;
+	}
+
+	float area_( Mesh_ const& aMesh, std::span<std::uint32_t const> aIndices )
+	{
+		float ret = 0.f;
+		for( std::size_t i = 0; i < aIndices.size(); i += 3 )
+		{
+			Vec3f const a = aMesh.positions[aIndices[i]];
+			Vec3f const e0 = aMesh.positions[aIndices[i+1]] - a;
+			Vec3f const e1 = aMesh.positions[aIndices[i+2]] - a;
+			Vec3f const n{ e0.y*e1.z - e0.z*e1.y, e0.z*e1.x - e0.x*e1.z, e0.x*e1.y - e0.y*e1.x };
+			ret += 0.5f * length( n );
+		}
+		return ret;
+	}
+}
+
+TEST_CASE( "Simplifying a flat grid", "[simplify]" )
+{
+	auto const mesh = make_grid_( 32, 32, [] ( float, float ) { return 0.f; } );
+
+	auto const result = simplify_mesh( mesh.indices, mesh.positions, {}, {}, mesh.indices.size() / 20 );
+
+	// A plane can be simplified without error, and without changing its
+	// outline.
+	REQUIRE( result.indices.size() <= mesh.indices.size() / 20 );
+	REQUIRE( result.indices.size() % 3 == 0 );
+	REQUIRE( result.error < 1e-4f );
+	REQUIRE( area_( mesh, result.indices ) == Catch::Approx( 32.f * 32.f ) );
+
+	// Triangles keep their orientation (up, for this grid's winding).
+	for( std::size_t i = 0; i < result.indices.size(); i += 3 )
+	{
+		Vec3f const a = mesh.positions[result.indices[i]];
+		Vec3f const e0 = mesh.positions[result.indices[i+1]] - a;
+		Vec3f const e1 = mesh.positions[result.indices[i+2]] - a;
+		REQUIRE( e0.z * e1.x - e0.x * e1.z > 0.f );
+	}
+}
+
+TEST_CASE( "Simplifying a curved grid", "[simplify]" )
+{
+	auto const mesh = make_grid_( 48, 48, [] ( float aX, float aZ ) {
+		return 3.f * std::sin( 0.15f * aX ) * std::cos( 0.1f * aZ );
+	} );
+
+	std::vector<std::uint32_t> indices = mesh.indices;
+	std::array<float,3> const ratios{ 0.5f, 0.2f, 0.05f };
+	auto const lods = build_lod_chain( indices, mesh.positions, {}, {}, ratios );
+
+	REQUIRE( lods.size() == 4 );
+	REQUIRE( lods[0].firstIndex == 0 );
+	REQUIRE( lods[0].indexCount == mesh.indices.size() );
+	REQUIRE( lods[0].error == 0.f );
+	REQUIRE( std::equal( mesh.indices.begin(), mesh.indices.end(), indices.begin() ) );
+
+	for( std::size_t level = 1; level < lods.size(); ++level )
+	{
+		INFO( "level " << level );
+		auto const& lod = lods[level];
+
+		REQUIRE( lod.firstIndex == lods[level-1].firstIndex + lods[level-1].indexCount );
+		REQUIRE( lod.indexCount <= std::size_t(mesh.indices.size() * ratios[level-1]) + 3 );
+		REQUIRE( lod.indexCount < lods[level-1].indexCount );
+		REQUIRE( lod.error > 0.f );
+		REQUIRE( lod.error >= lods[level-1].error );
+
+		// The surface stays close to the original (amplitude 3).
+		REQUIRE( lod.error < 0.5f );
+
+		auto const levelIndices = std::span( indices ).subspan( lod.firstIndex, lod.indexCount );
+		for( auto const index : levelIndices )
+			REQUIRE( index < mesh.positions.size() );
+		REQUIRE( area_( mesh, levelIndices ) == Catch::Approx( area_( mesh, mesh.indices ) ).epsilon( 0.02 ) );
+	}
+	REQUIRE( indices.size() == lods.back().firstIndex + lods.back().indexCount );
+}
+
+TEST_CASE( "Simplification keeps material boundaries", "[simplify]" )
+{
+	auto const mesh = make_grid_( 32, 13, [] ( float aX, float aZ ) {
+		return 0.5f * std::sin( 0.3f * aX + 0.2f * aZ );
+	} );
+
+	auto const result = simplify_mesh( mesh.indices, mesh.positions, {}, mesh.materials, mesh.indices.size() / 10 );
+	REQUIRE( result.indices.size() < mesh.indices.size() / 2 );
+
+	// Triangles do not mix materials.
+	for( std::size_t i = 0; i < result.indices.size(); i += 3 )
+	{
+		REQUIRE( mesh.materials[result.indices[i]] == mesh.materials[result.indices[i+1]] );
+		REQUIRE( mesh.materials[result.indices[i]] == mesh.materials[result.indices[i+2]] );
+	}
+
+	// The edges along the boundary (x = 13) are all still there, on both
+	// sides.
+	std::set<std::pair<std::uint32_t,std::uint32_t>> boundary[2];
+	for( auto const* indices : { &mesh.indices, &result.indices } )
+	{
+		auto& edges = boundary[indices == &mesh.indices ? 0 : 1];
+		for( std::size_t i = 0; i < indices->size(); i += 3 )
+		{
+			for( std::size_t k = 0; k < 3; ++k )
+			{
+				auto const a = (*indices)[i+k], b = (*indices)[i + (k+1) % 3];
+				if( mesh.positions[a].x == 13.f && mesh.positions[b].x == 13.f )
+					edges.emplace( std::min( a, b ), std::max( a, b ) );
+			}
+		}
+	}
+	REQUIRE( boundary[0].size() == 2 * 32 );
+	REQUIRE( boundary[1] == boundary[0] );
+}
+
+TEST_CASE( "Simplification picks matching normals", "[simplify]" )
+{
+	// A roof: two slopes that meet at a hard edge (x = 8). The vertices on
+	// the ridge exist once per slope, with that slope's normal.
+	auto const mesh = make_grid_( 16, 8, [] ( float aX, float ) {
+		return 4.f - 0.5f * std::abs( aX - 8.f );
+	} );
+	std::size_t const half = mesh.positions.size() / 2;
+
+	Vec3f const left = normalize( Vec3f{ -0.5f, 1.f, 0.f } ), right = normalize( Vec3f{ 0.5f, 1.f, 0.f } );
+	std::vector<Vec3f> normals( mesh.positions.size() );
+	for( std::size_t v = 0; v < normals.size(); ++v )
+		normals[v] = v < half ? left : right;
+
+	// Same material: the ridge may be simplified (along itself).
+	auto const result = simplify_mesh( mesh.indices, mesh.positions, normals, {}, mesh.indices.size() / 10 );
+	REQUIRE( result.indices.size() <= mesh.indices.size() / 10 );
+	REQUIRE( result.error < 1e-4f );
+
+	// Each triangle uses the vertices of its own slope.
+	for( std::size_t i = 0; i < result.indices.size(); i += 3 )
+	{
+		Vec3f const a = mesh.positions[result.indices[i]];
+		Vec3f const e0 = mesh.positions[result.indices[i+1]] - a;
+		Vec3f const e1 = mesh.positions[result.indices[i+2]] - a;
+		Vec3f const n = normalize( Vec3f{ e0.y*e1.z - e0.z*e1.y, e0.z*e1.x - e0.x*e1.z, e0.x*e1.y - e0.y*e1.x } );
+
+		for( std::size_t k = 0; k < 3; ++k )
+			REQUIRE( dot( normals[result.indices[i+k]], n ) > 0.999f );
+	}
+}
+
+TEST_CASE( "Simplification stops when it cannot continue", "[simplify]" )
+{
+	// A tetrahedron cannot lose a triangle without becoming non-manifold.
+	std::vector<Vec3f> const positions{ { 0.f, 0.f, 0.f }, { 1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 0.f, 0.f, 1.f } };
+	std::vector<std::uint32_t> const indices{ 0, 2, 1,  0, 1, 3,  0, 3, 2,  1, 2, 3 };
+
+	auto const result = simplify_mesh( indices, positions, {}, {}, 0 );
+	REQUIRE( result.indices.size() == indices.size() );
+	REQUIRE( result.error == 0.f );
+
+	std::vector<std::uint32_t> chain = indices;
+	std::array<float,1> const ratios{ 0.5f };
+	REQUIRE( build_lod_chain( chain, positions, {}, {}, ratios ).size() == 1 );
+	REQUIRE( chain == indices );
+}
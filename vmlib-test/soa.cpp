@@ -0,0 +1,214 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <random>
+#include <vector>
+
+#include "../vmlib/soa.hpp"
+
+namespace
+{
+	// Not a multiple of eight, so that the scalar tail is exercised too.
+	constexpr std::size_t kCount_ = 1003;
+
+	std::vector<Vec3f> random_vecs_( std::size_t aCount, std::uint32_t aSeed )
+	{
+		std::mt19937 rng( aSeed );
+		std::uniform_real_distribution<float> dist( -50.f, 50.f );
+
+		std::vector<Vec3f> ret( aCount );
+		for( auto& v : ret )
+			v = Vec3f{ dist( rng ), dist( rng ), dist( rng ) };
+		return ret;
+	}
+
+	Mat44f test_transform_()
+	{
+		return make_translation( { 10.f, -4.f, 7.f } ) * make_rotation_y( 0.7f ) * make_rotation_x( -0.3f ) * make_scaling( 2.f, 0.5f, 3.f );
+	}
+}
+
+TEST_CASE( "Vec3fSoA round trips through AoS", "[soa]" )
+{
+	auto const vecs = random_vecs_( kCount_, 1 );
+	auto const soa = make_soa( vecs );
+	REQUIRE( soa.size() == kCount_ );
+
+	std::vector<Vec3f> back( kCount_ );
+	copy_to_aos( soa, back );
+	for( std::size_t i = 0; i < kCount_; ++i )
+	{
+		REQUIRE( back[i].x == vecs[i].x );
+		REQUIRE( back[i].y == vecs[i].y );
+		REQUIRE( back[i].z == vecs[i].z );
+	}
+}
+
+TEST_CASE( "Batch kernels match per-element results", "[soa]" )
+{
+	using Catch::Matchers::WithinAbs;
+	using Catch::Matchers::WithinRel;
+	static constexpr float kEps = 1e-4f;
+
+	auto const vecs = random_vecs_( kCount_, 2 );
+	auto const transform = test_transform_();
+
+	SECTION( "Transform points" )
+	{
+		Vec3fSoA out;
+		batch_transform_points( transform, make_soa( vecs ), out );
+		REQUIRE( out.size() == kCount_ );
+
+		for( std::size_t i = 0; i < kCount_; ++i )
+		{
+			auto const ref = transform * Vec4f{ vecs[i].x, vecs[i].y, vecs[i].z, 1.f };
+			auto const res = out.get( i );
+			REQUIRE_THAT( res.x, WithinRel( ref.x, kEps ) || WithinAbs( ref.x, kEps ) );
+			REQUIRE_THAT( res.y, WithinRel( ref.y, kEps ) || WithinAbs( ref.y, kEps ) );
+			REQUIRE_THAT( res.z, WithinRel( ref.z, kEps ) || WithinAbs( ref.z, kEps ) );
+		}
+	}
+
+	SECTION( "Transform directions in place" )
+	{
+		auto soa = make_soa( vecs );
+		batch_transform_directions( transform, soa, soa );
+
+		for( std::size_t i = 0; i < kCount_; ++i )
+		{
+			auto const ref = transform * Vec4f{ vecs[i].x, vecs[i].y, vecs[i].z, 0.f };
+			auto const res = soa.get( i );
+			REQUIRE_THAT( res.x, WithinRel( ref.x, kEps ) || WithinAbs( ref.x, kEps ) );
+			REQUIRE_THAT( res.y, WithinRel( ref.y, kEps ) || WithinAbs( ref.y, kEps ) );
+			REQUIRE_THAT( res.z, WithinRel( ref.z, kEps ) || WithinAbs( ref.z, kEps ) );
+		}
+	}
+
+	SECTION( "Bounds" )
+	{
+		Aabb3f ref = kEmptyAabb3f;
+		for( auto const& v : vecs )
+			expand( ref, v );
+
+		auto const bounds = batch_bounds( make_soa( vecs ) );
+		REQUIRE( bounds.min.x == ref.min.x );
+		REQUIRE( bounds.min.y == ref.min.y );
+		REQUIRE( bounds.min.z == ref.min.z );
+		REQUIRE( bounds.max.x == ref.max.x );
+		REQUIRE( bounds.max.y == ref.max.y );
+		REQUIRE( bounds.max.z == ref.max.z );
+
+		REQUIRE( is_empty( batch_bounds( Vec3fSoA{} ) ) );
+	}
+
+	SECTION( "Normalize" )
+	{
+		auto withZero = vecs;
+		withZero[5] = Vec3f{ 0.f, 0.f, 0.f };
+		withZero[kCount_-1] = Vec3f{ 0.f, 0.f, 0.f };
+
+		auto soa = make_soa( withZero );
+		batch_normalize( soa, Vec3f{ 1.f, 0.f, 0.f } );
+
+		for( std::size_t i = 0; i < kCount_; ++i )
+		{
+			auto const res = soa.get( i );
+			if( i == 5 || i == kCount_-1 )
+			{
+				REQUIRE( res.x == 1.f );
+				REQUIRE( res.y == 0.f );
+				REQUIRE( res.z == 0.f );
+				continue;
+			}
+
+			auto const ref = normalize( withZero[i] );
+			REQUIRE_THAT( res.x, WithinAbs( ref.x, 1e-6f ) );
+			REQUIRE_THAT( res.y, WithinAbs( ref.y, 1e-6f ) );
+			REQUIRE_THAT( res.z, WithinAbs( ref.z, 1e-6f ) );
+		}
+	}
+
+	SECTION( "Dot products" )
+	{
+		auto const others = random_vecs_( kCount_, 3 );
+		Vec3f const axis{ 0.25f, -1.f, 2.f };
+
+		std::vector<float> pairwise( kCount_ ), withAxis( kCount_ );
+		batch_dot( make_soa( vecs ), make_soa( others ), pairwise );
+		batch_dot( make_soa( vecs ), axis, withAxis );
+
+		for( std::size_t i = 0; i < kCount_; ++i )
+		{
+			REQUIRE_THAT( pairwise[i], WithinRel( dot( vecs[i], others[i] ), kEps ) || WithinAbs( dot( vecs[i], others[i] ), kEps ) );
+			REQUIRE_THAT( withAxis[i], WithinRel( dot( vecs[i], axis ), kEps ) || WithinAbs( dot( vecs[i], axis ), kEps ) );
+		}
+	}
+}
+
+// Benchmarks (hidden by default; run with "[benchmark]").
+TEST_CASE( "Batch kernels: AoS loop vs SoA " VMLIB_SIMD_NAME " on 1M elements", "[.][benchmark][soa]" )
+{
+	constexpr std::size_t kBenchCount = 1'000'000;
+
+	auto const vecs = random_vecs_( kBenchCount, 4 );
+	auto const soa = make_soa( vecs );
+	auto const transform = test_transform_();
+
+	std::vector<Vec3f> aosOut( kBenchCount );
+	Vec3fSoA soaOut;
+	soaOut.resize( kBenchCount );
+
+	BENCHMARK( "transform points (AoS Mat44f * Vec4f)" )
+	{
+		for( std::size_t i = 0; i < kBenchCount; ++i )
+		{
+			auto const p = transform * Vec4f{ vecs[i].x, vecs[i].y, vecs[i].z, 1.f };
+			aosOut[i] = Vec3f{ p.x, p.y, p.z };
+		}
+		return aosOut[kBenchCount/2].x;
+	};
+	BENCHMARK( "transform points (SoA batch)" )
+	{
+		batch_transform_points( transform, soa, soaOut );
+		return soaOut.x[kBenchCount/2];
+	};
+
+	BENCHMARK( "bounds (AoS)" )
+	{
+		Aabb3f box = kEmptyAabb3f;
+		for( auto const& v : vecs )
+			expand( box, v );
+		return box;
+	};
+	BENCHMARK( "bounds (SoA batch)" )
+	{
+		return batch_bounds( soa );
+	};
+
+	BENCHMARK( "normalize (AoS)" )
+	{
+		for( std::size_t i = 0; i < kBenchCount; ++i )
+			aosOut[i] = normalize( vecs[i] );
+		return aosOut[kBenchCount/2].x;
+	};
+	// Normalizing in place repeatedly does the same amount of work each time.
+	soaOut = soa;
+	BENCHMARK( "normalize (SoA batch, in place)" )
+	{
+		batch_normalize( soaOut );
+		return soaOut.x[kBenchCount/2];
+	};
+
+	std::vector<float> dots( kBenchCount );
+	Vec3f const axis{ 0.f, 1.f, 0.f };
+	BENCHMARK( "dot with constant (AoS)" )
+	{
+		for( std::size_t i = 0; i < kBenchCount; ++i )
+			dots[i] = dot( vecs[i], axis );
+		return dots[kBenchCount/2];
+	};
+	BENCHMARK( "dot with constant (SoA batch)" )
+	{
+		batch_dot( soa, axis, dots );
+		return dots[kBenchCount/2];
+	};
+}
@@ -0,0 +1,62 @@
+#ifndef TEST_GRID_HPP_8D2F6A14_C37B_4E95_A0B1_5F94E2C8D763
+#define TEST_GRID_HPP_8D2F6A14_C37B_4E95_A0B1_5F94E2C8D763
+
+#include <vector>
+#include <cstdint>
+
+#include "../vmlib/vec3.hpp"
+
+// Indexed grid of aN x aN unit quads over [0,aN]^2 in the XZ plane, with
+// heights from aHeight( x, z ).
+//
+// Vertex (i,j) is at ( i, aHeight( i, j ), j ) and has the index
+// test_grid_vertex( aN, i, j ). Quads are emitted in rows of increasing j,
+// two triangles each, wound counter-clockwise seen from above: triangles
+// 2q and 2q+1 are those of quad ( q % aN, q / aN ).
+struct TestGrid
+{
+	std::vector<Vec3f> positions;
+	std::vector<std::uint32_t> indices;
+};
+
+constexpr
+std::uint32_t test_grid_vertex( std::uint32_t aN, std::uint32_t aI, std::uint32_t aJ ) noexcept
+{
+	return aJ * (aN+1) + aI;
+}
+
+template< class tHeight > inline
+TestGrid make_test_grid( std::uint32_t aN, tHeight&& aHeight )
+{
+	TestGrid ret;
+	ret.positions.reserve( std::size_t(aN+1) * (aN+1) );
+	for( std::uint32_t j = 0; j <= aN; ++j )
+	{
+		for( std::uint32_t i = 0; i <= aN; ++i )
+			ret.positions.emplace_back( Vec3f{ float(i), aHeight( float(i), float(j) ), float(j) } );
+	}
+
+	auto const vertex = [aN] ( std::uint32_t aI, std::uint32_t aJ ) {
+		return test_grid_vertex( aN, aI, aJ );
+	};
+
+	ret.indices.reserve( std::size_t(aN) * aN * 6 );
+	for( std::uint32_t j = 0; j < aN; ++j )
+	{
+		for( std::uint32_t i = 0; i < aN; ++i )
+		{
+			ret.indices.insert( ret.indices.end(), { vertex( i, j ), vertex( i, j+1 ), vertex( i+1, j+1 ) } );
+			ret.indices.insert( ret.indices.end(), { vertex( i, j ), vertex( i+1, j+1 ), vertex( i+1, j ) } );
+		}
+	}
+	return ret;
+}
+
+// Flat grid, at height zero.
+inline
+TestGrid make_test_grid( std::uint32_t aN )
+{
+	return make_test_grid( aN, [] ( float, float ) { return 0.f; } );
+}
+
+#endif // TEST_GRID_HPP_8D2F6A14_C37B_4E95_A0B1_5F94E2C8D763
@@ -0,0 +1,134 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <array>
+#include <random>
+
+#include "../vmlib/transform.hpp"
+
+namespace
+{
+	constexpr std::size_t kRandomCount_ = 64;
+
+	void require_near_( Mat44f const& aA, Mat44f const& aB, float aTolerance )
+	{
+		using Catch::Matchers::WithinAbs;
+		using Catch::Matchers::WithinRel;
+		for( std::size_t i = 0; i < 16; ++i )
+			REQUIRE_THAT( aA.v[i], WithinRel( aB.v[i], aTolerance ) || WithinAbs( aB.v[i], aTolerance ) );
+	}
+}
+
+TEST_CASE( "Transform steps match the naive matrix product", "[transform]" )
+{
+	std::mt19937 rng( 555 );
+	std::uniform_real_distribution<float> angle( -3.f, 3.f );
+	std::uniform_real_distribution<float> scale( 0.25f, 4.f );
+	std::uniform_real_distribution<float> offset( -50.f, 50.f );
+
+	SECTION( "Single steps" )
+	{
+		Vec3f const t{ offset( rng ), offset( rng ), offset( rng ) };
+		float const a = angle( rng );
+
+		require_near_( Transform{}.translate( t ).matrix(), make_translation( t ), 0.f );
+		require_near_( Transform{}.scale( 2.f, 3.f, 4.f ).matrix(), make_scaling( 2.f, 3.f, 4.f ), 0.f );
+		require_near_( Transform{}.rotate_x( a ).matrix(), make_rotation_x( a ), 1e-6f );
+		require_near_( Transform{}.rotate_y( a ).matrix(), make_rotation_y( a ), 1e-6f );
+		require_near_( Transform{}.rotate_z( a ).matrix(), make_rotation_z( a ), 1e-6f );
+	}
+
+	SECTION( "Random chains" )
+	{
+		for( std::size_t i = 0; i < kRandomCount_; ++i )
+		{
+			Transform fused;
+			Mat44f naive = kIdentity44f;
+
+			for( std::size_t step = 0; step < 6; ++step )
+			{
+				switch( rng() % 5 )
+				{
+					case 0: {
+						Vec3f const t{ offset( rng ), offset( rng ), offset( rng ) };
+						fused.translate( t );
+						naive = naive * make_translation( t );
+					} break;
+					case 1: {
+						float const sx = scale( rng ), sy = scale( rng ), sz = scale( rng );
+						fused.scale( sx, sy, sz );
+						naive = naive * make_scaling( sx, sy, sz );
+					} break;
+					case 2: {
+						float const a = angle( rng );
+						fused.rotate_x( a );
+						naive = naive * make_rotation_x( a );
+					} break;
+					case 3: {
+						float const a = angle( rng );
+						fused.rotate_y( a );
+						naive = naive * make_rotation_y( a );
+					} break;
+					case 4: {
+						float const a = angle( rng );
+						fused.rotate_z( a );
+						naive = naive * make_rotation_z( a );
+					} break;
+				}
+			}
+
+			require_near_( fused.matrix(), naive, 1e-4f );
+		}
+	}
+
+	SECTION( "Starting from an existing matrix" )
+	{
+		auto const base = make_translation( { 1.f, 2.f, 3.f } ) * make_rotation_y( 0.3f );
+		auto const fused = Transform( base ).translate( { 0.f, 0.2f, 0.f } ).scale( 25.f ).matrix();
+		auto const naive = base * make_translation( { 0.f, 0.2f, 0.f } ) * make_scaling( 25.f, 25.f, 25.f );
+		require_near_( fused, naive, 1e-5f );
+	}
+
+	SECTION( "Constant inputs fold at compile time" )
+	{
+		constexpr Mat44f placed = Transform{}
+			.translate( { -20.f, 0.1f, 12.f } )
+			.scale( 25.f )
+			.translate( { 0.f, 0.2f, 0.f } )
+			.matrix();
+		constexpr Mat44f naive = make_translation( { -20.f, 0.1f, 12.f } )
+			* make_scaling( 25.f, 25.f, 25.f )
+			* make_translation( { 0.f, 0.2f, 0.f } );
+
+		static_assert( placed[0,0] == 25.f && placed[0,3] == -20.f && placed[1,3] == naive[1,3] );
+		require_near_( placed, naive, 0.f );
+
+		// A quarter turn, with precomputed cosine and sine.
+		constexpr Mat44f turned = Transform{}.rotate_y( 0.f, 1.f ).matrix();
+		static_assert( turned[0,2] == 1.f && turned[2,0] == -1.f );
+	}
+}
+
+// Benchmarks (hidden by default; run with "[benchmark]").
+TEST_CASE( "Placement chains: fused Transform vs Mat44f products", "[.][benchmark][transform]" )
+{
+	std::array<Vec3f,64> positions;
+	std::mt19937 rng( 556 );
+	std::uniform_real_distribution<float> offset( -50.f, 50.f );
+	for( auto& p : positions )
+		p = Vec3f{ offset( rng ), offset( rng ), offset( rng ) };
+
+	BENCHMARK( "translate * rotate_y * scale (Mat44f products)" )
+	{
+		float acc = 0.f;
+		for( auto const& p : positions )
+			acc += (make_translation( p ) * make_rotation_y( p.x ) * make_scaling( 25.f, 25.f, 25.f )).v[3];
+		return acc;
+	};
+	BENCHMARK( "translate * rotate_y * scale (Transform)" )
+	{
+		float acc = 0.f;
+		for( auto const& p : positions )
+			acc += Transform{}.translate( p ).rotate_y( p.x ).scale( 25.f ).affine().v[3];
+		return acc;
+	};
+}
@@ -0,0 +1,146 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <array>
+#include <vector>
+#include <algorithm>
+
+#include "../vmlib/vertex_cache.hpp"
+
+#include "test_grid.hpp"
+
+namespace
+{
+	// Indices of an aN x aN grid of quads (see test_grid.hpp).
+	std::vector<std::uint32_t> grid_indices_( std::uint32_t aN )
+	{
+		return make_test_grid( aN ).indices;
+	}
+
+	// Triangles in a canonical form (rotated so that the smallest index comes
+	// first, which preserves the winding), sorted.
+	std::vector<std::array<std::uint32_t,3>> canonical_( std::span<std::uint32_t const> aIndices )
+	{
+		std::vector<std::array<std::uint32_t,3>> ret;
+		for( std::size_t i = 0; i < aIndices.size(); i += 3 )
+		{
+			std::array<std::uint32_t,3> tri{ aIndices[i], aIndices[i+1], aIndices[i+2] };
+			std::rotate( tri.begin(), std::min_element( tri.begin(), tri.end() ), tri.end() );
+			ret.emplace_back( tri );
+		}
+		std::sort( ret.begin(), ret.end() );
+		return ret;
+	}
+}
+
+TEST_CASE( "FIFO cache simulation", "[vcache]" )
+{
+	SECTION( "Single triangle" )
+	{
+		std::vector<std::uint32_t> const indices{ 0, 1, 2 };
+		auto const stats = analyze_vertex_cache( indices, 3 );
+
+		REQUIRE( stats.transformed == 3 );
+		REQUIRE( stats.acmr == Catch::Approx( 3.f ) );
+		REQUIRE( stats.atvr == Catch::Approx( 1.f ) );
+	}
+
+	SECTION( "Quad" )
+	{
+		std::vector<std::uint32_t> const indices{ 0, 1, 2, 0, 2, 3 };
+		auto const stats = analyze_vertex_cache( indices, 4 );
+
+		REQUIRE( stats.transformed == 4 );
+		REQUIRE( stats.acmr == Catch::Approx( 2.f ) );
+		REQUIRE( stats.atvr == Catch::Approx( 1.f ) );
+	}
+
+	SECTION( "Eviction" )
+	{
+		// With a cache of three vertices, vertex 0 is evicted by 3, 4 and 5.
+		std::vector<std::uint32_t> const indices{ 0, 1, 2, 3, 4, 5, 0, 4, 5 };
+		auto const stats = analyze_vertex_cache( indices, 6, 3 );
+
+		REQUIRE( stats.transformed == 7 );
+		REQUIRE( stats.atvr == Catch::Approx( 7.f / 6.f ) );
+	}
+
+	SECTION( "Empty" )
+	{
+		auto const stats = analyze_vertex_cache( {}, 0 );
+		REQUIRE( stats.transformed == 0 );
+		REQUIRE( stats.acmr == 0.f );
+	}
+}
+
+TEST_CASE( "Vertex cache optimization", "[vcache]" )
+{
+	constexpr std::uint32_t kN = 64;
+	constexpr std::size_t kVertexCount = (kN+1) * (kN+1);
+
+	auto const original = grid_indices_( kN );
+	auto indices = original;
+
+	optimize_vertex_cache( indices, kVertexCount );
+
+	// Same triangles with the same winding, in a different order.
+	REQUIRE( indices.size() == original.size() );
+	REQUIRE( canonical_( indices ) == canonical_( original ) );
+
+	auto const before = analyze_vertex_cache( original, kVertexCount );
+	auto const after = analyze_vertex_cache( indices, kVertexCount );
+
+	// Row order reloads every vertex once per adjacent row (ACMR ~1); the
+	// optimized order should get much closer to the ~0.5 limit.
+	REQUIRE( before.acmr > 0.95f );
+	REQUIRE( after.acmr < 0.8f );
+	REQUIRE( after.atvr < before.atvr );
+	REQUIRE( after.atvr >= 1.f );
+
+	// Still clearly better with a differently-sized cache.
+	REQUIRE( analyze_vertex_cache( indices, kVertexCount, 32 ).acmr < analyze_vertex_cache( original, kVertexCount, 32 ).acmr );
+}
+
+TEST_CASE( "Vertex cache optimization handles disconnected meshes", "[vcache]" )
+{
+	// Two separate triangles, an unused vertex (4) and a degenerate triangle.
+	std::vector<std::uint32_t> const original{ 5, 6, 7, 0, 1, 2, 3, 3, 3 };
+	auto indices = original;
+
+	optimize_vertex_cache( indices, 8 );
+	REQUIRE( canonical_( indices ) == canonical_( original ) );
+
+	std::vector<std::uint32_t> empty;
+	optimize_vertex_cache( empty, 0 );
+	REQUIRE( empty.empty() );
+}
+
+TEST_CASE( "Vertex fetch optimization", "[vcache]" )
+{
+	std::vector<std::uint32_t> indices{ 4, 2, 0, 2, 4, 3 };
+	std::vector<int> vertices{ 10, 11, 12, 13, 14, 15 };
+
+	optimize_vertex_fetch( std::span( indices ), vertices );
+
+	// Vertices in order of first use; 1 and 5 are unused and dropped.
+	REQUIRE( indices == std::vector<std::uint32_t>{ 0, 1, 2, 1, 0, 3 } );
+	REQUIRE( vertices == std::vector<int>{ 14, 12, 10, 13 } );
+}
+
+// Benchmarks (hidden by default; run with "[benchmark]").
+TEST_CASE( "Vertex cache optimization of a 512x512 grid", "[.][benchmark][vcache]" )
+{
+	constexpr std::uint32_t kN = 512;
+	auto const original = grid_indices_( kN );
+
+	BENCHMARK( "optimize_vertex_cache (524k triangles)" )
+	{
+		auto indices = original;
+		optimize_vertex_cache( indices, (kN+1) * (kN+1) );
+		return indices.front();
+	};
+
+	BENCHMARK( "analyze_vertex_cache (524k triangles)" )
+	{
+		return analyze_vertex_cache( original, (kN+1) * (kN+1) ).transformed;
+	};
+}
@@ -0,0 +1,129 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <vector>
+#include <cstring>
+
+#include "../vmlib/vec2.hpp"
+#include "../vmlib/vec3.hpp"
+#include "../vmlib/weld.hpp"
+
+namespace
+{
+	struct TestVertex_
+	{
+		Vec3f position;
+		Vec3f normal;
+		Vec2f texCoord;
+	};
+
+	// Triangle soup of an aN x aN grid of quads, two triangles per quad, as
+	// an OBJ loader would produce it.
+	std::vector<TestVertex_> grid_soup_( std::size_t aN )
+	{
+		auto const vertex = [aN] ( std::size_t aI, std::size_t aJ ) {
+			float const u = float(aI) / float(aN), v = float(aJ) / float(aN);
+			return TestVertex_{ { u, 0.1f * u * v, v }, { 0.f, 1.f, 0.f }, { u, v } };
+		};
+
+		std::vector<TestVertex_> ret;
+		ret.reserve( aN * aN * 6 );
+		for( std::size_t j = 0; j < aN; ++j )
+		{
+			for( std::size_t i = 0; i < aN; ++i )
+			{
+				ret.emplace_back( vertex( i, j ) );
+				ret.emplace_back( vertex( i+1, j ) );
+				ret.emplace_back( vertex( i+1, j+1 ) );
+
+				ret.emplace_back( vertex( i, j ) );
+				ret.emplace_back( vertex( i+1, j+1 ) );
+				ret.emplace_back( vertex( i, j+1 ) );
+			}
+		}
+		return ret;
+	}
+
+	bool same_( TestVertex_ const& aA, TestVertex_ const& aB )
+	{
+		return 0 == std::memcmp( &aA, &aB, sizeof(TestVertex_) );
+	}
+}
+
+TEST_CASE( "Welding reproduces the triangle soup", "[weld]" )
+{
+	constexpr std::size_t kN = 40;
+	auto const soup = grid_soup_( kN );
+	auto const mesh = weld_vertices( std::span<TestVertex_ const>( soup ) );
+
+	REQUIRE( mesh.vertices.size() == (kN+1) * (kN+1) );
+	REQUIRE( mesh.indices.size() == soup.size() );
+
+	for( std::size_t i = 0; i < soup.size(); ++i )
+	{
+		REQUIRE( mesh.indices[i] < mesh.vertices.size() );
+		REQUIRE( same_( mesh.vertices[mesh.indices[i]], soup[i] ) );
+	}
+
+	// No two output vertices are identical.
+	auto const again = weld_vertices( std::span<TestVertex_ const>( mesh.vertices ) );
+	REQUIRE( again.vertices.size() == mesh.vertices.size() );
+}
+
+TEST_CASE( "Welding merges only exact duplicates", "[weld]" )
+{
+	TestVertex_ const a{ { 1.f, 2.f, 3.f }, { 0.f, 1.f, 0.f }, { 0.5f, 0.5f } };
+	TestVertex_ b = a;
+	b.normal = Vec3f{ 1.f, 0.f, 0.f };
+	TestVertex_ c = a;
+	c.texCoord = Vec2f{ 0.5f, 0.25f };
+
+	std::vector<TestVertex_> const soup{ a, b, c, c, b, a };
+	auto const mesh = weld_vertices( std::span<TestVertex_ const>( soup ) );
+
+	REQUIRE( mesh.vertices.size() == 3 );
+	REQUIRE( mesh.indices == std::vector<std::uint32_t>{ 0, 1, 2, 2, 1, 0 } );
+
+	REQUIRE( weld_vertices( std::span<TestVertex_ const>() ).vertices.empty() );
+}
+
+TEST_CASE( "Incremental welding", "[weld]" )
+{
+	auto const soup = grid_soup_( 40 );
+	auto const expected = weld_vertices( std::span<TestVertex_ const>( soup ) );
+
+	// Without reserve(), the table grows as vertices are added; the result
+	// is the same.
+	VertexWelder<TestVertex_> welder;
+	for( std::size_t i = 0; i < soup.size(); ++i )
+		REQUIRE( welder.add( soup[i] ) == expected.indices[i] );
+	REQUIRE( welder.vertex_count() == expected.vertices.size() );
+
+	auto const mesh = welder.take();
+	REQUIRE( mesh.indices == expected.indices );
+	REQUIRE( mesh.vertices.size() == expected.vertices.size() );
+	for( std::size_t i = 0; i < mesh.vertices.size(); ++i )
+		REQUIRE( same_( mesh.vertices[i], expected.vertices[i] ) );
+
+	REQUIRE( 0 == welder.vertex_count() );
+}
+
+TEST_CASE( "16-bit index buffers", "[weld]" )
+{
+	REQUIRE( fits_16bit_indices( 65536 ) );
+	REQUIRE( !fits_16bit_indices( 65537 ) );
+
+	std::vector<std::uint32_t> const indices{ 0, 65535, 7, 300 };
+	auto const narrow = narrow_indices( indices );
+	REQUIRE( narrow == std::vector<std::uint16_t>{ 0, 65535, 7, 300 } );
+}
+
+// Benchmarks (hidden by default; run with "[benchmark]").
+TEST_CASE( "Welding a 512x512 grid soup", "[.][benchmark][weld]" )
+{
+	auto const soup = grid_soup_( 512 );
+
+	BENCHMARK( "weld_vertices (1.5M corners)" )
+	{
+		return weld_vertices( std::span<TestVertex_ const>( soup ) ).vertices.size();
+	};
+}
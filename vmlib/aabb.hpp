@@ -0,0 +1,112 @@
+#ifndef AABB_HPP_1C8F5F01_CA46_4CBE_9FE2_0FAAB72DBA0E
+#define AABB_HPP_1C8F5F01_CA46_4CBE_9FE2_0FAAB72DBA0E
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "vec3.hpp"
+#include "mat44.hpp"
+
+/** Aabb3f: axis aligned bounding box
+ *
+ * Default-initialize with kEmptyAabb3f, which has inverted bounds, such that
+ * the first expand() sets both min and max.
+ */
+struct Aabb3f
+{
+	Vec3f min;
+	Vec3f max;
+};
+
+constexpr Aabb3f kEmptyAabb3f = {
+	{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() },
+	{ std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() }
+};
+
+constexpr
+bool is_empty( Aabb3f const& aBox ) noexcept
+{
+	return aBox.min.x > aBox.max.x || aBox.min.y > aBox.max.y || aBox.min.z > aBox.max.z;
+}
+
+constexpr
+void expand( Aabb3f& aBox, Vec3f aPoint ) noexcept
+{
+	aBox.min.x = std::min( aBox.min.x, aPoint.x );
+	aBox.min.y = std::min( aBox.min.y, aPoint.y );
+	aBox.min.z = std::min( aBox.min.z, aPoint.z );
+	aBox.max.x = std::max( aBox.max.x, aPoint.x );
+	aBox.max.y = std::max( aBox.max.y, aPoint.y );
+	aBox.max.z = std::max( aBox.max.z, aPoint.z );
+}
+
+constexpr
+Aabb3f merge( Aabb3f const& aA, Aabb3f const& aB ) noexcept
+{
+	Aabb3f ret = aA;
+	expand( ret, aB.min );
+	expand( ret, aB.max );
+	return ret;
+}
+
+constexpr
+Vec3f center( Aabb3f const& aBox ) noexcept
+{
+	return 0.5f * (aBox.min + aBox.max);
+}
+
+// Half of the box' size along each axis
+constexpr
+Vec3f half_extent( Aabb3f const& aBox ) noexcept
+{
+	return 0.5f * (aBox.max - aBox.min);
+}
+
+// Radius of the bounding sphere around center()
+inline
+float radius( Aabb3f const& aBox ) noexcept
+{
+	return length( half_extent( aBox ) );
+}
+
+// Distance from aPoint to the closest point of the box; zero if aPoint is
+// inside the box.
+inline
+float distance( Aabb3f const& aBox, Vec3f aPoint ) noexcept
+{
+	Vec3f const below = aBox.min - aPoint;
+	Vec3f const above = aPoint - aBox.max;
+	Vec3f const d{
+		std::max( { below.x, above.x, 0.f } ),
+		std::max( { below.y, above.y, 0.f } ),
+		std::max( { below.z, above.z, 0.f } )
+	};
+	return length( d );
+}
+
+/* Bounds of a box after transforming it by the affine transformation aM. The
+ * result is the (possibly larger) axis aligned box around the transformed box,
+ * computed from the center and half extents (Arvo's method) instead of from
+ * eight transformed corners.
+ */
+inline
+Aabb3f transform_bounds( Mat44f const& aM, Aabb3f const& aBox ) noexcept
+{
+	if( is_empty( aBox ) )
+		return aBox;
+
+	Vec3f const c = center( aBox );
+	Vec3f const e = half_extent( aBox );
+
+	Vec3f newC, newE;
+	for( std::size_t i = 0; i < 3; ++i )
+	{
+		newC[i] = aM[i,0] * c.x + aM[i,1] * c.y + aM[i,2] * c.z + aM[i,3];
+		newE[i] = std::abs( aM[i,0] ) * e.x + std::abs( aM[i,1] ) * e.y + std::abs( aM[i,2] ) * e.z;
+	}
+
+	return Aabb3f{ newC - newE, newC + newE };
+}
+
+#endif // AABB_HPP_1C8F5F01_CA46_4CBE_9FE2_0FAAB72DBA0E
@@ -0,0 +1,550 @@
+#include "block_compression.hpp"
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <cassert>
+#include <algorithm>
+
+namespace
+{
+	using Texels_ = std::array<std::array<std::uint8_t, 4>, 16>;
+	using Color_ = std::array<float, 4>;
+
+	std::uint32_t block_count_( std::uint32_t aSize ) noexcept
+	{
+		return (aSize + 3) / 4;
+	}
+
+	// The 4x4 block at texel (aX, aY), with the last column and row of the
+	// image repeated past its edges.
+	Texels_ load_block_( std::uint8_t const* aPixels, std::uint32_t aWidth, std::uint32_t aHeight, std::uint32_t aX, std::uint32_t aY ) noexcept
+	{
+		Texels_ ret;
+		for( std::uint32_t j = 0; j < 4; ++j )
+		{
+			std::uint32_t const y = std::min( aY + j, aHeight - 1 );
+			for( std::uint32_t i = 0; i < 4; ++i )
+			{
+				std::uint32_t const x = std::min( aX + i, aWidth - 1 );
+				std::copy_n( aPixels + (std::size_t(y) * aWidth + x) * 4, 4, ret[j*4 + i].begin() );
+			}
+		}
+		return ret;
+	}
+
+	// Line through the colours of aTexels (their first tChannels channels),
+	// along their principal axis, from aLo to aHi.
+	template< std::size_t tChannels >
+	void fit_line_( Texels_ const& aTexels, Color_& aLo, Color_& aHi ) noexcept
+	{
+		Color_ mean{};
+		for( auto const& texel : aTexels )
+		{
+			for( std::size_t c = 0; c < tChannels; ++c )
+				mean[c] += texel[c];
+		}
+		for( auto& m : mean )
+			m /= 16.f;
+
+		float cov[tChannels][tChannels]{};
+		for( auto const& texel : aTexels )
+		{
+			float d[tChannels];
+			for( std::size_t c = 0; c < tChannels; ++c )
+				d[c] = texel[c] - mean[c];
+			for( std::size_t i = 0; i < tChannels; ++i )
+			{
+				for( std::size_t j = 0; j < tChannels; ++j )
+					cov[i][j] += d[i] * d[j];
+			}
+		}
+
+		aLo = mean;
+		aHi = mean;
+
+		std::size_t major = 0;
+		for( std::size_t c = 1; c < tChannels; ++c )
+		{
+			if( cov[c][c] > cov[major][major] )
+				major = c;
+		}
+		if( !(cov[major][major] > 0.f) )
+			return;
+
+		// Power iteration, from the covariances of the channel that varies
+		// most (never zero).
+		Color_ axis{};
+		for( std::size_t c = 0; c < tChannels; ++c )
+			axis[c] = cov[major][c];
+
+		for( int iteration = 0; iteration < 8; ++iteration )
+		{
+			Color_ next{};
+			float scale = 0.f;
+			for( std::size_t i = 0; i < tChannels; ++i )
+			{
+				for( std::size_t j = 0; j < tChannels; ++j )
+					next[i] += cov[i][j] * axis[j];
+				scale = std::max( scale, std::abs( next[i] ) );
+			}
+			if( !(scale > 0.f) )
+				break;
+
+			for( std::size_t c = 0; c < tChannels; ++c )
+				axis[c] = next[c] / scale;
+		}
+
+		float lengthSq = 0.f;
+		for( std::size_t c = 0; c < tChannels; ++c )
+			lengthSq += axis[c] * axis[c];
+		for( auto& a : axis )
+			a /= std::sqrt( lengthSq );
+
+		float tMin = std::numeric_limits<float>::max(), tMax = -std::numeric_limits<float>::max();
+		for( auto const& texel : aTexels )
+		{
+			float t = 0.f;
+			for( std::size_t c = 0; c < tChannels; ++c )
+				t += (texel[c] - mean[c]) * axis[c];
+			tMin = std::min( tMin, t );
+			tMax = std::max( tMax, t );
+		}
+
+		for( std::size_t c = 0; c < tChannels; ++c )
+		{
+			aLo[c] = std::clamp( mean[c] + tMin * axis[c], 0.f, 255.f );
+			aHi[c] = std::clamp( mean[c] + tMax * axis[c], 0.f, 255.f );
+		}
+	}
+
+	// Endpoints that minimise the squared error of the texels, when texel i
+	// is interpolated from aLo to aHi with weight aWeights[i]. False if the
+	// weights do not determine the endpoints (e.g., all are equal).
+	template< std::size_t tChannels >
+	bool solve_endpoints_( Texels_ const& aTexels, std::array<float, 16> const& aWeights, Color_& aLo, Color_& aHi ) noexcept
+	{
+		float aa = 0.f, ab = 0.f, bb = 0.f;
+		Color_ ax{}, bx{};
+		for( std::size_t i = 0; i < 16; ++i )
+		{
+			float const b = aWeights[i], a = 1.f - b;
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+			for( std::size_t c = 0; c < tChannels; ++c )
+			{
+				ax[c] += a * aTexels[i][c];
+				bx[c] += b * aTexels[i][c];
+			}
+		}
+
+		float const det = aa * bb - ab * ab;
+		if( !(det > 1e-6f) )
+			return false;
+
+		for( std::size_t c = 0; c < tChannels; ++c )
+		{
+			aLo[c] = std::clamp( (ax[c] * bb - bx[c] * ab) / det, 0.f, 255.f );
+			aHi[c] = std::clamp( (bx[c] * aa - ax[c] * ab) / det, 0.f, 255.f );
+		}
+		return true;
+	}
+
+	// Bits are packed from the least significant bit of the first byte.
+	struct BitWriter_
+	{
+		std::uint8_t* out;
+		std::size_t position = 0;
+
+		void put( std::uint32_t aValue, std::size_t aBits ) noexcept
+		{
+			for( std::size_t i = 0; i < aBits; ++i, ++position )
+			{
+				if( (aValue >> i) & 1u )
+					out[position / 8] |= std::uint8_t( 1u << (position % 8) );
+			}
+		}
+	};
+	struct BitReader_
+	{
+		std::uint8_t const* in;
+		std::size_t position = 0;
+
+		std::uint32_t get( std::size_t aBits ) noexcept
+		{
+			std::uint32_t ret = 0;
+			for( std::size_t i = 0; i < aBits; ++i, ++position )
+				ret |= std::uint32_t( (in[position / 8] >> (position % 8)) & 1u ) << i;
+			return ret;
+		}
+	};
+
+	// BC1
+	using Bc1Palette_ = std::array<std::array<int, 4>, 4>;
+
+	struct Bc1Block_
+	{
+		std::uint16_t c0, c1;
+		std::uint32_t indices;
+		int error;
+	};
+
+	std::uint16_t to_rgb565_( Color_ const& aColor ) noexcept
+	{
+		auto const q = [] ( float aValue, int aMax ) {
+			return static_cast<std::uint16_t>( aValue * aMax / 255.f + 0.5f );
+		};
+		return static_cast<std::uint16_t>( (q( aColor[0], 31 ) << 11) | (q( aColor[1], 63 ) << 5) | q( aColor[2], 31 ) );
+	}
+	std::array<int, 4> from_rgb565_( std::uint16_t aValue ) noexcept
+	{
+		int const r = (aValue >> 11) & 31, g = (aValue >> 5) & 63, b = aValue & 31;
+		return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255 };
+	}
+
+	// Four colours if aC0 > aC1; otherwise three and transparent black.
+	Bc1Palette_ bc1_palette_( std::uint16_t aC0, std::uint16_t aC1 ) noexcept
+	{
+		auto const a = from_rgb565_( aC0 ), b = from_rgb565_( aC1 );
+		Bc1Palette_ ret{ a, b, {}, {} };
+		for( std::size_t c = 0; c < 3; ++c )
+		{
+			if( aC0 > aC1 )
+			{
+				ret[2][c] = (2 * a[c] + b[c]) / 3;
+				ret[3][c] = (a[c] + 2 * b[c]) / 3;
+			}
+			else
+			{
+				ret[2][c] = (a[c] + b[c]) / 2;
+				ret[3][c] = 0;
+			}
+		}
+		ret[2][3] = 255;
+		ret[3][3] = aC0 > aC1 ? 255 : 0;
+		return ret;
+	}
+
+	// aTexels in four-colour mode, with the endpoints aA and aB in either
+	// order. Equal endpoints give a single colour.
+	Bc1Block_ evaluate_bc1_( Texels_ const& aTexels, std::uint16_t aA, std::uint16_t aB ) noexcept
+	{
+		Bc1Block_ ret{ std::max( aA, aB ), std::min( aA, aB ), 0, 0 };
+		auto const palette = bc1_palette_( ret.c0, ret.c1 );
+		std::size_t const colors = ret.c0 == ret.c1 ? 1 : 4;
+
+		for( std::size_t i = 0; i < 16; ++i )
+		{
+			int bestError = std::numeric_limits<int>::max();
+			std::uint32_t best = 0;
+			for( std::size_t k = 0; k < colors; ++k )
+			{
+				int error = 0;
+				for( std::size_t c = 0; c < 3; ++c )
+				{
+					int const d = aTexels[i][c] - palette[k][c];
+					error += d * d;
+				}
+				if( error < bestError )
+				{
+					bestError = error;
+					best = std::uint32_t(k);
+				}
+			}
+
+			ret.indices |= best << (2 * i);
+			ret.error += bestError;
+		}
+		return ret;
+	}
+
+	void encode_bc1_block_( Texels_ const& aTexels, std::uint8_t* aOut ) noexcept
+	{
+		Color_ lo, hi;
+		fit_line_<3>( aTexels, lo, hi );
+		auto best = evaluate_bc1_( aTexels, to_rgb565_( hi ), to_rgb565_( lo ) );
+
+		// Weight of c1 for each index.
+		constexpr float kWeights[4] = { 0.f, 1.f, 1.f / 3.f, 2.f / 3.f };
+		for( int iteration = 0; iteration < 2 && best.error > 0 && best.c0 != best.c1; ++iteration )
+		{
+			std::array<float, 16> weights;
+			for( std::size_t i = 0; i < 16; ++i )
+				weights[i] = kWeights[(best.indices >> (2 * i)) & 3u];
+
+			Color_ e0, e1;
+			if( !solve_endpoints_<3>( aTexels, weights, e0, e1 ) )
+				break;
+
+			auto const candidate = evaluate_bc1_( aTexels, to_rgb565_( e0 ), to_rgb565_( e1 ) );
+			if( candidate.error >= best.error )
+				break;
+			best = candidate;
+		}
+
+		aOut[0] = std::uint8_t( best.c0 );
+		aOut[1] = std::uint8_t( best.c0 >> 8 );
+		aOut[2] = std::uint8_t( best.c1 );
+		aOut[3] = std::uint8_t( best.c1 >> 8 );
+		for( std::size_t i = 0; i < 4; ++i )
+			aOut[4 + i] = std::uint8_t( best.indices >> (8 * i) );
+	}
+
+	void decode_bc1_block_( std::uint8_t const* aIn, Texels_& aOut ) noexcept
+	{
+		auto const c0 = static_cast<std::uint16_t>( aIn[0] | (aIn[1] << 8) );
+		auto const c1 = static_cast<std::uint16_t>( aIn[2] | (aIn[3] << 8) );
+		auto const indices = std::uint32_t(aIn[4]) | (std::uint32_t(aIn[5]) << 8) | (std::uint32_t(aIn[6]) << 16) | (std::uint32_t(aIn[7]) << 24);
+
+		auto const palette = bc1_palette_( c0, c1 );
+		for( std::size_t i = 0; i < 16; ++i )
+		{
+			auto const& color = palette[(indices >> (2 * i)) & 3u];
+			for( std::size_t c = 0; c < 4; ++c )
+				aOut[i][c] = std::uint8_t( color[c] );
+		}
+	}
+
+	// BC7, mode 6
+	constexpr std::array<int, 16> kBc7Weights_{ 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+	constexpr std::uint32_t kBc7Mode6_ = 1u << 6; // the mode's 7 bits
+
+	// The endpoint's channels are 2 * q + p.
+	struct Bc7Endpoint_
+	{
+		std::array<std::uint8_t, 4> q;
+		std::uint8_t p;
+	};
+
+	struct Bc7Block_
+	{
+		Bc7Endpoint_ e0, e1;
+		std::array<std::uint8_t, 16> indices;
+		int error;
+	};
+
+	std::array<int, 4> expand_bc7_( Bc7Endpoint_ const& aEndpoint ) noexcept
+	{
+		std::array<int, 4> ret;
+		for( std::size_t c = 0; c < 4; ++c )
+			ret[c] = 2 * aEndpoint.q[c] + aEndpoint.p;
+		return ret;
+	}
+
+	int interpolate_bc7_( int aE0, int aE1, int aWeight ) noexcept
+	{
+		return ((64 - aWeight) * aE0 + aWeight * aE1 + 32) >> 6;
+	}
+
+	// The closest endpoint to aColor. Opaque blocks need p = 1 to keep
+	// alpha at 255.
+	Bc7Endpoint_ quantize_bc7_( Color_ const& aColor, bool aOpaque ) noexcept
+	{
+		Bc7Endpoint_ ret{};
+		float bestError = std::numeric_limits<float>::max();
+		for( std::uint8_t p = aOpaque ? 1 : 0; p < 2; ++p )
+		{
+			Bc7Endpoint_ endpoint{ {}, p };
+			float error = 0.f;
+			for( std::size_t c = 0; c < 4; ++c )
+			{
+				int const q = std::clamp( int(std::floor( (aColor[c] - p) * 0.5f + 0.5f )), 0, 127 );
+				endpoint.q[c] = std::uint8_t( q );
+
+				float const d = float(2 * q + p) - aColor[c];
+				error += d * d;
+			}
+
+			if( error < bestError )
+			{
+				bestError = error;
+				ret = endpoint;
+			}
+		}
+		return ret;
+	}
+
+	Bc7Block_ evaluate_bc7_( Texels_ const& aTexels, Bc7Endpoint_ const& aE0, Bc7Endpoint_ const& aE1 ) noexcept
+	{
+		Bc7Block_ ret{ aE0, aE1, {}, 0 };
+
+		auto const a = expand_bc7_( aE0 ), b = expand_bc7_( aE1 );
+		std::array<std::array<int, 4>, 16> palette;
+		for( std::size_t k = 0; k < 16; ++k )
+		{
+			for( std::size_t c = 0; c < 4; ++c )
+				palette[k][c] = interpolate_bc7_( a[c], b[c], kBc7Weights_[k] );
+		}
+
+		int lengthSq = 0;
+		for( std::size_t c = 0; c < 4; ++c )
+			lengthSq += (b[c] - a[c]) * (b[c] - a[c]);
+
+		// The weights are nearly even, so the closest index is the
+		// projection onto the line, or one next to it.
+		for( std::size_t i = 0; i < 16; ++i )
+		{
+			int guess = 0;
+			if( lengthSq > 0 )
+			{
+				int t = 0;
+				for( std::size_t c = 0; c < 4; ++c )
+					t += (aTexels[i][c] - a[c]) * (b[c] - a[c]);
+				guess = std::clamp( int(std::lround( 15.f * float(t) / float(lengthSq) )), 0, 15 );
+			}
+
+			int bestError = std::numeric_limits<int>::max();
+			for( int k = std::max( 0, guess - 1 ); k <= std::min( 15, guess + 1 ); ++k )
+			{
+				int error = 0;
+				for( std::size_t c = 0; c < 4; ++c )
+				{
+					int const d = aTexels[i][c] - palette[k][c];
+					error += d * d;
+				}
+				if( error < bestError )
+				{
+					bestError = error;
+					ret.indices[i] = std::uint8_t( k );
+				}
+			}
+			ret.error += bestError;
+		}
+		return ret;
+	}
+
+	void encode_bc7_block_( Texels_ const& aTexels, std::uint8_t* aOut ) noexcept
+	{
+		bool const opaque = std::all_of( aTexels.begin(), aTexels.end(), [] ( auto const& aTexel ) { return 255 == aTexel[3]; } );
+
+		Color_ lo, hi;
+		fit_line_<4>( aTexels, lo, hi );
+		auto best = evaluate_bc7_( aTexels, quantize_bc7_( lo, opaque ), quantize_bc7_( hi, opaque ) );
+
+		for( int iteration = 0; iteration < 2 && best.error > 0; ++iteration )
+		{
+			std::array<float, 16> weights;
+			for( std::size_t i = 0; i < 16; ++i )
+				weights[i] = kBc7Weights_[best.indices[i]] / 64.f;
+
+			Color_ e0, e1;
+			if( !solve_endpoints_<4>( aTexels, weights, e0, e1 ) )
+				break;
+
+			auto const candidate = evaluate_bc7_( aTexels, quantize_bc7_( e0, opaque ), quantize_bc7_( e1, opaque ) );
+			if( candidate.error >= best.error )
+				break;
+			best = candidate;
+		}
+
+		// The first index is stored without its high bit, which must be zero.
+		if( best.indices[0] >= 8 )
+		{
+			std::swap( best.e0, best.e1 );
+			for( auto& index : best.indices )
+				index = std::uint8_t( 15 - index );
+		}
+
+		std::fill_n( aOut, 16, std::uint8_t(0) );
+		BitWriter_ out{ aOut };
+		out.put( kBc7Mode6_, 7 );
+		for( std::size_t c = 0; c < 4; ++c )
+		{
+			out.put( best.e0.q[c], 7 );
+			out.put( best.e1.q[c], 7 );
+		}
+		out.put( best.e0.p, 1 );
+		out.put( best.e1.p, 1 );
+
+		out.put( best.indices[0], 3 );
+		for( std::size_t i = 1; i < 16; ++i )
+			out.put( best.indices[i], 4 );
+	}
+
+	void decode_bc7_block_( std::uint8_t const* aIn, Texels_& aOut ) noexcept
+	{
+		BitReader_ in{ aIn };
+		if( kBc7Mode6_ != in.get( 7 ) )
+		{
+			aOut = {};
+			return;
+		}
+
+		Bc7Endpoint_ e0{}, e1{};
+		for( std::size_t c = 0; c < 4; ++c )
+		{
+			e0.q[c] = std::uint8_t( in.get( 7 ) );
+			e1.q[c] = std::uint8_t( in.get( 7 ) );
+		}
+		e0.p = std::uint8_t( in.get( 1 ) );
+		e1.p = std::uint8_t( in.get( 1 ) );
+
+		auto const a = expand_bc7_( e0 ), b = expand_bc7_( e1 );
+		for( std::size_t i = 0; i < 16; ++i )
+		{
+			int const weight = kBc7Weights_[in.get( 0 == i ? 3 : 4 )];
+			for( std::size_t c = 0; c < 4; ++c )
+				aOut[i][c] = std::uint8_t( interpolate_bc7_( a[c], b[c], weight ) );
+		}
+	}
+}
+
+std::size_t block_bytes( BlockFormat aFormat ) noexcept
+{
+	return BlockFormat::Bc1 == aFormat ? 8 : 16;
+}
+
+std::size_t compressed_size( BlockFormat aFormat, std::uint32_t aWidth, std::uint32_t aHeight ) noexcept
+{
+	return std::size_t(block_count_( aWidth )) * block_count_( aHeight ) * block_bytes( aFormat );
+}
+
+void encode_blocks( BlockFormat aFormat, std::span<std::uint8_t const> aPixels, std::uint32_t aWidth, std::uint32_t aHeight, std::span<std::uint8_t> aOut )
+{
+	assert( aPixels.size() == std::size_t(aWidth) * aHeight * 4 );
+	assert( aOut.size() == compressed_size( aFormat, aWidth, aHeight ) );
+
+	auto const encode = BlockFormat::Bc1 == aFormat ? &encode_bc1_block_ : &encode_bc7_block_;
+	std::size_t const bytes = block_bytes( aFormat );
+
+	std::uint8_t* out = aOut.data();
+	for( std::uint32_t y = 0; y < aHeight; y += 4 )
+	{
+		for( std::uint32_t x = 0; x < aWidth; x += 4, out += bytes )
+			encode( load_block_( aPixels.data(), aWidth, aHeight, x, y ), out );
+	}
+}
+
+std::vector<std::uint8_t> encode_blocks( BlockFormat aFormat, std::span<std::uint8_t const> aPixels, std::uint32_t aWidth, std::uint32_t aHeight )
+{
+	std::vector<std::uint8_t> ret( compressed_size( aFormat, aWidth, aHeight ) );
+	encode_blocks( aFormat, aPixels, aWidth, aHeight, ret );
+	return ret;
+}
+
+std::vector<std::uint8_t> decode_blocks( BlockFormat aFormat, std::span<std::uint8_t const> aBlocks, std::uint32_t aWidth, std::uint32_t aHeight )
+{
+	assert( aBlocks.size() == compressed_size( aFormat, aWidth, aHeight ) );
+
+	auto const decode = BlockFormat::Bc1 == aFormat ? &decode_bc1_block_ : &decode_bc7_block_;
+	std::size_t const bytes = block_bytes( aFormat );
+
+	std::vector<std::uint8_t> ret( std::size_t(aWidth) * aHeight * 4 );
+	std::uint8_t const* in = aBlocks.data();
+	for( std::uint32_t y = 0; y < aHeight; y += 4 )
+	{
+		for( std::uint32_t x = 0; x < aWidth; x += 4, in += bytes )
+		{
+			Texels_ texels;
+			decode( in, texels );
+
+			for( std::uint32_t j = 0; j < 4 && y + j < aHeight; ++j )
+			{
+				for( std::uint32_t i = 0; i < 4 && x + i < aWidth; ++i )
+					std::copy_n( texels[j*4 + i].begin(), 4, ret.data() + (std::size_t(y + j) * aWidth + x + i) * 4 );
+			}
+		}
+	}
+	return ret;
+}
@@ -0,0 +1,57 @@
+#ifndef BLOCK_COMPRESSION_HPP_2C6E0A95_4F7B_4D13_A8E2_5B19C7F3D640
+#define BLOCK_COMPRESSION_HPP_2C6E0A95_4F7B_4D13_A8E2_5B19C7F3D640
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/** Block compression (BC1 and BC7) of 8-bit RGBA images on the CPU
+ *
+ * Both formats store blocks of 4x4 texels, BC1 in 8 bytes (RGB, 4 bits per
+ * texel) and BC7 in 16 bytes (RGBA, 8 bits per texel): 8x and 4x smaller
+ * than RGBA8. The GPU samples them as they are, so they save video memory
+ * and bandwidth as well as disk space. Blocks are stored row by row. An
+ * image whose size is not a multiple of four is padded by repeating its
+ * last column and row; the GL ignores the padding.
+ *
+ * The encoders fit a line through the colours of each block (along their
+ * principal axis), snap its ends to the format's endpoints and then refine
+ * the endpoints by least squares for the chosen indices:
+ *  - BC1 uses its four-colour mode only. Alpha is dropped, so BC1 is for
+ *    opaque images.
+ *  - BC7 uses mode 6 only: one RGBA line, 4-bit indices, and 7-bit
+ *    endpoints with a shared low bit each. The other modes (partitions,
+ *    separate alpha) do better on blocks with several distinct colours, at
+ *    a much higher encoding cost.
+ *
+ * Values are encoded as they are stored, so sRGB images give sRGB blocks
+ * (e.g., for GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM).
+ *
+ * decode_blocks() decodes all of BC1, but only the BC7 blocks written by
+ * encode_blocks() (mode 6); other BC7 blocks decode to transparent black.
+ *
+ * Pixels are tightly packed rows of four bytes (R, G, B, A).
+ */
+enum class BlockFormat
+{
+	Bc1,
+	Bc7
+};
+
+std::size_t block_bytes( BlockFormat ) noexcept;
+
+// Size of an aWidth x aHeight image in aFormat, in bytes.
+std::size_t compressed_size( BlockFormat, std::uint32_t aWidth, std::uint32_t aHeight ) noexcept;
+
+// aOut must hold compressed_size( aFormat, aWidth, aHeight ) bytes.
+//
+// Rows of blocks are independent: a band of rows starting at a multiple of
+// four encodes to the matching range of aOut, so an image can be encoded
+// in parallel, one band per thread.
+void encode_blocks( BlockFormat, std::span<std::uint8_t const> aPixels, std::uint32_t aWidth, std::uint32_t aHeight, std::span<std::uint8_t> aOut );
+std::vector<std::uint8_t> encode_blocks( BlockFormat, std::span<std::uint8_t const> aPixels, std::uint32_t aWidth, std::uint32_t aHeight );
+
+std::vector<std::uint8_t> decode_blocks( BlockFormat, std::span<std::uint8_t const> aBlocks, std::uint32_t aWidth, std::uint32_t aHeight );
+
+#endif // BLOCK_COMPRESSION_HPP_2C6E0A95_4F7B_4D13_A8E2_5B19C7F3D640
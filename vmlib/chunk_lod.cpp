@@ -0,0 +1,170 @@
+#include "chunk_lod.hpp"
+
+#include <limits>
+#include <cassert>
+#include <utility>
+#include <algorithm>
+
+namespace
+{
+	constexpr std::uint32_t kUnowned_ = std::numeric_limits<std::uint32_t>::max();
+	constexpr std::uint32_t kShared_ = kUnowned_ - 1;
+
+	float average_edge_length_( std::span<std::uint32_t const> aIndices, std::span<Vec3f const> aPositions, std::span<MeshChunk const> aChunks ) noexcept
+	{
+		double sum = 0.0;
+		std::size_t edges = 0;
+		for( auto const& chunk : aChunks )
+		{
+			auto const indices = aIndices.subspan( chunk.firstIndex, chunk.indexCount );
+			for( std::size_t i = 0; i < indices.size(); i += 3 )
+			{
+				Vec3f const a = aPositions[indices[i+0]];
+				Vec3f const b = aPositions[indices[i+1]];
+				Vec3f const c = aPositions[indices[i+2]];
+				sum += length( b - a ) + length( c - b ) + length( a - c );
+			}
+			edges += indices.size();
+		}
+
+		float const ret = edges ? float(sum / double(edges)) : 0.f;
+		return ret > 0.f ? ret : 1.f;
+	}
+
+	// Packs the cell coordinates of aPos into 21 bits each.
+	std::uint64_t cell_key_( Vec3f aPos, float aInvCellSize ) noexcept
+	{
+		constexpr std::int64_t kBias = std::int64_t(1) << 20;
+		auto const coord = [] ( float aX ) {
+			auto const cell = static_cast<std::int64_t>( std::floor( aX ) ) + kBias;
+			return static_cast<std::uint64_t>( std::clamp<std::int64_t>( cell, 0, 2*kBias - 1 ) );
+		};
+
+		return coord( aPos.x * aInvCellSize )
+			| (coord( aPos.y * aInvCellSize ) << 21)
+			| (coord( aPos.z * aInvCellSize ) << 42)
+		;
+	}
+}
+
+std::vector<MeshLod> build_chunk_lods( std::vector<std::uint32_t>& aIndices, std::span<Vec3f const> aPositions, std::span<MeshChunk const> aChunks, std::size_t aLevelCount )
+{
+	assert( aLevelCount >= 1 && aLevelCount <= kMaxLodLevels );
+
+	std::size_t const vertexCount = aPositions.size();
+
+	// Vertices referenced by several chunks stay where they are.
+	std::vector<std::uint32_t> owner( vertexCount, kUnowned_ );
+	for( std::size_t c = 0; c < aChunks.size(); ++c )
+	{
+		for( std::size_t i = 0; i < aChunks[c].indexCount; ++i )
+		{
+			auto const index = aIndices[aChunks[c].firstIndex + i];
+			assert( index < vertexCount );
+
+			auto& o = owner[index];
+			if( kUnowned_ == o )
+				o = static_cast<std::uint32_t>( c );
+			else if( c != o )
+				o = kShared_;
+		}
+	}
+
+	float const baseCellSize = average_edge_length_( aIndices, aPositions, aChunks );
+
+	std::vector<std::uint32_t> remap( vertexCount );
+	for( std::size_t v = 0; v < vertexCount; ++v )
+		remap[v] = static_cast<std::uint32_t>( v );
+
+	std::vector<MeshLod> ret( aChunks.size() * aLevelCount );
+	std::vector<std::uint32_t> members;
+	std::vector<std::pair<std::uint64_t,std::uint32_t>> cells;
+
+	for( std::size_t c = 0; c < aChunks.size(); ++c )
+	{
+		auto const& chunk = aChunks[c];
+		ret[c * aLevelCount] = MeshLod{ chunk.firstIndex, chunk.indexCount, 0.f };
+
+		// The chunk's own vertices. Each vertex is owned by at most one
+		// chunk, so the owner array doubles as the "seen" marker.
+		members.clear();
+		for( std::size_t i = 0; i < chunk.indexCount; ++i )
+		{
+			auto const index = aIndices[chunk.firstIndex + i];
+			if( c == owner[index] )
+			{
+				members.emplace_back( index );
+				owner[index] = kUnowned_;
+			}
+		}
+		for( auto const index : members )
+			owner[index] = static_cast<std::uint32_t>( c );
+
+		float error = 0.f;
+		for( std::size_t level = 1; level < aLevelCount; ++level )
+		{
+			float const cellSize = baseCellSize * float(std::size_t(1) << level);
+
+			cells.clear();
+			for( auto const index : members )
+				cells.emplace_back( cell_key_( aPositions[index], 1.f / cellSize ), index );
+			std::sort( cells.begin(), cells.end() );
+
+			for( std::size_t first = 0; first < cells.size(); )
+			{
+				std::size_t end = first + 1;
+				while( end < cells.size() && cells[end].first == cells[first].first )
+					++end;
+
+				Vec3f mean{ 0.f, 0.f, 0.f };
+				for( std::size_t i = first; i < end; ++i )
+					mean += aPositions[cells[i].second];
+				mean /= float(end - first);
+
+				std::uint32_t best = cells[first].second;
+				float bestDistSq = std::numeric_limits<float>::max();
+				for( std::size_t i = first; i < end; ++i )
+				{
+					Vec3f const d = aPositions[cells[i].second] - mean;
+					if( float const distSq = dot( d, d ); distSq < bestDistSq )
+					{
+						best = cells[i].second;
+						bestDistSq = distSq;
+					}
+				}
+
+				for( std::size_t i = first; i < end; ++i )
+				{
+					remap[cells[i].second] = best;
+					error = std::max( error, length( aPositions[cells[i].second] - aPositions[best] ) );
+				}
+
+				first = end;
+			}
+
+			std::size_t const firstIndex = aIndices.size();
+			for( std::size_t i = 0; i < chunk.indexCount; i += 3 )
+			{
+				auto const v0 = remap[aIndices[chunk.firstIndex + i + 0]];
+				auto const v1 = remap[aIndices[chunk.firstIndex + i + 1]];
+				auto const v2 = remap[aIndices[chunk.firstIndex + i + 2]];
+				if( v0 == v1 || v1 == v2 || v2 == v0 )
+					continue;
+
+				aIndices.insert( aIndices.end(), { v0, v1, v2 } );
+			}
+
+			assert( aIndices.size() <= std::numeric_limits<std::uint32_t>::max() );
+			ret[c * aLevelCount + level] = MeshLod{
+				static_cast<std::uint32_t>( firstIndex ),
+				static_cast<std::uint32_t>( aIndices.size() - firstIndex ),
+				error
+			};
+		}
+
+		for( auto const index : members )
+			remap[index] = index;
+	}
+
+	return ret;
+}
@@ -0,0 +1,39 @@
+#ifndef CHUNK_LOD_HPP_8D3A51F7_2B6E_4C09_A4F8_E15C7B92D06A
+#define CHUNK_LOD_HPP_8D3A51F7_2B6E_4C09_A4F8_E15C7B92D06A
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "lod.hpp"
+#include "vec3.hpp"
+#include "mesh_chunks.hpp"
+
+/** Discrete levels of detail for the chunks of a mesh
+ *
+ * build_chunk_lods() creates aLevelCount levels for each chunk from
+ * partition_mesh_chunks(). Level 0 is the chunk itself. Level k >= 1 is made
+ * by vertex clustering (Rossignac and Borrel, "Multi-resolution 3D
+ * approximations for rendering complex scenes", 1993): the chunk's vertices
+ * are binned into a grid of cubes 2^k times the mesh's average edge length,
+ * every vertex is replaced by the member of its cube closest to the cube's
+ * mean, and triangles that collapse are dropped. The coarser levels only
+ * reference existing vertices, so all levels share the vertex buffer; their
+ * indices are appended to the index buffer.
+ *
+ * Vertices that are used by more than one chunk are never clustered. The
+ * edges along chunk borders are thus the same at every level, and two
+ * neighbouring chunks never show cracks, whatever levels they are drawn at.
+ *
+ * Each level records its error: the largest distance between a vertex and
+ * the vertex that replaces it. Errors do not decrease from one level to the
+ * next; select_lod() chooses between them.
+ */
+
+// Returns the levels in chunk-major order: level k of chunk c is at
+// ret[c * aLevelCount + k]. Appends the indices of levels 1 and up to
+// aIndices; the chunks' own indices (level 0) are not modified.
+std::vector<MeshLod> build_chunk_lods( std::vector<std::uint32_t>& aIndices, std::span<Vec3f const> aPositions, std::span<MeshChunk const> aChunks, std::size_t aLevelCount );
+
+#endif // CHUNK_LOD_HPP_8D3A51F7_2B6E_4C09_A4F8_E15C7B92D06A
@@ -0,0 +1,38 @@
+#include "fastmath.hpp"
+
+#include <cassert>
+#include <algorithm>
+
+void batch_sincos( std::span<float const> aAngles, std::span<float> aSin, std::span<float> aCos ) noexcept
+{
+	using FloatN_ = simd::Float8;
+	constexpr std::size_t kWidth = FloatN_::kWidth;
+
+	std::size_t const count = aAngles.size();
+	assert( aSin.size() >= count && aCos.size() >= count );
+
+	std::size_t i = 0;
+	for( ; i + kWidth <= count; i += kWidth )
+	{
+		FloatN_ s, c;
+		simd::sincos( simd::load8( aAngles.data() + i ), s, c );
+		simd::store( aSin.data() + i, s );
+		simd::store( aCos.data() + i, c );
+	}
+
+	// Pad the remaining elements to a full vector, so that the results do
+	// not depend on an element's position in the array.
+	if( i < count )
+	{
+		float in[kWidth] = {}, s[kWidth], c[kWidth];
+		std::copy( aAngles.begin() + i, aAngles.end(), in );
+
+		FloatN_ sv, cv;
+		simd::sincos( simd::load8( in ), sv, cv );
+		simd::store( s, sv );
+		simd::store( c, cv );
+
+		std::copy( s, s + (count - i), aSin.begin() + i );
+		std::copy( c, c + (count - i), aCos.begin() + i );
+	}
+}
@@ -0,0 +1,150 @@
+#ifndef FASTMATH_HPP_C47E8A1D_2B95_4F36_A0E7_6D3F1B58C924
+#define FASTMATH_HPP_C47E8A1D_2B95_4F36_A0E7_6D3F1B58C924
+
+#include <span>
+#include <concepts>
+#include <numbers>
+
+#include "simd.hpp"
+
+/** Fast 4- and 8-wide approximations of common math functions
+ *
+ * Polynomial approximations that work on simd::Float4 and simd::Float8 (and
+ * therefore on all code paths, see simd.hpp). The maximum errors below were
+ * measured against libm (see vmlib-test/fastmath.cpp, which enforces them):
+ *
+ *   sin, cos, sincos  absolute error <= 2e-7 for |x| <= 1000; the range
+ *                     reduction loses accuracy beyond that (absolute error
+ *                     grows roughly with |x| * 2^-24)
+ *   atan2             absolute error <= 4e-7 radians (about one ulp near
+ *                     +-pi); atan2( 0, 0 ) == 0, and the sign of zero
+ *                     inputs is otherwise ignored
+ *   rsqrt             relative error <= 4e-7 for normal positive inputs
+ *
+ * None of these handle infinities or NaNs specially.
+ *
+ * sin/cos reduce the argument to [-pi/4, pi/4] by subtracting the nearest
+ * multiple of pi/2 (in three parts, after Cody & Waite), and then use the
+ * minimax polynomials from the Cephes library (sinf.c, cosf.c). atan2 reduces
+ * to atan( a ), 0 <= a <= 1, and further to |a| <= tan(pi/8) before using
+ * Cephes' atanf polynomial. rsqrt refines the hardware estimate with one
+ * Newton-Raphson step.
+ */
+namespace simd
+{
+	template< class tFloatN >
+	concept FloatN = std::same_as<tFloatN,Float4> || std::same_as<tFloatN,Float8>;
+
+	namespace detail
+	{
+		// sin and cos on [-pi/4, pi/4]
+		template< FloatN tFloatN >
+		tFloatN sin_poly_( tFloatN aX, tFloatN aX2 ) noexcept
+		{
+			auto p = fmadd( tFloatN( -1.9515295891e-4f ), aX2, 8.3321608736e-3f );
+			p = fmadd( p, aX2, -1.6666654611e-1f );
+			return fmadd( p * aX2, aX, aX );
+		}
+		template< FloatN tFloatN >
+		tFloatN cos_poly_( tFloatN aX2 ) noexcept
+		{
+			auto p = fmadd( tFloatN( 2.443315711809948e-5f ), aX2, -1.388731625493765e-3f );
+			p = fmadd( p, aX2, 4.166664568298827e-2f );
+			return fmadd( p * aX2, aX2, fmadd( aX2, -0.5f, 1.f ) );
+		}
+
+		// Reduces aX to aR in [-pi/4, pi/4] with aX = aR + k pi/2, and returns
+		// k mod 4 as a float in {-2, -1, 0, 1, 2} (-2 and 2 both mean 2, -1
+		// means 3).
+		template< FloatN tFloatN >
+		tFloatN reduce_( tFloatN aX, tFloatN& aR ) noexcept
+		{
+			auto const k = round( aX * float(2.0 / std::numbers::pi) );
+
+			// pi/2 = kPio2a + kPio2b + kPio2c; the first two have few enough
+			// significant bits that k * kPio2a and k * kPio2b are exact.
+			constexpr float kPio2a = 1.5703125f;
+			constexpr float kPio2b = 4.837512969970703125e-4f;
+			constexpr float kPio2c = 7.54978995489188216e-8f;
+			aR = ((aX - k * kPio2a) - k * kPio2b) - k * kPio2c;
+
+			return k - 4.f * round( k * 0.25f );
+		}
+	}
+
+	template< FloatN tFloatN >
+	void sincos( tFloatN aX, tFloatN& aSin, tFloatN& aCos ) noexcept
+	{
+		tFloatN r;
+		auto const q = detail::reduce_( aX, r );
+		auto const r2 = r * r;
+
+		auto const s = detail::sin_poly_( r, r2 );
+		auto const c = detail::cos_poly_( r2 );
+
+		// Quadrants 1 and 3 swap sin and cos. sin is negative in quadrants 2
+		// and 3, cos in quadrants 1 and 2.
+		auto const swap = (abs( q ) > 0.5f) & (abs( q ) < 1.5f);
+		auto const negSin = (q < -0.5f) | (q > 1.5f);
+		auto const negCos = (q > 0.5f) | (q < -1.5f);
+
+		auto const signMask = tFloatN( -0.f );
+		aSin = select( swap, c, s ) ^ (negSin & signMask);
+		aCos = select( swap, s, c ) ^ (negCos & signMask);
+	}
+
+	template< FloatN tFloatN >
+	tFloatN sin( tFloatN aX ) noexcept
+	{
+		tFloatN s, c;
+		sincos( aX, s, c );
+		return s;
+	}
+	template< FloatN tFloatN >
+	tFloatN cos( tFloatN aX ) noexcept
+	{
+		tFloatN s, c;
+		sincos( aX, s, c );
+		return c;
+	}
+
+	template< FloatN tFloatN >
+	tFloatN atan2( tFloatN aY, tFloatN aX ) noexcept
+	{
+		auto const ax = abs( aX );
+		auto const ay = abs( aY );
+
+		auto const hi = max( ax, ay );
+		auto const lo = min( ax, ay );
+		auto const a = select( hi > 0.f, lo / hi, tFloatN( 0.f ) );
+
+		// atan( a ) = pi/4 + atan( (a-1)/(a+1) )
+		auto const big = a > 0.4142135623730950f;
+		auto const t = select( big, (a - 1.f) / (a + 1.f), a );
+		auto const offset = select( big, tFloatN( float(std::numbers::pi / 4) ), tFloatN( 0.f ) );
+
+		auto const t2 = t * t;
+		auto p = fmadd( tFloatN( 8.05374449538e-2f ), t2, -1.38776856032e-1f );
+		p = fmadd( p, t2, 1.99777106478e-1f );
+		p = fmadd( p, t2, -3.33329491539e-1f );
+		auto angle = offset + fmadd( p * t2, t, t );
+
+		// Undo the reductions: swap of x and y, negative x, negative y.
+		angle = select( ay > ax, float(std::numbers::pi / 2) - angle, angle );
+		angle = select( aX < 0.f, float(std::numbers::pi) - angle, angle );
+		return angle ^ (aY & tFloatN( -0.f ));
+	}
+
+	template< FloatN tFloatN >
+	tFloatN rsqrt( tFloatN aX ) noexcept
+	{
+		auto const y = rsqrt_approx( aX );
+		return y * fmadd( aX * -0.5f, y * y, 1.5f );
+	}
+}
+
+// Sines and cosines of an array of angles, eight at a time. aSin and aCos must
+// hold at least aAngles.size() elements.
+void batch_sincos( std::span<float const> aAngles, std::span<float> aSin, std::span<float> aCos ) noexcept;
+
+#endif // FASTMATH_HPP_C47E8A1D_2B95_4F36_A0E7_6D3F1B58C924
@@ -0,0 +1,216 @@
+#include "frustum.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cassert>
+
+#include "simd.hpp"
+
+namespace
+{
+	using FloatN_ = simd::Float8;
+	constexpr std::size_t kWidth_ = FloatN_::kWidth;
+
+	// Plane with dot( (aX, aY, aZ), p ) + aW >= 0 on the inside, scaled such
+	// that the normal has unit length.
+	Plane make_plane_( float aX, float aY, float aZ, float aW ) noexcept
+	{
+		Vec3f const normal{ aX, aY, aZ };
+		float const len = length( normal );
+		float const inv = len > 0.f ? 1.f / len : 0.f;
+		return Plane{ normal * inv, aW * inv };
+	}
+
+	// Plane coefficients broadcast to all lanes, plus the absolute values of
+	// the normal for the box tests.
+	struct PlaneN_
+	{
+		FloatN_ nx, ny, nz, d;
+		FloatN_ ax, ay, az;
+	};
+
+	std::array<PlaneN_,Frustum::kPlaneCount> broadcast_( Frustum const& aFrustum ) noexcept
+	{
+		std::array<PlaneN_,Frustum::kPlaneCount> ret{};
+		for( std::size_t i = 0; i < Frustum::kPlaneCount; ++i )
+		{
+			auto const& p = aFrustum.planes[i];
+			ret[i] = PlaneN_{
+				p.normal.x, p.normal.y, p.normal.z, p.offset,
+				std::abs( p.normal.x ), std::abs( p.normal.y ), std::abs( p.normal.z )
+			};
+		}
+		return ret;
+	}
+
+	// Writes one flag per lane (1 = visible) and returns the number of visible
+	// lanes. aOutside has all bits set in the lanes that were rejected.
+	std::size_t store_flags_( std::uint8_t* aOut, FloatN_ aOutside ) noexcept
+	{
+		int const bits = ~simd::movemask( aOutside ) & ((1 << kWidth_) - 1);
+		for( std::size_t j = 0; j < kWidth_; ++j )
+			aOut[j] = static_cast<std::uint8_t>( (bits >> j) & 1 );
+		return static_cast<std::size_t>( std::popcount( static_cast<unsigned>( bits ) ) );
+	}
+
+	float distance_( Plane const& aPlane, Vec3f aPoint ) noexcept
+	{
+		return dot( aPlane.normal, aPoint ) + aPlane.offset;
+	}
+	float box_radius_( Plane const& aPlane, Vec3f aHalfExtent ) noexcept
+	{
+		return std::abs( aPlane.normal.x ) * aHalfExtent.x
+			+ std::abs( aPlane.normal.y ) * aHalfExtent.y
+			+ std::abs( aPlane.normal.z ) * aHalfExtent.z;
+	}
+}
+
+// Gribb & Hartmann, "Fast Extraction of Viewing Frustum Planes from the
+// World-View-Projection Matrix". A point is inside if -w <= x,y,z <= w for its
+// clip coordinates (x,y,z,w) = M p; each inequality is one plane, formed from
+// the last row of M plus or minus one of the other rows.
+Frustum make_frustum( Mat44f const& aM ) noexcept
+{
+	auto const plane = [&aM] ( std::size_t aRow, float aSign ) {
+		return make_plane_(
+			aM[3,0] + aSign * aM[aRow,0],
+			aM[3,1] + aSign * aM[aRow,1],
+			aM[3,2] + aSign * aM[aRow,2],
+			aM[3,3] + aSign * aM[aRow,3]
+		);
+	};
+
+	Frustum ret{};
+	ret.planes[Frustum::kLeft] = plane( 0, 1.f );
+	ret.planes[Frustum::kRight] = plane( 0, -1.f );
+	ret.planes[Frustum::kBottom] = plane( 1, 1.f );
+	ret.planes[Frustum::kTop] = plane( 1, -1.f );
+	ret.planes[Frustum::kNear] = plane( 2, 1.f );
+	ret.planes[Frustum::kFar] = plane( 2, -1.f );
+	return ret;
+}
+
+bool is_visible( Frustum const& aFrustum, Vec3f aCenter, float aRadius ) noexcept
+{
+	for( auto const& plane : aFrustum.planes )
+	{
+		if( distance_( plane, aCenter ) < -aRadius )
+			return false;
+	}
+	return true;
+}
+
+bool is_visible( Frustum const& aFrustum, Aabb3f const& aBox ) noexcept
+{
+	if( is_empty( aBox ) )
+		return false;
+
+	Vec3f const c = center( aBox );
+	Vec3f const e = half_extent( aBox );
+	for( auto const& plane : aFrustum.planes )
+	{
+		if( distance_( plane, c ) < -box_radius_( plane, e ) )
+			return false;
+	}
+	return true;
+}
+
+std::size_t batch_test_spheres( Frustum const& aFrustum, Vec3fSoA const& aCenters, std::span<float const> aRadii, std::span<std::uint8_t> aVisible ) noexcept
+{
+	std::size_t const count = aCenters.size();
+	assert( aRadii.size() >= count );
+	assert( aVisible.size() >= count );
+
+	auto const planes = broadcast_( aFrustum );
+
+	float const* cx = aCenters.x.data();
+	float const* cy = aCenters.y.data();
+	float const* cz = aCenters.z.data();
+	float const* rr = aRadii.data();
+
+	std::size_t visible = 0;
+	std::size_t i = 0;
+	for( ; i + kWidth_ <= count; i += kWidth_ )
+	{
+		auto const x = simd::load8( cx + i );
+		auto const y = simd::load8( cy + i );
+		auto const z = simd::load8( cz + i );
+		auto const negR = -simd::load8( rr + i );
+
+		FloatN_ outside = 0.f;
+		for( auto const& p : planes )
+			outside = outside | (p.nx * x + p.ny * y + p.nz * z + p.d < negR);
+
+		visible += store_flags_( aVisible.data() + i, outside );
+	}
+
+	for( ; i < count; ++i )
+	{
+		bool const vis = is_visible( aFrustum, aCenters.get( i ), rr[i] );
+		aVisible[i] = vis ? 1 : 0;
+		visible += vis;
+	}
+
+	return visible;
+}
+
+std::size_t batch_test_boxes( Frustum const& aFrustum, Vec3fSoA const& aCenters, Vec3fSoA const& aHalfExtents, std::span<std::uint8_t> aVisible ) noexcept
+{
+	std::size_t const count = aCenters.size();
+	assert( aHalfExtents.size() >= count );
+	assert( aVisible.size() >= count );
+
+	auto const planes = broadcast_( aFrustum );
+
+	float const* cx = aCenters.x.data();
+	float const* cy = aCenters.y.data();
+	float const* cz = aCenters.z.data();
+	float const* ex = aHalfExtents.x.data();
+	float const* ey = aHalfExtents.y.data();
+	float const* ez = aHalfExtents.z.data();
+
+	std::size_t visible = 0;
+	std::size_t i = 0;
+	for( ; i + kWidth_ <= count; i += kWidth_ )
+	{
+		auto const x = simd::load8( cx + i );
+		auto const y = simd::load8( cy + i );
+		auto const z = simd::load8( cz + i );
+		auto const hx = simd::load8( ex + i );
+		auto const hy = simd::load8( ey + i );
+		auto const hz = simd::load8( ez + i );
+
+		// Box is outside a plane if even its corner furthest along the plane
+		// normal (center + radius along the normal) is behind the plane.
+		FloatN_ outside = 0.f;
+		for( auto const& p : planes )
+		{
+			auto const dist = p.nx * x + p.ny * y + p.nz * z + p.d;
+			auto const radius = p.ax * hx + p.ay * hy + p.az * hz;
+			outside = outside | (dist < -radius);
+		}
+
+		visible += store_flags_( aVisible.data() + i, outside );
+	}
+
+	for( ; i < count; ++i )
+	{
+		Vec3f const c = aCenters.get( i );
+		Vec3f const e = aHalfExtents.get( i );
+
+		bool vis = true;
+		for( auto const& plane : aFrustum.planes )
+		{
+			if( distance_( plane, c ) < -box_radius_( plane, e ) )
+			{
+				vis = false;
+				break;
+			}
+		}
+
+		aVisible[i] = vis ? 1 : 0;
+		visible += vis;
+	}
+
+	return visible;
+}
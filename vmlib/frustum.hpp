@@ -0,0 +1,64 @@
+#ifndef FRUSTUM_HPP_9B6E2D47_1F3A_4C8E_B0D5_7E4A19C2F683
+#define FRUSTUM_HPP_9B6E2D47_1F3A_4C8E_B0D5_7E4A19C2F683
+
+#include <span>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+#include "vec3.hpp"
+#include "aabb.hpp"
+#include "soa.hpp"
+#include "mat44.hpp"
+
+/** Plane: points p with dot( normal, p ) + offset == 0
+ *
+ * The normal points towards the "inside"; dot( normal, p ) + offset is the
+ * signed distance of p when the normal is unit length.
+ */
+struct Plane
+{
+	Vec3f normal;
+	float offset;
+};
+
+/** Frustum: six planes bounding the visible volume of a view
+ *
+ * Built from the combined projection and view matrix, i.e.,
+ *   make_frustum( proj * view )
+ * for a projection from make_perspective_projection() (OpenGL clip space,
+ * -w <= z <= w). The planes are then in world space; using proj * view * model
+ * instead gives planes in the model's local space.
+ *
+ * The tests below are conservative: they never reject anything that is
+ * (partially) visible, but may accept some objects that are just outside,
+ * near the frustum's edges and corners.
+ */
+struct Frustum
+{
+	enum PlaneIndex : std::size_t
+	{
+		kLeft, kRight, kBottom, kTop, kNear, kFar,
+		kPlaneCount
+	};
+
+	std::array<Plane,kPlaneCount> planes;
+};
+
+Frustum make_frustum( Mat44f const& aProjView ) noexcept;
+
+// Single-object tests
+bool is_visible( Frustum const& aFrustum, Vec3f aCenter, float aRadius ) noexcept;
+bool is_visible( Frustum const& aFrustum, Aabb3f const& aBox ) noexcept;
+
+// Batch tests. These process eight objects per iteration where possible (see
+// simd::Float8). aVisible[i] is set to 1 if object i is potentially visible
+// and to 0 otherwise; aVisible must hold at least aCenters.size() elements.
+// Both return the number of potentially visible objects.
+//
+// Boxes are given as centers and half extents (see center() and
+// half_extent() in aabb.hpp).
+std::size_t batch_test_spheres( Frustum const& aFrustum, Vec3fSoA const& aCenters, std::span<float const> aRadii, std::span<std::uint8_t> aVisible ) noexcept;
+std::size_t batch_test_boxes( Frustum const& aFrustum, Vec3fSoA const& aCenters, Vec3fSoA const& aHalfExtents, std::span<std::uint8_t> aVisible ) noexcept;
+
+#endif // FRUSTUM_HPP_9B6E2D47_1F3A_4C8E_B0D5_7E4A19C2F683
@@ -0,0 +1,219 @@
+#include "jpeg_strips.hpp"
+
+#include <numeric>
+#include <algorithm>
+
+namespace
+{
+	constexpr std::uint8_t kSoi_ = 0xD8;
+	constexpr std::uint8_t kEoi_ = 0xD9;
+	constexpr std::uint8_t kSos_ = 0xDA;
+	constexpr std::uint8_t kDri_ = 0xDD;
+	constexpr std::uint8_t kRst0_ = 0xD0;
+
+	constexpr std::size_t kNoFrame_ = ~std::size_t(0);
+
+	std::uint32_t read_u16_( std::uint8_t const* aBytes ) noexcept
+	{
+		return (std::uint32_t(aBytes[0]) << 8) | aBytes[1];
+	}
+
+	bool is_restart_( std::uint8_t aMarker ) noexcept
+	{
+		return aMarker >= kRst0_ && aMarker <= kRst0_ + 7;
+	}
+
+	// Baseline (SOF0) and extended sequential Huffman (SOF1) frames; the
+	// other SOFn are progressive, lossless or arithmetic-coded. C4, C8 and
+	// CC are not frames (DHT, JPG and DAC).
+	bool is_sequential_frame_( std::uint8_t aMarker ) noexcept
+	{
+		return 0xC0 == aMarker || 0xC1 == aMarker;
+	}
+	bool is_other_frame_( std::uint8_t aMarker ) noexcept
+	{
+		return aMarker >= 0xC2 && aMarker <= 0xCF && 0xC4 != aMarker && 0xC8 != aMarker && 0xCC != aMarker;
+	}
+
+	// A marker segment: the marker, its length and its payload.
+	struct Segment_
+	{
+		std::uint8_t marker;
+		std::size_t begin, end;
+	};
+}
+
+std::vector<JpegStrip> split_jpeg( std::span<std::uint8_t const> aJpeg, std::size_t aMaxStrips )
+{
+	std::uint8_t const* const data = aJpeg.data();
+	std::size_t const size = aJpeg.size();
+	if( size < 4 || 0xFF != data[0] || kSoi_ != data[1] )
+		return {};
+
+	// Headers, up to and including the SOS segment.
+	std::vector<Segment_> headers;
+	std::size_t frame = kNoFrame_;
+	std::uint32_t width = 0, height = 0, components = 0, mcuWidth = 8, mcuHeight = 8, restartInterval = 0;
+
+	std::size_t pos = 2;
+	for( ;; )
+	{
+		// A marker may be preceded by fill bytes (0xFF).
+		while( pos + 1 < size && 0xFF == data[pos] && 0xFF == data[pos+1] )
+			++pos;
+		if( pos + 4 > size || 0xFF != data[pos] )
+			return {};
+
+		std::uint8_t const marker = data[pos+1];
+		std::size_t const length = read_u16_( data + pos + 2 );
+		if( length < 2 || size - pos - 2 < length || kEoi_ == marker || is_other_frame_( marker ) )
+			return {};
+
+		Segment_ const segment{ marker, pos, pos + 2 + length };
+		std::uint8_t const* const payload = data + pos + 4;
+
+		if( is_sequential_frame_( marker ) )
+		{
+			if( length < 8 || kNoFrame_ != frame )
+				return {};
+
+			height = read_u16_( payload + 1 );
+			width = read_u16_( payload + 3 );
+			components = payload[5];
+			if( 8 != payload[0] || 0 == width || 0 == height || 0 == components || length < 8 + 3 * components )
+				return {}; // a height of zero is given later, in a DNL segment
+
+			// Interleaved MCUs cover the largest sampling factors; a single
+			// component is coded in 8x8 blocks whatever its factors.
+			if( components > 1 )
+			{
+				std::uint32_t maxH = 1, maxV = 1;
+				for( std::uint32_t i = 0; i < components; ++i )
+				{
+					maxH = std::max<std::uint32_t>( maxH, payload[6 + 3*i + 1] >> 4 );
+					maxV = std::max<std::uint32_t>( maxV, payload[6 + 3*i + 1] & 15 );
+				}
+				mcuWidth = 8 * maxH;
+				mcuHeight = 8 * maxV;
+			}
+
+			frame = headers.size();
+		}
+		else if( kDri_ == marker )
+		{
+			if( length < 4 )
+				return {};
+			restartInterval = read_u16_( payload );
+		}
+
+		headers.emplace_back( segment );
+		pos = segment.end;
+
+		if( kSos_ == marker )
+		{
+			// All components in this one scan.
+			if( kNoFrame_ == frame || length < 3 || payload[0] != components )
+				return {};
+			break;
+		}
+	}
+
+	if( 0 == restartInterval )
+		return {};
+
+	// The restart intervals, up to the end of the scan, which must be the
+	// end of the image.
+	std::vector<std::size_t> intervalBegin{ pos }, intervalEnd;
+	for( std::size_t i = pos; ; ++i )
+	{
+		if( i + 1 >= size )
+			return {};
+		if( 0xFF != data[i] )
+			continue;
+
+		std::uint8_t const next = data[i+1];
+		if( 0x00 == next || 0xFF == next )
+		{
+			i += (0x00 == next); // stuffed zero, or a fill byte
+			continue;
+		}
+
+		intervalEnd.emplace_back( i );
+		if( !is_restart_( next ) )
+		{
+			if( kEoi_ != next )
+				return {};
+			break;
+		}
+
+		intervalBegin.emplace_back( i + 2 );
+		++i;
+	}
+
+	std::size_t const mcuColumns = (width + mcuWidth - 1) / mcuWidth;
+	std::size_t const mcuRows = (height + mcuHeight - 1) / mcuHeight;
+	std::size_t const intervals = intervalBegin.size();
+	if( intervals != (mcuColumns * mcuRows + restartInterval - 1) / restartInterval )
+		return {};
+
+	// Intervals start at the beginning of every alignedRows-th MCU row.
+	std::size_t const alignedRows = restartInterval / std::gcd( std::size_t(restartInterval), mcuColumns );
+	std::size_t const units = (mcuRows + alignedRows - 1) / alignedRows;
+	std::size_t const strips = std::min( units, aMaxStrips );
+	if( strips < 2 )
+		return {};
+
+	auto const boundary = [&] ( std::size_t aStrip ) {
+		return std::min( mcuRows, units * aStrip / strips * alignedRows );
+	};
+	auto const interval = [&] ( std::size_t aMcuRow ) {
+		return aMcuRow >= mcuRows ? intervals : aMcuRow * mcuColumns / restartInterval;
+	};
+
+	std::vector<JpegStrip> ret( strips );
+	for( std::size_t s = 0; s < strips; ++s )
+	{
+		std::size_t const first = boundary( s ), last = boundary( s+1 );
+
+		// The strip's rows of MCUs, with one aligned unit of context above
+		// and below.
+		std::size_t const decodeFirst = first > 0 ? first - alignedRows : 0;
+		std::size_t const decodeLast = std::min( mcuRows, last + alignedRows );
+
+		auto const pixelRow = [&] ( std::size_t aMcuRow ) {
+			return static_cast<std::uint32_t>( std::min<std::size_t>( height, aMcuRow * mcuHeight ) );
+		};
+
+		auto& strip = ret[s];
+		strip.firstRow = pixelRow( first );
+		strip.rowCount = pixelRow( last ) - strip.firstRow;
+		strip.skipRows = strip.firstRow - pixelRow( decodeFirst );
+
+		std::uint32_t const stripHeight = pixelRow( decodeLast ) - pixelRow( decodeFirst );
+
+		auto& out = strip.jpeg;
+		out.reserve( intervalEnd[interval( decodeLast ) - 1] - intervalBegin[interval( decodeFirst )] + pos + 16 );
+		out.insert( out.end(), { 0xFF, kSoi_ } );
+		for( std::size_t h = 0; h < headers.size(); ++h )
+		{
+			auto const begin = out.size();
+			out.insert( out.end(), data + headers[h].begin, data + headers[h].end );
+			if( frame == h )
+			{
+				out[begin + 5] = std::uint8_t( stripHeight >> 8 );
+				out[begin + 6] = std::uint8_t( stripHeight );
+			}
+		}
+
+		// Restart markers are renumbered from RST0.
+		for( std::size_t i = interval( decodeFirst ); i < interval( decodeLast ); ++i )
+		{
+			if( i != interval( decodeFirst ) )
+				out.insert( out.end(), { 0xFF, std::uint8_t( kRst0_ + (i - interval( decodeFirst ) - 1) % 8 ) } );
+			out.insert( out.end(), data + intervalBegin[i], data + intervalEnd[i] );
+		}
+		out.insert( out.end(), { 0xFF, kEoi_ } );
+	}
+
+	return ret;
+}
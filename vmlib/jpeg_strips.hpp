@@ -0,0 +1,47 @@
+#ifndef JPEG_STRIPS_HPP_E81B4D07_6C2A_4F95_93D8_0A7F25C6B1E4
+#define JPEG_STRIPS_HPP_E81B4D07_6C2A_4F95_93D8_0A7F25C6B1E4
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/** Splitting baseline JPEGs into strips that decode independently
+ *
+ * A JPEG's entropy-coded data decodes only from its start, except at
+ * restart markers (RSTn). These reset the decoder, so each restart interval
+ * (the data between two markers) decodes on its own. If intervals end at the
+ * end of a row of MCUs (the 8x8 to 16x16 pixel units of the image), a band
+ * of MCU rows can be cut out as a JPEG of its own: the original headers,
+ * with the height changed, and the band's restart intervals. Decoding the
+ * strips on several threads and copying their rows into place then decodes
+ * the image in parallel.
+ *
+ * Chroma upsampling blends neighbouring rows, so a strip also carries the
+ * restart-aligned MCU rows just above and below it (where there are any),
+ * and their pixels are discarded. Decoding the strips thus gives the same
+ * pixels as decoding the whole image.
+ *
+ * split_jpeg() returns no strips if the image cannot be split: if it is not
+ * a single-scan baseline JPEG (e.g., it is progressive), if it has no
+ * restart markers, or if its intervals end on an MCU row too rarely for two
+ * strips. Encoders add restart markers on request, e.g., with
+ * `cjpeg -restart 1` (one interval per MCU row).
+ */
+struct JpegStrip
+{
+	std::vector<std::uint8_t> jpeg; // a complete JPEG
+
+	// Rows of the decoded strip: skipRows rows at the top belong to the
+	// strip above, then come the strip's own rowCount rows, which are rows
+	// firstRow onwards of the image. Rows below them belong to the strip
+	// below.
+	std::uint32_t skipRows;
+	std::uint32_t rowCount;
+	std::uint32_t firstRow;
+};
+
+// At most aMaxStrips strips, top to bottom, of (nearly) equal height.
+std::vector<JpegStrip> split_jpeg( std::span<std::uint8_t const> aJpeg, std::size_t aMaxStrips );
+
+#endif // JPEG_STRIPS_HPP_E81B4D07_6C2A_4F95_93D8_0A7F25C6B1E4
@@ -0,0 +1,57 @@
+#ifndef LOD_HPP_47C19E2B_8F3D_4A65_B0D7_6E2A91F4C38B
+#define LOD_HPP_47C19E2B_8F3D_4A65_B0D7_6E2A91F4C38B
+
+#include <span>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+/** MeshLod: one level of detail of a mesh (or of a part of one)
+ *
+ * A level is a range of the mesh's index buffer; all levels of a mesh share
+ * its vertex buffer. The error is the level's geometric deviation from the
+ * full-detail mesh, in model units. Levels are ordered from fine to coarse,
+ * and their errors do not decrease.
+ *
+ * Levels are built by build_chunk_lods() (terrain chunks, vertex clustering)
+ * and build_lod_chain() (whole meshes, quadric error simplification).
+ */
+struct MeshLod
+{
+	std::uint32_t firstIndex;
+	std::uint32_t indexCount;
+	float error;
+};
+
+constexpr std::size_t kMaxLodLevels = 8;
+
+// Screen-space scale of a perspective projection: the size in pixels of one
+// world unit at distance one.
+inline
+float lod_pixels_per_unit( float aViewportHeight, float aFovY ) noexcept
+{
+	return aViewportHeight / (2.f * std::tan( 0.5f * aFovY ));
+}
+
+// Coarsest level in aLevels whose error, seen at aDistance, covers at most
+// aMaxPixelError pixels. Scale aPixelsPerUnit by the model's scale factor if
+// the errors are in a scaled model space.
+inline
+std::size_t select_lod( std::span<MeshLod const> aLevels, float aDistance, float aPixelsPerUnit, float aMaxPixelError ) noexcept
+{
+	// error * aPixelsPerUnit / aDistance <= aMaxPixelError, without the
+	// division (aDistance may be zero).
+	float const budget = aMaxPixelError * std::max( aDistance, 0.f );
+
+	std::size_t ret = 0;
+	for( std::size_t level = 1; level < aLevels.size(); ++level )
+	{
+		if( aLevels[level].error * aPixelsPerUnit > budget )
+			break;
+		ret = level;
+	}
+	return ret;
+}
+
+#endif // LOD_HPP_47C19E2B_8F3D_4A65_B0D7_6E2A91F4C38B
@@ -0,0 +1,238 @@
+#ifndef MAT34_HPP_3D0C6B52_9A41_4F7E_8E15_52C1A7F0B6D9
+#define MAT34_HPP_3D0C6B52_9A41_4F7E_8E15_52C1A7F0B6D9
+
+#include <cmath>
+#include <cassert>
+#include <cstdlib>
+
+#include "vec3.hpp"
+#include "mat33.hpp"
+#include "mat44.hpp"
+
+/** Mat34f: 3x4 affine transformation with floats
+ *
+ * An affine transformation is a Mat44f whose last row is always (0, 0, 0, 1).
+ * Mat34f stores only the first three rows (48 bytes instead of 64), i.e., the
+ * linear 3x3 part and the translation column:
+ *
+ *   ⎛ 0,0  0,1  0,2  0,3 ⎞
+ *   ⎜ 1,0  1,1  1,2  1,3 ⎟
+ *   ⎝ 2,0  2,1  2,2  2,3 ⎠
+ *
+ * The matrix is stored in row-major order, like Mat44f. Model matrices built
+ * from translations, rotations and scalings, and view matrices (but not
+ * projections!) fit into a Mat34f.
+ *
+ * Composing two Mat34f takes 36 multiplications (vs 64 for Mat44f). Inverses
+ * are cheap as well: invert_rigid() for rotation + translation only, and
+ * invert_affine() for anything else.
+ */
+struct Mat34f
+{
+	float v[12];
+
+	constexpr
+	float& operator[] (std::size_t aI, std::size_t aJ) noexcept
+	{
+		assert( aI < 3 && aJ < 4 );
+		return v[aI*4 + aJ];
+	}
+	constexpr
+	float const& operator[] (std::size_t aI, std::size_t aJ) const noexcept
+	{
+		assert( aI < 3 && aJ < 4 );
+		return v[aI*4 + aJ];
+	}
+};
+
+static_assert( sizeof(Mat34f) == 48 );
+
+// Identity matrix
+constexpr Mat34f kIdentity34f = { {
+	1.f, 0.f, 0.f, 0.f,
+	0.f, 1.f, 0.f, 0.f,
+	0.f, 0.f, 1.f, 0.f
+} };
+
+// Common operators for Mat34f.
+//
+// The implicit fourth row (0, 0, 0, 1) only ever contributes the translation
+// column of the left operand, so the product needs 3x3x4 = 36 multiplications.
+
+constexpr
+Mat34f operator*( Mat34f const& aLeft, Mat34f const& aRight ) noexcept
+{
+	Mat34f ret{};
+	for( std::size_t i = 0; i < 3; ++i )
+	{
+		for( std::size_t j = 0; j < 4; ++j )
+		{
+			ret[i,j] = aLeft[i,0] * aRight[0,j]
+				+ aLeft[i,1] * aRight[1,j]
+				+ aLeft[i,2] * aRight[2,j];
+		}
+		ret[i,3] += aLeft[i,3];
+	}
+	return ret;
+}
+
+constexpr
+Mat34f& operator*=( Mat34f& aLeft, Mat34f const& aRight ) noexcept
+{
+	aLeft = aLeft * aRight;
+	return aLeft;
+}
+
+// Functions:
+
+/* Transform a point (implicit w = 1) or a direction (implicit w = 0).
+ */
+constexpr
+Vec3f transform_point( Mat34f const& aM, Vec3f const& aP ) noexcept
+{
+	return Vec3f{
+		aM[0,0] * aP.x + aM[0,1] * aP.y + aM[0,2] * aP.z + aM[0,3],
+		aM[1,0] * aP.x + aM[1,1] * aP.y + aM[1,2] * aP.z + aM[1,3],
+		aM[2,0] * aP.x + aM[2,1] * aP.y + aM[2,2] * aP.z + aM[2,3]
+	};
+}
+constexpr
+Vec3f transform_direction( Mat34f const& aM, Vec3f const& aD ) noexcept
+{
+	return Vec3f{
+		aM[0,0] * aD.x + aM[0,1] * aD.y + aM[0,2] * aD.z,
+		aM[1,0] * aD.x + aM[1,1] * aD.y + aM[1,2] * aD.z,
+		aM[2,0] * aD.x + aM[2,1] * aD.y + aM[2,2] * aD.z
+	};
+}
+
+constexpr
+Mat34f make_affine( Mat33f const& aLinear, Vec3f aTranslation ) noexcept
+{
+	return Mat34f{ {
+		aLinear[0,0], aLinear[0,1], aLinear[0,2], aTranslation.x,
+		aLinear[1,0], aLinear[1,1], aLinear[1,2], aTranslation.y,
+		aLinear[2,0], aLinear[2,1], aLinear[2,2], aTranslation.z
+	} };
+}
+
+constexpr
+Mat33f linear_part( Mat34f const& aM ) noexcept
+{
+	return Mat33f{ {
+		aM[0,0], aM[0,1], aM[0,2],
+		aM[1,0], aM[1,1], aM[1,2],
+		aM[2,0], aM[2,1], aM[2,2]
+	} };
+}
+constexpr
+Vec3f translation_part( Mat34f const& aM ) noexcept
+{
+	return Vec3f{ aM[0,3], aM[1,3], aM[2,3] };
+}
+
+/* Conversions. to_mat34() drops the last row, which must be (0, 0, 0, 1).
+ */
+constexpr
+Mat44f to_mat44( Mat34f const& aM ) noexcept
+{
+	return Mat44f{ {
+		aM[0,0], aM[0,1], aM[0,2], aM[0,3],
+		aM[1,0], aM[1,1], aM[1,2], aM[1,3],
+		aM[2,0], aM[2,1], aM[2,2], aM[2,3],
+		0.f, 0.f, 0.f, 1.f
+	} };
+}
+constexpr
+Mat34f to_mat34( Mat44f const& aM ) noexcept
+{
+	assert( (aM[3,0] == 0.f && aM[3,1] == 0.f && aM[3,2] == 0.f && aM[3,3] == 1.f) );
+	return Mat34f{ {
+		aM[0,0], aM[0,1], aM[0,2], aM[0,3],
+		aM[1,0], aM[1,1], aM[1,2], aM[1,3],
+		aM[2,0], aM[2,1], aM[2,2], aM[2,3]
+	} };
+}
+
+/* Inverse of a rigid-body transformation (rotation and translation only). The
+ * inverse rotation is the transpose; no division is required. The result is
+ * meaningless if the linear part is not orthonormal.
+ */
+constexpr
+Mat34f invert_rigid( Mat34f const& aM ) noexcept
+{
+	Mat34f ret{};
+	for( std::size_t i = 0; i < 3; ++i )
+	{
+		for( std::size_t j = 0; j < 3; ++j )
+			ret[i,j] = aM[j,i];
+
+		ret[i,3] = -(aM[0,i] * aM[0,3] + aM[1,i] * aM[1,3] + aM[2,i] * aM[2,3]);
+	}
+	return ret;
+}
+
+namespace detail
+{
+	// Cofactor matrix of the linear part. Its transpose is the adjugate.
+	constexpr
+	Mat33f cofactors_( Mat34f const& aM ) noexcept
+	{
+		return Mat33f{ {
+			aM[1,1] * aM[2,2] - aM[1,2] * aM[2,1],
+			aM[1,2] * aM[2,0] - aM[1,0] * aM[2,2],
+			aM[1,0] * aM[2,1] - aM[1,1] * aM[2,0],
+
+			aM[0,2] * aM[2,1] - aM[0,1] * aM[2,2],
+			aM[0,0] * aM[2,2] - aM[0,2] * aM[2,0],
+			aM[0,1] * aM[2,0] - aM[0,0] * aM[2,1],
+
+			aM[0,1] * aM[1,2] - aM[0,2] * aM[1,1],
+			aM[0,2] * aM[1,0] - aM[0,0] * aM[1,2],
+			aM[0,0] * aM[1,1] - aM[0,1] * aM[1,0]
+		} };
+	}
+}
+
+/* Inverse of a general affine transformation. The linear part is inverted via
+ * its adjugate; the translation is then -A^-1 t. The linear part must not be
+ * singular (asserted in debug builds).
+ */
+constexpr
+Mat34f invert_affine( Mat34f const& aM ) noexcept
+{
+	auto const cof = detail::cofactors_( aM );
+	float const det = aM[0,0] * cof[0,0] + aM[0,1] * cof[0,1] + aM[0,2] * cof[0,2];
+	assert( det != 0.f );
+
+	float const invDet = 1.f / det;
+
+	Mat34f ret{};
+	for( std::size_t i = 0; i < 3; ++i )
+	{
+		for( std::size_t j = 0; j < 3; ++j )
+			ret[i,j] = cof[j,i] * invDet;
+
+		ret[i,3] = -(ret[i,0] * aM[0,3] + ret[i,1] * aM[1,3] + ret[i,2] * aM[2,3]);
+	}
+	return ret;
+}
+
+/* Normal matrix: transforms normals consistently with the points transformed
+ * by aM, i.e., the inverse transpose of the linear part. The result is not
+ * normalized; for rigid transformations it equals linear_part( aM ).
+ */
+constexpr
+Mat33f make_normal_matrix( Mat34f const& aM ) noexcept
+{
+	auto cof = detail::cofactors_( aM );
+	float const det = aM[0,0] * cof[0,0] + aM[0,1] * cof[0,1] + aM[0,2] * cof[0,2];
+	assert( det != 0.f );
+
+	float const invDet = 1.f / det;
+	for( auto& c : cof.v )
+		c *= invDet;
+	return cof;
+}
+
+#endif // MAT34_HPP_3D0C6B52_9A41_4F7E_8E15_52C1A7F0B6D9
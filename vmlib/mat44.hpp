@@ -2,10 +2,12 @@
 #define MAT44_HPP_E7187A26_469E_48AD_A3D2_63150F05A4CA
 // SOLUTION_TAGS: gl-(ex-[^12]|cw-2|resit)
 
+#include <bit>
 #include <cmath>
 #include <cassert>
 #include <cstdlib>
 
+#include "simd.hpp"
 #include "vec3.hpp"
 #include "vec4.hpp"
 
@@ -14,7 +16,8 @@
  * See vec2f.hpp for discussion. Similar to the implementation, the Mat44f is
  * intentionally kept simple and somewhat bare bones.
  *
- * The matrix is stored in row-major order (careful when passing it to OpenGL).
+ * The matrix is stored in row-major order (careful when passing it to OpenGL;
+ * see Mat44fGl below).
  *
  * The overloaded operator [] allows access to individual elements. Example:
  *    Mat44f m = ...;
@@ -56,54 +59,249 @@ constexpr Mat44f kIdentity44f = { {
 	0.f, 0.f, 0.f, 1.f
 } };
 
+// Scalar reference implementations.
+//
+// The operators below dispatch to SIMD versions when those are available (see
+// simd.hpp), and to these scalar versions otherwise and during constant
+// evaluation. The scalar versions stay available so that tests and benchmarks
+// can compare both paths.
+namespace detail
+{
+	constexpr
+	Mat44f mul_scalar( Mat44f const& aLeft, Mat44f const& aRight ) noexcept
+	{
+		Mat44f ret{};
+		for( std::size_t i = 0; i < 4; ++i )
+		{
+			for( std::size_t j = 0; j < 4; ++j )
+			{
+				float sum = 0.f;
+				for( std::size_t k = 0; k < 4; ++k )
+					sum += aLeft[i,k] * aRight[k,j];
+				ret[i,j] = sum;
+			}
+		}
+		return ret;
+	}
+
+	constexpr
+	Vec4f mul_scalar( Mat44f const& aLeft, Vec4f const& aRight ) noexcept
+	{
+		Vec4f ret{};
+		for( std::size_t i = 0; i < 4; ++i )
+		{
+			float sum = 0.f;
+			for( std::size_t j = 0; j < 4; ++j )
+				sum += aLeft[i,j] * aRight[j];
+			ret[i] = sum;
+		}
+		return ret;
+	}
+
+	constexpr
+	Mat44f transpose_scalar( Mat44f const& aM ) noexcept
+	{
+		Mat44f ret{};
+		for( std::size_t i = 0; i < 4; ++i )
+		{
+			for( std::size_t j = 0; j < 4; ++j )
+				ret[j,i] = aM[i,j];
+		}
+		return ret;
+	}
+
+	Mat44f invert_scalar( Mat44f const& aM ) noexcept;
+
+#	if defined(VMLIB_SIMD_SSE)
+	// SIMD versions. Rows are loaded directly, as Mat44f is row-major. The
+	// results match the scalar versions up to rounding (the order of some
+	// additions differs).
+	inline
+	Mat44f mul_simd( Mat44f const& aLeft, Mat44f const& aRight ) noexcept
+	{
+		Mat44f ret;
+#		if defined(VMLIB_SIMD_AVX)
+		// Two rows of the result per iteration: each 128-bit lane of the
+		// 256-bit register holds one row.
+		__m256 const b0 = _mm256_broadcast_ps( reinterpret_cast<__m128 const*>( aRight.v + 0 ) );
+		__m256 const b1 = _mm256_broadcast_ps( reinterpret_cast<__m128 const*>( aRight.v + 4 ) );
+		__m256 const b2 = _mm256_broadcast_ps( reinterpret_cast<__m128 const*>( aRight.v + 8 ) );
+		__m256 const b3 = _mm256_broadcast_ps( reinterpret_cast<__m128 const*>( aRight.v + 12 ) );
+		for( std::size_t i = 0; i < 16; i += 8 )
+		{
+			__m256 const a = _mm256_loadu_ps( aLeft.v + i );
+			__m256 r = _mm256_mul_ps( _mm256_shuffle_ps( a, a, 0x00 ), b0 );
+			r = _mm256_add_ps( r, _mm256_mul_ps( _mm256_shuffle_ps( a, a, 0x55 ), b1 ) );
+			r = _mm256_add_ps( r, _mm256_mul_ps( _mm256_shuffle_ps( a, a, 0xaa ), b2 ) );
+			r = _mm256_add_ps( r, _mm256_mul_ps( _mm256_shuffle_ps( a, a, 0xff ), b3 ) );
+			_mm256_storeu_ps( ret.v + i, r );
+		}
+#		else // SSE
+		__m128 const b0 = _mm_loadu_ps( aRight.v + 0 );
+		__m128 const b1 = _mm_loadu_ps( aRight.v + 4 );
+		__m128 const b2 = _mm_loadu_ps( aRight.v + 8 );
+		__m128 const b3 = _mm_loadu_ps( aRight.v + 12 );
+		for( std::size_t i = 0; i < 16; i += 4 )
+		{
+			__m128 const a = _mm_loadu_ps( aLeft.v + i );
+			__m128 r = _mm_mul_ps( _mm_shuffle_ps( a, a, 0x00 ), b0 );
+			r = _mm_add_ps( r, _mm_mul_ps( _mm_shuffle_ps( a, a, 0x55 ), b1 ) );
+			r = _mm_add_ps( r, _mm_mul_ps( _mm_shuffle_ps( a, a, 0xaa ), b2 ) );
+			r = _mm_add_ps( r, _mm_mul_ps( _mm_shuffle_ps( a, a, 0xff ), b3 ) );
+			_mm_storeu_ps( ret.v + i, r );
+		}
+#		endif
+		return ret;
+	}
+
+	inline
+	Vec4f mul_simd( Mat44f const& aLeft, Vec4f const& aRight ) noexcept
+	{
+		__m128 const v = _mm_loadu_ps( &aRight.x );
+		__m128 r0 = _mm_mul_ps( _mm_loadu_ps( aLeft.v + 0 ), v );
+		__m128 r1 = _mm_mul_ps( _mm_loadu_ps( aLeft.v + 4 ), v );
+		__m128 r2 = _mm_mul_ps( _mm_loadu_ps( aLeft.v + 8 ), v );
+		__m128 r3 = _mm_mul_ps( _mm_loadu_ps( aLeft.v + 12 ), v );
+
+		// Horizontal sums of all four rows at once
+		_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+		__m128 const sum = _mm_add_ps( _mm_add_ps( r0, r1 ), _mm_add_ps( r2, r3 ) );
+
+		Vec4f ret;
+		_mm_storeu_ps( &ret.x, sum );
+		return ret;
+	}
+
+	inline
+	Mat44f transpose_simd( Mat44f const& aM ) noexcept
+	{
+		__m128 r0 = _mm_loadu_ps( aM.v + 0 );
+		__m128 r1 = _mm_loadu_ps( aM.v + 4 );
+		__m128 r2 = _mm_loadu_ps( aM.v + 8 );
+		__m128 r3 = _mm_loadu_ps( aM.v + 12 );
+		_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+
+		Mat44f ret;
+		_mm_storeu_ps( ret.v + 0, r0 );
+		_mm_storeu_ps( ret.v + 4, r1 );
+		_mm_storeu_ps( ret.v + 8, r2 );
+		_mm_storeu_ps( ret.v + 12, r3 );
+		return ret;
+	}
+
+	Mat44f invert_simd( Mat44f const& aM ) noexcept;
+#	endif // ~ VMLIB_SIMD_SSE
+}
+
 // Common operators for Mat44f.
-// Note that you will need to implement these yourself.
 
 constexpr
 Mat44f operator*( Mat44f const& aLeft, Mat44f const& aRight ) noexcept
 {
-	Mat44f ret{};
-	for( std::size_t i = 0; i < 4; ++i )
+	if consteval
 	{
-		for( std::size_t j = 0; j < 4; ++j )
-		{
-			float sum = 0.f;
-			for( std::size_t k = 0; k < 4; ++k )
-				sum += aLeft[i,k] * aRight[k,j];
-			ret[i,j] = sum;
-		}
+		return detail::mul_scalar( aLeft, aRight );
+	}
+	else
+	{
+#		if defined(VMLIB_SIMD_SSE)
+		return detail::mul_simd( aLeft, aRight );
+#		else
+		return detail::mul_scalar( aLeft, aRight );
+#		endif
 	}
-	return ret;
 }
 
 constexpr
 Vec4f operator*( Mat44f const& aLeft, Vec4f const& aRight ) noexcept
 {
-	Vec4f ret{};
-	for( std::size_t i = 0; i < 4; ++i )
+	if consteval
 	{
-		float sum = 0.f;
-		for( std::size_t j = 0; j < 4; ++j )
-			sum += aLeft[i,j] * aRight[j];
-		ret[i] = sum;
+		return detail::mul_scalar( aLeft, aRight );
+	}
+	else
+	{
+#		if defined(VMLIB_SIMD_SSE)
+		return detail::mul_simd( aLeft, aRight );
+#		else
+		return detail::mul_scalar( aLeft, aRight );
+#		endif
 	}
-	return ret;
 }
 
 // Functions:
 
 Mat44f invert( Mat44f const& aM ) noexcept;
 
-inline
+constexpr
 Mat44f transpose( Mat44f const& aM ) noexcept
 {
-	Mat44f ret;
-	for( std::size_t i = 0; i < 4; ++i )
+	if consteval
 	{
-		for( std::size_t j = 0; j < 4; ++j )
-			ret[j,i] = aM[i,j];
+		return detail::transpose_scalar( aM );
 	}
-	return ret;
+	else
+	{
+#		if defined(VMLIB_SIMD_SSE)
+		return detail::transpose_simd( aM );
+#		else
+		return detail::transpose_scalar( aM );
+#		endif
+	}
+}
+
+/** Mat44fGl: 4x4 matrix in OpenGL layout
+ *
+ * Holds the same matrix as a Mat44f, but stores the elements in column-major
+ * order, i.e., the order that glUniformMatrix4fv() expects with transpose set
+ * to GL_FALSE. Convert with to_gl() when a matrix changes, and keep the result
+ * around; data() can then be handed to OpenGL directly at draw time.
+ *
+ * Element access uses the same (row, column) convention as Mat44f, so that
+ *    to_gl( m )[i,j] == m[i,j]
+ */
+struct Mat44fGl
+{
+	float v[16];
+
+	constexpr
+	float& operator[] (std::size_t aI, std::size_t aJ) noexcept
+	{
+		assert( aI < 4 && aJ < 4 );
+		return v[aJ*4 + aI];
+	}
+	constexpr
+	float const& operator[] (std::size_t aI, std::size_t aJ) const noexcept
+	{
+		assert( aI < 4 && aJ < 4 );
+		return v[aJ*4 + aI];
+	}
+
+	constexpr
+	float const* data() const noexcept
+	{
+		return v;
+	}
+};
+
+static_assert( sizeof(Mat44fGl) == sizeof(Mat44f) );
+
+constexpr Mat44fGl kIdentity44fGl = { {
+	1.f, 0.f, 0.f, 0.f,
+	0.f, 1.f, 0.f, 0.f,
+	0.f, 0.f, 1.f, 0.f,
+	0.f, 0.f, 0.f, 1.f
+} };
+
+constexpr
+Mat44fGl to_gl( Mat44f const& aM ) noexcept
+{
+	return std::bit_cast<Mat44fGl>( transpose( aM ) );
+}
+constexpr
+Mat44f from_gl( Mat44fGl const& aM ) noexcept
+{
+	return transpose( std::bit_cast<Mat44f>( aM ) );
 }
 
 inline
@@ -149,7 +347,7 @@ Mat44f make_rotation_z( float aAngle ) noexcept
 	return ret;
 }
 
-inline
+constexpr
 Mat44f make_translation( Vec3f aTranslation ) noexcept
 {
 	Mat44f ret = kIdentity44f;
@@ -158,15 +356,14 @@ Mat44f make_translation( Vec3f aTranslation ) noexcept
 	ret[2,3] = aTranslation.z;
 	return ret;
 }
-inline
+constexpr
 Mat44f make_scaling( float aSX, float aSY, float aSZ ) noexcept
 {
-	//TODO: your implementation goes here
-	//TODO: remove the following when you start your implementation
-	(void)aSX;  // Avoid warnings about unused arguments until the function
-	(void)aSY;  // is properly implemented.
-	(void)aSZ;
-	return kIdentity44f;
+	Mat44f ret = kIdentity44f;
+	ret[0,0] = aSX;
+	ret[1,1] = aSY;
+	ret[2,2] = aSZ;
+	return ret;
 }
 
 inline
@@ -0,0 +1,108 @@
+#include "mesh_chunks.hpp"
+
+#include <cmath>
+#include <limits>
+#include <cassert>
+#include <algorithm>
+
+namespace
+{
+	std::size_t cell_( float aX, float aMin, float aExtent, std::size_t aCells ) noexcept
+	{
+		if( !(aExtent > 0.f) )
+			return 0;
+
+		// Clamp, as the centroid of a triangle on the max edge may round to
+		// aCells.
+		float const cell = (aX - aMin) / aExtent * float(aCells);
+		return std::min( static_cast<std::size_t>( std::max( cell, 0.f ) ), aCells - 1 );
+	}
+}
+
+std::vector<MeshChunk> partition_mesh_chunks( std::span<std::uint32_t> aIndices, std::span<Vec3f const> aPositions, std::size_t aCellsX, std::size_t aCellsZ )
+{
+	assert( aIndices.size() % 3 == 0 );
+	assert( aCellsX > 0 && aCellsZ > 0 );
+	assert( aCellsX <= std::numeric_limits<std::uint16_t>::max() && aCellsZ <= std::numeric_limits<std::uint16_t>::max() );
+	assert( aIndices.size() <= std::numeric_limits<std::uint32_t>::max() );
+
+	std::size_t const triangles = aIndices.size() / 3;
+	std::size_t const cells = aCellsX * aCellsZ;
+
+	Aabb3f meshBounds = kEmptyAabb3f;
+	for( auto const index : aIndices )
+	{
+		assert( index < aPositions.size() );
+		expand( meshBounds, aPositions[index] );
+	}
+
+	float const extentX = meshBounds.max.x - meshBounds.min.x;
+	float const extentZ = meshBounds.max.z - meshBounds.min.z;
+
+	// Counting sort of the triangles by cell. The sort is stable, so that
+	// triangles keep their relative order.
+	std::vector<std::uint32_t> triangleCell( triangles );
+	std::vector<std::uint32_t> cellStart( cells + 1, 0 );
+	for( std::size_t t = 0; t < triangles; ++t )
+	{
+		Vec3f const a = aPositions[aIndices[3*t+0]];
+		Vec3f const b = aPositions[aIndices[3*t+1]];
+		Vec3f const c = aPositions[aIndices[3*t+2]];
+
+		float const cx = (a.x + b.x + c.x) * (1.f / 3.f);
+		float const cz = (a.z + b.z + c.z) * (1.f / 3.f);
+
+		auto const cell = cell_( cx, meshBounds.min.x, extentX, aCellsX ) + aCellsX * cell_( cz, meshBounds.min.z, extentZ, aCellsZ );
+		triangleCell[t] = static_cast<std::uint32_t>( cell );
+		++cellStart[cell + 1];
+	}
+
+	for( std::size_t i = 0; i < cells; ++i )
+		cellStart[i+1] += cellStart[i];
+
+	std::vector<std::uint32_t> const source( aIndices.begin(), aIndices.end() );
+	std::vector<std::uint32_t> fill( cellStart.begin(), cellStart.end() - 1 );
+	for( std::size_t t = 0; t < triangles; ++t )
+	{
+		auto const dest = 3 * std::size_t(fill[triangleCell[t]]++);
+		aIndices[dest+0] = source[3*t+0];
+		aIndices[dest+1] = source[3*t+1];
+		aIndices[dest+2] = source[3*t+2];
+	}
+
+	// Chunk bounds: the box first, then the sphere around its center.
+	std::vector<MeshChunk> ret;
+	for( std::size_t cell = 0; cell < cells; ++cell )
+	{
+		std::size_t const first = 3 * std::size_t(cellStart[cell]);
+		std::size_t const end = 3 * std::size_t(cellStart[cell+1]);
+		if( first == end )
+			continue;
+
+		auto const chunkIndices = aIndices.subspan( first, end - first );
+
+		Aabb3f bounds = kEmptyAabb3f;
+		for( auto const index : chunkIndices )
+			expand( bounds, aPositions[index] );
+
+		Vec3f const mid = center( bounds );
+		float radiusSq = 0.f;
+		for( auto const index : chunkIndices )
+		{
+			Vec3f const d = aPositions[index] - mid;
+			radiusSq = std::max( radiusSq, dot( d, d ) );
+		}
+
+		ret.emplace_back( MeshChunk{
+			bounds,
+			mid,
+			std::sqrt( radiusSq ),
+			static_cast<std::uint32_t>( first ),
+			static_cast<std::uint32_t>( end - first ),
+			static_cast<std::uint16_t>( cell % aCellsX ),
+			static_cast<std::uint16_t>( cell / aCellsX )
+		} );
+	}
+
+	return ret;
+}
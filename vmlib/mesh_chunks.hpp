@@ -0,0 +1,54 @@
+#ifndef MESH_CHUNKS_HPP_6C2F8E45_A93B_4D17_B8E6_1F57D03A29C4
+#define MESH_CHUNKS_HPP_6C2F8E45_A93B_4D17_B8E6_1F57D03A29C4
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "vec3.hpp"
+#include "aabb.hpp"
+
+/** MeshChunk: a spatially coherent part of an indexed triangle mesh
+ *
+ * partition_mesh_chunks() sorts the triangles of a mesh into a regular grid
+ * of aCellsX x aCellsZ cells over the mesh's extent in the XZ plane (i.e.,
+ * a height field such as the terrain is cut into columns). Each triangle goes
+ * to the cell that contains its centroid, and the triangles of each cell are
+ * made contiguous in the index buffer, so that a chunk is drawn with
+ *
+ *   glDrawElements( GL_TRIANGLES, indexCount, type, firstIndex * indexSize )
+ *
+ * Triangles keep their relative order within a chunk and their winding.
+ * Empty cells do not produce chunks; the chunks are ordered by cell, row by
+ * row along X (cellX + cellZ * aCellsX).
+ *
+ * The bounds are those of the chunk's triangles, which may extend past the
+ * cell. The bounding sphere is centered on the box, with the smallest radius
+ * that contains all of the chunk's vertices.
+ */
+struct MeshChunk
+{
+	Aabb3f bounds;
+	Vec3f center;
+	float radius;
+
+	std::uint32_t firstIndex;
+	std::uint32_t indexCount;
+
+	std::uint16_t cellX, cellZ;
+};
+
+std::vector<MeshChunk> partition_mesh_chunks( std::span<std::uint32_t> aIndices, std::span<Vec3f const> aPositions, std::size_t aCellsX, std::size_t aCellsZ );
+
+// Gathers the positions of aVertices for partition_mesh_chunks().
+template< class tVertex >
+std::vector<Vec3f> extract_positions( std::span<tVertex const> aVertices )
+{
+	std::vector<Vec3f> ret( aVertices.size() );
+	for( std::size_t i = 0; i < aVertices.size(); ++i )
+		ret[i] = aVertices[i].position;
+	return ret;
+}
+
+#endif // MESH_CHUNKS_HPP_6C2F8E45_A93B_4D17_B8E6_1F57D03A29C4
@@ -0,0 +1,146 @@
+#include "meshlets.hpp"
+
+#include <cmath>
+#include <limits>
+#include <cassert>
+#include <algorithm>
+
+#include "aabb.hpp"
+
+namespace
+{
+	constexpr std::uint32_t kNone_ = ~std::uint32_t(0);
+
+	Vec3f cross_( Vec3f aA, Vec3f aB ) noexcept
+	{
+		return Vec3f{
+			aA.y * aB.z - aA.z * aB.y,
+			aA.z * aB.x - aA.x * aB.z,
+			aA.x * aB.y - aA.y * aB.x
+		};
+	}
+
+	// Bounding sphere and normal cone of the triangles in aIndices.
+	void compute_bounds_( Meshlet& aMeshlet, std::span<std::uint32_t const> aIndices, std::span<Vec3f const> aPositions ) noexcept
+	{
+		Aabb3f box = kEmptyAabb3f;
+		for( auto const index : aIndices )
+			expand( box, aPositions[index] );
+
+		aMeshlet.center = 0.5f * (box.min + box.max);
+		float radiusSq = 0.f;
+		for( auto const index : aIndices )
+		{
+			Vec3f const d = aPositions[index] - aMeshlet.center;
+			radiusSq = std::max( radiusSq, dot( d, d ) );
+		}
+		aMeshlet.radius = std::sqrt( radiusSq );
+
+		// The cone's axis is the mean of the unit normals; its angle is that
+		// of the normal furthest from the axis. Degenerate triangles have no
+		// normal and are invisible, so they do not count.
+		std::vector<Vec3f> normals;
+		normals.reserve( aIndices.size() / 3 );
+
+		Vec3f sum{ 0.f, 0.f, 0.f };
+		for( std::size_t i = 0; i < aIndices.size(); i += 3 )
+		{
+			Vec3f const p0 = aPositions[aIndices[i]];
+			Vec3f const n = cross_( aPositions[aIndices[i+1]] - p0, aPositions[aIndices[i+2]] - p0 );
+			float const len = length( n );
+			if( !(len > 0.f) )
+				continue;
+
+			normals.emplace_back( n / len );
+			sum += normals.back();
+		}
+
+		aMeshlet.coneAxis = Vec3f{ 0.f, 0.f, 0.f };
+		aMeshlet.coneCutoff = 1.f;
+
+		float const sumLength = length( sum );
+		if( normals.empty() || !(sumLength > 0.f) )
+			return;
+
+		Vec3f const axis = sum / sumLength;
+		float minDot = 1.f;
+		for( auto const& n : normals )
+			minDot = std::min( minDot, dot( n, axis ) );
+
+		// Normals more than 90 degrees apart: some triangle always faces the
+		// camera.
+		if( minDot <= 0.f )
+			return;
+
+		aMeshlet.coneAxis = axis;
+		aMeshlet.coneCutoff = std::sqrt( std::max( 0.f, 1.f - minDot * minDot ) );
+	}
+}
+
+std::vector<Meshlet> build_meshlets( std::span<std::uint32_t const> aIndices, std::span<Vec3f const> aPositions, std::span<MeshLod const> aRanges, std::size_t aMaxVertices, std::size_t aMaxTriangles )
+{
+	assert( aMaxVertices >= 3 && aMaxTriangles >= 1 );
+
+	std::vector<MeshLod> ranges( aRanges.begin(), aRanges.end() );
+	std::sort( ranges.begin(), ranges.end(), [] ( MeshLod const& aA, MeshLod const& aB ) {
+		return aA.firstIndex < aB.firstIndex;
+	} );
+
+	std::vector<Meshlet> ret;
+
+	// owner[v] is the number of the last meshlet that used vertex v.
+	std::vector<std::uint32_t> owner( aPositions.size(), kNone_ );
+
+	for( auto const& range : ranges )
+	{
+		assert( range.indexCount % 3 == 0 );
+		assert( std::size_t(range.firstIndex) + range.indexCount <= aIndices.size() );
+
+		std::size_t i = 0;
+		while( i < range.indexCount )
+		{
+			auto const id = static_cast<std::uint32_t>( ret.size() );
+			std::size_t const first = range.firstIndex + i;
+
+			std::size_t vertices = 0, triangles = 0;
+			for( ; i < range.indexCount && triangles < aMaxTriangles; i += 3 )
+			{
+				std::uint32_t const* tri = aIndices.data() + range.firstIndex + i;
+				std::size_t added = 0;
+				for( std::size_t k = 0; k < 3; ++k )
+				{
+					if( id != owner[tri[k]] && std::find( tri, tri + k, tri[k] ) == tri + k )
+						++added;
+				}
+
+				if( vertices + added > aMaxVertices )
+					break;
+
+				for( std::size_t k = 0; k < 3; ++k )
+					owner[tri[k]] = id;
+
+				vertices += added;
+				++triangles;
+			}
+
+			Meshlet meshlet{};
+			meshlet.firstIndex = static_cast<std::uint32_t>( first );
+			meshlet.indexCount = static_cast<std::uint32_t>( triangles * 3 );
+			compute_bounds_( meshlet, aIndices.subspan( first, meshlet.indexCount ), aPositions );
+			ret.emplace_back( meshlet );
+		}
+	}
+
+	return ret;
+}
+
+std::span<Meshlet const> find_meshlets( std::span<Meshlet const> aMeshlets, MeshLod const& aRange ) noexcept
+{
+	auto const begin = std::lower_bound( aMeshlets.begin(), aMeshlets.end(), aRange.firstIndex, [] ( Meshlet const& aMeshlet, std::uint32_t aIndex ) {
+		return aMeshlet.firstIndex < aIndex;
+	} );
+	auto const end = std::lower_bound( begin, aMeshlets.end(), aRange.firstIndex + aRange.indexCount, [] ( Meshlet const& aMeshlet, std::uint32_t aIndex ) {
+		return aMeshlet.firstIndex < aIndex;
+	} );
+	return std::span<Meshlet const>( begin, end );
+}
@@ -0,0 +1,64 @@
+#ifndef MESHLETS_HPP_E4A7C1D9_5B26_4F83_9C0E_3D18B76F52A4
+#define MESHLETS_HPP_E4A7C1D9_5B26_4F83_9C0E_3D18B76F52A4
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "lod.hpp"
+#include "vec3.hpp"
+
+/** Meshlet: a small cluster of triangles with culling bounds
+ *
+ * build_meshlets() splits ranges of an index buffer into meshlets of at most
+ * aMaxVertices distinct vertices and aMaxTriangles triangles. The triangles
+ * are taken in index buffer order, so a meshlet is a contiguous range of
+ * indices that is drawn like a chunk (see mesh_chunks.hpp), and the index
+ * buffer itself is not modified. Meshlets are thus only as compact as the
+ * triangle order; the order from optimize_vertex_cache() keeps neighbouring
+ * triangles together.
+ *
+ * Each meshlet has a bounding sphere, for frustum culling, and a cone that
+ * contains the normals of its triangles, for culling meshlets that face
+ * entirely away from the camera (see is_backfacing()). Meshlets whose normals
+ * spread over a half space or more have coneCutoff == 1 and are never
+ * backfacing.
+ *
+ * The defaults follow the usual hardware meshlet sizes (64 vertices and 124
+ * triangles, which keeps the triangle indices of a meshlet in 372 bytes).
+ */
+struct Meshlet
+{
+	Vec3f center;
+	float radius;
+
+	Vec3f coneAxis;
+	float coneCutoff; // sine of the cone's half angle
+
+	std::uint32_t firstIndex;
+	std::uint32_t indexCount;
+};
+
+constexpr std::size_t kMeshletMaxVertices = 64;
+constexpr std::size_t kMeshletMaxTriangles = 124;
+
+// Builds the meshlets of each of aRanges (e.g., the levels of detail from
+// build_chunk_lods() or build_lod_chain()); the ranges must not overlap. The
+// meshlets are returned sorted by firstIndex, for find_meshlets().
+std::vector<Meshlet> build_meshlets( std::span<std::uint32_t const> aIndices, std::span<Vec3f const> aPositions, std::span<MeshLod const> aRanges, std::size_t aMaxVertices = kMeshletMaxVertices, std::size_t aMaxTriangles = kMeshletMaxTriangles );
+
+// The meshlets that build_meshlets() made for aRange.
+std::span<Meshlet const> find_meshlets( std::span<Meshlet const> aMeshlets, MeshLod const& aRange ) noexcept;
+
+// True if every triangle of aMeshlet faces away from aEye (with
+// counter-clockwise front faces), i.e., the meshlet is invisible with
+// backface culling. Conservative: may return false for a backfacing meshlet.
+inline
+bool is_backfacing( Meshlet const& aMeshlet, Vec3f aEye ) noexcept
+{
+	Vec3f const toCenter = aMeshlet.center - aEye;
+	return dot( toCenter, aMeshlet.coneAxis ) >= aMeshlet.coneCutoff * length( toCenter ) + aMeshlet.radius;
+}
+
+#endif // MESHLETS_HPP_E4A7C1D9_5B26_4F83_9C0E_3D18B76F52A4
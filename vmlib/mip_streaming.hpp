@@ -0,0 +1,89 @@
+#ifndef MIP_STREAMING_HPP_6A3E91D4_2C5B_4F07_8B1E_D49C07A2F5E3
+#define MIP_STREAMING_HPP_6A3E91D4_2C5B_4F07_8B1E_D49C07A2F5E3
+
+#include <span>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+/** Choosing which mip levels of a streamed texture to keep resident
+ *
+ * A streamed texture (see main/texture_stream.hpp) always has its mip tail,
+ * the levels up to a small size, on the GPU; finer levels are loaded when
+ * the camera gets close enough to need them, and dropped when it moves away
+ * or when they do not fit in the texture's memory budget.
+ *
+ * Levels are numbered as in OpenGL (level 0 is the full-size image; see
+ * vmlib/mipmap.hpp). "Finer" means a smaller level number.
+ */
+
+// First level of the mip tail of an aWidth x aHeight texture: the largest
+// level that is at most aMaxTailSize texels wide and high (or the last
+// level, if none is).
+inline
+std::size_t mip_tail_level( std::uint32_t aWidth, std::uint32_t aHeight, std::uint32_t aMaxTailSize, std::size_t aLevelCount ) noexcept
+{
+	std::size_t level = 0;
+	while( level + 1 < aLevelCount && (aWidth >> level > aMaxTailSize || aHeight >> level > aMaxTailSize) )
+		++level;
+	return level;
+}
+
+// Finest level needed to texture a surface aDistance from the camera, with
+// aTexelsPerUnit texels per world unit, under a projection with
+// aPixelsPerUnit pixels per world unit at distance one (see
+// lod_pixels_per_unit() in vmlib/lod.hpp). That is the level at which one
+// texel covers at least one pixel; at grazing angles the GL selects coarser
+// levels still, so the result is conservative.
+inline
+std::size_t needed_mip_level( float aTexelsPerUnit, float aDistance, float aPixelsPerUnit, std::size_t aLevelCount ) noexcept
+{
+	if( aLevelCount < 2 )
+		return 0;
+
+	// Texels per pixel: aTexelsPerUnit / (aPixelsPerUnit / aDistance).
+	float const texelsPerPixel = aTexelsPerUnit * std::max( aDistance, 0.f ) / aPixelsPerUnit;
+	if( !(texelsPerPixel > 1.f) )
+		return 0; // also catches NaN (zero distance with zero pixels per unit)
+
+	float const level = std::floor( std::log2( texelsPerPixel ) );
+	return std::min( aLevelCount - 1, static_cast<std::size_t>( std::min( level, 64.f ) ) );
+}
+
+// Finest level at which the chain of levels from there down to the last one
+// fits in aBudgetBytes. aLevelBytes has the size of each level. The levels
+// from aTailLevel on are always resident, whatever the budget, so the result
+// is never coarser than aTailLevel; a tail level past the last level is taken
+// as the last level.
+inline
+std::size_t budget_mip_level( std::span<std::size_t const> aLevelBytes, std::size_t aBudgetBytes, std::size_t aTailLevel ) noexcept
+{
+	if( aLevelBytes.empty() )
+		return 0;
+
+	aTailLevel = std::min( aTailLevel, aLevelBytes.size() - 1 );
+
+	std::size_t total = 0;
+	for( std::size_t level = aLevelBytes.size(); level > aTailLevel; --level )
+		total += aLevelBytes[level-1];
+
+	std::size_t ret = aTailLevel;
+	while( ret > 0 && total + aLevelBytes[ret-1] <= aBudgetBytes )
+		total += aLevelBytes[--ret];
+	return ret;
+}
+
+// Whether a level that was loaded for streaming should still be uploaded,
+// given the finest resident level aBaseLevel and the finest level that is
+// wanted now, aTargetLevel. A level that is already resident was loaded twice
+// (asked for again after a cancel that came while it was being loaded); a
+// level finer than the target was cancelled while it was being loaded, and
+// would take memory that the target does not allow.
+inline
+bool wanted_mip_level( std::size_t aLevel, std::size_t aBaseLevel, std::size_t aTargetLevel ) noexcept
+{
+	return aLevel < aBaseLevel && aLevel >= aTargetLevel;
+}
+
+#endif // MIP_STREAMING_HPP_6A3E91D4_2C5B_4F07_8B1E_D49C07A2F5E3
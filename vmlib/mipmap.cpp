@@ -0,0 +1,99 @@
+#include "mipmap.hpp"
+
+#include <array>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+namespace
+{
+	float srgb_to_linear_( float aValue ) noexcept
+	{
+		return aValue <= 0.04045f ? aValue / 12.92f : std::pow( (aValue + 0.055f) / 1.055f, 2.4f );
+	}
+
+	std::uint8_t linear_to_srgb8_( float aValue ) noexcept
+	{
+		float const c = std::clamp( aValue, 0.f, 1.f );
+		float const s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow( c, 1.f / 2.4f ) - 0.055f;
+		return static_cast<std::uint8_t>( s * 255.f + 0.5f );
+	}
+
+	std::array<float, 256> const& srgb8_to_linear_table_() noexcept
+	{
+		static std::array<float, 256> const table = [] {
+			std::array<float, 256> ret{};
+			for( std::size_t i = 0; i < ret.size(); ++i )
+				ret[i] = srgb_to_linear_( float(i) / 255.f );
+			return ret;
+		}();
+		return table;
+	}
+}
+
+std::size_t mip_level_count( std::uint32_t aWidth, std::uint32_t aHeight ) noexcept
+{
+	std::size_t ret = 1;
+	for( std::uint32_t size = std::max( aWidth, aHeight ); size > 1; size >>= 1 )
+		++ret;
+	return ret;
+}
+
+std::vector<std::uint8_t> downsample_srgba8( std::span<std::uint8_t const> aPixels, std::uint32_t aWidth, std::uint32_t aHeight )
+{
+	assert( aPixels.size() == std::size_t(aWidth) * aHeight * 4 );
+
+	auto const& toLinear = srgb8_to_linear_table_();
+
+	std::uint32_t const width = std::max<std::uint32_t>( 1, aWidth / 2 );
+	std::uint32_t const height = std::max<std::uint32_t>( 1, aHeight / 2 );
+
+	std::vector<std::uint8_t> ret( std::size_t(width) * height * 4 );
+	for( std::uint32_t y = 0; y < height; ++y )
+	{
+		std::uint32_t const y0 = std::min( 2*y, aHeight-1 ), y1 = std::min( 2*y+1, aHeight-1 );
+		for( std::uint32_t x = 0; x < width; ++x )
+		{
+			std::uint32_t const x0 = std::min( 2*x, aWidth-1 ), x1 = std::min( 2*x+1, aWidth-1 );
+			std::uint8_t const* const texels[4] = {
+				aPixels.data() + (std::size_t(y0) * aWidth + x0) * 4,
+				aPixels.data() + (std::size_t(y0) * aWidth + x1) * 4,
+				aPixels.data() + (std::size_t(y1) * aWidth + x0) * 4,
+				aPixels.data() + (std::size_t(y1) * aWidth + x1) * 4
+			};
+
+			std::uint8_t* out = ret.data() + (std::size_t(y) * width + x) * 4;
+			for( std::size_t c = 0; c < 3; ++c )
+			{
+				float sum = 0.f;
+				for( auto const* texel : texels )
+					sum += toLinear[texel[c]];
+				out[c] = linear_to_srgb8_( 0.25f * sum );
+			}
+
+			unsigned alpha = 0;
+			for( auto const* texel : texels )
+				alpha += texel[3];
+			out[3] = static_cast<std::uint8_t>( (alpha + 2) / 4 );
+		}
+	}
+
+	return ret;
+}
+
+std::vector<std::vector<std::uint8_t>> build_srgba8_mips( std::span<std::uint8_t const> aPixels, std::uint32_t aWidth, std::uint32_t aHeight )
+{
+	std::vector<std::vector<std::uint8_t>> ret;
+	ret.reserve( mip_level_count( aWidth, aHeight ) );
+	ret.emplace_back( aPixels.begin(), aPixels.end() );
+
+	std::uint32_t width = aWidth, height = aHeight;
+	while( width > 1 || height > 1 )
+	{
+		ret.emplace_back( downsample_srgba8( ret.back(), width, height ) );
+		width = std::max<std::uint32_t>( 1, width / 2 );
+		height = std::max<std::uint32_t>( 1, height / 2 );
+	}
+
+	return ret;
+}
@@ -0,0 +1,34 @@
+#ifndef MIPMAP_HPP_93C05E2B_7D1A_4A68_B2F4_E6185D3C90A7
+#define MIPMAP_HPP_93C05E2B_7D1A_4A68_B2F4_E6185D3C90A7
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/** Mip chains of 8-bit RGBA images on the CPU
+ *
+ * Building the mip levels offline (see assetc) lets the application upload
+ * them as they are, instead of calling glGenerateMipmap() at startup.
+ *
+ * Levels follow OpenGL's sizes: level l is max(1, w >> l) by
+ * max(1, h >> l), down to 1x1, so mip_level_count() is
+ * 1 + floor(log2(max(w, h))).
+ *
+ * downsample_srgba8() halves an image with a 2x2 box filter. The colour
+ * channels are sRGB-encoded, so they are averaged in linear space and
+ * re-encoded, as the GL does for GL_SRGB8_ALPHA8 textures; averaging the
+ * encoded values would darken the smaller levels. Alpha is linear. With an
+ * odd size, the last row or column is dropped (as by a 2x2 filter at even
+ * positions); with a size of one, that row or column is repeated.
+ *
+ * Pixels are tightly packed rows of four bytes (R, G, B, A).
+ */
+std::size_t mip_level_count( std::uint32_t aWidth, std::uint32_t aHeight ) noexcept;
+
+std::vector<std::uint8_t> downsample_srgba8( std::span<std::uint8_t const> aPixels, std::uint32_t aWidth, std::uint32_t aHeight );
+
+// All levels of aPixels, level 0 (a copy of aPixels) first.
+std::vector<std::vector<std::uint8_t>> build_srgba8_mips( std::span<std::uint8_t const> aPixels, std::uint32_t aWidth, std::uint32_t aHeight );
+
+#endif // MIPMAP_HPP_93C05E2B_7D1A_4A68_B2F4_E6185D3C90A7
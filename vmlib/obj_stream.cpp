@@ -0,0 +1,227 @@
+#include "obj_stream.hpp"
+
+#include <charconv>
+#include <system_error>
+
+namespace
+{
+	bool is_space_( char aChar ) noexcept
+	{
+		return ' ' == aChar || '\t' == aChar || '\r' == aChar;
+	}
+
+	std::string_view skip_space_( std::string_view aText ) noexcept
+	{
+		std::size_t i = 0;
+		while( i < aText.size() && is_space_( aText[i] ) )
+			++i;
+		return aText.substr( i );
+	}
+
+	// Splits off the next whitespace-separated token.
+	std::string_view next_token_( std::string_view& aText ) noexcept
+	{
+		aText = skip_space_( aText );
+		std::size_t i = 0;
+		while( i < aText.size() && !is_space_( aText[i] ) )
+			++i;
+
+		auto const ret = aText.substr( 0, i );
+		aText = aText.substr( i );
+		return ret;
+	}
+
+	bool parse_float_( std::string_view& aText, float& aOut ) noexcept
+	{
+		auto const token = next_token_( aText );
+		if( token.empty() )
+			return false;
+
+		// from_chars() does not accept a leading '+'.
+		char const* first = token.data();
+		if( '+' == *first )
+			++first;
+
+		auto const [ptr, ec] = std::from_chars( first, token.data() + token.size(), aOut );
+		return std::errc{} == ec && token.data() + token.size() == ptr;
+	}
+
+	// Resolves a one-based (or, if negative, relative) OBJ index against
+	// aCount elements.
+	bool resolve_index_( std::string_view aText, std::size_t aCount, std::uint32_t& aOut ) noexcept
+	{
+		long long value = 0;
+		auto const [ptr, ec] = std::from_chars( aText.data(), aText.data() + aText.size(), value );
+		if( std::errc{} != ec || aText.data() + aText.size() != ptr || 0 == value )
+			return false;
+
+		long long const index = value > 0 ? value - 1 : static_cast<long long>( aCount ) + value;
+		if( index < 0 || static_cast<unsigned long long>( index ) >= aCount )
+			return false;
+
+		aOut = static_cast<std::uint32_t>( index );
+		return true;
+	}
+}
+
+void ObjStreamParser::feed( std::span<char const> aBytes )
+{
+	std::string_view rest( aBytes.data(), aBytes.size() );
+	while( !failed() )
+	{
+		auto const newline = rest.find( '\n' );
+		if( std::string_view::npos == newline )
+		{
+			mPartial.append( rest );
+			return;
+		}
+
+		if( mPartial.empty() )
+		{
+			parse_line_( rest.substr( 0, newline ) );
+		}
+		else
+		{
+			mPartial.append( rest.substr( 0, newline ) );
+			parse_line_( mPartial );
+			mPartial.clear();
+		}
+
+		rest = rest.substr( newline + 1 );
+	}
+}
+
+void ObjStreamParser::finish()
+{
+	if( !failed() && !mPartial.empty() )
+		parse_line_( mPartial );
+
+	mPartial = std::string();
+}
+
+bool ObjStreamParser::failed() const noexcept
+{
+	return !mError.empty();
+}
+std::string const& ObjStreamParser::error() const noexcept
+{
+	return mError;
+}
+
+std::size_t ObjStreamParser::line() const noexcept
+{
+	return mLine;
+}
+
+std::span<Vec3f const> ObjStreamParser::positions() const noexcept
+{
+	return mPositions;
+}
+std::span<Vec3f const> ObjStreamParser::normals() const noexcept
+{
+	return mNormals;
+}
+std::span<Vec2f const> ObjStreamParser::texCoords() const noexcept
+{
+	return mTexCoords;
+}
+
+std::span<ObjCorner const> ObjStreamParser::triangles() const noexcept
+{
+	return mTriangles;
+}
+void ObjStreamParser::clear_triangles() noexcept
+{
+	mTriangles.clear();
+}
+
+void ObjStreamParser::release() noexcept
+{
+	mPositions = std::vector<Vec3f>();
+	mNormals = std::vector<Vec3f>();
+	mTexCoords = std::vector<Vec2f>();
+	mTriangles = std::vector<ObjCorner>();
+	mPolygon = std::vector<ObjCorner>();
+}
+
+void ObjStreamParser::parse_line_( std::string_view aLine )
+{
+	++mLine;
+
+	auto rest = skip_space_( aLine );
+	if( rest.empty() || '#' == rest.front() )
+		return;
+
+	auto const keyword = next_token_( rest );
+	if( "v" == keyword || "vn" == keyword )
+	{
+		// Extra values (w, or vertex colours) are ignored.
+		Vec3f v{};
+		if( !parse_float_( rest, v.x ) || !parse_float_( rest, v.y ) || !parse_float_( rest, v.z ) )
+		{
+			fail_( "expected three coordinates" );
+			return;
+		}
+
+		("v" == keyword ? mPositions : mNormals).emplace_back( v );
+	}
+	else if( "vt" == keyword )
+	{
+		// v is optional, and w is ignored.
+		Vec2f t{ 0.f, 0.f };
+		if( !parse_float_( rest, t.x ) || (!skip_space_( rest ).empty() && !parse_float_( rest, t.y )) )
+		{
+			fail_( "expected a texture coordinate" );
+			return;
+		}
+
+		mTexCoords.emplace_back( t );
+	}
+	else if( "f" == keyword )
+	{
+		parse_face_( rest );
+	}
+}
+
+bool ObjStreamParser::parse_face_( std::string_view aText )
+{
+	mPolygon.clear();
+	for( auto token = next_token_( aText ); !token.empty(); token = next_token_( aText ) )
+	{
+		// p, p/t, p//n or p/t/n
+		ObjCorner corner{ 0, kObjNoIndex, kObjNoIndex };
+
+		auto const slash0 = token.find( '/' );
+		if( !resolve_index_( token.substr( 0, slash0 ), mPositions.size(), corner.position ) )
+			return fail_( "invalid position index" );
+
+		if( std::string_view::npos != slash0 )
+		{
+			auto const rest = token.substr( slash0 + 1 );
+			auto const slash1 = rest.find( '/' );
+
+			auto const texCoord = rest.substr( 0, slash1 );
+			if( !texCoord.empty() && !resolve_index_( texCoord, mTexCoords.size(), corner.texCoord ) )
+				return fail_( "invalid texture coordinate index" );
+
+			if( std::string_view::npos != slash1 && !resolve_index_( rest.substr( slash1 + 1 ), mNormals.size(), corner.normal ) )
+				return fail_( "invalid normal index" );
+		}
+
+		mPolygon.emplace_back( corner );
+	}
+
+	if( mPolygon.size() < 3 )
+		return fail_( "face with fewer than three vertices" );
+
+	for( std::size_t i = 1; i + 1 < mPolygon.size(); ++i )
+		mTriangles.insert( mTriangles.end(), { mPolygon[0], mPolygon[i], mPolygon[i+1] } );
+
+	return true;
+}
+
+bool ObjStreamParser::fail_( std::string_view aMessage )
+{
+	mError.assign( aMessage );
+	return false;
+}
@@ -0,0 +1,93 @@
+#ifndef OBJ_STREAM_HPP_5D2E8B71_C3A6_4F09_B7E4_1A96F03D82C5
+#define OBJ_STREAM_HPP_5D2E8B71_C3A6_4F09_B7E4_1A96F03D82C5
+
+#include <span>
+#include <limits>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+#include "vec2.hpp"
+#include "vec3.hpp"
+
+/** ObjStreamParser: incremental Wavefront OBJ parsing
+ *
+ * The parser is fed the file in pieces of any size (e.g., fixed-size reads),
+ * so that the file never has to be in memory as a whole. Complete lines are
+ * parsed immediately; a line split between two pieces is kept until the
+ * rest of it arrives.
+ *
+ * The vertex attributes (v, vt and vn) are kept for the whole file, since a
+ * face may refer to any earlier vertex. Faces (f) are triangulated as fans
+ * and queued as triangles, three ObjCorner each, with resolved zero-based
+ * indices (relative indices included). The caller is expected to consume
+ * the queued triangles after each feed() and then clear_triangles(), so that
+ * only the triangles of one piece are ever held.
+ *
+ * Everything else (o, g, s, usemtl, mtllib, l, p, ...) is skipped, so the
+ * parser suits meshes without materials, e.g. large terrains.
+ *
+ * Parsing stops at the first malformed line or out-of-range index; see
+ * failed() and error().
+ */
+struct ObjCorner
+{
+	std::uint32_t position;
+	std::uint32_t texCoord; // kObjNoIndex if absent
+	std::uint32_t normal;   // kObjNoIndex if absent
+};
+
+constexpr std::uint32_t kObjNoIndex = std::numeric_limits<std::uint32_t>::max();
+
+class ObjStreamParser
+{
+	public:
+		ObjStreamParser() = default;
+
+	public:
+		// Parses the complete lines in aBytes (together with the partial
+		// line left from the previous call).
+		void feed( std::span<char const> aBytes );
+
+		// Parses the last line, if the file did not end with a newline.
+		void finish();
+
+		bool failed() const noexcept;
+		std::string const& error() const noexcept;
+
+		// Number of lines parsed so far (the failing line if failed()).
+		std::size_t line() const noexcept;
+
+		std::span<Vec3f const> positions() const noexcept;
+		std::span<Vec3f const> normals() const noexcept;
+		std::span<Vec2f const> texCoords() const noexcept;
+
+		// Triangles queued since the last clear_triangles().
+		std::span<ObjCorner const> triangles() const noexcept;
+		void clear_triangles() noexcept;
+
+		// Releases the vertex attributes, e.g. once all triangles are
+		// consumed.
+		void release() noexcept;
+
+	private:
+		void parse_line_( std::string_view );
+		bool parse_face_( std::string_view );
+		bool fail_( std::string_view );
+
+	private:
+		std::vector<Vec3f> mPositions;
+		std::vector<Vec3f> mNormals;
+		std::vector<Vec2f> mTexCoords;
+
+		std::vector<ObjCorner> mTriangles;
+		std::vector<ObjCorner> mPolygon;
+
+		std::string mPartial;
+		std::string mError;
+		std::size_t mLine = 0;
+};
+
+#endif // OBJ_STREAM_HPP_5D2E8B71_C3A6_4F09_B7E4_1A96F03D82C5
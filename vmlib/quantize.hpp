@@ -0,0 +1,210 @@
+#ifndef QUANTIZE_HPP_5A1D8E73_2C4B_4F96_8E07_B3F6D92A41C5
+#define QUANTIZE_HPP_5A1D8E73_2C4B_4F96_8E07_B3F6D92A41C5
+
+#include <bit>
+#include <cmath>
+#include <array>
+#include <cstdint>
+#include <algorithm>
+
+#include "vec2.hpp"
+#include "vec3.hpp"
+#include "aabb.hpp"
+
+/** Quantization of vertex attributes
+ *
+ * Encoders for packed vertex formats. Each encoder has a matching decoder;
+ * the decoders mirror what the GPU (fixed-function normalization) or the
+ * vertex shader does, and exist mainly for testing.
+ *
+ *  - unorm/snorm: [0,1] resp. [-1,1] to 8- or 16-bit integers, as read with
+ *    glVertexAttribPointer( ..., GL_TRUE, ... ). Snorm uses the GL 4.2+ rule
+ *    max( c / 32767, -1 ), so -32768 and -32767 both decode to -1.
+ *  - positions: unorm16 relative to a bounding box. The vertex shader undoes
+ *    this with p * scale + offset (see PositionQuantization).
+ *  - normals: octahedral encoding (Cigolle et al., "A Survey of Efficient
+ *    Representations for Independent Unit Vectors", 2014) as two snorm16s.
+ *    The vertex shader decodes them with decode_octahedral().
+ *  - half floats: IEEE 754 binary16, for GL_HALF_FLOAT attributes. Rounds to
+ *    nearest; results that would be subnormal are flushed to zero.
+ */
+constexpr
+std::uint16_t quantize_unorm16( float aX ) noexcept
+{
+	return static_cast<std::uint16_t>( std::clamp( aX, 0.f, 1.f ) * 65535.f + 0.5f );
+}
+constexpr
+float dequantize_unorm16( std::uint16_t aX ) noexcept
+{
+	return float(aX) / 65535.f;
+}
+
+constexpr
+std::uint8_t quantize_unorm8( float aX ) noexcept
+{
+	return static_cast<std::uint8_t>( std::clamp( aX, 0.f, 1.f ) * 255.f + 0.5f );
+}
+constexpr
+float dequantize_unorm8( std::uint8_t aX ) noexcept
+{
+	return float(aX) / 255.f;
+}
+
+constexpr
+std::int16_t quantize_snorm16( float aX ) noexcept
+{
+	// Round half away from zero, like std::lround(), but without the call.
+	float const x = std::clamp( aX, -1.f, 1.f ) * 32767.f;
+	return static_cast<std::int16_t>( x >= 0.f ? x + 0.5f : x - 0.5f );
+}
+constexpr
+float dequantize_snorm16( std::int16_t aX ) noexcept
+{
+	return std::max( float(aX) / 32767.f, -1.f );
+}
+
+
+/* Positions: the bounding box is mapped to [0,1]^3. Degenerate (flat) axes
+ * get a scale of 1, so that they decode to the box' minimum exactly.
+ */
+struct PositionQuantization
+{
+	Vec3f scale;
+	Vec3f offset;
+};
+
+constexpr PositionQuantization kIdentityPositionQuantization = {
+	{ 1.f, 1.f, 1.f },
+	{ 0.f, 0.f, 0.f }
+};
+
+constexpr
+PositionQuantization make_position_quantization( Aabb3f const& aBounds ) noexcept
+{
+	auto const extent = [] ( float aMin, float aMax ) {
+		return aMax > aMin ? aMax - aMin : 1.f;
+	};
+
+	return PositionQuantization{
+		{ extent( aBounds.min.x, aBounds.max.x ), extent( aBounds.min.y, aBounds.max.y ), extent( aBounds.min.z, aBounds.max.z ) },
+		aBounds.min
+	};
+}
+
+constexpr
+std::array<std::uint16_t,3> quantize_position( PositionQuantization const& aQ, Vec3f aPos ) noexcept
+{
+	return {
+		quantize_unorm16( (aPos.x - aQ.offset.x) / aQ.scale.x ),
+		quantize_unorm16( (aPos.y - aQ.offset.y) / aQ.scale.y ),
+		quantize_unorm16( (aPos.z - aQ.offset.z) / aQ.scale.z )
+	};
+}
+constexpr
+Vec3f dequantize_position( PositionQuantization const& aQ, std::array<std::uint16_t,3> const& aPos ) noexcept
+{
+	return Vec3f{
+		dequantize_unorm16( aPos[0] ) * aQ.scale.x + aQ.offset.x,
+		dequantize_unorm16( aPos[1] ) * aQ.scale.y + aQ.offset.y,
+		dequantize_unorm16( aPos[2] ) * aQ.scale.z + aQ.offset.z
+	};
+}
+
+
+/* Octahedral normals: the unit sphere is projected onto the octahedron
+ * |x|+|y|+|z| = 1, whose lower half is folded over the upper one, giving a
+ * point in [-1,1]^2. The input need not be normalized, but must not be zero.
+ */
+namespace detail
+{
+	constexpr
+	float sign_not_zero_( float aX ) noexcept
+	{
+		return aX >= 0.f ? 1.f : -1.f;
+	}
+}
+
+inline
+Vec2f encode_octahedral( Vec3f aN ) noexcept
+{
+	float const l1 = std::abs( aN.x ) + std::abs( aN.y ) + std::abs( aN.z );
+	Vec2f p{ aN.x / l1, aN.y / l1 };
+
+	if( aN.z < 0.f )
+	{
+		p = Vec2f{
+			(1.f - std::abs( p.y )) * detail::sign_not_zero_( p.x ),
+			(1.f - std::abs( p.x )) * detail::sign_not_zero_( p.y )
+		};
+	}
+
+	return p;
+}
+
+inline
+Vec3f decode_octahedral( Vec2f aP ) noexcept
+{
+	Vec3f n{ aP.x, aP.y, 1.f - std::abs( aP.x ) - std::abs( aP.y ) };
+	float const t = std::max( -n.z, 0.f );
+	n.x += n.x >= 0.f ? -t : t;
+	n.y += n.y >= 0.f ? -t : t;
+	return normalize( n );
+}
+
+inline
+std::array<std::int16_t,2> quantize_normal( Vec3f aN ) noexcept
+{
+	auto const p = encode_octahedral( aN );
+	return { quantize_snorm16( p.x ), quantize_snorm16( p.y ) };
+}
+inline
+Vec3f dequantize_normal( std::array<std::int16_t,2> const& aN ) noexcept
+{
+	return decode_octahedral( Vec2f{ dequantize_snorm16( aN[0] ), dequantize_snorm16( aN[1] ) } );
+}
+
+
+/* Half floats
+ */
+constexpr
+std::uint16_t float_to_half( float aX ) noexcept
+{
+	std::uint32_t const bits = std::bit_cast<std::uint32_t>( aX );
+	std::uint32_t const sign = (bits >> 16) & 0x8000u;
+	std::uint32_t const em = bits & 0x7fffffffu; // exponent and mantissa
+
+	// Rebias the exponent from 127 to 15 and round the mantissa (which may
+	// carry into the exponent, as it should).
+	std::uint32_t half = (em - (112u << 23) + (1u << 12)) >> 13;
+
+	if( em < (113u << 23) )
+		half = 0; // below the smallest normal half (2^-14)
+	if( em >= (143u << 23) )
+		half = 0x7c00; // overflow to infinity
+	if( em > (255u << 23) )
+		half = 0x7e00; // NaN
+
+	return static_cast<std::uint16_t>( sign | half );
+}
+
+constexpr
+float half_to_float( std::uint16_t aX ) noexcept
+{
+	std::uint32_t const sign = std::uint32_t(aX & 0x8000u) << 16;
+	std::uint32_t const em = aX & 0x7fffu;
+
+	if( em < (1u << 10) )
+	{
+		// Zero or subnormal: mantissa * 2^-24.
+		float const mag = float(em) * (1.f / 16777216.f);
+		return std::bit_cast<float>( sign | std::bit_cast<std::uint32_t>( mag ) );
+	}
+
+	std::uint32_t bits = (em << 13) + (112u << 23);
+	if( em >= (31u << 10) )
+		bits += 112u << 23; // infinity and NaN: exponent all ones
+
+	return std::bit_cast<float>( sign | bits );
+}
+
+#endif // QUANTIZE_HPP_5A1D8E73_2C4B_4F96_8E07_B3F6D92A41C5
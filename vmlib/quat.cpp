@@ -0,0 +1,137 @@
+#include "quat.hpp"
+
+#include "simd.hpp"
+#include "fastmath.hpp"
+
+namespace
+{
+	using FloatN_ = simd::Float8;
+	constexpr std::size_t kWidth_ = FloatN_::kWidth;
+
+	// kWidth_ quaternions, one component per vector.
+	struct QuatN_
+	{
+		FloatN_ x, y, z, w;
+	};
+
+	QuatN_ load_( Quatf const* aQ ) noexcept
+	{
+		alignas(32) float x[kWidth_], y[kWidth_], z[kWidth_], w[kWidth_];
+		for( std::size_t j = 0; j < kWidth_; ++j )
+		{
+			x[j] = aQ[j].x;
+			y[j] = aQ[j].y;
+			z[j] = aQ[j].z;
+			w[j] = aQ[j].w;
+		}
+		return QuatN_{ simd::load8( x ), simd::load8( y ), simd::load8( z ), simd::load8( w ) };
+	}
+	void store_( Quatf* aOut, QuatN_ const& aQ ) noexcept
+	{
+		alignas(32) float x[kWidth_], y[kWidth_], z[kWidth_], w[kWidth_];
+		simd::store( x, aQ.x );
+		simd::store( y, aQ.y );
+		simd::store( z, aQ.z );
+		simd::store( w, aQ.w );
+		for( std::size_t j = 0; j < kWidth_; ++j )
+			aOut[j] = Quatf{ x[j], y[j], z[j], w[j] };
+	}
+
+	// aA * aWa + aB * aWb, normalized
+	QuatN_ blend_( QuatN_ const& aA, FloatN_ aWa, QuatN_ const& aB, FloatN_ aWb ) noexcept
+	{
+		QuatN_ const r{
+			aA.x * aWa + aB.x * aWb,
+			aA.y * aWa + aB.y * aWb,
+			aA.z * aWa + aB.z * aWb,
+			aA.w * aWa + aB.w * aWb
+		};
+		auto const inv = simd::rsqrt( r.x * r.x + r.y * r.y + r.z * r.z + r.w * r.w );
+		return QuatN_{ r.x * inv, r.y * inv, r.z * inv, r.w * inv };
+	}
+
+	// Returns dot( aFrom, aTo ), and flips aTo where the dot product is
+	// negative, so that the interpolation takes the shorter path. The
+	// returned dot product is then non-negative.
+	FloatN_ align_( QuatN_ const& aFrom, QuatN_& aTo ) noexcept
+	{
+		auto const d = aFrom.x * aTo.x + aFrom.y * aTo.y + aFrom.z * aTo.z + aFrom.w * aTo.w;
+		auto const sign = d & FloatN_( -0.f );
+		aTo.x = aTo.x ^ sign;
+		aTo.y = aTo.y ^ sign;
+		aTo.z = aTo.z ^ sign;
+		aTo.w = aTo.w ^ sign;
+		return d ^ sign;
+	}
+
+	template< class tKernel, class tScalar >
+	void interpolate_( std::span<Quatf const> aFrom, std::span<Quatf const> aTo, std::span<float const> aT, std::span<Quatf> aOut, tKernel&& aKernel, tScalar&& aScalar ) noexcept
+	{
+		std::size_t const count = aOut.size();
+		assert( aFrom.size() >= count );
+		assert( aTo.size() >= count );
+		assert( aT.size() >= count );
+
+		std::size_t i = 0;
+		for( ; i + kWidth_ <= count; i += kWidth_ )
+		{
+			auto const from = load_( aFrom.data() + i );
+			auto to = load_( aTo.data() + i );
+			auto const t = simd::load8( aT.data() + i );
+
+			auto const d = align_( from, to );
+			store_( aOut.data() + i, aKernel( from, to, d, t ) );
+		}
+
+		for( ; i < count; ++i )
+			aOut[i] = aScalar( aFrom[i], aTo[i], aT[i] );
+	}
+}
+
+void batch_nlerp( std::span<Quatf const> aFrom, std::span<Quatf const> aTo, std::span<float const> aT, std::span<Quatf> aOut ) noexcept
+{
+	interpolate_( aFrom, aTo, aT, aOut,
+		[] ( QuatN_ const& aA, QuatN_ const& aB, FloatN_, FloatN_ aT ) {
+			return blend_( aA, 1.f - aT, aB, aT );
+		},
+		[] ( Quatf const& aA, Quatf const& aB, float aT ) {
+			return nlerp( aA, aB, aT );
+		}
+	);
+}
+
+void batch_slerp( std::span<Quatf const> aFrom, std::span<Quatf const> aTo, std::span<float const> aT, std::span<Quatf> aOut ) noexcept
+{
+	interpolate_( aFrom, aTo, aT, aOut,
+		[] ( QuatN_ const& aA, QuatN_ const& aB, FloatN_ aD, FloatN_ aT ) {
+			// angle = acos( d ), computed as atan2( sin, cos ), which is
+			// accurate over the whole range (acos is not, near d = 1).
+			auto const s = simd::sqrt( simd::max( 1.f - aD * aD, 0.f ) );
+			auto const angle = simd::atan2( s, aD );
+
+			auto const u = 1.f - aT;
+			auto const invSin = 1.f / s;
+			auto const wa = simd::sin( u * angle ) * invSin;
+			auto const wb = simd::sin( aT * angle ) * invSin;
+
+			// Same fallback as slerp(). s may be zero in those lanes; the
+			// resulting infinities are discarded by the select.
+			auto const linear = aD > detail::kSlerpLinearThreshold_;
+			return blend_( aA, simd::select( linear, u, wa ), aB, simd::select( linear, aT, wb ) );
+		},
+		[] ( Quatf const& aA, Quatf const& aB, float aT ) {
+			return slerp( aA, aB, aT );
+		}
+	);
+}
+
+void batch_make_rigid( std::span<Quatf const> aRotations, std::span<Vec3f const> aTranslations, std::span<Mat34f> aOut ) noexcept
+{
+	assert( aRotations.size() >= aOut.size() );
+	assert( aTranslations.size() >= aOut.size() );
+
+	// A plain loop. The outputs are stored as whole matrices, so an explicit
+	// transpose into eight-wide vectors and back costs as much as it saves.
+	for( std::size_t i = 0; i < aOut.size(); ++i )
+		aOut[i] = make_rigid( aRotations[i], aTranslations[i] );
+}
@@ -0,0 +1,366 @@
+#ifndef SIMD_HPP_817B58ED_7897_4FDF_BBAA_8108D8CD4DDF
+#define SIMD_HPP_817B58ED_7897_4FDF_BBAA_8108D8CD4DDF
+
+/** SIMD configuration for vmlib
+ *
+ * The code paths are selected at compile time. The premake build passes
+ * -march=native with GCC and clang, so the compiler already tells us which
+ * instruction sets are available via the usual predefined macros:
+ *
+ *   VMLIB_SIMD_SSE  - SSE2 (always there on x86-64, including MSVC)
+ *   VMLIB_SIMD_AVX  - AVX (8-wide floats); MSVC requires /arch:AVX or later
+ *
+ * Define VMLIB_NO_SIMD before including any vmlib header to force the scalar
+ * reference implementations everywhere. The scalar versions are always
+ * available regardless (see the detail:: functions in mat44.hpp), so that
+ * tests and benchmarks can compare the two paths side by side.
+ *
+ * Non-x86 targets (e.g. Apple Silicon) currently fall back to the scalar
+ * code, which the compiler is free to auto-vectorize.
+ *
+ * Batch kernels are written against simd::Float4 and simd::Float8 (below),
+ * which hide the instruction set selection.
+ */
+
+#if !defined(VMLIB_NO_SIMD)
+#	if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#		define VMLIB_SIMD_SSE 1
+#	endif
+#	if defined(VMLIB_SIMD_SSE) && defined(__AVX__)
+#		define VMLIB_SIMD_AVX 1
+#	endif
+#endif // ~ VMLIB_NO_SIMD
+
+#if defined(VMLIB_SIMD_SSE)
+#	include <immintrin.h>
+#endif
+
+// Human readable name of the selected code path (for benchmark output).
+#if defined(VMLIB_SIMD_AVX)
+#	define VMLIB_SIMD_NAME "avx"
+#elif defined(VMLIB_SIMD_SSE)
+#	define VMLIB_SIMD_NAME "sse"
+#else
+#	define VMLIB_SIMD_NAME "scalar"
+#endif
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+/** simd::Float4, simd::Float8: 4- and 8-wide float vectors
+ *
+ * Thin wrappers that the batch kernels in vmlib are written against. Each maps
+ * onto a single register when the instruction set is available (SSE for
+ * Float4, AVX for Float8). Otherwise Float8 is made up of two Float4s, and
+ * Float4 of four plain floats. Kernels written with these therefore compile
+ * on every target, and use the widest code path available.
+ *
+ * Comparisons return a mask of the same type, where each lane is either all
+ * ones or all zeros (as with the SSE/AVX compare instructions). Masks are
+ * consumed by select(), any(), all() and the bitwise operators.
+ *
+ * Example:
+ *   for( ; i + simd::Float8::kWidth <= n; i += simd::Float8::kWidth )
+ *   {
+ *     auto const x = simd::load8( xs + i );
+ *     simd::store( out + i, simd::max( x * 2.f, 0.f ) );
+ *   }
+ */
+namespace simd
+{
+	struct Float4
+	{
+		static constexpr std::size_t kWidth = 4;
+
+#		if defined(VMLIB_SIMD_SSE)
+		__m128 v;
+
+		Float4() noexcept = default;
+		Float4( __m128 aV ) noexcept : v( aV ) {}
+		Float4( float aScalar ) noexcept : v( _mm_set1_ps( aScalar ) ) {}
+#		else
+		float v[4];
+
+		Float4() noexcept = default;
+		Float4( float aScalar ) noexcept : v{ aScalar, aScalar, aScalar, aScalar } {}
+#		endif
+	};
+
+	struct Float8
+	{
+		static constexpr std::size_t kWidth = 8;
+
+#		if defined(VMLIB_SIMD_AVX)
+		__m256 v;
+
+		Float8() noexcept = default;
+		Float8( __m256 aV ) noexcept : v( aV ) {}
+		Float8( float aScalar ) noexcept : v( _mm256_set1_ps( aScalar ) ) {}
+#		else
+		Float4 lo, hi;
+
+		Float8() noexcept = default;
+		Float8( Float4 aLo, Float4 aHi ) noexcept : lo( aLo ), hi( aHi ) {}
+		Float8( float aScalar ) noexcept : lo( aScalar ), hi( aScalar ) {}
+#		endif
+	};
+
+	// Float4 implementation
+#	if defined(VMLIB_SIMD_SSE)
+	inline Float4 load4( float const* aPtr ) noexcept { return _mm_loadu_ps( aPtr ); }
+	inline void store( float* aPtr, Float4 aV ) noexcept { _mm_storeu_ps( aPtr, aV.v ); }
+
+	inline Float4 operator+( Float4 aA, Float4 aB ) noexcept { return _mm_add_ps( aA.v, aB.v ); }
+	inline Float4 operator-( Float4 aA, Float4 aB ) noexcept { return _mm_sub_ps( aA.v, aB.v ); }
+	inline Float4 operator*( Float4 aA, Float4 aB ) noexcept { return _mm_mul_ps( aA.v, aB.v ); }
+	inline Float4 operator/( Float4 aA, Float4 aB ) noexcept { return _mm_div_ps( aA.v, aB.v ); }
+	inline Float4 operator-( Float4 aA ) noexcept { return _mm_xor_ps( aA.v, _mm_set1_ps( -0.f ) ); }
+
+	inline Float4 operator&( Float4 aA, Float4 aB ) noexcept { return _mm_and_ps( aA.v, aB.v ); }
+	inline Float4 operator|( Float4 aA, Float4 aB ) noexcept { return _mm_or_ps( aA.v, aB.v ); }
+	inline Float4 operator^( Float4 aA, Float4 aB ) noexcept { return _mm_xor_ps( aA.v, aB.v ); }
+
+	inline Float4 operator<( Float4 aA, Float4 aB ) noexcept { return _mm_cmplt_ps( aA.v, aB.v ); }
+	inline Float4 operator<=( Float4 aA, Float4 aB ) noexcept { return _mm_cmple_ps( aA.v, aB.v ); }
+	inline Float4 operator>( Float4 aA, Float4 aB ) noexcept { return _mm_cmpgt_ps( aA.v, aB.v ); }
+	inline Float4 operator>=( Float4 aA, Float4 aB ) noexcept { return _mm_cmpge_ps( aA.v, aB.v ); }
+
+	inline Float4 min( Float4 aA, Float4 aB ) noexcept { return _mm_min_ps( aA.v, aB.v ); }
+	inline Float4 max( Float4 aA, Float4 aB ) noexcept { return _mm_max_ps( aA.v, aB.v ); }
+	inline Float4 sqrt( Float4 aA ) noexcept { return _mm_sqrt_ps( aA.v ); }
+	inline Float4 abs( Float4 aA ) noexcept { return _mm_andnot_ps( _mm_set1_ps( -0.f ), aA.v ); }
+
+	// Round to nearest (ties to even). Without SSE4.1, this goes through a
+	// 32-bit integer conversion and is only valid for |aA| < 2^31.
+	inline Float4 round( Float4 aA ) noexcept
+	{
+#		if defined(__SSE4_1__)
+		return _mm_round_ps( aA.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC );
+#		else
+		return _mm_cvtepi32_ps( _mm_cvtps_epi32( aA.v ) );
+#		endif
+	}
+
+	// Approximate 1/sqrt(aA); relative error below 1.5 * 2^-12.
+	inline Float4 rsqrt_approx( Float4 aA ) noexcept { return _mm_rsqrt_ps( aA.v ); }
+
+	// Returns aA where aMask is set and aB elsewhere
+	inline Float4 select( Float4 aMask, Float4 aA, Float4 aB ) noexcept
+	{
+		return _mm_or_ps( _mm_and_ps( aMask.v, aA.v ), _mm_andnot_ps( aMask.v, aB.v ) );
+	}
+
+	// One bit per lane (bit i = sign bit of lane i)
+	inline int movemask( Float4 aMask ) noexcept { return _mm_movemask_ps( aMask.v ); }
+
+	inline float hmin( Float4 aA ) noexcept
+	{
+		__m128 m = _mm_min_ps( aA.v, _mm_movehl_ps( aA.v, aA.v ) );
+		m = _mm_min_ss( m, _mm_shuffle_ps( m, m, 0x55 ) );
+		return _mm_cvtss_f32( m );
+	}
+	inline float hmax( Float4 aA ) noexcept
+	{
+		__m128 m = _mm_max_ps( aA.v, _mm_movehl_ps( aA.v, aA.v ) );
+		m = _mm_max_ss( m, _mm_shuffle_ps( m, m, 0x55 ) );
+		return _mm_cvtss_f32( m );
+	}
+	inline float hsum( Float4 aA ) noexcept
+	{
+		__m128 m = _mm_add_ps( aA.v, _mm_movehl_ps( aA.v, aA.v ) );
+		m = _mm_add_ss( m, _mm_shuffle_ps( m, m, 0x55 ) );
+		return _mm_cvtss_f32( m );
+	}
+#	else // scalar Float4
+	namespace detail
+	{
+		template< typename tOp >
+		inline Float4 map_( Float4 aA, Float4 aB, tOp&& aOp ) noexcept
+		{
+			Float4 ret;
+			for( std::size_t i = 0; i < 4; ++i )
+				ret.v[i] = aOp( aA.v[i], aB.v[i] );
+			return ret;
+		}
+		template< typename tOp >
+		inline Float4 map_( Float4 aA, tOp&& aOp ) noexcept
+		{
+			Float4 ret;
+			for( std::size_t i = 0; i < 4; ++i )
+				ret.v[i] = aOp( aA.v[i] );
+			return ret;
+		}
+
+		inline float mask_( bool aSet ) noexcept
+		{
+			return std::bit_cast<float>( aSet ? ~std::uint32_t(0) : std::uint32_t(0) );
+		}
+		inline std::uint32_t bits_( float aX ) noexcept
+		{
+			return std::bit_cast<std::uint32_t>( aX );
+		}
+	}
+
+	inline Float4 load4( float const* aPtr ) noexcept
+	{
+		Float4 ret;
+		for( std::size_t i = 0; i < 4; ++i )
+			ret.v[i] = aPtr[i];
+		return ret;
+	}
+	inline void store( float* aPtr, Float4 aV ) noexcept
+	{
+		for( std::size_t i = 0; i < 4; ++i )
+			aPtr[i] = aV.v[i];
+	}
+
+	inline Float4 operator+( Float4 aA, Float4 aB ) noexcept { return detail::map_( aA, aB, []( float a, float b ) { return a + b; } ); }
+	inline Float4 operator-( Float4 aA, Float4 aB ) noexcept { return detail::map_( aA, aB, []( float a, float b ) { return a - b; } ); }
+	inline Float4 operator*( Float4 aA, Float4 aB ) noexcept { return detail::map_( aA, aB, []( float a, float b ) { return a * b; } ); }
+	inline Float4 operator/( Float4 aA, Float4 aB ) noexcept { return detail::map_( aA, aB, []( float a, float b ) { return a / b; } ); }
+	inline Float4 operator-( Float4 aA ) noexcept { return detail::map_( aA, []( float a ) { return -a; } ); }
+
+	inline Float4 operator&( Float4 aA, Float4 aB ) noexcept { return detail::map_( aA, aB, []( float a, float b ) { return std::bit_cast<float>( detail::bits_( a ) & detail::bits_( b ) ); } ); }
+	inline Float4 operator|( Float4 aA, Float4 aB ) noexcept { return detail::map_( aA, aB, []( float a, float b ) { return std::bit_cast<float>( detail::bits_( a ) | detail::bits_( b ) ); } ); }
+	inline Float4 operator^( Float4 aA, Float4 aB ) noexcept { return detail::map_( aA, aB, []( float a, float b ) { return std::bit_cast<float>( detail::bits_( a ) ^ detail::bits_( b ) ); } ); }
+
+	inline Float4 operator<( Float4 aA, Float4 aB ) noexcept { return detail::map_( aA, aB, []( float a, float b ) { return detail::mask_( a < b ); } ); }
+	inline Float4 operator<=( Float4 aA, Float4 aB ) noexcept { return detail::map_( aA, aB, []( float a, float b ) { return detail::mask_( a <= b ); } ); }
+	inline Float4 operator>( Float4 aA, Float4 aB ) noexcept { return detail::map_( aA, aB, []( float a, float b ) { return detail::mask_( a > b ); } ); }
+	inline Float4 operator>=( Float4 aA, Float4 aB ) noexcept { return detail::map_( aA, aB, []( float a, float b ) { return detail::mask_( a >= b ); } ); }
+
+	inline Float4 min( Float4 aA, Float4 aB ) noexcept { return detail::map_( aA, aB, []( float a, float b ) { return a < b ? a : b; } ); }
+	inline Float4 max( Float4 aA, Float4 aB ) noexcept { return detail::map_( aA, aB, []( float a, float b ) { return a > b ? a : b; } ); }
+	inline Float4 sqrt( Float4 aA ) noexcept { return detail::map_( aA, []( float a ) { return std::sqrt( a ); } ); }
+	inline Float4 abs( Float4 aA ) noexcept { return detail::map_( aA, []( float a ) { return std::abs( a ); } ); }
+	inline Float4 round( Float4 aA ) noexcept { return detail::map_( aA, []( float a ) { return std::nearbyint( a ); } ); }
+	inline Float4 rsqrt_approx( Float4 aA ) noexcept { return detail::map_( aA, []( float a ) { return 1.f / std::sqrt( a ); } ); }
+
+	inline Float4 select( Float4 aMask, Float4 aA, Float4 aB ) noexcept
+	{
+		Float4 ret;
+		for( std::size_t i = 0; i < 4; ++i )
+			ret.v[i] = detail::bits_( aMask.v[i] ) ? aA.v[i] : aB.v[i];
+		return ret;
+	}
+
+	inline int movemask( Float4 aMask ) noexcept
+	{
+		int ret = 0;
+		for( std::size_t i = 0; i < 4; ++i )
+			ret |= int(detail::bits_( aMask.v[i] ) >> 31) << i;
+		return ret;
+	}
+
+	inline float hmin( Float4 aA ) noexcept { return std::min( std::min( aA.v[0], aA.v[2] ), std::min( aA.v[1], aA.v[3] ) ); }
+	inline float hmax( Float4 aA ) noexcept { return std::max( std::max( aA.v[0], aA.v[2] ), std::max( aA.v[1], aA.v[3] ) ); }
+	inline float hsum( Float4 aA ) noexcept { return (aA.v[0] + aA.v[2]) + (aA.v[1] + aA.v[3]); }
+#	endif // ~ Float4
+
+	// Float8 implementation
+#	if defined(VMLIB_SIMD_AVX)
+	inline Float8 load8( float const* aPtr ) noexcept { return _mm256_loadu_ps( aPtr ); }
+	inline void store( float* aPtr, Float8 aV ) noexcept { _mm256_storeu_ps( aPtr, aV.v ); }
+
+	inline Float8 operator+( Float8 aA, Float8 aB ) noexcept { return _mm256_add_ps( aA.v, aB.v ); }
+	inline Float8 operator-( Float8 aA, Float8 aB ) noexcept { return _mm256_sub_ps( aA.v, aB.v ); }
+	inline Float8 operator*( Float8 aA, Float8 aB ) noexcept { return _mm256_mul_ps( aA.v, aB.v ); }
+	inline Float8 operator/( Float8 aA, Float8 aB ) noexcept { return _mm256_div_ps( aA.v, aB.v ); }
+	inline Float8 operator-( Float8 aA ) noexcept { return _mm256_xor_ps( aA.v, _mm256_set1_ps( -0.f ) ); }
+
+	inline Float8 operator&( Float8 aA, Float8 aB ) noexcept { return _mm256_and_ps( aA.v, aB.v ); }
+	inline Float8 operator|( Float8 aA, Float8 aB ) noexcept { return _mm256_or_ps( aA.v, aB.v ); }
+	inline Float8 operator^( Float8 aA, Float8 aB ) noexcept { return _mm256_xor_ps( aA.v, aB.v ); }
+
+	inline Float8 operator<( Float8 aA, Float8 aB ) noexcept { return _mm256_cmp_ps( aA.v, aB.v, _CMP_LT_OQ ); }
+	inline Float8 operator<=( Float8 aA, Float8 aB ) noexcept { return _mm256_cmp_ps( aA.v, aB.v, _CMP_LE_OQ ); }
+	inline Float8 operator>( Float8 aA, Float8 aB ) noexcept { return _mm256_cmp_ps( aA.v, aB.v, _CMP_GT_OQ ); }
+	inline Float8 operator>=( Float8 aA, Float8 aB ) noexcept { return _mm256_cmp_ps( aA.v, aB.v, _CMP_GE_OQ ); }
+
+	inline Float8 min( Float8 aA, Float8 aB ) noexcept { return _mm256_min_ps( aA.v, aB.v ); }
+	inline Float8 max( Float8 aA, Float8 aB ) noexcept { return _mm256_max_ps( aA.v, aB.v ); }
+	inline Float8 sqrt( Float8 aA ) noexcept { return _mm256_sqrt_ps( aA.v ); }
+	inline Float8 abs( Float8 aA ) noexcept { return _mm256_andnot_ps( _mm256_set1_ps( -0.f ), aA.v ); }
+	inline Float8 round( Float8 aA ) noexcept { return _mm256_round_ps( aA.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC ); }
+	inline Float8 rsqrt_approx( Float8 aA ) noexcept { return _mm256_rsqrt_ps( aA.v ); }
+
+	inline Float8 select( Float8 aMask, Float8 aA, Float8 aB ) noexcept
+	{
+		return _mm256_blendv_ps( aB.v, aA.v, aMask.v );
+	}
+
+	inline int movemask( Float8 aMask ) noexcept { return _mm256_movemask_ps( aMask.v ); }
+
+	inline Float4 low( Float8 aA ) noexcept { return _mm256_castps256_ps128( aA.v ); }
+	inline Float4 high( Float8 aA ) noexcept { return _mm256_extractf128_ps( aA.v, 1 ); }
+#	else // Float8 as two Float4
+	inline Float8 load8( float const* aPtr ) noexcept { return { load4( aPtr ), load4( aPtr + 4 ) }; }
+	inline void store( float* aPtr, Float8 aV ) noexcept { store( aPtr, aV.lo ); store( aPtr + 4, aV.hi ); }
+
+	inline Float8 operator+( Float8 aA, Float8 aB ) noexcept { return { aA.lo + aB.lo, aA.hi + aB.hi }; }
+	inline Float8 operator-( Float8 aA, Float8 aB ) noexcept { return { aA.lo - aB.lo, aA.hi - aB.hi }; }
+	inline Float8 operator*( Float8 aA, Float8 aB ) noexcept { return { aA.lo * aB.lo, aA.hi * aB.hi }; }
+	inline Float8 operator/( Float8 aA, Float8 aB ) noexcept { return { aA.lo / aB.lo, aA.hi / aB.hi }; }
+	inline Float8 operator-( Float8 aA ) noexcept { return { -aA.lo, -aA.hi }; }
+
+	inline Float8 operator&( Float8 aA, Float8 aB ) noexcept { return { aA.lo & aB.lo, aA.hi & aB.hi }; }
+	inline Float8 operator|( Float8 aA, Float8 aB ) noexcept { return { aA.lo | aB.lo, aA.hi | aB.hi }; }
+	inline Float8 operator^( Float8 aA, Float8 aB ) noexcept { return { aA.lo ^ aB.lo, aA.hi ^ aB.hi }; }
+
+	inline Float8 operator<( Float8 aA, Float8 aB ) noexcept { return { aA.lo < aB.lo, aA.hi < aB.hi }; }
+	inline Float8 operator<=( Float8 aA, Float8 aB ) noexcept { return { aA.lo <= aB.lo, aA.hi <= aB.hi }; }
+	inline Float8 operator>( Float8 aA, Float8 aB ) noexcept { return { aA.lo > aB.lo, aA.hi > aB.hi }; }
+	inline Float8 operator>=( Float8 aA, Float8 aB ) noexcept { return { aA.lo >= aB.lo, aA.hi >= aB.hi }; }
+
+	inline Float8 min( Float8 aA, Float8 aB ) noexcept { return { min( aA.lo, aB.lo ), min( aA.hi, aB.hi ) }; }
+	inline Float8 max( Float8 aA, Float8 aB ) noexcept { return { max( aA.lo, aB.lo ), max( aA.hi, aB.hi ) }; }
+	inline Float8 sqrt( Float8 aA ) noexcept { return { sqrt( aA.lo ), sqrt( aA.hi ) }; }
+	inline Float8 abs( Float8 aA ) noexcept { return { abs( aA.lo ), abs( aA.hi ) }; }
+	inline Float8 round( Float8 aA ) noexcept { return { round( aA.lo ), round( aA.hi ) }; }
+	inline Float8 rsqrt_approx( Float8 aA ) noexcept { return { rsqrt_approx( aA.lo ), rsqrt_approx( aA.hi ) }; }
+
+	inline Float8 select( Float8 aMask, Float8 aA, Float8 aB ) noexcept
+	{
+		return { select( aMask.lo, aA.lo, aB.lo ), select( aMask.hi, aA.hi, aB.hi ) };
+	}
+
+	inline int movemask( Float8 aMask ) noexcept { return movemask( aMask.lo ) | (movemask( aMask.hi ) << 4); }
+
+	inline Float4 low( Float8 aA ) noexcept { return aA.lo; }
+	inline Float4 high( Float8 aA ) noexcept { return aA.hi; }
+#	endif // ~ Float8
+
+	inline float hmin( Float8 aA ) noexcept { return hmin( min( low( aA ), high( aA ) ) ); }
+	inline float hmax( Float8 aA ) noexcept { return hmax( max( low( aA ), high( aA ) ) ); }
+	inline float hsum( Float8 aA ) noexcept { return hsum( low( aA ) + high( aA ) ); }
+
+	// Fused (when available) multiply-add: aA * aB + aC
+	inline Float4 fmadd( Float4 aA, Float4 aB, Float4 aC ) noexcept
+	{
+#		if defined(VMLIB_SIMD_SSE) && defined(__FMA__)
+		return _mm_fmadd_ps( aA.v, aB.v, aC.v );
+#		else
+		return aA * aB + aC;
+#		endif
+	}
+	inline Float8 fmadd( Float8 aA, Float8 aB, Float8 aC ) noexcept
+	{
+#		if defined(VMLIB_SIMD_AVX) && defined(__FMA__)
+		return _mm256_fmadd_ps( aA.v, aB.v, aC.v );
+#		elif defined(VMLIB_SIMD_AVX)
+		return aA * aB + aC;
+#		else
+		return { fmadd( aA.lo, aB.lo, aC.lo ), fmadd( aA.hi, aB.hi, aC.hi ) };
+#		endif
+	}
+
+	inline bool any( Float4 aMask ) noexcept { return 0 != movemask( aMask ); }
+	inline bool any( Float8 aMask ) noexcept { return 0 != movemask( aMask ); }
+	inline bool all( Float4 aMask ) noexcept { return 0xf == movemask( aMask ); }
+	inline bool all( Float8 aMask ) noexcept { return 0xff == movemask( aMask ); }
+}
+
+#endif // SIMD_HPP_817B58ED_7897_4FDF_BBAA_8108D8CD4DDF
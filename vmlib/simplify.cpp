@@ -0,0 +1,648 @@
+#include "simplify.hpp"
+
+#include "aabb.hpp"
+
+#include <cmath>
+#include <array>
+#include <queue>
+#include <tuple>
+#include <limits>
+#include <cassert>
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+	constexpr std::uint32_t kNone_ = std::numeric_limits<std::uint32_t>::max();
+
+	// Weight of the quadrics that hold open borders in place, relative to
+	// those of the faces.
+	constexpr double kBorderWeight_ = 10.0;
+
+	Vec3f cross_( Vec3f aA, Vec3f aB ) noexcept
+	{
+		return Vec3f{
+			aA.y * aB.z - aA.z * aB.y,
+			aA.z * aB.x - aA.x * aB.z,
+			aA.x * aB.y - aA.y * aB.x
+		};
+	}
+
+	// Sum of (weighted) squared distances to a set of planes n.p + d = 0,
+	// i.e., the symmetric 4x4 matrix [n n^T, n d; n^T d, d^2].
+	struct Quadric_
+	{
+		double a00, a01, a02, a11, a12, a22;
+		double b0, b1, b2;
+		double c;
+	};
+
+	void add_plane_( Quadric_& aQ, Vec3f aN, float aD, double aWeight ) noexcept
+	{
+		double const x = aN.x, y = aN.y, z = aN.z, d = aD;
+		aQ.a00 += aWeight * x * x;
+		aQ.a01 += aWeight * x * y;
+		aQ.a02 += aWeight * x * z;
+		aQ.a11 += aWeight * y * y;
+		aQ.a12 += aWeight * y * z;
+		aQ.a22 += aWeight * z * z;
+		aQ.b0 += aWeight * x * d;
+		aQ.b1 += aWeight * y * d;
+		aQ.b2 += aWeight * z * d;
+		aQ.c += aWeight * d * d;
+	}
+
+	Quadric_ operator+( Quadric_ const& aA, Quadric_ const& aB ) noexcept
+	{
+		return Quadric_{
+			aA.a00 + aB.a00, aA.a01 + aB.a01, aA.a02 + aB.a02, aA.a11 + aB.a11, aA.a12 + aB.a12, aA.a22 + aB.a22,
+			aA.b0 + aB.b0, aA.b1 + aB.b1, aA.b2 + aB.b2,
+			aA.c + aB.c
+		};
+	}
+
+	float evaluate_( Quadric_ const& aQ, Vec3f aP ) noexcept
+	{
+		double const x = aP.x, y = aP.y, z = aP.z;
+		double const q = aQ.a00 * x * x + aQ.a11 * y * y + aQ.a22 * z * z
+			+ 2.0 * (aQ.a01 * x * y + aQ.a02 * x * z + aQ.a12 * y * z)
+			+ 2.0 * (aQ.b0 * x + aQ.b1 * y + aQ.b2 * z)
+			+ aQ.c
+		;
+		return float(std::max( q, 0.0 ));
+	}
+
+	// Distance from aP to the triangle (aA,aB,aC). See Ericson, "Real-Time
+	// Collision Detection", 2005, section 5.1.5.
+	float distance_to_triangle_( Vec3f aP, Vec3f aA, Vec3f aB, Vec3f aC ) noexcept
+	{
+		Vec3f const ab = aB - aA, ac = aC - aA, ap = aP - aA;
+		float const d1 = dot( ab, ap ), d2 = dot( ac, ap );
+		if( d1 <= 0.f && d2 <= 0.f )
+			return length( aP - aA );
+
+		Vec3f const bp = aP - aB;
+		float const d3 = dot( ab, bp ), d4 = dot( ac, bp );
+		if( d3 >= 0.f && d4 <= d3 )
+			return length( aP - aB );
+
+		float const vc = d1 * d4 - d3 * d2;
+		if( vc <= 0.f && d1 >= 0.f && d3 <= 0.f )
+			return length( aP - (aA + d1 / (d1 - d3) * ab) );
+
+		Vec3f const cp = aP - aC;
+		float const d5 = dot( ab, cp ), d6 = dot( ac, cp );
+		if( d6 >= 0.f && d5 <= d6 )
+			return length( aP - aC );
+
+		float const vb = d5 * d2 - d1 * d6;
+		if( vb <= 0.f && d2 >= 0.f && d6 <= 0.f )
+			return length( aP - (aA + d2 / (d2 - d6) * ac) );
+
+		float const va = d3 * d6 - d5 * d4;
+		if( va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f )
+			return length( aP - (aB + (d4 - d3) / ((d4 - d3) + (d5 - d6)) * (aC - aB)) );
+
+		float const denom = 1.f / (va + vb + vc);
+		return length( aP - (aA + (vb * denom) * ab + (vc * denom) * ac) );
+	}
+
+	// Uniform grid over a set of triangles, for distance queries. Each cell
+	// lists the triangles whose bounds overlap it (cellStart/items as in a
+	// compressed sparse row matrix).
+	struct TriangleGrid_
+	{
+		std::vector<std::array<Vec3f,3>> triangles;
+		Aabb3f bounds;
+		float cellSize;
+		std::array<int,3> dims;
+		std::vector<std::uint32_t> cellStart;
+		std::vector<std::uint32_t> items;
+	};
+
+	TriangleGrid_ make_triangle_grid_( std::vector<std::array<Vec3f,3>> aTriangles )
+	{
+		constexpr int kMaxDim = 128;
+
+		TriangleGrid_ ret{ std::move(aTriangles), kEmptyAabb3f, 1.f, {}, {}, {} };
+		for( auto const& tri : ret.triangles )
+		{
+			for( auto const& p : tri )
+				expand( ret.bounds, p );
+		}
+
+		// About one cell per triangle on a (mostly) two-dimensional surface.
+		Vec3f const extent = ret.bounds.max - ret.bounds.min;
+		float const maxExtent = std::max( { extent.x, extent.y, extent.z } );
+		float const cellsPerAxis = std::ceil( std::sqrt( float(ret.triangles.size()) ) );
+		ret.cellSize = maxExtent > 0.f ? maxExtent / std::min( cellsPerAxis, float(kMaxDim) ) : 1.f;
+		for( std::size_t i = 0; i < 3; ++i )
+			ret.dims[i] = std::clamp( int(extent[i] / ret.cellSize) + 1, 1, kMaxDim );
+
+		auto const cell_range = [&] ( std::array<Vec3f,3> const& aTri, std::array<int,3>& aLo, std::array<int,3>& aHi ) {
+			for( std::size_t i = 0; i < 3; ++i )
+			{
+				float const lo = std::min( { aTri[0][i], aTri[1][i], aTri[2][i] } );
+				float const hi = std::max( { aTri[0][i], aTri[1][i], aTri[2][i] } );
+				aLo[i] = std::clamp( int((lo - ret.bounds.min[i]) / ret.cellSize), 0, ret.dims[i] - 1 );
+				aHi[i] = std::clamp( int((hi - ret.bounds.min[i]) / ret.cellSize), 0, ret.dims[i] - 1 );
+			}
+		};
+		auto const for_each_cell = [&] ( std::array<Vec3f,3> const& aTri, auto&& aBody ) {
+			std::array<int,3> lo, hi;
+			cell_range( aTri, lo, hi );
+			for( int z = lo[2]; z <= hi[2]; ++z )
+				for( int y = lo[1]; y <= hi[1]; ++y )
+					for( int x = lo[0]; x <= hi[0]; ++x )
+						aBody( std::size_t(x) + std::size_t(ret.dims[0]) * (std::size_t(y) + std::size_t(ret.dims[1]) * std::size_t(z)) );
+		};
+
+		std::size_t const cells = std::size_t(ret.dims[0]) * std::size_t(ret.dims[1]) * std::size_t(ret.dims[2]);
+		ret.cellStart.assign( cells + 1, 0 );
+		for( auto const& tri : ret.triangles )
+			for_each_cell( tri, [&] ( std::size_t aCell ) { ++ret.cellStart[aCell + 1]; } );
+		for( std::size_t i = 0; i < cells; ++i )
+			ret.cellStart[i+1] += ret.cellStart[i];
+
+		ret.items.resize( ret.cellStart.back() );
+		std::vector<std::uint32_t> fill( ret.cellStart.begin(), ret.cellStart.end() - 1 );
+		for( std::size_t t = 0; t < ret.triangles.size(); ++t )
+			for_each_cell( ret.triangles[t], [&] ( std::size_t aCell ) { ret.items[fill[aCell]++] = static_cast<std::uint32_t>( t ); } );
+
+		return ret;
+	}
+
+	// Searches shells of cells around aP until no unsearched cell can hold a
+	// closer triangle.
+	float distance_to_surface_( TriangleGrid_ const& aGrid, Vec3f aP ) noexcept
+	{
+		std::array<int,3> center;
+		for( std::size_t i = 0; i < 3; ++i )
+			center[i] = std::clamp( int((aP[i] - aGrid.bounds.min[i]) / aGrid.cellSize), 0, aGrid.dims[i] - 1 );
+
+		int const maxRing = std::max( { aGrid.dims[0], aGrid.dims[1], aGrid.dims[2] } );
+		float best = std::numeric_limits<float>::max();
+		for( int ring = 0; ring < maxRing; ++ring )
+		{
+			std::array<int,3> lo, hi;
+			for( std::size_t i = 0; i < 3; ++i )
+			{
+				lo[i] = std::max( center[i] - ring, 0 );
+				hi[i] = std::min( center[i] + ring, aGrid.dims[i] - 1 );
+			}
+
+			for( int z = lo[2]; z <= hi[2]; ++z )
+			{
+				for( int y = lo[1]; y <= hi[1]; ++y )
+				{
+					for( int x = lo[0]; x <= hi[0]; ++x )
+					{
+						if( std::max( { std::abs( x - center[0] ), std::abs( y - center[1] ), std::abs( z - center[2] ) } ) != ring )
+							continue;
+
+						std::size_t const cell = std::size_t(x) + std::size_t(aGrid.dims[0]) * (std::size_t(y) + std::size_t(aGrid.dims[1]) * std::size_t(z));
+						for( auto i = aGrid.cellStart[cell]; i < aGrid.cellStart[cell+1]; ++i )
+						{
+							auto const& tri = aGrid.triangles[aGrid.items[i]];
+							best = std::min( best, distance_to_triangle_( aP, tri[0], tri[1], tri[2] ) );
+						}
+					}
+				}
+			}
+
+			// Anything not searched yet is beyond the searched block.
+			float reach = std::numeric_limits<float>::max();
+			for( std::size_t i = 0; i < 3; ++i )
+			{
+				if( lo[i] > 0 )
+					reach = std::min( reach, aP[i] - (aGrid.bounds.min[i] + float(lo[i]) * aGrid.cellSize) );
+				if( hi[i] < aGrid.dims[i] - 1 )
+					reach = std::min( reach, aGrid.bounds.min[i] + float(hi[i] + 1) * aGrid.cellSize - aP[i] );
+			}
+			if( best <= reach )
+				break;
+		}
+
+		return best;
+	}
+
+	struct Collapse_
+	{
+		float cost;
+		std::uint32_t from, to;
+		std::uint32_t fromStamp, toStamp;
+
+		bool operator>( Collapse_ const& aOther ) const noexcept
+		{
+			return cost > aOther.cost;
+		}
+	};
+}
+
+SimplifiedMesh simplify_mesh( std::span<std::uint32_t const> aIndices, std::span<Vec3f const> aPositions, std::span<Vec3f const> aNormals, std::span<std::uint32_t const> aMaterials, std::size_t aTargetIndexCount )
+{
+	assert( aIndices.size() % 3 == 0 );
+	assert( aNormals.empty() || aNormals.size() == aPositions.size() );
+	assert( aMaterials.empty() || aMaterials.size() == aPositions.size() );
+
+	std::size_t const vertexCount = aPositions.size();
+	auto const material_of = [&] ( std::uint32_t aVertex ) {
+		return aMaterials.empty() ? 0u : aMaterials[aVertex];
+	};
+	auto const position_key = [&] ( std::uint32_t aVertex ) {
+		auto const& p = aPositions[aVertex];
+		return std::make_tuple( p.x, p.y, p.z );
+	};
+
+	// Corners: vertices with the same position and material. The vertices
+	// of corner c are vertexOrder[cornerFirst[c]] ... [cornerFirst[c+1]-1].
+	// Only referenced vertices count; others may, e.g., be on a material
+	// boundary that the triangles do not use.
+	std::vector<std::uint8_t> referenced( vertexCount, 0 );
+	for( auto const index : aIndices )
+	{
+		assert( index < vertexCount );
+		referenced[index] = 1;
+	}
+
+	std::vector<std::uint32_t> vertexOrder;
+	for( std::size_t v = 0; v < vertexCount; ++v )
+	{
+		if( referenced[v] )
+			vertexOrder.emplace_back( static_cast<std::uint32_t>( v ) );
+	}
+	std::sort( vertexOrder.begin(), vertexOrder.end(), [&] ( std::uint32_t aA, std::uint32_t aB ) {
+		return std::make_tuple( position_key( aA ), material_of( aA ), aA ) < std::make_tuple( position_key( aB ), material_of( aB ), aB );
+	} );
+
+	std::vector<std::uint32_t> cornerOf( vertexCount, kNone_ );
+	std::vector<std::uint32_t> cornerFirst;
+	std::vector<std::uint8_t> locked;
+	for( std::size_t i = 0; i < vertexOrder.size(); ++i )
+	{
+		auto const v = vertexOrder[i];
+		bool const samePosition = i > 0 && position_key( vertexOrder[i-1] ) == position_key( v );
+		if( !samePosition || material_of( vertexOrder[i-1] ) != material_of( v ) )
+		{
+			// A position with several materials is on a material boundary.
+			if( samePosition )
+			{
+				locked.back() = 1;
+				locked.emplace_back( 1 );
+			}
+			else
+			{
+				locked.emplace_back( 0 );
+			}
+			cornerFirst.emplace_back( static_cast<std::uint32_t>( i ) );
+		}
+		cornerOf[v] = static_cast<std::uint32_t>( cornerFirst.size() - 1 );
+	}
+	cornerFirst.emplace_back( static_cast<std::uint32_t>( vertexOrder.size() ) );
+
+	std::size_t const cornerCount = cornerFirst.size() - 1;
+	auto const corner_position = [&] ( std::uint32_t aCorner ) {
+		return aPositions[vertexOrder[cornerFirst[aCorner]]];
+	};
+
+	// Triangles, in terms of corners.
+	std::size_t const triangleCount = aIndices.size() / 3;
+	std::vector<std::array<std::uint32_t,3>> triangles( triangleCount );
+	std::vector<std::uint8_t> alive( triangleCount, 0 );
+	std::vector<std::vector<std::uint32_t>> cornerTriangles( cornerCount );
+	std::size_t liveTriangles = 0;
+	for( std::size_t t = 0; t < triangleCount; ++t )
+	{
+		auto& tri = triangles[t];
+		for( std::size_t k = 0; k < 3; ++k )
+			tri[k] = cornerOf[aIndices[3*t+k]];
+
+		if( tri[0] == tri[1] || tri[1] == tri[2] || tri[2] == tri[0] )
+			continue;
+
+		alive[t] = 1;
+		++liveTriangles;
+		for( auto const c : tri )
+			cornerTriangles[c].emplace_back( static_cast<std::uint32_t>( t ) );
+	}
+
+	// Face quadrics, weighted by area.
+	std::vector<Quadric_> quadrics( cornerCount, Quadric_{} );
+	for( std::size_t t = 0; t < triangleCount; ++t )
+	{
+		if( !alive[t] )
+			continue;
+
+		auto const& tri = triangles[t];
+		Vec3f const p0 = corner_position( tri[0] );
+		Vec3f n = cross_( corner_position( tri[1] ) - p0, corner_position( tri[2] ) - p0 );
+		float const area2 = length( n );
+		if( !(area2 > 0.f) )
+			continue;
+
+		n = n / area2;
+		for( auto const c : tri )
+			add_plane_( quadrics[c], n, -dot( n, p0 ), 0.5 * area2 );
+	}
+
+	// Edges: open borders get quadrics perpendicular to their triangle;
+	// edges with more than two triangles lock their corners.
+	std::vector<std::uint8_t> border( cornerCount, 0 );
+	{
+		std::vector<std::pair<std::uint64_t,std::uint32_t>> edges;
+		edges.reserve( 3 * liveTriangles );
+		for( std::size_t t = 0; t < triangleCount; ++t )
+		{
+			if( !alive[t] )
+				continue;
+
+			for( std::size_t k = 0; k < 3; ++k )
+			{
+				auto const a = triangles[t][k], b = triangles[t][(k+1) % 3];
+				edges.emplace_back( (std::uint64_t(std::min( a, b )) << 32) | std::max( a, b ), static_cast<std::uint32_t>( t*3 + k ) );
+			}
+		}
+		std::sort( edges.begin(), edges.end() );
+
+		for( std::size_t first = 0; first < edges.size(); )
+		{
+			std::size_t end = first + 1;
+			while( end < edges.size() && edges[end].first == edges[first].first )
+				++end;
+
+			auto const a = static_cast<std::uint32_t>( edges[first].first >> 32 );
+			auto const b = static_cast<std::uint32_t>( edges[first].first );
+			if( end - first > 2 )
+			{
+				locked[a] = locked[b] = 1;
+			}
+			else if( end - first == 1 )
+			{
+				border[a] = border[b] = 1;
+
+				auto const t = edges[first].second / 3, k = edges[first].second % 3;
+				Vec3f const p0 = corner_position( triangles[t][k] );
+				Vec3f const p1 = corner_position( triangles[t][(k+1) % 3] );
+				Vec3f const p2 = corner_position( triangles[t][(k+2) % 3] );
+
+				Vec3f const e = p1 - p0;
+				Vec3f m = cross_( e, cross_( e, p2 - p0 ) );
+				if( float const len = length( m ); len > 0.f )
+				{
+					m = m / len;
+					double const weight = kBorderWeight_ * dot( e, e );
+					add_plane_( quadrics[a], m, -dot( m, p0 ), weight );
+					add_plane_( quadrics[b], m, -dot( m, p0 ), weight );
+				}
+			}
+
+			first = end;
+		}
+	}
+
+	// Greedy collapses, cheapest first. Entries are invalidated lazily: each
+	// corner has a stamp that changes when the corner's quadric or
+	// neighbourhood changes.
+	std::vector<std::uint32_t> stamps( cornerCount, 0 );
+	std::vector<std::uint32_t> collapsedInto( cornerCount, kNone_ );
+	std::priority_queue<Collapse_, std::vector<Collapse_>, std::greater<Collapse_>> queue;
+
+	auto const cornerMaterial = [&] ( std::uint32_t aCorner ) {
+		return material_of( vertexOrder[cornerFirst[aCorner]] );
+	};
+	auto const push = [&] ( std::uint32_t aFrom, std::uint32_t aTo ) {
+		if( locked[aFrom] || cornerMaterial( aFrom ) != cornerMaterial( aTo ) )
+			return;
+
+		float const cost = evaluate_( quadrics[aFrom] + quadrics[aTo], corner_position( aTo ) );
+		queue.emplace( Collapse_{ cost, aFrom, aTo, stamps[aFrom], stamps[aTo] } );
+	};
+
+	for( std::size_t t = 0; t < triangleCount; ++t )
+	{
+		if( !alive[t] )
+			continue;
+
+		for( std::size_t k = 0; k < 3; ++k )
+		{
+			push( triangles[t][k], triangles[t][(k+1) % 3] );
+			push( triangles[t][(k+1) % 3], triangles[t][k] );
+		}
+	}
+
+	std::vector<std::uint32_t> fromNeighbours, toNeighbours;
+	auto const gather_neighbours = [&] ( std::uint32_t aCorner, std::vector<std::uint32_t>& aOut ) {
+		aOut.clear();
+		for( auto const t : cornerTriangles[aCorner] )
+		{
+			if( !alive[t] )
+				continue;
+			for( auto const c : triangles[t] )
+			{
+				if( c != aCorner )
+					aOut.emplace_back( c );
+			}
+		}
+		std::sort( aOut.begin(), aOut.end() );
+		aOut.erase( std::unique( aOut.begin(), aOut.end() ), aOut.end() );
+	};
+
+	auto const can_collapse = [&] ( std::uint32_t aFrom, std::uint32_t aTo ) {
+		std::size_t shared = 0;
+		for( auto const t : cornerTriangles[aFrom] )
+		{
+			if( alive[t] && std::find( triangles[t].begin(), triangles[t].end(), aTo ) != triangles[t].end() )
+				++shared;
+		}
+
+		// Still an edge; border corners only move along the border.
+		if( 0 == shared || (border[aFrom] && 1 != shared) )
+			return false;
+
+		// Link condition: the corners adjacent to both are exactly those
+		// opposite the edge. Otherwise the collapse pinches the surface.
+		gather_neighbours( aFrom, fromNeighbours );
+		gather_neighbours( aTo, toNeighbours );
+
+		std::size_t common = 0;
+		for( std::size_t i = 0, j = 0; i < fromNeighbours.size() && j < toNeighbours.size(); )
+		{
+			if( fromNeighbours[i] < toNeighbours[j] )
+				++i;
+			else if( toNeighbours[j] < fromNeighbours[i] )
+				++j;
+			else
+			{
+				++common;
+				++i;
+				++j;
+			}
+		}
+		if( common != shared )
+			return false;
+
+		// No remaining triangle may flip or turn sharply (which also rules out
+		// slivers), or end up on top of an existing one (e.g., when
+		// collapsing a tetrahedron).
+		Vec3f const target = corner_position( aTo );
+		for( auto const t : cornerTriangles[aFrom] )
+		{
+			auto const& tri = triangles[t];
+			if( !alive[t] || std::find( tri.begin(), tri.end(), aTo ) != tri.end() )
+				continue;
+
+			auto moved = tri;
+			*std::find( moved.begin(), moved.end(), aFrom ) = aTo;
+			std::sort( moved.begin(), moved.end() );
+			for( auto const u : cornerTriangles[aTo] )
+			{
+				auto other = triangles[u];
+				std::sort( other.begin(), other.end() );
+				if( alive[u] && other == moved )
+					return false;
+			}
+
+			std::array<Vec3f,3> before, after;
+			for( std::size_t k = 0; k < 3; ++k )
+			{
+				before[k] = corner_position( tri[k] );
+				after[k] = tri[k] == aFrom ? target : before[k];
+			}
+
+			Vec3f const n0 = cross_( before[1] - before[0], before[2] - before[0] );
+			Vec3f const n1 = cross_( after[1] - after[0], after[2] - after[0] );
+			if( dot( n0, n1 ) <= 0.25f * length( n0 ) * length( n1 ) )
+				return false;
+		}
+
+		return true;
+	};
+
+	while( liveTriangles * 3 > aTargetIndexCount && !queue.empty() )
+	{
+		auto const collapse = queue.top();
+		queue.pop();
+
+		auto const from = collapse.from, to = collapse.to;
+		if( stamps[from] != collapse.fromStamp || stamps[to] != collapse.toStamp )
+			continue;
+		if( !can_collapse( from, to ) )
+			continue;
+
+		for( auto const t : cornerTriangles[from] )
+		{
+			if( !alive[t] )
+				continue;
+
+			auto& tri = triangles[t];
+			if( std::find( tri.begin(), tri.end(), to ) != tri.end() )
+			{
+				alive[t] = 0;
+				--liveTriangles;
+				continue;
+			}
+
+			*std::find( tri.begin(), tri.end(), from ) = to;
+			cornerTriangles[to].emplace_back( t );
+		}
+
+		cornerTriangles[from].clear();
+		std::erase_if( cornerTriangles[to], [&] ( std::uint32_t aT ) { return !alive[aT]; } );
+
+		quadrics[to] = quadrics[to] + quadrics[from];
+		collapsedInto[from] = to;
+		++stamps[from];
+		++stamps[to];
+
+		gather_neighbours( to, toNeighbours );
+		for( auto const n : toNeighbours )
+		{
+			push( to, n );
+			push( n, to );
+		}
+	}
+
+	SimplifiedMesh ret{ {}, 0.f };
+	ret.indices.reserve( liveTriangles * 3 );
+	for( std::size_t t = 0; t < triangleCount; ++t )
+	{
+		if( !alive[t] )
+			continue;
+
+		for( std::size_t k = 0; k < 3; ++k )
+		{
+			auto const original = aIndices[3*t+k];
+			auto const corner = triangles[t][k];
+			if( cornerOf[original] == corner || aNormals.empty() )
+			{
+				ret.indices.emplace_back( cornerOf[original] == corner ? original : vertexOrder[cornerFirst[corner]] );
+				continue;
+			}
+
+			// Pick the corner's vertex whose normal is closest to ours.
+			std::uint32_t best = vertexOrder[cornerFirst[corner]];
+			float bestDot = std::numeric_limits<float>::lowest();
+			for( auto i = cornerFirst[corner]; i < cornerFirst[corner+1]; ++i )
+			{
+				float const d = dot( aNormals[vertexOrder[i]], aNormals[original] );
+				if( d > bestDot )
+				{
+					best = vertexOrder[i];
+					bestDot = d;
+				}
+			}
+			ret.indices.emplace_back( best );
+		}
+	}
+
+	// Error: distance from the collapsed corners to the result.
+	std::vector<std::array<Vec3f,3>> result;
+	result.reserve( liveTriangles );
+	for( std::size_t t = 0; t < triangleCount; ++t )
+	{
+		if( alive[t] )
+			result.push_back( { corner_position( triangles[t][0] ), corner_position( triangles[t][1] ), corner_position( triangles[t][2] ) } );
+	}
+
+	if( !result.empty() )
+	{
+		auto const grid = make_triangle_grid_( std::move(result) );
+		for( std::size_t c = 0; c < cornerCount; ++c )
+		{
+			if( kNone_ != collapsedInto[c] )
+				ret.error = std::max( ret.error, distance_to_surface_( grid, corner_position( static_cast<std::uint32_t>( c ) ) ) );
+		}
+	}
+
+	return ret;
+}
+
+std::vector<MeshLod> build_lod_chain( std::vector<std::uint32_t>& aIndices, std::span<Vec3f const> aPositions, std::span<Vec3f const> aNormals, std::span<std::uint32_t const> aMaterials, std::span<float const> aTargetRatios )
+{
+	assert( aTargetRatios.size() < kMaxLodLevels );
+	assert( aIndices.size() <= std::numeric_limits<std::uint32_t>::max() );
+
+	// Each level is simplified from the full mesh, so that its error is
+	// measured against the original surface.
+	std::vector<std::uint32_t> const base( aIndices.begin(), aIndices.end() );
+
+	std::vector<MeshLod> ret{ MeshLod{ 0, static_cast<std::uint32_t>( base.size() ), 0.f } };
+	for( auto const ratio : aTargetRatios )
+	{
+		std::size_t const target = static_cast<std::size_t>( double(base.size() / 3) * std::clamp( double(ratio), 0.0, 1.0 ) ) * 3;
+		auto const simplified = simplify_mesh( base, aPositions, aNormals, aMaterials, target );
+
+		auto const previous = ret.back();
+		if( simplified.indices.empty() || simplified.indices.size() >= previous.indexCount )
+			break;
+
+		ret.emplace_back( MeshLod{
+			static_cast<std::uint32_t>( aIndices.size() ),
+			static_cast<std::uint32_t>( simplified.indices.size() ),
+			std::max( previous.error, simplified.error )
+		} );
+		aIndices.insert( aIndices.end(), simplified.indices.begin(), simplified.indices.end() );
+	}
+
+	return ret;
+}
@@ -0,0 +1,65 @@
+#ifndef SIMPLIFY_HPP_B52E8D07_13C9_4F6A_9E24_7D0A6C85F1B3
+#define SIMPLIFY_HPP_B52E8D07_13C9_4F6A_9E24_7D0A6C85F1B3
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "lod.hpp"
+#include "vec3.hpp"
+
+/** Mesh simplification with quadric error metrics
+ *
+ * simplify_mesh() reduces an indexed triangle mesh by repeatedly collapsing
+ * the edge that changes the surface least (Garland and Heckbert, "Surface
+ * Simplification Using Quadric Error Metrics", 1997). Collapses move one
+ * vertex onto a neighbouring one (half-edge collapses), so the result only
+ * references existing vertices and can share the vertex buffer with the
+ * input.
+ *
+ * The simplifier works on corners: vertices with the same position and
+ * material are treated as one, even if their other attributes (e.g.,
+ * normals at hard edges) differ. Each corner of the output uses the vertex of
+ * its (possibly new) corner whose normal is closest to the original one.
+ *
+ * Material boundaries are kept exactly: a corner whose position is shared
+ * with a corner of a different material never moves, and no collapse joins
+ * two materials. Open borders of the mesh may only collapse along the
+ * border, and are held in place by additional quadrics.
+ *
+ * Collapses that would flip (or sharply turn) a triangle or make the mesh
+ * non-manifold are skipped, so the target may not be reached.
+ *
+ * The reported error is the largest distance from a removed corner to the
+ * simplified surface: an estimate of the one-sided Hausdorff distance from
+ * the input to the result.
+ */
+struct SimplifiedMesh
+{
+	std::vector<std::uint32_t> indices;
+	float error;
+};
+
+// aNormals and aMaterials are per vertex, and may be empty (all normals and
+// materials the same).
+SimplifiedMesh simplify_mesh( std::span<std::uint32_t const> aIndices, std::span<Vec3f const> aPositions, std::span<Vec3f const> aNormals, std::span<std::uint32_t const> aMaterials, std::size_t aTargetIndexCount );
+
+// Builds a chain of levels of detail from the mesh in aIndices. Level 0 is
+// the mesh itself; level k is simplified to aTargetRatios[k-1] of its
+// triangles (ratios should decrease). The chain ends early if a level is no
+// smaller than the previous one. The indices of the new levels are appended
+// to aIndices.
+std::vector<MeshLod> build_lod_chain( std::vector<std::uint32_t>& aIndices, std::span<Vec3f const> aPositions, std::span<Vec3f const> aNormals, std::span<std::uint32_t const> aMaterials, std::span<float const> aTargetRatios );
+
+// Gathers the normals of aVertices for simplify_mesh().
+template< class tVertex >
+std::vector<Vec3f> extract_normals( std::span<tVertex const> aVertices )
+{
+	std::vector<Vec3f> ret( aVertices.size() );
+	for( std::size_t i = 0; i < aVertices.size(); ++i )
+		ret[i] = aVertices[i].normal;
+	return ret;
+}
+
+#endif // SIMPLIFY_HPP_B52E8D07_13C9_4F6A_9E24_7D0A6C85F1B3
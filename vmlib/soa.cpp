@@ -0,0 +1,180 @@
+#include "soa.hpp"
+
+#include "simd.hpp"
+
+namespace
+{
+	using FloatN_ = simd::Float8;
+	constexpr std::size_t kWidth_ = FloatN_::kWidth;
+
+	// Shared by the point and direction transforms; aW is the implicit fourth
+	// component (1 for points, 0 for directions).
+	void transform_( Mat44f const& aM, Vec3fSoA const& aIn, Vec3fSoA& aOut, float aW )
+	{
+		std::size_t const count = aIn.size();
+		aOut.resize( count );
+
+		float const* ix = aIn.x.data();
+		float const* iy = aIn.y.data();
+		float const* iz = aIn.z.data();
+		float* ox = aOut.x.data();
+		float* oy = aOut.y.data();
+		float* oz = aOut.z.data();
+
+		std::size_t i = 0;
+
+		FloatN_ const m00 = aM[0,0], m01 = aM[0,1], m02 = aM[0,2], m03 = aM[0,3] * aW;
+		FloatN_ const m10 = aM[1,0], m11 = aM[1,1], m12 = aM[1,2], m13 = aM[1,3] * aW;
+		FloatN_ const m20 = aM[2,0], m21 = aM[2,1], m22 = aM[2,2], m23 = aM[2,3] * aW;
+		for( ; i + kWidth_ <= count; i += kWidth_ )
+		{
+			auto const x = simd::load8( ix + i );
+			auto const y = simd::load8( iy + i );
+			auto const z = simd::load8( iz + i );
+
+			simd::store( ox + i, m00 * x + m01 * y + m02 * z + m03 );
+			simd::store( oy + i, m10 * x + m11 * y + m12 * z + m13 );
+			simd::store( oz + i, m20 * x + m21 * y + m22 * z + m23 );
+		}
+
+		for( ; i < count; ++i )
+		{
+			float const x = ix[i], y = iy[i], z = iz[i];
+			ox[i] = aM[0,0] * x + aM[0,1] * y + aM[0,2] * z + aM[0,3] * aW;
+			oy[i] = aM[1,0] * x + aM[1,1] * y + aM[1,2] * z + aM[1,3] * aW;
+			oz[i] = aM[2,0] * x + aM[2,1] * y + aM[2,2] * z + aM[2,3] * aW;
+		}
+	}
+}
+
+Vec3fSoA make_soa( std::span<Vec3f const> aVecs )
+{
+	Vec3fSoA ret;
+	ret.resize( aVecs.size() );
+	for( std::size_t i = 0; i < aVecs.size(); ++i )
+		ret.set( i, aVecs[i] );
+	return ret;
+}
+
+void copy_to_aos( Vec3fSoA const& aSoA, std::span<Vec3f> aOut ) noexcept
+{
+	assert( aOut.size() >= aSoA.size() );
+	for( std::size_t i = 0; i < aSoA.size(); ++i )
+		aOut[i] = aSoA.get( i );
+}
+
+void batch_transform_points( Mat44f const& aM, Vec3fSoA const& aIn, Vec3fSoA& aOut )
+{
+	transform_( aM, aIn, aOut, 1.f );
+}
+void batch_transform_directions( Mat44f const& aM, Vec3fSoA const& aIn, Vec3fSoA& aOut )
+{
+	transform_( aM, aIn, aOut, 0.f );
+}
+
+Aabb3f batch_bounds( Vec3fSoA const& aVecs ) noexcept
+{
+	std::size_t const count = aVecs.size();
+	float const* xs = aVecs.x.data();
+	float const* ys = aVecs.y.data();
+	float const* zs = aVecs.z.data();
+
+	Aabb3f ret = kEmptyAabb3f;
+
+	std::size_t i = 0;
+	if( count >= kWidth_ )
+	{
+		FloatN_ minX = ret.min.x, minY = ret.min.y, minZ = ret.min.z;
+		FloatN_ maxX = ret.max.x, maxY = ret.max.y, maxZ = ret.max.z;
+		for( ; i + kWidth_ <= count; i += kWidth_ )
+		{
+			auto const x = simd::load8( xs + i );
+			auto const y = simd::load8( ys + i );
+			auto const z = simd::load8( zs + i );
+			minX = simd::min( minX, x ); maxX = simd::max( maxX, x );
+			minY = simd::min( minY, y ); maxY = simd::max( maxY, y );
+			minZ = simd::min( minZ, z ); maxZ = simd::max( maxZ, z );
+		}
+
+		ret.min = Vec3f{ simd::hmin( minX ), simd::hmin( minY ), simd::hmin( minZ ) };
+		ret.max = Vec3f{ simd::hmax( maxX ), simd::hmax( maxY ), simd::hmax( maxZ ) };
+	}
+
+	for( ; i < count; ++i )
+		expand( ret, Vec3f{ xs[i], ys[i], zs[i] } );
+
+	return ret;
+}
+
+void batch_normalize( Vec3fSoA& aVecs, Vec3f aFallback, float aEpsilon ) noexcept
+{
+	std::size_t const count = aVecs.size();
+	float* xs = aVecs.x.data();
+	float* ys = aVecs.y.data();
+	float* zs = aVecs.z.data();
+
+	std::size_t i = 0;
+
+	FloatN_ const eps = aEpsilon;
+	FloatN_ const fx = aFallback.x, fy = aFallback.y, fz = aFallback.z;
+	for( ; i + kWidth_ <= count; i += kWidth_ )
+	{
+		auto const x = simd::load8( xs + i );
+		auto const y = simd::load8( ys + i );
+		auto const z = simd::load8( zs + i );
+
+		// A true division rather than a reciprocal square root estimate, so
+		// that the results match normalize() to within rounding.
+		auto const len = simd::sqrt( x * x + y * y + z * z );
+		auto const valid = len > eps;
+
+		simd::store( xs + i, simd::select( valid, x / len, fx ) );
+		simd::store( ys + i, simd::select( valid, y / len, fy ) );
+		simd::store( zs + i, simd::select( valid, z / len, fz ) );
+	}
+
+	for( ; i < count; ++i )
+	{
+		Vec3f const v{ xs[i], ys[i], zs[i] };
+		float const len = length( v );
+		aVecs.set( i, len > aEpsilon ? v / len : aFallback );
+	}
+}
+
+void batch_dot( Vec3fSoA const& aA, Vec3fSoA const& aB, std::span<float> aOut ) noexcept
+{
+	std::size_t const count = aA.size();
+	assert( aB.size() >= count && aOut.size() >= count );
+
+	std::size_t i = 0;
+	for( ; i + kWidth_ <= count; i += kWidth_ )
+	{
+		auto const d = simd::load8( aA.x.data() + i ) * simd::load8( aB.x.data() + i )
+			+ simd::load8( aA.y.data() + i ) * simd::load8( aB.y.data() + i )
+			+ simd::load8( aA.z.data() + i ) * simd::load8( aB.z.data() + i );
+		simd::store( aOut.data() + i, d );
+	}
+
+	for( ; i < count; ++i )
+		aOut[i] = dot( aA.get( i ), aB.get( i ) );
+}
+
+void batch_dot( Vec3fSoA const& aA, Vec3f aB, std::span<float> aOut ) noexcept
+{
+	std::size_t const count = aA.size();
+	assert( aOut.size() >= count );
+
+	std::size_t i = 0;
+
+	FloatN_ const bx = aB.x, by = aB.y, bz = aB.z;
+	for( ; i + kWidth_ <= count; i += kWidth_ )
+	{
+		auto const d = simd::load8( aA.x.data() + i ) * bx
+			+ simd::load8( aA.y.data() + i ) * by
+			+ simd::load8( aA.z.data() + i ) * bz;
+		simd::store( aOut.data() + i, d );
+	}
+
+	for( ; i < count; ++i )
+		aOut[i] = dot( aA.get( i ), aB );
+}
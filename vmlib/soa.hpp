@@ -0,0 +1,90 @@
+#ifndef SOA_HPP_3EEE175F_BCF1_464F_9F65_BEA282C6C82C
+#define SOA_HPP_3EEE175F_BCF1_464F_9F65_BEA282C6C82C
+
+#include <span>
+#include <vector>
+#include <cstddef>
+#include <cassert>
+
+#include "vec3.hpp"
+#include "aabb.hpp"
+#include "mat44.hpp"
+
+/** Vec3fSoA: array of 3D vectors in structure-of-arrays layout
+ *
+ * The x, y and z components are kept in three separate streams. Batch kernels
+ * (below) can then load eight consecutive x values (etc.) with a single vector
+ * load, instead of having to gather them from an array of Vec3f.
+ *
+ * Example:
+ *   Vec3fSoA points = make_soa( positions );
+ *   batch_transform_points( model, points, points );
+ *   Aabb3f const bounds = batch_bounds( points );
+ */
+struct Vec3fSoA
+{
+	std::vector<float> x, y, z;
+
+	std::size_t size() const noexcept
+	{
+		return x.size();
+	}
+
+	void resize( std::size_t aCount )
+	{
+		x.resize( aCount );
+		y.resize( aCount );
+		z.resize( aCount );
+	}
+	void reserve( std::size_t aCount )
+	{
+		x.reserve( aCount );
+		y.reserve( aCount );
+		z.reserve( aCount );
+	}
+
+	void push_back( Vec3f aVec )
+	{
+		x.push_back( aVec.x );
+		y.push_back( aVec.y );
+		z.push_back( aVec.z );
+	}
+
+	Vec3f get( std::size_t aI ) const noexcept
+	{
+		assert( aI < size() );
+		return Vec3f{ x[aI], y[aI], z[aI] };
+	}
+	void set( std::size_t aI, Vec3f aVec ) noexcept
+	{
+		assert( aI < size() );
+		x[aI] = aVec.x;
+		y[aI] = aVec.y;
+		z[aI] = aVec.z;
+	}
+};
+
+// Conversion to and from arrays of Vec3f
+Vec3fSoA make_soa( std::span<Vec3f const> aVecs );
+void copy_to_aos( Vec3fSoA const& aSoA, std::span<Vec3f> aOut ) noexcept;
+
+// Batch kernels. These process eight elements per iteration where possible
+// (see simd::Float8). Input and output may refer to the same object.
+//
+// The transform kernels assume an affine matrix, i.e., the bottom row is
+// ( 0, 0, 0, 1 ). Points receive the translation, directions do not.
+void batch_transform_points( Mat44f const& aM, Vec3fSoA const& aIn, Vec3fSoA& aOut );
+void batch_transform_directions( Mat44f const& aM, Vec3fSoA const& aIn, Vec3fSoA& aOut );
+
+// Bounds of all elements. Returns kEmptyAabb3f for an empty array.
+Aabb3f batch_bounds( Vec3fSoA const& aVecs ) noexcept;
+
+// Normalizes all elements in place. Elements with a length below aEpsilon are
+// replaced by aFallback (as with the safe_normalize() helper in main).
+void batch_normalize( Vec3fSoA& aVecs, Vec3f aFallback = Vec3f{ 0.f, 1.f, 0.f }, float aEpsilon = 1e-6f ) noexcept;
+
+// Per-element dot products. aOut must hold at least aA.size() elements.
+void batch_dot( Vec3fSoA const& aA, Vec3fSoA const& aB, std::span<float> aOut ) noexcept;
+void batch_dot( Vec3fSoA const& aA, Vec3f aB, std::span<float> aOut ) noexcept;
+
+#endif // SOA_HPP_3EEE175F_BCF1_464F_9F65_BEA282C6C82C
@@ -0,0 +1,139 @@
+#ifndef TRANSFORM_HPP_A5E1F0C4_7B2D_4C39_9E8A_D41B6F23C870
+#define TRANSFORM_HPP_A5E1F0C4_7B2D_4C39_9E8A_D41B6F23C870
+
+#include <cmath>
+
+#include "vec3.hpp"
+#include "mat34.hpp"
+#include "mat44.hpp"
+
+/** Transform: builds affine transformations from translate/rotate/scale steps
+ *
+ * Each step right-multiplies the accumulated transformation, so steps are
+ * written in the same order as the equivalent matrix product:
+ *
+ *    Transform{}.translate( p ).rotate_y( a ).scale( s ).matrix()
+ *      == make_translation( p ) * make_rotation_y( a ) * make_scaling( s, s, s )
+ *
+ * Instead of building a full matrix per step and multiplying, each step is
+ * applied in closed form to the accumulated Mat34f: a translation updates the
+ * last column (9 multiplications), a scaling scales three columns (9), and a
+ * rotation about a coordinate axis mixes two columns (12). A chained product
+ * of N full Mat44f costs 64 multiplications per step.
+ *
+ * Translation and scaling steps are constexpr, so that placements with
+ * constant inputs can be folded at compile time. The rotation steps call
+ * std::cos/std::sin and are evaluated at runtime; rotate_*( aCos, aSin ) take
+ * precomputed values and are constexpr.
+ */
+class Transform final
+{
+	public:
+		constexpr Transform() noexcept = default;
+
+		constexpr explicit
+		Transform( Mat34f const& aAffine ) noexcept
+			: mM( aAffine )
+		{}
+		constexpr explicit
+		Transform( Mat44f const& aAffine ) noexcept
+			: mM( to_mat34( aAffine ) )
+		{}
+
+	public:
+		constexpr
+		Transform& translate( Vec3f aT ) noexcept
+		{
+			for( std::size_t i = 0; i < 3; ++i )
+				mM[i,3] += mM[i,0] * aT.x + mM[i,1] * aT.y + mM[i,2] * aT.z;
+			return *this;
+		}
+
+		constexpr
+		Transform& scale( float aSX, float aSY, float aSZ ) noexcept
+		{
+			for( std::size_t i = 0; i < 3; ++i )
+			{
+				mM[i,0] *= aSX;
+				mM[i,1] *= aSY;
+				mM[i,2] *= aSZ;
+			}
+			return *this;
+		}
+		constexpr
+		Transform& scale( float aS ) noexcept
+		{
+			return scale( aS, aS, aS );
+		}
+
+		constexpr
+		Transform& rotate_x( float aCos, float aSin ) noexcept
+		{
+			return rotate_( 1, 2, aCos, aSin );
+		}
+		constexpr
+		Transform& rotate_y( float aCos, float aSin ) noexcept
+		{
+			return rotate_( 2, 0, aCos, aSin );
+		}
+		constexpr
+		Transform& rotate_z( float aCos, float aSin ) noexcept
+		{
+			return rotate_( 0, 1, aCos, aSin );
+		}
+
+		Transform& rotate_x( float aAngle ) noexcept
+		{
+			return rotate_x( std::cos( aAngle ), std::sin( aAngle ) );
+		}
+		Transform& rotate_y( float aAngle ) noexcept
+		{
+			return rotate_y( std::cos( aAngle ), std::sin( aAngle ) );
+		}
+		Transform& rotate_z( float aAngle ) noexcept
+		{
+			return rotate_z( std::cos( aAngle ), std::sin( aAngle ) );
+		}
+
+		// General step, for anything that is not covered above.
+		constexpr
+		Transform& then( Mat34f const& aRight ) noexcept
+		{
+			mM = mM * aRight;
+			return *this;
+		}
+
+	public:
+		constexpr
+		Mat34f const& affine() const noexcept
+		{
+			return mM;
+		}
+		constexpr
+		Mat44f matrix() const noexcept
+		{
+			return to_mat44( mM );
+		}
+
+	private:
+		// Right-multiply by a rotation in the plane of axes aA and aB, i.e.,
+		// the rotation that takes axis aA towards axis aB. Only columns aA
+		// and aB of the accumulated matrix change.
+		constexpr
+		Transform& rotate_( std::size_t aA, std::size_t aB, float aCos, float aSin ) noexcept
+		{
+			for( std::size_t i = 0; i < 3; ++i )
+			{
+				float const a = mM[i,aA];
+				float const b = mM[i,aB];
+				mM[i,aA] = a * aCos + b * aSin;
+				mM[i,aB] = b * aCos - a * aSin;
+			}
+			return *this;
+		}
+
+	private:
+		Mat34f mM = kIdentity34f;
+};
+
+#endif // TRANSFORM_HPP_A5E1F0C4_7B2D_4C39_9E8A_D41B6F23C870
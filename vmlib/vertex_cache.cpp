@@ -0,0 +1,181 @@
+#include "vertex_cache.hpp"
+
+#include <limits>
+
+namespace
+{
+	constexpr std::uint32_t kNone_ = std::numeric_limits<std::uint32_t>::max();
+
+	// Triangles adjacent to each vertex, in compressed form: the triangles of
+	// vertex v are triangles[offsets[v]] ... triangles[offsets[v+1]-1].
+	struct Adjacency_
+	{
+		std::vector<std::uint32_t> offsets;
+		std::vector<std::uint32_t> triangles;
+	};
+
+	Adjacency_ make_adjacency_( std::span<std::uint32_t const> aIndices, std::size_t aVertexCount )
+	{
+		Adjacency_ ret;
+		ret.offsets.assign( aVertexCount + 1, 0 );
+		ret.triangles.resize( aIndices.size() );
+
+		for( auto const index : aIndices )
+			++ret.offsets[index + 1];
+		for( std::size_t v = 0; v < aVertexCount; ++v )
+			ret.offsets[v + 1] += ret.offsets[v];
+
+		std::vector<std::uint32_t> fill( ret.offsets.begin(), ret.offsets.end() - 1 );
+		for( std::size_t i = 0; i < aIndices.size(); ++i )
+			ret.triangles[fill[aIndices[i]]++] = static_cast<std::uint32_t>( i / 3 );
+
+		return ret;
+	}
+}
+
+VertexCacheStats analyze_vertex_cache( std::span<std::uint32_t const> aIndices, std::size_t aVertexCount, std::size_t aCacheSize )
+{
+	assert( aIndices.size() % 3 == 0 );
+	assert( aCacheSize > 0 );
+
+	// FIFO cache: a vertex is in the cache if fewer than aCacheSize misses
+	// occurred since it was last loaded.
+	std::vector<std::size_t> loadTime( aVertexCount, 0 );
+	std::vector<std::uint8_t> referenced( aVertexCount, 0 );
+	std::size_t time = aCacheSize + 1;
+
+	std::size_t transformed = 0, distinct = 0;
+	for( auto const index : aIndices )
+	{
+		assert( index < aVertexCount );
+
+		if( time - loadTime[index] > aCacheSize )
+		{
+			loadTime[index] = time++;
+			++transformed;
+		}
+
+		distinct += !referenced[index];
+		referenced[index] = 1;
+	}
+
+	std::size_t const triangles = aIndices.size() / 3;
+	return VertexCacheStats{
+		transformed,
+		triangles ? float(transformed) / float(triangles) : 0.f,
+		distinct ? float(transformed) / float(distinct) : 0.f
+	};
+}
+
+void optimize_vertex_cache( std::span<std::uint32_t> aIndices, std::size_t aVertexCount, std::size_t aCacheSize )
+{
+	assert( aIndices.size() % 3 == 0 );
+	assert( aVertexCount < kNone_ );
+
+	if( aIndices.empty() )
+		return;
+
+	std::vector<std::uint32_t> const source( aIndices.begin(), aIndices.end() );
+	auto const adjacency = make_adjacency_( source, aVertexCount );
+
+	// Number of not yet emitted triangles per vertex.
+	std::vector<std::uint32_t> live( aVertexCount );
+	for( std::size_t v = 0; v < aVertexCount; ++v )
+		live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+
+	// Simulated cache, as in analyze_vertex_cache().
+	std::vector<std::size_t> loadTime( aVertexCount, 0 );
+	std::size_t time = aCacheSize + 1;
+
+	std::vector<std::uint8_t> emitted( source.size() / 3, 0 );
+	std::vector<std::uint32_t> deadEnd;   // recently used vertices
+	std::vector<std::uint32_t> candidates;
+	std::size_t cursor = 0; // next vertex to try when deadEnd is exhausted
+	std::size_t out = 0;
+
+	std::uint32_t fanning = 0;
+	while( kNone_ != fanning )
+	{
+		// Emit all remaining triangles around the fanning vertex.
+		candidates.clear();
+		for( auto k = adjacency.offsets[fanning]; k < adjacency.offsets[fanning + 1]; ++k )
+		{
+			auto const tri = adjacency.triangles[k];
+			if( emitted[tri] )
+				continue;
+
+			for( std::size_t c = 0; c < 3; ++c )
+			{
+				auto const v = source[3*tri + c];
+				aIndices[out++] = v;
+
+				deadEnd.emplace_back( v );
+				candidates.emplace_back( v );
+				--live[v];
+
+				if( time - loadTime[v] > aCacheSize )
+					loadTime[v] = time++;
+			}
+
+			emitted[tri] = 1;
+		}
+
+		// Continue with the candidate that is oldest while still being in
+		// the cache after its remaining triangles have been emitted (each
+		// of which adds at most two new vertices).
+		fanning = kNone_;
+		std::size_t bestPriority = 0;
+		for( auto const v : candidates )
+		{
+			if( 0 == live[v] )
+				continue;
+
+			std::size_t const age = time - loadTime[v];
+			std::size_t const priority = 1 + (age + 2*live[v] <= aCacheSize ? age : 0);
+			if( priority > bestPriority )
+			{
+				bestPriority = priority;
+				fanning = v;
+			}
+		}
+
+		if( kNone_ != fanning )
+			continue;
+
+		// Dead end: restart at a recently used vertex, or failing that, at
+		// the next vertex with triangles left.
+		while( !deadEnd.empty() && kNone_ == fanning )
+		{
+			auto const v = deadEnd.back();
+			deadEnd.pop_back();
+			if( live[v] )
+				fanning = v;
+		}
+
+		for( ; kNone_ == fanning && cursor < aVertexCount; ++cursor )
+		{
+			if( live[cursor] )
+				fanning = static_cast<std::uint32_t>( cursor );
+		}
+	}
+
+	assert( out == source.size() );
+}
+
+std::vector<std::uint32_t> make_vertex_fetch_remap( std::span<std::uint32_t> aIndices, std::size_t aVertexCount )
+{
+	std::vector<std::uint32_t> remap( aVertexCount, kUnusedVertex );
+
+	std::uint32_t next = 0;
+	for( auto& index : aIndices )
+	{
+		assert( index < aVertexCount );
+
+		if( kUnusedVertex == remap[index] )
+			remap[index] = next++;
+
+		index = remap[index];
+	}
+
+	return remap;
+}
@@ -0,0 +1,83 @@
+#ifndef VERTEX_CACHE_HPP_2E7B9C14_6A3D_4F85_B1E0_C84D5A2F97B3
+#define VERTEX_CACHE_HPP_2E7B9C14_6A3D_4F85_B1E0_C84D5A2F97B3
+
+#include <span>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+/** Vertex cache optimization for indexed triangle lists
+ *
+ * GPUs keep the results of recently shaded vertices in a small post-transform
+ * cache, so a vertex that is referenced again shortly after is not shaded a
+ * second time. How often that happens depends only on the order of the
+ * triangles in the index buffer.
+ *
+ * optimize_vertex_cache() reorders the triangles with Tipsify (Sander, Nehab
+ * and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced
+ * Overdraw", 2007). It runs in linear time and does not depend much on the
+ * actual cache size, which differs between GPUs. The vertices of each
+ * triangle keep their order, so the winding is unchanged.
+ *
+ * optimize_vertex_fetch() then renumbers the vertices in the order in which
+ * the index buffer first references them, so that vertex fetches walk
+ * through the vertex buffer front to back.
+ *
+ * analyze_vertex_cache() simulates a FIFO cache of the given size on the
+ * CPU and reports
+ *  - ACMR, average cache miss ratio: shaded vertices per triangle. 3 is the
+ *    worst case; about 0.5 is the limit for large regular meshes.
+ *  - ATVR, average transform to vertex ratio: shaded vertices per distinct
+ *    vertex. 1 is optimal (every vertex is shaded exactly once).
+ */
+struct VertexCacheStats
+{
+	std::size_t transformed; // simulated cache misses
+	float acmr;
+	float atvr;
+};
+
+// Reference cache size. Actual hardware differs (and is not necessarily
+// FIFO), but 16 to 32 entries are representative.
+constexpr std::size_t kDefaultVertexCacheSize = 16;
+
+VertexCacheStats analyze_vertex_cache( std::span<std::uint32_t const> aIndices, std::size_t aVertexCount, std::size_t aCacheSize = kDefaultVertexCacheSize );
+
+// Reorders the triangles of aIndices in place. All indices must be less than
+// aVertexCount.
+void optimize_vertex_cache( std::span<std::uint32_t> aIndices, std::size_t aVertexCount, std::size_t aCacheSize = kDefaultVertexCacheSize );
+
+// Renumbers the indices in place in order of first use. Returns the mapping
+// from old to new vertex indices; vertices that are never referenced map to
+// kUnusedVertex.
+constexpr std::uint32_t kUnusedVertex = ~std::uint32_t(0);
+
+std::vector<std::uint32_t> make_vertex_fetch_remap( std::span<std::uint32_t> aIndices, std::size_t aVertexCount );
+
+// Applies make_vertex_fetch_remap() to aIndices and reorders aVertices to
+// match. Unreferenced vertices are dropped.
+template< class tVertex >
+void optimize_vertex_fetch( std::span<std::uint32_t> aIndices, std::vector<tVertex>& aVertices )
+{
+	auto const remap = make_vertex_fetch_remap( aIndices, aVertices.size() );
+
+	std::size_t used = 0;
+	for( auto const index : remap )
+		used += (kUnusedVertex != index);
+
+	std::vector<tVertex> reordered( used );
+	for( std::size_t i = 0; i < remap.size(); ++i )
+	{
+		if( kUnusedVertex != remap[i] )
+		{
+			assert( remap[i] < used );
+			reordered[remap[i]] = aVertices[i];
+		}
+	}
+
+	aVertices = std::move(reordered);
+}
+
+#endif // VERTEX_CACHE_HPP_2E7B9C14_6A3D_4F85_B1E0_C84D5A2F97B3
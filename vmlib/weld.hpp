@@ -0,0 +1,191 @@
+#ifndef WELD_HPP_8D3F6A21_B5C4_4E97_A1F0_39C7E2D6B548
+#define WELD_HPP_8D3F6A21_B5C4_4E97_A1F0_39C7E2D6B548
+
+#include <span>
+#include <bit>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+/** Vertex welding: triangle soup to indexed mesh
+ *
+ * OBJ loaders naturally produce one vertex per face corner. In a connected
+ * mesh most corners are shared by several triangles (about six for a regular
+ * grid), so most of those vertices are duplicates.
+ *
+ * weld_vertices() keeps the first occurrence of each distinct vertex and
+ * emits an index per corner, i.e., drawing the result with glDrawElements()
+ * gives exactly the same triangles as drawing aCorners with glDrawArrays().
+ *
+ * Vertices are compared bitwise. Only exact duplicates are merged (e.g., the
+ * same position with a different normal or texture coordinate stays a
+ * separate vertex), and 0.f and -0.f are considered different. tVertex must
+ * be trivially copyable and must not contain padding bytes.
+ *
+ * Duplicates are found with an open-addressing hash table (linear probing,
+ * load factor <= 0.5) that stores only 32-bit vertex indices. This runs in
+ * linear time and uses 8 bytes of table per input corner at most.
+ *
+ * VertexWelder does the same one corner at a time, for corners that are
+ * produced incrementally (e.g., while streaming a file) and never exist as a
+ * whole. Its table grows with the number of distinct vertices instead, so it
+ * needs 8 to 16 bytes of table per output vertex.
+ */
+template< class tVertex >
+struct IndexedMesh
+{
+	std::vector<tVertex> vertices;
+	std::vector<std::uint32_t> indices;
+};
+
+namespace detail
+{
+	inline
+	std::uint64_t hash_vertex_( void const* aData, std::size_t aSize ) noexcept
+	{
+		auto const* bytes = static_cast<unsigned char const*>( aData );
+
+		std::uint64_t h = 0x9E3779B97F4A7C15ull;
+		std::size_t i = 0;
+		for( ; i + 4 <= aSize; i += 4 )
+		{
+			std::uint32_t word;
+			std::memcpy( &word, bytes + i, 4 );
+			h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+		}
+		for( ; i < aSize; ++i )
+			h = (h ^ bytes[i]) * 0xFF51AFD7ED558CCDull;
+
+		// Mix the high bits into the low ones, which select the slot.
+		return h ^ (h >> 32);
+	}
+}
+
+template< class tVertex >
+class VertexWelder
+{
+	static_assert( std::is_trivially_copyable_v<tVertex> );
+
+	public:
+		VertexWelder() = default;
+
+		// Sizes the table for aCorners corners (and as many distinct
+		// vertices, at most), so that it never needs to grow.
+		void reserve( std::size_t aCorners )
+		{
+			mMesh.indices.reserve( aCorners );
+			if( 2 * aCorners > mTable.size() )
+				rehash_( std::bit_ceil( std::max<std::size_t>( 16, 2 * aCorners ) ) );
+		}
+
+		// Appends the index of aCorner, adding it as a new vertex if it has
+		// not been seen before.
+		std::uint32_t add( tVertex const& aCorner )
+		{
+			assert( mMesh.vertices.size() < kEmpty_ );
+
+			if( 2 * (mMesh.vertices.size() + 1) > mTable.size() )
+				rehash_( std::max<std::size_t>( 16, 2 * mTable.size() ) );
+
+			std::size_t const mask = mTable.size() - 1;
+			std::size_t slot = detail::hash_vertex_( &aCorner, sizeof(tVertex) ) & mask;
+			while( true )
+			{
+				auto const index = mTable[slot];
+				if( kEmpty_ == index )
+				{
+					auto const newIndex = static_cast<std::uint32_t>( mMesh.vertices.size() );
+					mTable[slot] = newIndex;
+					mMesh.vertices.emplace_back( aCorner );
+					mMesh.indices.emplace_back( newIndex );
+					return newIndex;
+				}
+
+				if( 0 == std::memcmp( &mMesh.vertices[index], &aCorner, sizeof(tVertex) ) )
+				{
+					mMesh.indices.emplace_back( index );
+					return index;
+				}
+
+				slot = (slot + 1) & mask;
+			}
+		}
+
+		std::size_t vertex_count() const noexcept
+		{
+			return mMesh.vertices.size();
+		}
+
+		// Returns the welded mesh and releases the table. The welder is
+		// empty afterwards.
+		IndexedMesh<tVertex> take()
+		{
+			mTable = std::vector<std::uint32_t>();
+			mMesh.vertices.shrink_to_fit();
+			return std::exchange( mMesh, IndexedMesh<tVertex>{} );
+		}
+
+	private:
+		static constexpr std::uint32_t kEmpty_ = std::numeric_limits<std::uint32_t>::max();
+
+		void rehash_( std::size_t aTableSize )
+		{
+			assert( std::has_single_bit( aTableSize ) );
+
+			std::size_t const mask = aTableSize - 1;
+			std::vector<std::uint32_t> table( aTableSize, kEmpty_ );
+			for( std::uint32_t i = 0; i < mMesh.vertices.size(); ++i )
+			{
+				std::size_t slot = detail::hash_vertex_( &mMesh.vertices[i], sizeof(tVertex) ) & mask;
+				while( kEmpty_ != table[slot] )
+					slot = (slot + 1) & mask;
+				table[slot] = i;
+			}
+			mTable = std::move(table);
+		}
+
+	private:
+		std::vector<std::uint32_t> mTable;
+		IndexedMesh<tVertex> mMesh;
+};
+
+template< class tVertex >
+IndexedMesh<tVertex> weld_vertices( std::span<tVertex const> aCorners )
+{
+	assert( aCorners.size() <= std::numeric_limits<std::uint32_t>::max() );
+
+	VertexWelder<tVertex> welder;
+	welder.reserve( aCorners.size() );
+	for( auto const& corner : aCorners )
+		welder.add( corner );
+
+	return welder.take();
+}
+
+/* Index buffers for meshes with at most 65536 vertices fit into 16 bits
+ * (GL_UNSIGNED_SHORT), which halves their size.
+ */
+constexpr
+bool fits_16bit_indices( std::size_t aVertexCount ) noexcept
+{
+	return aVertexCount <= std::size_t(std::numeric_limits<std::uint16_t>::max()) + 1;
+}
+
+inline
+std::vector<std::uint16_t> narrow_indices( std::span<std::uint32_t const> aIndices )
+{
+	std::vector<std::uint16_t> ret( aIndices.size() );
+	for( std::size_t i = 0; i < aIndices.size(); ++i )
+	{
+		assert( aIndices[i] <= std::numeric_limits<std::uint16_t>::max() );
+		ret[i] = static_cast<std::uint16_t>( aIndices[i] );
+	}
+	return ret;
+}
+
+#endif // WELD_HPP_8D3F6A21_B5C4_4E97_A1F0_39C7E2D6B548